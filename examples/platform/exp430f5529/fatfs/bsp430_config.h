@@ -14,6 +14,12 @@
 /* Explicitly require SPI via serial abstraction */
 #define configBSP430_SERIAL_ENABLE_SPI 1
 
+/* Hand sector-sized transfers to the DMA controller */
+#define configBSP430_SERIAL_SPI_USE_DMA 1
+
+/* The card is switched between configurations through the bus manager */
+#define configBSP430_SERIAL_SPI_BUS 1
+
 /* SD card is on USCI B1, which by default is port-mapped to P4 */
 #define configBSP430_HAL_USCI5_B1 1
 #define APP_SD_SPI_PERIPH_HANDLE BSP430_PERIPH_USCI5_B1
@@ -28,7 +34,7 @@
 #define APP_SD_MISO_PORT_BIT BIT2
 
 /* The chip select for the SD card is on P3.7 */
-#define configBSP430_HPL_PORT3 1
+#define configBSP430_HAL_PORT3 1
 #define APP_SD_CS_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT3
 #define APP_SD_CS_PORT_BIT BIT7
 
@@ -43,7 +43,14 @@
 /* Platform dependent macros and functions needed to be modified           */
 /*-------------------------------------------------------------------------*/
 
-#define APP_SD_CS_PORT_HPL xBSP430hplLookupPORT(APP_SD_CS_PORT_PERIPH_HANDLE)
+#define APP_SD_CS_PORT_HAL hBSP430portLookup(APP_SD_CS_PORT_PERIPH_HANDLE)
+static sBSP430spiBus sdbus_;
+static sBSP430spiBusDevice sdslow_;
+static sBSP430spiBusDevice sdfast_;
+static sBSP430spiBusDevice sdidle_slow_;
+static sBSP430spiBusDevice sdidle_fast_;
+static hBSP430spiBusDevice sddev;
+static hBSP430spiBusDevice sdidle;
 static hBSP430halSERIAL sdspi;
 
 /* Following BSP430/POSIX conventions, this returns 0 if successful,
@@ -51,55 +58,93 @@ static hBSP430halSERIAL sdspi;
 static int
 configureSPIforSD (int fastp)
 {
-  unsigned long smclk_hz = ulBSP430clockSMCLK_Hz();
+  unsigned long smclk_hz;
   unsigned int init_spi_divisor;
-  volatile sBSP430hplPORT * miso_port = xBSP430hplLookupPORT(APP_SD_MISO_PORT_PERIPH_HANDLE);
+  unsigned int fast_spi_divisor;
+  const unsigned char ctl0_byte = BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(UCCKPL | UCMSB | UCMST | UCMODE_0);
+  volatile sBSP430hplPORT * miso_port;
+
+  /* The card is registered on the bus once, in each of the
+   * configurations it needs.  Thereafter switching between them
+   * touches only the prescaler. */
+  if (NULL != sdspi) {
+    sddev = fastp ? &sdfast_ : &sdslow_;
+    sdidle = fastp ? &sdidle_fast_ : &sdidle_slow_;
+    return 0;
+  }
 
   /* We'll drive the SPI device using SMCLK.  For initialization, we
    * need to stay below 400 kHz, and have chosen 380 kHz in case of
    * clock variances.  After initialization, we can go faster. */
-  if (fastp) {
-    init_spi_divisor = (smclk_hz + BSP430_MMC_FAST_HZ) / BSP430_MMC_FAST_HZ;
-  } else {
-    init_spi_divisor = (smclk_hz + 380000UL) / 380000UL;
-  }
+  smclk_hz = ulBSP430clockSMCLK_Hz();
+  init_spi_divisor = (smclk_hz + 380000UL) / 380000UL;
+  fast_spi_divisor = (smclk_hz + BSP430_MMC_FAST_HZ) / BSP430_MMC_FAST_HZ;
   /* SPI divisor must not be zero */
   if (0 == init_spi_divisor) {
     init_spi_divisor = 1;
   }
-  
-  /* Close the device if we already opened it. */
-  if (sdspi) {
-    (void)iBSP430serialClose(sdspi);
+  if (0 == fast_spi_divisor) {
+    fast_spi_divisor = 1;
   }
-  
+
   /* For some SD cards, need MISO pullup, or so we're told.  Do that
    * first, hoping the platform peripheral configuration won't destroy
    * it. */
+  miso_port = xBSP430hplLookupPORT(APP_SD_MISO_PORT_PERIPH_HANDLE);
   miso_port->ren |= APP_SD_MISO_PORT_BIT;
   miso_port->dir &= ~APP_SD_MISO_PORT_BIT;
   miso_port->out |= APP_SD_MISO_PORT_BIT;
 
-  /* Configure SPI.  Probably ought to have a way to return an error
-   * code. */
-  sdspi = hBSP430serialOpenSPI(hBSP430serialLookup(APP_SD_SPI_PERIPH_HANDLE),
-                               BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(UCCKPL | UCMSB | UCMST | UCMODE_0),
-                               UCSSEL__SMCLK, init_spi_divisor);
+  /* The idle configurations have no chip select, and are used to
+   * clock the card while it is deselected at the current speed. */
+  if ((NULL == hBSP430spiBusInitialize(&sdbus_, hBSP430serialLookup(APP_SD_SPI_PERIPH_HANDLE)))
+      || (NULL == hBSP430spiBusDeviceRegister(&sdbus_, &sdslow_, ctl0_byte, UCSSEL__SMCLK, init_spi_divisor,
+                                              APP_SD_CS_PORT_HAL, APP_SD_CS_PORT_BIT))
+      || (NULL == hBSP430spiBusDeviceRegister(&sdbus_, &sdfast_, ctl0_byte, UCSSEL__SMCLK, fast_spi_divisor,
+                                              APP_SD_CS_PORT_HAL, APP_SD_CS_PORT_BIT))
+      || (NULL == hBSP430spiBusDeviceRegister(&sdbus_, &sdidle_slow_, ctl0_byte, UCSSEL__SMCLK, init_spi_divisor,
+                                              NULL, 0))
+      || (NULL == hBSP430spiBusDeviceRegister(&sdbus_, &sdidle_fast_, ctl0_byte, UCSSEL__SMCLK, fast_spi_divisor,
+                                              NULL, 0))) {
+    return -1;
+  }
+  sdspi = xBSP430spiBusSerial(&sdbus_);
+  sddev = fastp ? &sdfast_ : &sdslow_;
+  sdidle = fastp ? &sdidle_fast_ : &sdidle_slow_;
+  return 0;
+}
+
+/* Take the bus for dev, returning 0 if successful and -1 on error. */
+static int
+busSelect (hBSP430spiBusDevice dev)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  int rc;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430spiBusSelect_ni(dev);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rc;
+}
 
-  /* Configure the chip-select port. */
-  APP_SD_CS_PORT_HPL->sel &= ~APP_SD_CS_PORT_BIT;
-  APP_SD_CS_PORT_HPL->out |= APP_SD_CS_PORT_BIT;
-  APP_SD_CS_PORT_HPL->dir |= APP_SD_CS_PORT_BIT;
+static void
+busDeselect (hBSP430spiBusDevice dev)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
 
-  return (0 != sdspi) ? 0 : -1;
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)iBSP430spiBusDeselect_ni(dev);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
 }
 
 #define INIT_PORT() configureSPIforSD(0)
 #define REINIT_PORT_FAST() configureSPIforSD(1)
 #define DLY_US(n_) BSP430_CORE_DELAY_CYCLES(((n_) * BSP430_CLOCK_NOMINAL_MCLK_HZ)/1000000)
 
-#define CS_H() do { APP_SD_CS_PORT_HPL->out |= APP_SD_CS_PORT_BIT; } while (0)
-#define CS_L() do { APP_SD_CS_PORT_HPL->out &= ~APP_SD_CS_PORT_BIT; } while (0)
+#define CS_H() busDeselect(sddev)
+#define CS_L() busSelect(sddev)
 
 /** [BSP430 Initialization] */
 /*--------------------------------------------------------------------------
@@ -206,10 +251,20 @@ int wait_ready (void)	/* 1:OK, 0:Timeout */
 static
 void deselect (void)
 {
+	BSP430_CORE_INTERRUPT_STATE_T istate;
 	BYTE d;
 
+	/* The dummy clock must follow the rise of CS but precede release
+	 * of the bus, so it is sent through the idle configuration before
+	 * any other device can take the bus. */
+	BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+	BSP430_CORE_DISABLE_INTERRUPT();
 	CS_H();
-	rcvr_mmc(&d, 1);	/* Dummy clock (force DO hi-z for multiple slave SPI) */
+	if (0 == busSelect(sdidle)) {
+		rcvr_mmc(&d, 1);	/* Dummy clock (force DO hi-z for multiple slave SPI) */
+		busDeselect(sdidle);
+	}
+	BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
 }
 
 
@@ -223,7 +278,7 @@ int select (void)	/* 1:OK, 0:Timeout */
 {
 	BYTE d;
 
-	CS_L();
+	if (0 != CS_L()) return 0;	/* Bus held by another device */
 	rcvr_mmc(&d, 1);	/* Dummy clock (force DO enabled) */
 
 	if (wait_ready()) return 1;	/* OK */
@@ -394,7 +449,11 @@ DSTATUS disk_initialize (
 		return RES_ERROR;
 	}
 
+	if (0 != busSelect(&sdidle_slow_)) {
+		return RES_ERROR;
+	}
 	for (n = 10; n; n--) rcvr_mmc(buf, 1);	/* 80 dummy clocks */
+	busDeselect(&sdidle_slow_);
 
 	ty = 0;
 	if (send_cmd(CMD0, 0) == 1) {			/* Enter Idle state */
@@ -8,6 +8,9 @@
 /* Support console output */
 #define configBSP430_CONSOLE 1
 
+/* Support uptime for I2C transaction timeouts */
+#define configBSP430_UPTIME 1
+
 /* We need serial I2C for the TMP102 access */
 #define configBSP430_SERIAL_ENABLE_I2C 1
 
@@ -15,9 +18,12 @@
 #if BSP430_PLATFORM_EXP430F5438 - 0
 #define APP_TMP102_I2C_PERIPH_HANDLE BSP430_PERIPH_USCI5_B3
 #define configBSP430_HAL_USCI5_B3 1
+#define configBSP430_SERIAL_I2C_USE_ISR 1
 #elif BSP430_PLATFORM_EXP430FR5739 - 0
 #define APP_TMP102_I2C_PERIPH_HANDLE BSP430_PERIPH_EUSCI_B0
 #define configBSP430_HAL_EUSCI_B0 1
+#define configBSP430_HAL_EUSCI_B0_ISR 1
+#define configBSP430_SERIAL_I2C_USE_ISR 1
 #else
 #define APP_TMP102_I2C_PERIPH_HANDLE BSP430_PERIPH_USCI_B0
 #define configBSP430_HAL_USCI_B0 1
@@ -26,6 +32,8 @@
 #define APP_TMP102_I2C_PRESCALER 100
 /* Address for the thing.  0x48 when ADD0 is shorted to GND. */
 #define APP_TMP102_I2C_ADDRESS 0x48
+/* Uptime timer capture/compare register used for I2C timeouts */
+#define APP_TMP102_I2C_TIMEOUT_CCIDX 1
 
 /* Get platform defaults */
 #include <bsp430/platform/bsp430_config.h>
@@ -12,10 +12,18 @@
 
 unsigned int temp_xCel;
 
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+sBSP430i2cQueue i2c_queue;
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
 void main ()
 {
   hBSP430halSERIAL i2c = hBSP430serialLookup(APP_TMP102_I2C_PERIPH_HANDLE);
   uint8_t pr = 0;
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  hBSP430i2cQueue queue;
+  sBSP430i2cTransaction txn;
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
 
   vBSP430platformInitialize_ni();
   (void)iBSP430consoleInitialize();
@@ -34,6 +42,21 @@ void main ()
 
   (void)iBSP430i2cSetAddresses_ni(i2c, -1, APP_TMP102_I2C_ADDRESS);
 
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  queue = hBSP430i2cQueueInitialize(&i2c_queue, i2c, APP_TMP102_I2C_TIMEOUT_CCIDX);
+  if (! queue) {
+    cprintf("I2C queue initialization failed.\n");
+    return;
+  }
+  memset(&txn, 0, sizeof(txn));
+  txn.slave_address = APP_TMP102_I2C_ADDRESS;
+  txn.tx_data = &pr;
+  txn.tx_len = sizeof(pr);
+  txn.rx_len = 2;
+  /* TMP102 transactions take well under a millisecond at 80 kHz */
+  txn.timeout_utt = ulBSP430uptimeConversionFrequency_Hz_ni() / 20;
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
 #define BSP430_TMP_xCel_TO_ddegF(xcel_) (320 + ((9 * (xcel_ >> 1)) / (4 >> (1 & (xcel_)))))
 
   while (1) {
@@ -41,17 +64,34 @@ void main ()
     uint8_t data[2];
     uint16_t temp_xCel;
 
-    rc = iBSP430i2cTxData_ni(i2c, &pr, 1);
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+    memset(data, 0, sizeof(data));
+    txn.rx_data = data;
+    BSP430_CORE_DISABLE_INTERRUPT();
+    rc = iBSP430i2cQueueSubmit_ni(queue, &txn);
+    while ((0 == rc) && (! iBSP430i2cQueueIdle_ni(queue))) {
+      /* Sleep until the transaction completes or times out */
+      BSP430_CORE_LPM_ENTER_NI(LPM0_bits | GIE);
+      BSP430_CORE_DISABLE_INTERRUPT();
+    }
+    BSP430_CORE_ENABLE_INTERRUPT();
+    if (0 == rc) {
+      rc = txn.result;
+    }
     if (0 > rc) {
-      cprintf("I2C TX ERROR\n");
+      cprintf("I2C ERROR %d\n", rc);
       continue;
     }
+#else /* configBSP430_SERIAL_I2C_USE_ISR */
+    /* Write the pointer register and read its value in one
+     * transaction */
     memset(data, 0, sizeof(data));
-    rc = iBSP430i2cRxData_ni(i2c, data, sizeof(data));
+    rc = iBSP430i2cTxRx_ni(i2c, &pr, 1, sizeof(data), data);
     if (0 > rc) {
-      cprintf("I2C RX ERROR\n");
+      cprintf("I2C ERROR\n");
       continue;
     }
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
     temp_xCel = data[1] | (data[0] << 8);
     if (0 == pr) {
       cprintf("temp 0x%04x = %d d[degF]\n", temp_xCel, BSP430_TMP_xCel_TO_ddegF(temp_xCel));
@@ -0,0 +1,18 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Monitor uptime and provide generic ACLK-driven timer */
+#define configBSP430_UPTIME 1
+
+/* Build with EXT_CPPFLAGS=-DconfigBSP430_SERIAL_DIRECT_DISPATCH=1 to
+ * compare against the dispatch table */
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,61 @@
+/** This file is in the public domain.
+ *
+ * Measure the cost of a generic serial call.  The program times a
+ * large number of iBSP430uartRxByte_ni() calls on the console, which
+ * return immediately when no data is available, and reports the
+ * average number of MCLK cycles per call.  Build once normally and
+ * once with EXT_CPPFLAGS=-DconfigBSP430_SERIAL_DIRECT_DISPATCH=1 to
+ * compare the dispatch table with direct calls.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/serial.h>
+
+#define APP_ITERATIONS 10000U
+
+void main ()
+{
+  hBSP430halSERIAL console;
+  unsigned long mclk_Hz;
+  unsigned long utt_Hz;
+
+  vBSP430platformInitialize_ni();
+  iBSP430consoleInitialize();
+  console = hBSP430console();
+
+  cprintf("\nSerial dispatch timing: %s dispatch\n",
+          (BSP430_SERIAL_DIRECT_DISPATCH - 0) ? "direct" : "table");
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    unsigned long t0;
+    unsigned long t1;
+    unsigned long cycles;
+    unsigned int i;
+    int rc = 0;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    mclk_Hz = ulBSP430clockMCLK_Hz_ni();
+    utt_Hz = ulBSP430uptimeConversionFrequency_Hz_ni();
+    t0 = ulBSP430uptime_ni();
+    for (i = 0; i < APP_ITERATIONS; ++i) {
+      rc += iBSP430uartRxByte_ni(console);
+    }
+    t1 = ulBSP430uptime_ni();
+    BSP430_CORE_ENABLE_INTERRUPT();
+
+    /* Scale ticks to cycles in two steps to avoid overflow */
+    cycles = ((t1 - t0) * (mclk_Hz / 1000)) / (utt_Hz / 1000);
+    cprintf("%u calls: %lu ticks, %lu cycles, %lu.%02lu cycles/call (rc %d)\n",
+            APP_ITERATIONS, t1 - t0, cycles,
+            cycles / APP_ITERATIONS, (100 * (cycles % APP_ITERATIONS)) / APP_ITERATIONS,
+            rc);
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ);
+  }
+}
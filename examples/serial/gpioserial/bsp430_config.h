@@ -0,0 +1,29 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Monitor uptime and provide generic ACLK-driven timer */
+#define configBSP430_UPTIME 1
+
+/* Enable SPI in the serial layer */
+#define configBSP430_SERIAL_ENABLE_SPI 1
+
+/* Software SPI on the RF header SPI pins.  Jumper MOSI (P3.1) to MISO
+ * (P3.2) to check the loopback data. */
+#define configBSP430_HAL_PORT3 1
+#define configBSP430_HAL_GPIOSERIAL0 1
+#define BSP430_GPIOSERIAL0_CLK_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT3
+#define BSP430_GPIOSERIAL0_CLK_PORT_BIT BIT3
+#define BSP430_GPIOSERIAL0_MOSI_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT3
+#define BSP430_GPIOSERIAL0_MOSI_PORT_BIT BIT1
+#define BSP430_GPIOSERIAL0_MISO_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT3
+#define BSP430_GPIOSERIAL0_MISO_PORT_BIT BIT2
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
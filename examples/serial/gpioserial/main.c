@@ -0,0 +1,98 @@
+/** This file is in the public domain.
+ *
+ * Measure the throughput of the GPIO software SPI.  The program
+ * repeatedly transfers a block through #BSP430_HAL_GPIOSERIAL0 at a
+ * series of SMCLK prescalers, and reports the MCLK cycles spent per
+ * octet along with the achieved and requested bit rates.  A prescaler
+ * of 1 selects the unrolled shift loop, which shows the fastest bit
+ * rate the current MCLK supports.
+ *
+ * If MOSI is jumpered to MISO the received data is compared with what
+ * was sent.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/serial.h>
+#include <string.h>
+
+#define APP_BLOCK_LENGTH 64
+#define APP_ITERATIONS 16U
+
+static const unsigned int prescalers[] = { 1, 2, 4, 8, 16, 64 };
+
+static uint8_t tx_buffer[APP_BLOCK_LENGTH];
+static uint8_t rx_buffer[APP_BLOCK_LENGTH];
+
+void main ()
+{
+  hBSP430halSERIAL spi;
+  unsigned long mclk_Hz;
+  unsigned long smclk_Hz;
+  unsigned long utt_Hz;
+  int i;
+
+  vBSP430platformInitialize_ni();
+  iBSP430consoleInitialize();
+
+  for (i = 0; i < sizeof(tx_buffer); ++i) {
+    tx_buffer[i] = 0x5A ^ i;
+  }
+
+  cprintf("\nGPIO software SPI timing on %s\n",
+          xBSP430serialName(BSP430_PERIPH_GPIOSERIAL0));
+  spi = hBSP430serialLookup(BSP430_PERIPH_GPIOSERIAL0);
+  spi = hBSP430serialOpenSPI(spi, UCCKPH | UCMSB | UCMST | UCSYNC, UCSSEL_2, 1);
+  if (NULL == spi) {
+    cprintf("SPI open failed\n");
+    return;
+  }
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    int pi;
+
+    for (pi = 0; pi < sizeof(prescalers) / sizeof(*prescalers); ++pi) {
+      unsigned int prescaler = prescalers[pi];
+      unsigned long t0;
+      unsigned long t1;
+      unsigned long cycles;
+      unsigned long octets;
+      unsigned long bit_Hz;
+      unsigned int n;
+      int rc = 0;
+
+      BSP430_CORE_DISABLE_INTERRUPT();
+      mclk_Hz = ulBSP430clockMCLK_Hz_ni();
+      smclk_Hz = ulBSP430clockSMCLK_Hz_ni();
+      utt_Hz = ulBSP430uptimeConversionFrequency_Hz_ni();
+      (void)iBSP430spiReconfigure_ni(spi, UCCKPH | UCMSB | UCMST | UCSYNC, UCSSEL_2, prescaler);
+      memset(rx_buffer, 0, sizeof(rx_buffer));
+      t0 = ulBSP430uptime_ni();
+      for (n = 0; n < APP_ITERATIONS; ++n) {
+        rc = iBSP430spiTxRx_ni(spi, tx_buffer, sizeof(tx_buffer), 0, rx_buffer);
+      }
+      t1 = ulBSP430uptime_ni();
+      BSP430_CORE_ENABLE_INTERRUPT();
+
+      /* Scale ticks to cycles in two steps to avoid overflow */
+      octets = (unsigned long)APP_ITERATIONS * sizeof(tx_buffer);
+      cycles = ((t1 - t0) * (mclk_Hz / 1000)) / (utt_Hz / 1000);
+      bit_Hz = 0;
+      if (100 <= cycles) {
+        bit_Hz = (8 * octets * (mclk_Hz / 100)) / (cycles / 100);
+      }
+      cprintf("prescaler %3u: %lu cycles/octet, %lu bps (requested %lu)%s\n",
+              prescaler, cycles / octets, bit_Hz, smclk_Hz / prescaler,
+              (sizeof(tx_buffer) != rc) ? " FAILED"
+              : ((0 == memcmp(tx_buffer, rx_buffer, sizeof(rx_buffer))) ? " loopback ok" : ""));
+    }
+    cprintf("MCLK %lu Hz\n\n", mclk_Hz);
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ);
+  }
+}
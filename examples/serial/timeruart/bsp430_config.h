@@ -0,0 +1,21 @@
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Second UART on Timer1_A3 of the msp430g2553: receive on P2.1
+ * (TA1.1 CCI1A), transmit on P2.4 (TA1.2 output) */
+#define configBSP430_HAL_TA1 1
+#define configBSP430_HAL_PORT2 1
+#define configBSP430_HAL_TIMERUART0 1
+#define BSP430_TIMERUART0_TIMER_PERIPH_HANDLE BSP430_PERIPH_TA1
+#define BSP430_TIMERUART0_RX_CCIDX 1
+#define BSP430_TIMERUART0_TX_CCIDX 2
+#define BSP430_TIMERUART0_RX_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT2
+#define BSP430_TIMERUART0_RX_PORT_BIT BIT1
+#define BSP430_TIMERUART0_TX_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT2
+#define BSP430_TIMERUART0_TX_PORT_BIT BIT4
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,68 @@
+/** This file is in the public domain.
+ *
+ * Run a second UART on timer capture/compare blocks alongside the
+ * console.  Octets received on the timer UART are displayed on the
+ * console in hex and echoed back through the timer UART.  Connect a
+ * 9600 baud 8N1 terminal to the pins identified in bsp430_config.h.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/serial.h>
+
+#define APP_BAUD 9600
+
+static volatile int rx_octet = -1;
+
+static int
+rx_cb_ni (const struct sBSP430halISRVoidChainNode * cb,
+          void * context)
+{
+  hBSP430halSERIAL device = (hBSP430halSERIAL)context;
+
+  rx_octet = device->rx_byte;
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+static sBSP430halISRVoidChainNode rx_cb = {
+  .callback = rx_cb_ni
+};
+
+void main ()
+{
+  hBSP430halSERIAL tty;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\nTimer UART %s at %u baud\n",
+          xBSP430serialName(BSP430_PERIPH_TIMERUART0), APP_BAUD);
+  tty = hBSP430serialOpenUART(hBSP430serialLookup(BSP430_PERIPH_TIMERUART0), 0, 0, APP_BAUD);
+  if (NULL == tty) {
+    cprintf("Open failed\n");
+    return;
+  }
+  (void)iBSP430uartTxASCIIZ_ni(tty, "Hello from the timer UART\r\n");
+
+  rx_cb.next_ni = tty->rx_cbchain_ni;
+  tty->rx_cbchain_ni = &rx_cb;
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    int c;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    c = rx_octet;
+    rx_octet = -1;
+    if (0 > c) {
+      BSP430_CORE_LPM_ENTER_NI(LPM0_bits | GIE);
+      continue;
+    }
+    (void)iBSP430uartTxByte_ni(tty, c);
+    BSP430_CORE_ENABLE_INTERRUPT();
+    cprintf("rx %02x\n", c);
+  }
+}
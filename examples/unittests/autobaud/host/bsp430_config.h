@@ -0,0 +1,3 @@
+/* Host builds of the autobaud module need only the UART interface
+ * through which a detected rate is applied. */
+#define configBSP430_SERIAL_ENABLE_UART 1
@@ -0,0 +1,18 @@
+/* Host builds need the timer definitions used by the capture loop,
+ * which the host test never runs. */
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+#include "hostintrinsics.h"
+#define __MSP430_HAS_T0A3__
+#define __MSP430_BASEADDRESS_T0A3__ 0x0340
+#define MC0 0x0010
+#define MC1 0x0020
+#define CCIS0 0x1000
+#define CCIS1 0x2000
+#define CM_2 0x8000
+#define CM_3 0xC000
+#define CAP 0x0100
+#define SCS 0x0800
+#define CCIFG 0x0001
+#define COV 0x0002
+#endif /* HOST_MSP430_H */
@@ -0,0 +1,108 @@
+/** This file is in the public domain.
+ *
+ * Validate the baud rate detection arithmetic with synthetic edge
+ * timestamps.  No timer is used: the edges of characters at known
+ * rates are generated from the exact bit time, with jitter, and
+ * passed to ulBSP430autobaudBitTicksQ16() as the capture interrupt
+ * would record them.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/autobaud.h>
+
+/* Edges of two back-to-back characters */
+#define MAX_EDGES (2 * BSP430_AUTOBAUD_MAX_EDGES)
+
+/* Per-bit timing error, in ticks, cycled through the edges */
+static const int jitter[] = { 0, 2, -1, -3, 1, 3, -2 };
+
+/* Append the edges of character c, with its start edge at bit index
+ * bit0, to edges.  Returns the updated edge count. */
+static unsigned int
+synthesize (unsigned int * edges,
+            unsigned int nedges,
+            uint8_t c,
+            unsigned int bit0,
+            unsigned int t0_tck,
+            unsigned long bit_tck_q16,
+            int jitter_tck)
+{
+  /* Start bit low, data LSB first, stop bit high */
+  unsigned int frame = 0x200 | ((unsigned int)c << 1);
+  int level = 1;
+  int k;
+
+  for (k = 0; k < 10; ++k) {
+    int bit = (frame >> k) & 1;
+
+    if (bit != level) {
+      unsigned long offset_q16 = (bit0 + k) * bit_tck_q16 + 0x8000;
+      int j = jitter_tck ? (jitter[nedges % (sizeof(jitter) / sizeof(*jitter))] * jitter_tck) / 3 : 0;
+
+      edges[nedges++] = t0_tck + (unsigned int)(offset_q16 >> 16) + j;
+      level = bit;
+    }
+  }
+  return nedges;
+}
+
+/* Measure the rate of character c followed immediately by a 0x00,
+ * which has a long low pulse that must not affect the result. */
+static unsigned long
+detect (uint8_t c,
+        unsigned long clock_Hz,
+        unsigned long baud,
+        unsigned int t0_tck,
+        int jitter_tck)
+{
+  unsigned int edges[MAX_EDGES];
+  unsigned long bit_tck_q16 = ((clock_Hz << 4) / baud) << 12;
+  unsigned int nedges;
+
+  nedges = synthesize(edges, 0, c, 0, t0_tck, bit_tck_q16, jitter_tck);
+  nedges = synthesize(edges, nedges, 0x00, 10, t0_tck, bit_tck_q16, jitter_tck);
+  return ulBSP430autobaudBaud(ulBSP430autobaudBitTicksQ16(edges, nedges), clock_Hz);
+}
+
+static void
+testDetection (void)
+{
+  unsigned int edges[2] = { 100, 204 };
+
+  /* Sync character, 104.17 ticks per bit */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(detect('U', 1000000UL, 9600, 0x1234, 0), 9600UL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(detect('U', 1000000UL, 9600, 0x1234, 3), 9600UL);
+
+  /* Carriage return, counter wraps during the character */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(detect('\r', 8000000UL, 38400, 0xFF80, 3), 38400UL);
+
+  /* Fast rate: 138.9 ticks per bit */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(detect('U', 16000000UL, 115200, 0x8000, 3), 115200UL);
+
+  /* Sparse edges at only 17.4 ticks per bit */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(detect('a', 1000000UL, 57600, 0, 1), 57600UL);
+
+  /* A rate that is not standard is reported as measured */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(detect('U', 16000000UL, 250000, 0, 0), 250000UL);
+
+  /* Too few edges to measure */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(ulBSP430autobaudBitTicksQ16(edges, 1), 0UL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(ulBSP430autobaudBaud(0, 1000000UL), 0UL);
+
+  /* A lone start bit */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(ulBSP430autobaudBitTicksQ16(edges, 2), 104UL << 16);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testDetection();
+
+  vBSP430unittestFinalize();
+}
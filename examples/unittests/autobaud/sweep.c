@@ -0,0 +1,154 @@
+/** This file is in the public domain.
+ *
+ * Host test of the baud rate detection arithmetic.  The synthetic
+ * edge cases of the on-target test are repeated, then every
+ * character that contains an isolated bit is measured at each
+ * standard rate against a range of timer clocks, with and without
+ * jitter, and with a start edge just before the counter wraps.  Build and run with <tt>make
+ * check-host</tt>; the exit status is nonzero on failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/utility/autobaud.h>
+#include "hostcheck.h"
+
+/* Edges of two back-to-back characters */
+#define MAX_EDGES (2 * BSP430_AUTOBAUD_MAX_EDGES)
+
+/* The fewest ticks per bit for which detection is required to
+ * succeed with jitter of one tick, as documented by the module */
+#define MIN_BIT_TCK 20
+
+/* Per-bit timing error, in ticks, cycled through the edges */
+static const int jitter[] = { 0, 2, -1, -3, 1, 3, -2 };
+
+static const unsigned long standard_baud[] = {
+  1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400,
+};
+
+static const unsigned long clock_Hz[] = {
+  32768, 1000000, 1048576, 4000000, 8000000, 12000000, 16000000, 20000000, 25000000,
+};
+
+/* Append the edges of character c, with its start edge at bit index
+ * bit0, to edges.  Returns the updated edge count. */
+static unsigned int
+synthesize (unsigned int * edges,
+            unsigned int nedges,
+            uint8_t c,
+            unsigned int bit0,
+            unsigned int t0_tck,
+            unsigned long bit_tck_q16,
+            int jitter_tck)
+{
+  /* Start bit low, data LSB first, stop bit high */
+  unsigned int frame = 0x200 | ((unsigned int)c << 1);
+  int level = 1;
+  int k;
+
+  for (k = 0; k < 10; ++k) {
+    int bit = (frame >> k) & 1;
+
+    if (bit != level) {
+      unsigned long offset_q16 = (bit0 + k) * bit_tck_q16 + 0x8000;
+      int j = jitter_tck ? (jitter[nedges % (sizeof(jitter) / sizeof(*jitter))] * jitter_tck) / 3 : 0;
+
+      edges[nedges++] = t0_tck + (unsigned int)(offset_q16 >> 16) + j;
+      level = bit;
+    }
+  }
+  return nedges;
+}
+
+/* Measure the rate of character c followed immediately by a 0x00,
+ * which has a long low pulse that must not affect the result. */
+static unsigned long
+detect (uint8_t c,
+        unsigned long clock_Hz,
+        unsigned long baud,
+        unsigned int t0_tck,
+        int jitter_tck)
+{
+  unsigned int edges[MAX_EDGES];
+  unsigned long bit_tck_q16 = ((clock_Hz << 4) / baud) << 12;
+  unsigned int nedges;
+
+  nedges = synthesize(edges, 0, c, 0, t0_tck, bit_tck_q16, jitter_tck);
+  nedges = synthesize(edges, nedges, 0x00, 10, t0_tck, bit_tck_q16, jitter_tck);
+  return ulBSP430autobaudBaud(ulBSP430autobaudBitTicksQ16(edges, nedges), clock_Hz);
+}
+
+/* The cases of the on-target test.  The wrap case starts 0x80 ticks
+ * before the counter wraps at the width of unsigned int. */
+static void
+testDetection (void)
+{
+  unsigned int edges[2] = { 100, 204 };
+
+  CHECK_EQUAL(detect('U', 1000000UL, 9600, 0x1234, 0), 9600UL);
+  CHECK_EQUAL(detect('U', 1000000UL, 9600, 0x1234, 3), 9600UL);
+  CHECK_EQUAL(detect('\r', 8000000UL, 38400, -0x80, 3), 38400UL);
+  CHECK_EQUAL(detect('U', 16000000UL, 115200, 0x8000, 3), 115200UL);
+  CHECK_EQUAL(detect('a', 1000000UL, 57600, 0, 1), 57600UL);
+  CHECK_EQUAL(detect('U', 16000000UL, 250000, 0, 0), 250000UL);
+  CHECK_EQUAL(ulBSP430autobaudBitTicksQ16(edges, 1), 0UL);
+  CHECK_EQUAL(ulBSP430autobaudBaud(0, 1000000UL), 0UL);
+  CHECK_EQUAL(ulBSP430autobaudBitTicksQ16(edges, 2), 104UL << 16);
+}
+
+/* Nonzero if a bit of the character, from the start bit through the
+ * last data bit, differs from both of its neighbours.  Only such
+ * characters may be used for detection. */
+static int
+hasIsolatedBit (unsigned int c)
+{
+  /* Idle high, start bit low, data LSB first, stop bit high */
+  unsigned int line = 0x401 | (c << 2);
+  int k;
+
+  for (k = 1; k <= 9; ++k) {
+    unsigned int bit = (line >> k) & 1;
+
+    if ((bit != ((line >> (k - 1)) & 1)) && (bit != ((line >> (k + 1)) & 1))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Every usable character at every standard rate whose bit time fits
+ * the 16-bit capture register and is long enough to resolve */
+static void
+testSweep (void)
+{
+  unsigned int ci;
+  unsigned int bi;
+
+  for (ci = 0; ci < sizeof(clock_Hz) / sizeof(*clock_Hz); ++ci) {
+    for (bi = 0; bi < sizeof(standard_baud) / sizeof(*standard_baud); ++bi) {
+      unsigned long bit_tck = clock_Hz[ci] / standard_baud[bi];
+      unsigned int c;
+
+      if ((MIN_BIT_TCK > bit_tck) || (65535 < 10 * bit_tck)) {
+        continue;
+      }
+      for (c = 0; c < 256; ++c) {
+        if (! hasIsolatedBit(c)) {
+          continue;
+        }
+        CHECK_EQUAL(detect(c, clock_Hz[ci], standard_baud[bi], c * 251, 0), standard_baud[bi]);
+        CHECK_EQUAL(detect(c, clock_Hz[ci], standard_baud[bi], -(c + 1), 1), standard_baud[bi]);
+      }
+    }
+  }
+}
+
+int main (int argc,
+          char * argv[])
+{
+  testDetection();
+  testSweep();
+  return hostCheckReport(NULL);
+}
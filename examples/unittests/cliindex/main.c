@@ -0,0 +1,212 @@
+/** This file is in the public domain.
+ *
+ * Validate that a sorted command index identifies the same commands
+ * as the linear search, and that registration rejects an index that
+ * does not describe its chain.  The index is written by hand here;
+ * applications normally generate it with maintainer/cliindex.py.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/cli.h>
+#include <string.h>
+
+static int last_handler;
+
+static int
+cmd_handler (sBSP430cliCommandLink * chain,
+             void * param,
+             const char * argstr,
+             size_t argstr_len)
+{
+  last_handler = (int)(uintptr_t)chain->cmd->param;
+  return 0;
+}
+
+/* Chain order differs from key order */
+#define LAST_COMMAND NULL
+static const sBSP430cliCommand dcmd_delta = {
+  .key = "delta", .handler = cmd_handler, .param = (void *)4,
+  .next = LAST_COMMAND
+};
+static const sBSP430cliCommand dcmd_bravo = {
+  .key = "bravo", .handler = cmd_handler, .param = (void *)2,
+  .next = &dcmd_delta
+};
+static const sBSP430cliCommand dcmd_echo = {
+  .key = "echo", .handler = cmd_handler, .param = (void *)5,
+  .next = &dcmd_bravo
+};
+static const sBSP430cliCommand dcmd_alpha = {
+  .key = "alpha", .handler = cmd_handler, .param = (void *)1,
+  .next = &dcmd_echo
+};
+static const sBSP430cliCommand dcmd_beta = {
+  .key = "beta", .handler = cmd_handler, .param = (void *)6,
+  .next = &dcmd_alpha
+};
+static const sBSP430cliCommand dcmd_charlie = {
+  .key = "charlie", .handler = cmd_handler, .param = (void *)3,
+  .next = &dcmd_beta
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND (&dcmd_charlie)
+
+static const sBSP430cliCommand * const sorted[] = {
+  &dcmd_alpha, &dcmd_beta, &dcmd_bravo, &dcmd_charlie, &dcmd_delta, &dcmd_echo,
+};
+static const sBSP430cliCommandIndex index_ok[] = {
+  { .command_set = LAST_COMMAND, .sorted = sorted, .count = 6 },
+};
+
+/* Out of order */
+static const sBSP430cliCommand * const unsorted[] = {
+  &dcmd_beta, &dcmd_alpha, &dcmd_bravo, &dcmd_charlie, &dcmd_delta, &dcmd_echo,
+};
+static const sBSP430cliCommandIndex index_unsorted[] = {
+  { .command_set = LAST_COMMAND, .sorted = unsorted, .count = 6 },
+};
+
+/* Missing a command in the chain */
+static const sBSP430cliCommandIndex index_short[] = {
+  { .command_set = LAST_COMMAND, .sorted = sorted + 1, .count = 5 },
+};
+
+/* Covering a different chain */
+static const sBSP430cliCommandIndex index_other[] = {
+  { .command_set = &dcmd_alpha, .sorted = sorted, .count = 6 },
+};
+
+typedef struct sMatchOrder {
+  sBSP430cliMatchCallback cb;
+  const sBSP430cliCommand * cmds[8];
+  int n;
+} sMatchOrder;
+
+static void
+record_match (sBSP430cliMatchCallback * self,
+              const sBSP430cliCommand * cmd)
+{
+  sMatchOrder * mop = (sMatchOrder *)self;
+
+  if (mop->n < (sizeof(mop->cmds) / sizeof(*mop->cmds))) {
+    mop->cmds[mop->n] = cmd;
+  }
+  ++mop->n;
+}
+
+typedef struct sMatchResult {
+  int nmatches;
+  const sBSP430cliCommand * match;
+  const char * argstr;
+  size_t argstr_len;
+  sMatchOrder order;
+} sMatchResult;
+
+static void
+match (const char * command,
+       sMatchResult * rp)
+{
+  memset(rp, 0, sizeof(*rp));
+  rp->order.cb.callback = record_match;
+  rp->nmatches = iBSP430cliMatchCommand(LAST_COMMAND, command, strlen(command),
+                                        &rp->match, &rp->order.cb,
+                                        &rp->argstr, &rp->argstr_len);
+}
+
+/* Match command with and without the index and require identical
+ * results */
+static void
+compare (const char * command)
+{
+  sMatchResult linear;
+  sMatchResult indexed;
+  const sBSP430cliCommand * nomatch;
+  int i;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(NULL, 0), 0);
+  match(command, &linear);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(index_ok, 1), 0);
+  match(command, &indexed);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(indexed.nmatches, linear.nmatches);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(indexed.match, linear.match);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(indexed.argstr, linear.argstr);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(indexed.argstr_len, linear.argstr_len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(indexed.order.n, linear.order.n);
+  for (i = 0; (i < linear.order.n) && (i < (sizeof(linear.order.cmds) / sizeof(*linear.order.cmds))); ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTp(indexed.order.cmds[i], linear.order.cmds[i]);
+  }
+
+  /* Without a callback the index alone determines the result */
+  nomatch = NULL;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliMatchCommand(LAST_COMMAND, command, strlen(command),
+                                                           &nomatch, NULL, NULL, NULL),
+                                    linear.nmatches);
+  if (0 <= linear.nmatches) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTp(nomatch, linear.match);
+  }
+}
+
+static void
+testMatch (void)
+{
+  static const char * const tokens[] = {
+    "", "  ", "a", "al", "alpha", "alphas", "b", "be", "bet", "br",
+    "c", "charlie x", " d 1 2", "e", "echo", "f", "z", "0", "~",
+    "b rest", "alphabet",
+  };
+  const sBSP430cliCommand * cmd;
+  int i;
+
+  for (i = 0; i < (sizeof(tokens) / sizeof(*tokens)); ++i) {
+    compare(tokens[i]);
+  }
+  /* Every prefix of every key */
+  for (cmd = LAST_COMMAND; cmd; cmd = cmd->next) {
+    char buf[16];
+    size_t len;
+
+    for (len = 1; len <= strlen(cmd->key); ++len) {
+      memcpy(buf, cmd->key, len);
+      buf[len] = 0;
+      compare(buf);
+    }
+  }
+}
+
+static void
+testRegistration (void)
+{
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(index_unsorted, 1), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(index_short, 1), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(index_other, 1), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(index_ok, 1), 0);
+
+  /* Dispatch through the index */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliExecuteCommand(LAST_COMMAND, NULL, "ch 1"), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_handler, 3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliExecuteCommand(LAST_COMMAND, NULL, "bet"), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_handler, 6);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliExecuteCommand(LAST_COMMAND, NULL, "echo"), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_handler, 5);
+
+  /* A null array clears the registration whatever its length */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(NULL, 3), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliExecuteCommand(LAST_COMMAND, NULL, "bet"), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_handler, 6);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430cliSetCommandIndex(NULL, 0), 0);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testRegistration();
+  testMatch();
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,130 @@
+/** This file is in the public domain.
+ *
+ * Validate console output fan-out to sinks and severity filtering.
+ * Two ring sinks capture the output: one accepting everything, one
+ * accepting only warnings and worse and overwriting when full.  The
+ * test's own diagnostics also reach any registered sink, so each
+ * check captures the sink contents before asserting.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+
+static uint8_t debug_storage[64];
+static sBSP430consoleRingSink debug_sink;
+static uint8_t warn_storage[16];
+static sBSP430consoleRingSink warn_sink;
+
+/* Move the contents of a sink into a string */
+static const char *
+take (sBSP430consoleRingSink * rsp,
+      char * dst,
+      size_t size)
+{
+  size_t len = xBSP430ring16Get(&rsp->ring, (uint8_t *)dst, size - 1);
+
+  dst[len] = 0;
+  return dst;
+}
+
+static void
+testFanOut (void)
+{
+  char debug_text[sizeof(debug_storage) + 1];
+  char warn_text[sizeof(warn_storage) + 1];
+  int rc1;
+  int rc2;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc1 = iBSP430consoleAddSink_ni(hBSP430consoleRingSinkInitialize(&debug_sink, debug_storage, sizeof(debug_storage), BSP430_CONSOLE_LEVEL_DEBUG, 0));
+  rc2 = iBSP430consoleAddSink_ni(hBSP430consoleRingSinkInitialize(&warn_sink, warn_storage, sizeof(warn_storage), BSP430_CONSOLE_LEVEL_WARNING, 1));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc1, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc2, 0);
+
+  /* Unqualified output has the default level */
+  cprintf("[plain %d]", 1);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)take(&debug_sink, debug_text, sizeof(debug_text));
+  (void)take(&warn_sink, warn_text, sizeof(warn_text));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(debug_text, "[plain 1]");
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(warn_text, "");
+
+  /* Severe output reaches both */
+  clprintf(BSP430_CONSOLE_LEVEL_ERR, "[err %d]", 2);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)take(&debug_sink, debug_text, sizeof(debug_text));
+  (void)take(&warn_sink, warn_text, sizeof(warn_text));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(debug_text, "[err 2]");
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(warn_text, "[err 2]");
+
+  /* The overwriting sink keeps the newest text */
+  clprintf(BSP430_CONSOLE_LEVEL_CRIT, "[%s]", "0123456789abcdefghij");
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)take(&debug_sink, debug_text, sizeof(debug_text));
+  (void)take(&warn_sink, warn_text, sizeof(warn_text));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(debug_text, "[0123456789abcdefghij]");
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(warn_text, "56789abcdefghij]");
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(warn_sink.dropped, 6);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(debug_sink.dropped, 0);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc1 = iBSP430consoleAddSink_ni(&debug_sink.sink);
+  rc2 = iBSP430consoleRemoveSink_ni(&warn_sink.sink);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc1, -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc2, 0);
+}
+
+static void
+testThreshold (void)
+{
+  char debug_text[sizeof(debug_storage) + 1];
+  int threshold;
+  int rc1;
+  int rc2;
+
+  /* Detail goes to the sink but not the UART */
+  BSP430_CORE_DISABLE_INTERRUPT();
+  threshold = iBSP430consoleSetThreshold_ni(BSP430_CONSOLE_LEVEL_NOTICE);
+  rc1 = clprintf(BSP430_CONSOLE_LEVEL_DEBUG, "[dbg]");
+  (void)take(&debug_sink, debug_text, sizeof(debug_text));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(threshold, BSP430_CONSOLE_LEVEL_DEBUG);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc1, 5);
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(debug_text, "[dbg]");
+
+  /* Output nobody accepts is not formatted */
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc2 = iBSP430consoleRemoveSink_ni(&debug_sink.sink);
+  rc1 = clprintf(BSP430_CONSOLE_LEVEL_DEBUG, "[dbg]");
+  threshold = iBSP430consoleSetThreshold_ni(BSP430_CONSOLE_LEVEL_DEBUG + 1);
+  (void)iBSP430consoleSetThreshold_ni(BSP430_CONSOLE_LEVEL_DEBUG);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc2, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc1, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(threshold, -1);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc1 = iBSP430consoleRemoveSink_ni(&debug_sink.sink);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc1, -1);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testFanOut();
+  testThreshold();
+
+  vBSP430unittestFinalize();
+}
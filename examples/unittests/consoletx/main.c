@@ -0,0 +1,74 @@
+/** This file is in the public domain.
+ *
+ * Validate the console transmit policies.  With interrupts disabled
+ * the transmit buffer does not drain, so writing more than it holds
+ * exercises the full-buffer path deterministically.  The output
+ * includes a run of filler followed by the drop marker.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+
+/* Octets the transmit buffer holds */
+#define CAPACITY BSP430_CONSOLE_TX_BUFFER_SIZE
+
+#define MARKER_LEN (sizeof(BSP430_CONSOLE_TX_DROP_MARKER) - 1)
+
+#define EXCESS 10
+
+/* Write CAPACITY + EXCESS octets to an empty buffer under the given
+ * policy, without letting it drain.  Returns the number dropped. */
+static unsigned int
+overfill (int policy)
+{
+  static const uint8_t probe[] = { '.' };
+  unsigned int dropped;
+  int prev_policy;
+  int rc;
+  int i;
+
+  (void)iBSP430consoleFlush();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)uiBSP430consoleTxDropped_ni(1);
+  prev_policy = iBSP430consoleSetTxPolicy_ni(policy);
+  for (i = 0; i < CAPACITY + EXCESS; ++i) {
+    (void)cputchar_ni('a' + (i % 26));
+  }
+  /* Raw blocks are never partially queued */
+  rc = iBSP430consoleTransmitBlock_ni(probe, sizeof(probe));
+  dropped = uiBSP430consoleTxDropped_ni(1);
+  (void)iBSP430consoleSetTxPolicy_ni(prev_policy);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  (void)iBSP430consoleFlush();
+  cputchar_ni('\n');
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rc, -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(prev_policy, BSP430_CONSOLE_TX_POLICY_BLOCK);
+  return dropped;
+}
+
+void main ()
+{
+  int policy;
+
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  policy = iBSP430consoleSetTxPolicy_ni(-1);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(policy, -1);
+
+  /* Each octet that does not fit is lost */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(overfill(BSP430_CONSOLE_TX_POLICY_DROP_NEWEST), EXCESS);
+
+  /* The first discard also loses the octets the marker overwrites;
+   * later ones move the marker forward one octet */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(overfill(BSP430_CONSOLE_TX_POLICY_DROP_OLDEST), EXCESS + MARKER_LEN);
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,14 @@
+/* Host builds of the DMA module use only the channel functions,
+ * applied to a simulated register block; the HAL instance and its
+ * interrupt handler are left out.  The receive ring test defines
+ * HOST_RX_RING when building the serial module and itself, which
+ * use the HAL instance that test supplies over the same block. */
+#if HOST_RX_RING - 0
+#define configBSP430_HAL_DMA 1
+#define configBSP430_HAL_DMA_ISR 0
+#define configBSP430_SERIAL_ENABLE_UART 1
+#define configBSP430_SERIAL_UART_RX_USE_DMA 1
+#define configBSP430_SERIAL_ERROR_COUNTERS 1
+#else /* HOST_RX_RING */
+#define configBSP430_HAL_DMA 0
+#endif /* HOST_RX_RING */
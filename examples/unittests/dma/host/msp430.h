@@ -0,0 +1,40 @@
+/* Host builds need the DMA register fields.  The controller has
+ * three channels unless HOST_DMAX_6 is defined; its registers are
+ * never at the nominal base address, since the test supplies a
+ * simulated register block.  The serial module also needs a timer
+ * for the declarations of the idle alarm used by the receive ring. */
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+#include "hostintrinsics.h"
+#if HOST_DMAX_6 - 0
+#define __MSP430_HAS_DMAX_6__
+#define __MSP430_BASEADDRESS_DMAX_6__ 0x0500
+#else /* HOST_DMAX_6 */
+#define __MSP430_HAS_DMAX_3__
+#define __MSP430_BASEADDRESS_DMAX_3__ 0x0500
+#endif /* HOST_DMAX_6 */
+#define DMAREQ 0x0001
+#define DMAABORT 0x0002
+#define DMAIE 0x0004
+#define DMAIFG 0x0008
+#define DMAEN 0x0010
+#define DMASRCBYTE 0x0040
+#define DMADSTBYTE 0x0080
+#define DMASRCINCR_3 0x0300
+#define DMADSTINCR_3 0x0C00
+#define DMADT_1 0x1000
+#define DMADT_4 0x4000
+#define __MSP430_HAS_T0A3__
+#define __MSP430_BASEADDRESS_T0A3__ 0x0340
+#define MC0 0x0010
+#define MC1 0x0020
+#define CCIFG 0x0001
+#define COV 0x0002
+#define CCIE 0x0010
+#define CAP 0x0100
+#define SCS 0x0800
+#define CCIS0 0x1000
+#define CCIS1 0x2000
+#define CM_2 0x8000
+#define CM_3 0xC000
+#endif /* HOST_MSP430_H */
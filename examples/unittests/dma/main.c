@@ -0,0 +1,152 @@
+/** This file is in the public domain.
+ *
+ * Validate the DMA HAL.  Channel bookkeeping and register encoding
+ * are checked against a simulated register block in RAM; transfers
+ * and completion callbacks are checked against the real controller.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/periph/dma.h>
+#include <string.h>
+
+static sBSP430hplDMA sim_hpl;
+static const sBSP430halISRIndexedChainNode * sim_callback[BSP430_DMA_CHANNEL_COUNT];
+static sBSP430halDMA sim_hal_ = {
+  .hpl = &sim_hpl,
+  .ch_cbchain_ni = sim_callback
+};
+static hBSP430halDMA const sim_hal = &sim_hal_;
+
+static void
+testSimulated (void)
+{
+  int i;
+  int ch;
+  const char src[] = "src";
+  char dst[4];
+
+  /* Automatic allocation proceeds from the lowest free channel */
+  for (i = 0; i < BSP430_DMA_CHANNEL_COUNT; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelAllocate_ni(sim_hal, -1), i);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelAllocate_ni(sim_hal, -1), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelRelease_ni(sim_hal, 1), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelRelease_ni(sim_hal, 1), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelAllocate_ni(sim_hal, 0), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelAllocate_ni(sim_hal, -1), 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelAllocate_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT), -1);
+  for (i = 0; i < BSP430_DMA_CHANNEL_COUNT; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelRelease_ni(sim_hal, i), 0);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hal->allocated_ni, 0);
+
+  /* Trigger selects pack two channels per register, even channel low */
+  memset(&sim_hpl, 0, sizeof(sim_hpl));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelSetTrigger_ni(sim_hal, 0, 0x1E), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelSetTrigger_ni(sim_hal, 1, 0x13), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelSetTrigger_ni(sim_hal, 2, 0xFF), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ctl[0], 0x131E);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ctl[1], 0x001F);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelSetTrigger_ni(sim_hal, 0, 0x05), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ctl[0], 0x1305);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelSetTrigger_ni(sim_hal, -1, 0), -1);
+
+  /* Configuration writes the channel registers but does not arm it */
+  ch = 1;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelConfigure_ni(sim_hal, ch, 7, DMADT_1 | DMASRCINCR_3 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAEN, src, dst, sizeof(dst)), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ctl[0], 0x0705);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ch[ch].ctl, DMADT_1 | DMASRCINCR_3 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(sim_hpl.ch[ch].sa, (unsigned long)(uintptr_t)src);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(sim_hpl.ch[ch].da, (unsigned long)(uintptr_t)dst);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(sim_hpl.ch[ch].sz, sizeof(dst));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelBusy_ni(sim_hal, ch), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelEnable_ni(sim_hal, ch), 0);
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430dmaChannelBusy_ni(sim_hal, ch));
+
+  /* Release clears the channel and its trigger */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelAllocate_ni(sim_hal, ch), ch);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelRelease_ni(sim_hal, ch), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ch[ch].ctl, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(sim_hpl.ctl[0], 0x0005);
+}
+
+typedef struct sCompletion {
+  sBSP430halISRIndexedChainNode cb_node;
+  volatile int count;
+  volatile int last_idx;
+} sCompletion;
+
+static int
+completion_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                   void * context,
+                   int idx)
+{
+  sCompletion * cp = (sCompletion *)cb;
+
+  ++cp->count;
+  cp->last_idx = idx;
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+static sCompletion completion = {
+  .cb_node = { .callback = completion_isr_ni },
+  .last_idx = -1
+};
+
+static void
+testHardware (void)
+{
+  hBSP430halDMA dma = hBSP430dmaLookup(BSP430_PERIPH_DMA);
+  static const char src[] = "DMA block transfer";
+  char dst[sizeof(src)];
+  int ch;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(dma, BSP430_HAL_DMA);
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(xBSP430dmaName(BSP430_PERIPH_DMA), "DMA");
+  ch = iBSP430dmaChannelAllocate_ni(dma, -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(ch, 0);
+
+  /* Software-triggered block transfer completes before the trigger
+   * instruction returns. */
+  memset(dst, 0, sizeof(dst));
+  (void)iBSP430dmaChannelConfigure_ni(dma, ch, BSP430_DMA_TSEL_DMAREQ,
+                                      DMADT_1 | DMASRCINCR_3 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE,
+                                      src, dst, sizeof(src));
+  (void)iBSP430dmaChannelEnable_ni(dma, ch);
+  vBSP430dmaChannelTrigger_ni(dma, ch);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelBusy_ni(dma, ch), 0);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(src, dst, sizeof(src)));
+
+  /* Completion invokes the channel callback chain */
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[ch], completion.cb_node, next_ni);
+  memset(dst, 0, sizeof(dst));
+  (void)iBSP430dmaChannelConfigure_ni(dma, ch, BSP430_DMA_TSEL_DMAREQ,
+                                      DMADT_1 | DMASRCINCR_3 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAIE,
+                                      src, dst, sizeof(src));
+  (void)iBSP430dmaChannelEnable_ni(dma, ch);
+  vBSP430dmaChannelTrigger_ni(dma, ch);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_CORE_DELAY_CYCLES(10);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(completion.count, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(completion.last_idx, ch);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(src, dst, sizeof(src)));
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[ch], completion.cb_node, next_ni);
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430dmaChannelRelease_ni(dma, ch), 0);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testSimulated();
+  testHardware();
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,311 @@
+/** This file is in the public domain.
+ *
+ * Host test of the UART DMA receive ring.  The serial module is built
+ * with DMA reception over a simulated controller that moves each
+ * octet delivered by a fake UART into the ring, reloads at the end of
+ * each half, and raises the completion interrupt either at once or
+ * on request.  Data continuity across halves and the buffer wrap, the
+ * completion events, the position reported while a completion is
+ * pending, and overrun detection when the reader falls behind are
+ * checked.  Build and run with <tt>make check-host</tt>; the exit
+ * status is nonzero on failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/serial.h>
+#include <bsp430/periph/dma.h>
+#include <string.h>
+#include "hostcheck.h"
+
+#define RING_SIZE 16
+#define HALF (RING_SIZE / 2)
+#define RX_TSEL 0x11
+
+/* The HAL instance the serial module uses, over a simulated register
+ * block */
+static sBSP430hplDMA sim_hpl;
+static const sBSP430halISRIndexedChainNode * sim_callback[BSP430_DMA_CHANNEL_COUNT];
+sBSP430halDMA xBSP430hal_DMA_ = {
+  .hpl = &sim_hpl,
+  .ch_cbchain_ni = sim_callback
+};
+
+/* The idle alarm is not used */
+int
+iBSP430timerAlarmSetEnabled_ni (hBSP430timerAlarm alarm,
+                                int enablep)
+{
+  return -1;
+}
+
+static volatile uint8_t uart_rxbuf;
+
+static int
+dmaTarget_ni (hBSP430halSERIAL hal,
+              const volatile void ** rxbufpp,
+              volatile void ** txbufpp)
+{
+  *rxbufpp = &uart_rxbuf;
+  return RX_TSEL;
+}
+
+static const struct sBSP430serialDispatch dispatch = {
+  .dmaTarget_ni = dmaTarget_ni,
+};
+
+static sBSP430halSERIAL uart = {
+  .dispatch = &dispatch,
+};
+
+/* Channel state held internally by the controller: the destination
+ * of the next transfer, and the block size restored on reload */
+static uint8_t * sim_da;
+static unsigned int sim_reload_sz;
+static int defer_isr;
+
+static uint8_t storage[RING_SIZE];
+static sBSP430uartRxRing ring_state;
+static hBSP430uartRxRing ring;
+static int last_events;
+static unsigned int ncallbacks;
+
+/* Sequence number of the next octet received and of the next octet
+ * the reader expects */
+static uint8_t rx_seq;
+static uint8_t read_seq;
+
+static int
+ring_cb_ni (hBSP430uartRxRing rp,
+            int events)
+{
+  CHECK_EQUAL(rp == ring, 1);
+  last_events = events;
+  ++ncallbacks;
+  return 0;
+}
+
+/* The interrupt handler for the controller */
+static void
+serviceDMA (void)
+{
+  int ch;
+
+  for (ch = 0; ch < BSP430_DMA_CHANNEL_COUNT; ++ch) {
+    volatile sBSP430hplDMAChannel * chp = sim_hpl.ch + ch;
+
+    if ((DMAIFG | DMAIE) == ((DMAIFG | DMAIE) & chp->ctl)) {
+      chp->ctl &= ~DMAIFG;
+      (void)iBSP430callbackInvokeISRIndexed_ni(ch + xBSP430hal_DMA_.ch_cbchain_ni, &xBSP430hal_DMA_, ch, 0);
+    }
+  }
+}
+
+/* Receive an octet through the ring's channel.  In repeated block
+ * mode the destination and size are reloaded when the block
+ * completes; the destination comes from DMAxDA, which the ring
+ * rewrites in each completion interrupt. */
+static void
+receive (void)
+{
+  volatile sBSP430hplDMAChannel * chp = sim_hpl.ch + ring_state.channel;
+
+  CHECK_EQUAL(chp->ctl & DMAEN, DMAEN);
+  uart_rxbuf = rx_seq++;
+  *sim_da++ = uart_rxbuf;
+  if (0 == --chp->sz) {
+    chp->sz = sim_reload_sz;
+    sim_da = (uint8_t *)(uintptr_t)chp->da;
+    chp->ctl |= DMAIFG;
+    if (! defer_isr) {
+      serviceDMA();
+    }
+  }
+}
+
+static void
+receiveN (unsigned int n)
+{
+  while (0 < n--) {
+    receive();
+  }
+}
+
+/* Read up to n octets and confirm they continue the sequence */
+static unsigned int
+readN (unsigned int n)
+{
+  uint8_t buf[RING_SIZE];
+  int rv = iBSP430uartRxRingRead_ni(ring, buf, n);
+  int i;
+
+  for (i = 0; i < rv; ++i) {
+    CHECK_EQUAL(buf[i], read_seq);
+    ++read_seq;
+  }
+  return rv;
+}
+
+static void
+testInitialize (void)
+{
+  volatile sBSP430hplDMAChannel * chp;
+
+  CHECK_EQUAL(NULL == hBSP430uartRxRingInitialize(&ring_state, &uart, storage, RING_SIZE - 1, ring_cb_ni, -1, 0), 1);
+  CHECK_EQUAL(NULL == hBSP430uartRxRingInitialize(&ring_state, &uart, storage, RING_SIZE, NULL, -1, 0), 1);
+  ring = hBSP430uartRxRingInitialize(&ring_state, &uart, storage, RING_SIZE, ring_cb_ni, -1, 0);
+  CHECK_EQUAL(NULL != ring, 1);
+  CHECK_EQUAL(xBSP430hal_DMA_.allocated_ni, 1 << ring_state.channel);
+  chp = sim_hpl.ch + ring_state.channel;
+  CHECK_EQUAL(chp->ctl, DMADT_4 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAIE | DMAEN);
+  CHECK_EQUAL((sim_hpl.ctl[ring_state.channel / 2] >> ((ring_state.channel & 1) ? 8 : 0)) & BSP430_DMA_TSEL_MASK, RX_TSEL);
+  CHECK_EQUAL(chp->sa, (unsigned long)(uintptr_t)&uart_rxbuf);
+  CHECK_EQUAL(chp->sz, HALF);
+
+  /* The first half was latched on enable; DMAxDA already names the
+   * second, for the first reload */
+  CHECK_EQUAL(chp->da, (unsigned long)(uintptr_t)(storage + HALF));
+  sim_da = storage;
+  sim_reload_sz = chp->sz;
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 0);
+}
+
+static void
+testStreaming (void)
+{
+  unsigned int lap;
+
+  /* Partial reads within the first half */
+  receiveN(5);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 5);
+  CHECK_EQUAL(readN(3), 3);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 2);
+  CHECK_EQUAL(ncallbacks, 0);
+
+  /* Completing each half notifies, alternately HALF and FULL */
+  receiveN(3);
+  CHECK_EQUAL(ncallbacks, 1);
+  CHECK_EQUAL(last_events, BSP430_UART_RX_RING_EVENT_HALF);
+  CHECK_EQUAL(uart.num_rx, HALF);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 5);
+  receiveN(HALF);
+  CHECK_EQUAL(ncallbacks, 2);
+  CHECK_EQUAL(last_events, BSP430_UART_RX_RING_EVENT_FULL);
+  CHECK_EQUAL(uart.num_rx, 2 * HALF);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 5 + HALF);
+
+  /* A read larger than the content returns what there is, across
+   * the wrap */
+  CHECK_EQUAL(readN(RING_SIZE), 5 + HALF);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 0);
+
+  /* A reader that keeps within a half of the channel never loses
+   * data, whatever the phase of its reads */
+  for (lap = 0; lap < 4 * RING_SIZE; ++lap) {
+    receiveN(1 + lap % HALF);
+    (void)readN(RING_SIZE);
+    CHECK_EQUAL(last_events & BSP430_UART_RX_RING_EVENT_OVERRUN, 0);
+  }
+  CHECK_EQUAL(rx_seq, read_seq);
+  CHECK_EQUAL(uart.errors.rx_dropped, 0);
+}
+
+static void
+testPending (void)
+{
+  unsigned int before;
+  unsigned int n;
+
+  /* Advance to three octets before a half completes */
+  n = HALF - ((rx_seq + 3) % HALF);
+  receiveN(n % HALF);
+  (void)readN(RING_SIZE);
+  before = ncallbacks;
+
+  /* The channel completes the half and reloads, but the interrupt has
+   * not been serviced: the reported content includes octets stored in
+   * the next half */
+  defer_isr = 1;
+  receiveN(5);
+  CHECK_EQUAL(ncallbacks, before);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 5);
+  CHECK_EQUAL(readN(4), 4);
+  defer_isr = 0;
+  serviceDMA();
+  CHECK_EQUAL(ncallbacks, before + 1);
+  CHECK_EQUAL(last_events & BSP430_UART_RX_RING_EVENT_OVERRUN, 0);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 1);
+  (void)readN(RING_SIZE);
+  CHECK_EQUAL(rx_seq, read_seq);
+}
+
+static void
+testOverrun (void)
+{
+  unsigned int before;
+  unsigned int n;
+
+  /* Align to a half boundary with the reader caught up */
+  n = HALF - (rx_seq % HALF);
+  receiveN(n % HALF);
+  (void)readN(RING_SIZE);
+  before = ncallbacks;
+
+  /* Falling behind by less than a ring loses nothing, even though
+   * the reader is in the half the channel has returned to */
+  receiveN(HALF);
+  CHECK_EQUAL(readN(3), 3);
+  receiveN(HALF);
+  CHECK_EQUAL(last_events & BSP430_UART_RX_RING_EVENT_OVERRUN, 0);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), 2 * HALF - 3);
+
+  /* Once the channel fills that half too the five unread octets in it
+   * have been overwritten.  Those and the older half are discarded,
+   * and reading resumes at the start of the half just filled. */
+  receiveN(HALF);
+  CHECK_EQUAL(ncallbacks, before + 3);
+  CHECK_EQUAL(last_events & BSP430_UART_RX_RING_EVENT_OVERRUN, BSP430_UART_RX_RING_EVENT_OVERRUN);
+  CHECK_EQUAL(0 != (last_events & (BSP430_UART_RX_RING_EVENT_HALF | BSP430_UART_RX_RING_EVENT_FULL)), 1);
+  CHECK_EQUAL(uart.errors.rx_dropped, 2 * HALF - 3);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), HALF);
+  read_seq += 2 * HALF - 3;
+  CHECK_EQUAL(readN(RING_SIZE), HALF);
+
+  /* A reader that stopped entirely loses everything but the last
+   * completed half, however many laps the channel has made */
+  receiveN(3 * RING_SIZE + 2);
+  CHECK_EQUAL(last_events & BSP430_UART_RX_RING_EVENT_OVERRUN, BSP430_UART_RX_RING_EVENT_OVERRUN);
+  CHECK_EQUAL(iBSP430uartRxRingAvailable_ni(ring), HALF + 2);
+  CHECK_EQUAL(uart.errors.rx_dropped, 2 * HALF - 3 + 3 * RING_SIZE - HALF);
+  read_seq = rx_seq - (HALF + 2);
+  CHECK_EQUAL(readN(RING_SIZE), HALF + 2);
+
+  /* Normal operation resumes */
+  receiveN(HALF);
+  CHECK_EQUAL(last_events & BSP430_UART_RX_RING_EVENT_OVERRUN, 0);
+  CHECK_EQUAL(readN(RING_SIZE), HALF);
+  CHECK_EQUAL(rx_seq, read_seq);
+}
+
+static void
+testRelease (void)
+{
+  int ch = ring_state.channel;
+
+  CHECK_EQUAL(iBSP430uartRxRingRelease(ring), 0);
+  CHECK_EQUAL(sim_hpl.ch[ch].ctl, 0);
+  CHECK_EQUAL(xBSP430hal_DMA_.allocated_ni, 0);
+  CHECK_EQUAL(NULL == sim_callback[ch], 1);
+}
+
+int main (int argc,
+          char * argv[])
+{
+  testInitialize();
+  testStreaming();
+  testPending();
+  testOverrun();
+  testRelease();
+  return hostCheckReport(NULL);
+}
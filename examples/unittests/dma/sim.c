@@ -0,0 +1,152 @@
+/** This file is in the public domain.
+ *
+ * Host test of the DMA channel functions against a simulated
+ * register block.  Channel allocation and release, the packing of
+ * trigger selects two to a register, and the channel register
+ * settings written by configuration are checked, for the three- and
+ * six-channel controllers as selected by HOST_DMAX_6.  Build and run
+ * with <tt>make check-host</tt>; the exit status is nonzero on
+ * failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/periph/dma.h>
+#include <string.h>
+#include "hostcheck.h"
+
+static sBSP430hplDMA sim_hpl;
+static const sBSP430halISRIndexedChainNode * sim_callback[BSP430_DMA_CHANNEL_COUNT];
+static sBSP430halDMA sim_hal_ = {
+  .hpl = &sim_hpl,
+  .ch_cbchain_ni = sim_callback
+};
+static hBSP430halDMA const sim_hal = &sim_hal_;
+
+static void
+testAllocation (void)
+{
+  int i;
+
+  /* Automatic allocation proceeds from the lowest free channel */
+  for (i = 0; i < BSP430_DMA_CHANNEL_COUNT; ++i) {
+    CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, -1), i);
+  }
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, -1), -1);
+  CHECK_EQUAL(sim_hal->allocated_ni, (1 << BSP430_DMA_CHANNEL_COUNT) - 1);
+
+  /* A released channel is the next allocated, and cannot be
+   * released twice */
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, 1), 0);
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, 1), -1);
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, 0), -1);
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, -1), 1);
+
+  /* Out-of-range channels are rejected */
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT), -1);
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT), -1);
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, -1), -1);
+  for (i = 0; i < BSP430_DMA_CHANNEL_COUNT; ++i) {
+    CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, i), 0);
+  }
+  CHECK_EQUAL(sim_hal->allocated_ni, 0);
+
+  /* A specific channel may be requested out of order */
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT - 1), BSP430_DMA_CHANNEL_COUNT - 1);
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, -1), 0);
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, 0), 0);
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT - 1), 0);
+  CHECK_EQUAL(sim_hal->allocated_ni, 0);
+}
+
+static void
+testTriggers (void)
+{
+  int ch;
+
+  /* Trigger selects pack two channels per register, even channel
+   * low; values are masked to the field */
+  memset(&sim_hpl, 0, sizeof(sim_hpl));
+  CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, 0, 0x1E), 0);
+  CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, 1, 0x13), 0);
+  CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, 2, 0xFF), 0);
+  CHECK_EQUAL(sim_hpl.ctl[0], 0x131E);
+  CHECK_EQUAL(sim_hpl.ctl[1], 0x001F);
+  CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, 0, 0x05), 0);
+  CHECK_EQUAL(sim_hpl.ctl[0], 0x1305);
+  CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, -1, 0), -1);
+  CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT, 0), -1);
+
+  /* Every channel updates only its own field, and never touches
+   * DMACTL4 */
+  memset(&sim_hpl, 0, sizeof(sim_hpl));
+  sim_hpl.ctl4 = 0x0005;
+  for (ch = 0; ch < BSP430_DMA_CHANNEL_COUNT; ++ch) {
+    CHECK_EQUAL(iBSP430dmaChannelSetTrigger_ni(sim_hal, ch, ch + 1), 0);
+  }
+  for (ch = 0; ch < BSP430_DMA_CHANNEL_COUNT; ++ch) {
+    CHECK_EQUAL((sim_hpl.ctl[ch / 2] >> ((ch & 1) ? 8 : 0)) & BSP430_DMA_TSEL_MASK, ch + 1);
+  }
+  CHECK_EQUAL(sim_hpl.ctl[(BSP430_DMA_CHANNEL_COUNT + 1) / 2], 0);
+  CHECK_EQUAL(sim_hpl.ctl4, 0x0005);
+}
+
+static void
+testConfiguration (void)
+{
+  const char src[] = "src";
+  char dst[4];
+  int ch;
+
+  memset(&sim_hpl, 0, sizeof(sim_hpl));
+  for (ch = 0; ch < BSP430_DMA_CHANNEL_COUNT; ++ch) {
+    /* Configuration writes the channel registers but does not arm
+     * the channel, even if asked to */
+    sim_hpl.ch[ch].ctl = DMAEN | DMAIFG;
+    CHECK_EQUAL(iBSP430dmaChannelConfigure_ni(sim_hal, ch, 7 + ch,
+                                              DMADT_1 | DMASRCINCR_3 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAEN | DMAREQ | DMAIFG | DMAABORT | DMAIE,
+                                              src, dst, sizeof(dst)), 0);
+    CHECK_EQUAL(sim_hpl.ch[ch].ctl, DMADT_1 | DMASRCINCR_3 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAIE);
+    CHECK_EQUAL((sim_hpl.ctl[ch / 2] >> ((ch & 1) ? 8 : 0)) & BSP430_DMA_TSEL_MASK, 7 + ch);
+    CHECK_EQUAL(sim_hpl.ch[ch].sa, (unsigned long)(uintptr_t)src);
+    CHECK_EQUAL(sim_hpl.ch[ch].da, (unsigned long)(uintptr_t)dst);
+    CHECK_EQUAL(sim_hpl.ch[ch].sz, sizeof(dst));
+    CHECK_EQUAL(iBSP430dmaChannelBusy_ni(sim_hal, ch), 0);
+
+    /* Enable, trigger, and reload act on the channel alone */
+    CHECK_EQUAL(iBSP430dmaChannelEnable_ni(sim_hal, ch), 0);
+    CHECK_EQUAL(iBSP430dmaChannelBusy_ni(sim_hal, ch), 1);
+    vBSP430dmaChannelTrigger_ni(sim_hal, ch);
+    CHECK_EQUAL(sim_hpl.ch[ch].ctl & (DMAEN | DMAREQ), DMAEN | DMAREQ);
+    vBSP430dmaChannelSetReloadDestination_ni(sim_hal, ch, dst + 1);
+    CHECK_EQUAL(sim_hpl.ch[ch].da, (unsigned long)(uintptr_t)(dst + 1));
+
+    /* Disable reports the transfers remaining */
+    sim_hpl.ch[ch].sz = 2;
+    CHECK_EQUAL(iBSP430dmaChannelDisable_ni(sim_hal, ch), 2);
+    CHECK_EQUAL(iBSP430dmaChannelBusy_ni(sim_hal, ch), 0);
+  }
+  CHECK_EQUAL(iBSP430dmaChannelConfigure_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT, 0, 0, src, dst, 1), -1);
+  CHECK_EQUAL(iBSP430dmaChannelEnable_ni(sim_hal, -1), -1);
+  CHECK_EQUAL(iBSP430dmaChannelDisable_ni(sim_hal, BSP430_DMA_CHANNEL_COUNT), -1);
+
+  /* Release clears the channel and its trigger */
+  ch = BSP430_DMA_CHANNEL_COUNT - 1;
+  CHECK_EQUAL(iBSP430dmaChannelAllocate_ni(sim_hal, ch), ch);
+  CHECK_EQUAL(iBSP430dmaChannelEnable_ni(sim_hal, ch), 0);
+  CHECK_EQUAL(iBSP430dmaChannelRelease_ni(sim_hal, ch), 0);
+  CHECK_EQUAL(sim_hpl.ch[ch].ctl, 0);
+  CHECK_EQUAL((sim_hpl.ctl[ch / 2] >> ((ch & 1) ? 8 : 0)) & BSP430_DMA_TSEL_MASK, BSP430_DMA_TSEL_DMAREQ);
+  CHECK_EQUAL((sim_hpl.ctl[ch / 2] >> ((ch & 1) ? 0 : 8)) & BSP430_DMA_TSEL_MASK, (ch & 1) ? 7 + ch - 1 : 0);
+}
+
+int main (int argc,
+          char * argv[])
+{
+  testAllocation();
+  testTriggers();
+  testConfiguration();
+  printf("%d channels: ", BSP430_DMA_CHANNEL_COUNT);
+  return hostCheckReport(NULL);
+}
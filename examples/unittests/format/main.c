@@ -0,0 +1,85 @@
+/** This file is in the public domain.
+ *
+ * Validate utility/format on the target, where int is 16 bits and
+ * the divide-by-ten path depends on the multiplier.  The host
+ * comparison (<tt>make check-host</tt>) covers the value range
+ * exhaustively; these cases confirm the target build agrees.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/format.h>
+#include <string.h>
+
+static char buf[BSP430_FORMAT_BUFFER_SIZE];
+
+#define ASSERT_FORMAT(expr_, text_) do {                                \
+    unsigned int len_ = (expr_);                                        \
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTu(len_, (unsigned int)strlen(text_)); \
+    BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(buf, text_);                    \
+  } while (0)
+
+static void
+testInteger (void)
+{
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 0, 0), "0");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 9, 0), "9");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 65535U, 0), "65535");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 65536UL, 0), "65536");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 4294967295UL, 0), "4294967295");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 1000000000UL, 0), "1000000000");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 42, 5), "   42");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 42, 5 | BSP430_FORMAT_FLAG_ZERO_PAD), "00042");
+  ASSERT_FORMAT(uiBSP430formatUnsigned(buf, 123456UL, 3), "123456");
+
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, -1, 0), "-1");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, -32768L, 0), "-32768");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, -2147483647L - 1, 0), "-2147483648");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, 2147483647L, 0), "2147483647");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, -42, 6), "   -42");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, -42, 6 | BSP430_FORMAT_FLAG_ZERO_PAD), "-00042");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, 42, BSP430_FORMAT_FLAG_PLUS), "+42");
+  ASSERT_FORMAT(uiBSP430formatSigned(buf, 0, BSP430_FORMAT_WIDTH_MASK), "                              0");
+
+  ASSERT_FORMAT(uiBSP430formatHex(buf, 0, 0), "0");
+  ASSERT_FORMAT(uiBSP430formatHex(buf, 0xBEEF, 0), "beef");
+  ASSERT_FORMAT(uiBSP430formatHex(buf, 0xBEEF, BSP430_FORMAT_FLAG_UPPER), "BEEF");
+  ASSERT_FORMAT(uiBSP430formatHex(buf, 0x3A, 4 | BSP430_FORMAT_FLAG_ZERO_PAD), "003a");
+  ASSERT_FORMAT(uiBSP430formatHex(buf, 0xFFFFFFFFUL, 0), "ffffffff");
+}
+
+static void
+testFixed (void)
+{
+  ASSERT_FORMAT(uiBSP430formatScaled(buf, 2345, 2, 0), "23.45");
+  ASSERT_FORMAT(uiBSP430formatScaled(buf, -5, 2, 0), "-0.05");
+  ASSERT_FORMAT(uiBSP430formatScaled(buf, 5, 0, 0), "5");
+  ASSERT_FORMAT(uiBSP430formatScaled(buf, -123, 1, 7 | BSP430_FORMAT_FLAG_ZERO_PAD), "-0012.3");
+  ASSERT_FORMAT(uiBSP430formatScaled(buf, 1, 9, 0), "0.000000001");
+  ASSERT_FORMAT(uiBSP430formatScaled(buf, 1, 10, 0), "");
+
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 0x1780, 8, 2, 0), "23.50");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, -0x0180, 8, 1, 0), "-1.5");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 0x8000, 16, 4, 0), "0.5000");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 0xFFFF, 16, 4, 0), "1.0000");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 0xFFFF, 16, 0, 0), "1");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 0x5555, 16, 3, 0), "0.333");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, -1, 16, 2, 0), "-0.00");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 7, 0, 1, 6), "   7.0");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 1, 17, 1, 0), "");
+  ASSERT_FORMAT(uiBSP430formatQ(buf, 1, 8, 5, 0), "");
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testInteger();
+  testFixed();
+
+  vBSP430unittestFinalize();
+}
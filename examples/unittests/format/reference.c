@@ -0,0 +1,168 @@
+/** This file is in the public domain.
+ *
+ * Host comparison of utility/format against the host C library.
+ * Every 16-bit value, and a spread of 32-bit values including the
+ * boundaries, is formatted by each function in several specs and
+ * compared with the equivalent snprintf() output.  Build and run
+ * with <tt>make check-host</tt>; the exit status is nonzero on
+ * failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/utility/format.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned long checks;
+static unsigned long errors;
+
+static void
+check (const char * what,
+       long value,
+       const char * got,
+       unsigned int got_len,
+       const char * expected)
+{
+  ++checks;
+  if ((0 != strcmp(got, expected)) || (strlen(expected) != got_len)) {
+    if (10 > errors++) {
+      fprintf(stderr, "%s(%ld): got '%s' (%u) expected '%s'\n",
+              what, value, got, got_len, expected);
+    }
+  }
+}
+
+/* The printf equivalent of a scaled integer */
+static void
+scaled_reference (char * buf,
+                  long value,
+                  unsigned int decimals,
+                  const char * flags,
+                  unsigned int width)
+{
+  unsigned long mag = (0 > value) ? 0UL - (unsigned long)value : (unsigned long)value;
+  unsigned long div = 1;
+  char text[32];
+  unsigned int i;
+
+  for (i = 0; i < decimals; ++i) {
+    div *= 10;
+  }
+  if (decimals) {
+    sprintf(text, "%s%lu.%0*lu", (0 > value) ? "-" : (strchr(flags, '+') ? "+" : ""),
+            mag / div, (int)decimals, mag % div);
+  } else {
+    sprintf(text, "%s%lu", (0 > value) ? "-" : (strchr(flags, '+') ? "+" : ""), mag);
+  }
+  if (strchr(flags, '0') && (strlen(text) < width)) {
+    unsigned int sign = ('-' == text[0]) || ('+' == text[0]);
+    unsigned int pad = width - strlen(text);
+
+    memcpy(buf, text, sign);
+    memset(buf + sign, '0', pad);
+    strcpy(buf + sign + pad, text + sign);
+  } else {
+    sprintf(buf, "%*s", (int)width, text);
+  }
+}
+
+static void
+check_value (long value)
+{
+  static const unsigned int widths[] = { 0, 1, 7, 12, BSP430_FORMAT_WIDTH_MASK };
+  char got[BSP430_FORMAT_BUFFER_SIZE];
+  char expected[64];
+  unsigned long u = (unsigned long)value & 0xFFFFFFFFUL;
+  long s = (long)(int32_t)value;
+  unsigned int wi;
+  unsigned int n;
+
+  for (wi = 0; wi < sizeof(widths) / sizeof(*widths); ++wi) {
+    unsigned int w = widths[wi];
+
+    sprintf(expected, "%*lu", w, u);
+    check("Unsigned", value, got, uiBSP430formatUnsigned(got, u, w), expected);
+    sprintf(expected, "%0*lu", w, u);
+    check("Unsigned0", value, got, uiBSP430formatUnsigned(got, u, w | BSP430_FORMAT_FLAG_ZERO_PAD), expected);
+    sprintf(expected, "%*ld", w, s);
+    check("Signed", value, got, uiBSP430formatSigned(got, s, w), expected);
+    sprintf(expected, "%+0*ld", w, s);
+    check("Signed+0", value, got, uiBSP430formatSigned(got, s, w | BSP430_FORMAT_FLAG_ZERO_PAD | BSP430_FORMAT_FLAG_PLUS), expected);
+    sprintf(expected, "%*lx", w, u);
+    check("Hex", value, got, uiBSP430formatHex(got, u, w), expected);
+    sprintf(expected, "%0*lX", w, u);
+    check("HEX0", value, got, uiBSP430formatHex(got, u, w | BSP430_FORMAT_FLAG_ZERO_PAD | BSP430_FORMAT_FLAG_UPPER), expected);
+  }
+  for (n = 0; n <= BSP430_FORMAT_SCALED_MAX_DECIMALS; n += 1 + (n % 3)) {
+    scaled_reference(expected, s, n, "", 0);
+    check("Scaled", value, got, uiBSP430formatScaled(got, s, n, 0), expected);
+    scaled_reference(expected, s, n, "+0", 14);
+    check("Scaled+0", value, got, uiBSP430formatScaled(got, s, n, 14 | BSP430_FORMAT_FLAG_ZERO_PAD | BSP430_FORMAT_FLAG_PLUS), expected);
+  }
+  for (n = 0; n <= BSP430_FORMAT_Q_MAX_FRAC_BITS; n += 4) {
+    unsigned int d;
+
+    for (d = 0; d <= BSP430_FORMAT_Q_MAX_DECIMALS; ++d) {
+      /* Rounding is exact: the host double holds the value exactly,
+       * and ties are broken away from zero in the module but to even
+       * by printf, so ties are excluded. */
+      double x = (double)s / (double)(1UL << n);
+      double ulp = 1.0;
+      unsigned int k;
+
+      for (k = 0; k < d; ++k) {
+        ulp /= 10;
+      }
+      {
+        double f = (x < 0 ? -x : x) / ulp;
+        if ((f - (long)f) == 0.5) {
+          continue;
+        }
+      }
+      sprintf(expected, "%.*f", (int)d, x);
+      check("Q", value, got, uiBSP430formatQ(got, s, n, d, 0), expected);
+    }
+  }
+}
+
+int
+main (void)
+{
+  static const long edges[] = {
+    65535L, 65536L, 65537L, 99999L, 100000L, 999999L, 1000000L,
+    9999999L, 10000000L, 99999999L, 100000000L, 999999999L,
+    1000000000L, 2147483647L, -2147483647L - 1, -1L, -65536L,
+    0x7FFFFFFFL, 0x12345678L, -305419896L,
+  };
+  char got[BSP430_FORMAT_BUFFER_SIZE];
+  unsigned long state = 1;
+  long v;
+  unsigned int i;
+
+  for (v = -65536L; v <= 65535L; ++v) {
+    check_value(v);
+  }
+  for (i = 0; i < sizeof(edges) / sizeof(*edges); ++i) {
+    check_value(edges[i]);
+  }
+  for (i = 0; i < 200000; ++i) {
+    state = state * 1103515245UL + 12345UL;
+    v = (long)(int32_t)((state >> 8) ^ (state << 20));
+    check_value(v);
+  }
+  for (i = 0; i < 32; ++i) {
+    check_value((long)(int32_t)(1UL << i));
+    check_value((long)(int32_t)((1UL << i) - 1));
+  }
+
+  /* Arguments out of range */
+  check("Scaled", 1, got, uiBSP430formatScaled(got, 1, BSP430_FORMAT_SCALED_MAX_DECIMALS + 1, 0), "");
+  check("Q", 1, got, uiBSP430formatQ(got, 1, BSP430_FORMAT_Q_MAX_FRAC_BITS + 1, 0, 0), "");
+  check("Q", 1, got, uiBSP430formatQ(got, 1, 8, BSP430_FORMAT_Q_MAX_DECIMALS + 1, 0), "");
+
+  printf("%lu checks, %lu errors\n", checks, errors);
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/** This file is in the public domain.
+ *
+ * Host round-trip fuzz test of utility/framing.  Pseudo-random
+ * payloads of random length and composition are encoded in both COBS
+ * and SLIP, through iBSP430framingEncode() and through
+ * iBSP430framingTxFrame_ni() over a simulated UART, and fed to the
+ * decoder in streams of back-to-back frames.  The host has no CRC
+ * module, so the software CRC is also compared with an independent
+ * table-driven implementation.  Build and run with <tt>make
+ * check-host</tt>; the exit status is nonzero on failure.
+ *
+ * An optional argument sets the number of frames per mode, and a
+ * second the seed.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/utility/framing.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hostcheck.h"
+
+#define MAX_PAYLOAD 1100
+#define STREAM_FRAMES 4
+
+static unsigned long prng_state;
+
+static uint8_t payload[STREAM_FRAMES][MAX_PAYLOAD];
+static size_t payload_len[STREAM_FRAMES];
+static uint8_t encoded[BSP430_FRAMING_ENCODED_MAX(MAX_PAYLOAD)];
+static uint8_t stream[STREAM_FRAMES * BSP430_FRAMING_ENCODED_MAX(MAX_PAYLOAD)];
+static size_t stream_len;
+static uint8_t rx_buffer[MAX_PAYLOAD + BSP430_FRAMING_CRC_LENGTH];
+
+static unsigned int
+prng (void)
+{
+  prng_state = 1103515245UL * prng_state + 12345;
+  return (unsigned int)((prng_state >> 16) & 0x7FFF);
+}
+
+/* The simulated UART appends transmitted octets to the stream */
+static int
+uartTxByte_ni (hBSP430halSERIAL hal,
+               uint8_t c)
+{
+  stream[stream_len++] = c;
+  return c;
+}
+
+static const struct sBSP430serialDispatch dispatch = {
+  .uartTxByte_ni = uartTxByte_ni,
+};
+
+static sBSP430halSERIAL uart = {
+  .dispatch = &dispatch,
+};
+
+/* CRC-16/CCITT computed a byte at a time from a table */
+static unsigned int
+referenceCRC16 (unsigned int crc,
+                const uint8_t * data,
+                size_t len)
+{
+  static unsigned int table[256];
+  unsigned int i;
+
+  if (0 == table[1]) {
+    for (i = 0; i < 256; ++i) {
+      unsigned int v = i << 8;
+      int b;
+
+      for (b = 0; b < 8; ++b) {
+        v = 0xFFFF & ((v << 1) ^ ((v & 0x8000) ? 0x1021 : 0));
+      }
+      table[i] = v;
+    }
+  }
+  while (0 < len--) {
+    crc = 0xFFFF & ((crc << 8) ^ table[(crc >> 8) ^ *data++]);
+  }
+  return crc;
+}
+
+/* Fill a payload of random length.  The octets special to either
+ * encoding appear with a density that varies from none to all. */
+static void
+fillPayload (unsigned int i)
+{
+  static const uint8_t special[] = { 0x00, 0xC0, 0xDB, 0xDC, 0xDD };
+  unsigned int density = prng() % 9;
+  size_t len;
+  size_t j;
+
+  switch (prng() % 4) {
+    case 0:
+      len = prng() % 8;
+      break;
+    case 1:
+      /* Around the COBS block boundary */
+      len = 250 + prng() % 10;
+      break;
+    default:
+      len = prng() % (MAX_PAYLOAD + 1);
+      break;
+  }
+  payload_len[i] = len;
+  for (j = 0; j < len; ++j) {
+    if ((prng() % 8) < density) {
+      payload[i][j] = special[prng() % sizeof(special)];
+    } else {
+      payload[i][j] = prng();
+    }
+  }
+}
+
+static void
+fuzz (int mode,
+      unsigned long nframes)
+{
+  sBSP430framingDecoder decoder_state;
+  hBSP430framingDecoder decoder;
+  unsigned long n;
+
+  decoder = hBSP430framingDecoderInitialize(&decoder_state, mode, NULL);
+  CHECK(NULL != decoder);
+  for (n = 0; n < nframes; n += STREAM_FRAMES) {
+    unsigned int i;
+    unsigned int delivered;
+    size_t sp;
+
+    /* Transmit a stream of frames, checking that each matches the
+     * buffered encoding. */
+    stream_len = 0;
+    for (i = 0; i < STREAM_FRAMES; ++i) {
+      size_t start = stream_len;
+      int elen;
+
+      fillPayload(i);
+      elen = iBSP430framingEncode(mode, payload[i], payload_len[i], encoded, sizeof(encoded));
+      CHECK(0 < elen);
+      CHECK(elen <= BSP430_FRAMING_ENCODED_MAX(payload_len[i]));
+      CHECK((int)payload_len[i] == iBSP430framingTxFrame_ni(&uart, mode, payload[i], payload_len[i]));
+      CHECK((stream_len - start) == (size_t)elen);
+      CHECK(0 == memcmp(stream + start, encoded, elen));
+      if (BSP430_FRAMING_MODE_COBS == mode) {
+        CHECK(NULL == memchr(encoded, 0, elen - 1));
+      } else {
+        CHECK(NULL == memchr(encoded + 1, 0xC0, elen - 2));
+      }
+    }
+
+    /* Decode the stream, taking each frame as it completes */
+    delivered = 0;
+    vBSP430framingDecoderSetBuffer_ni(decoder, rx_buffer, sizeof(rx_buffer));
+    for (sp = 0; sp < stream_len; ++sp) {
+      int rv = iBSP430framingDecoderRxOctet_ni(decoder, stream[sp]);
+
+      if (0 <= rv) {
+        CHECK(delivered < STREAM_FRAMES);
+        if (delivered < STREAM_FRAMES) {
+          CHECK(rv == (int)payload_len[delivered]);
+          CHECK(decoder->frame == rx_buffer);
+          CHECK(decoder->frame_len == payload_len[delivered]);
+          CHECK(0 == memcmp(rx_buffer, payload[delivered], payload_len[delivered]));
+        }
+        ++delivered;
+        vBSP430framingDecoderSetBuffer_ni(decoder, rx_buffer, sizeof(rx_buffer));
+      }
+    }
+    CHECK(STREAM_FRAMES == delivered);
+
+    /* The software CRC matches the reference over random spans */
+    for (i = 0; i < STREAM_FRAMES; ++i) {
+      unsigned int crc0 = prng() & 0xFFFF;
+
+      CHECK(referenceCRC16(crc0, payload[i], payload_len[i])
+            == uiBSP430framingCRC16(crc0, payload[i], payload_len[i]));
+    }
+  }
+  CHECK(0 == decoder->errors);
+  CHECK(0 == decoder->overruns);
+}
+
+int main (int argc,
+          char * argv[])
+{
+  unsigned long nframes = 20000;
+
+  prng_state = 1;
+  if (1 < argc) {
+    nframes = strtoul(argv[1], NULL, 0);
+  }
+  if (2 < argc) {
+    prng_state = strtoul(argv[2], NULL, 0);
+  }
+  /* CRC-16/CCITT-FALSE check value */
+  CHECK(0x29B1 == uiBSP430framingCRC16(BSP430_FRAMING_CRC16_INIT, (const uint8_t *)"123456789", 9));
+  fuzz(BSP430_FRAMING_MODE_COBS, nframes);
+  fuzz(BSP430_FRAMING_MODE_SLIP, nframes);
+  return hostCheckReport(NULL);
+}
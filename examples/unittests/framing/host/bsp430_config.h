@@ -0,0 +1,3 @@
+/* Host builds of the framing module need only the UART interface,
+ * which the host test implements with its own dispatch table. */
+#define configBSP430_SERIAL_ENABLE_UART 1
@@ -0,0 +1,238 @@
+/** This file is in the public domain.
+ *
+ * Validate COBS and SLIP framing by round-tripping pseudo-random
+ * payloads through the encoder and the incremental decoder.  The
+ * payloads vary in length and in the density of octets that each
+ * encoding treats specially, so block boundaries, escapes, and the
+ * CRC are exercised together.  No serial device is used.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/framing.h>
+#include <string.h>
+
+#define MAX_PAYLOAD 300
+#define NUM_FUZZ 60
+
+static uint8_t payload[MAX_PAYLOAD];
+static uint8_t encoded[BSP430_FRAMING_ENCODED_MAX(MAX_PAYLOAD)];
+static uint8_t rx_buffer[MAX_PAYLOAD + BSP430_FRAMING_CRC_LENGTH];
+static sBSP430framingDecoder decoder_state;
+static unsigned long prng_state = 1;
+
+static unsigned int
+prng (void)
+{
+  prng_state = 1103515245UL * prng_state + 12345;
+  return (unsigned int)(prng_state >> 16);
+}
+
+/* Fill len octets, of which about one in density is drawn from the
+ * octets that are special to the encodings. */
+static void
+fillPayload (size_t len,
+             unsigned int density)
+{
+  static const uint8_t special[] = { 0x00, 0xC0, 0xDB, 0xDC, 0xDD };
+  size_t i;
+
+  for (i = 0; i < len; ++i) {
+    if (0 == (prng() % density)) {
+      payload[i] = special[prng() % sizeof(special)];
+    } else {
+      payload[i] = 1 + (prng() % 255);
+    }
+  }
+}
+
+/* Feed n encoded octets to the decoder, returning the result for the
+ * last one and the count of completed frames in *nframesp. */
+static int
+feed (hBSP430framingDecoder decoder,
+      const uint8_t * data,
+      size_t n,
+      int * nframesp)
+{
+  int rv = -1;
+
+  while (0 < n--) {
+    rv = iBSP430framingDecoderRxOctet_ni(decoder, *data++);
+    if ((0 <= rv) && nframesp) {
+      ++*nframesp;
+    }
+  }
+  return rv;
+}
+
+static void
+testCRC (void)
+{
+  static const uint8_t check[] = "123456789";
+  uint8_t frame[sizeof(check) - 1 + BSP430_FRAMING_CRC_LENGTH];
+  unsigned int crc;
+
+  /* CRC-16/CCITT-FALSE check value */
+  crc = uiBSP430framingCRC16(BSP430_FRAMING_CRC16_INIT, check, sizeof(check) - 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(crc, 0x29B1);
+
+  /* Incremental computation matches */
+  crc = uiBSP430framingCRC16(BSP430_FRAMING_CRC16_INIT, check, 4);
+  crc = uiBSP430framingCRC16(crc, check + 4, sizeof(check) - 5);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(crc, 0x29B1);
+
+  /* Appending the CRC leaves a zero residue */
+  memcpy(frame, check, sizeof(check) - 1);
+  frame[sizeof(check) - 1] = crc >> 8;
+  frame[sizeof(check)] = crc;
+  crc = uiBSP430framingCRC16(BSP430_FRAMING_CRC16_INIT, frame, sizeof(frame));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(crc, 0);
+}
+
+static void
+testRoundTrip (int mode)
+{
+  hBSP430framingDecoder decoder;
+  int n;
+
+  decoder = hBSP430framingDecoderInitialize(&decoder_state, mode, NULL);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != decoder);
+  for (n = 0; n < NUM_FUZZ; ++n) {
+    size_t len;
+    int elen;
+    int rv;
+    int nframes = 0;
+
+    /* Cover the short and COBS block-boundary lengths explicitly */
+    if (n < 4) {
+      len = n;
+    } else if (n < 8) {
+      len = 250 + n;
+    } else {
+      len = prng() % (MAX_PAYLOAD + 1);
+    }
+    fillPayload(len, 1 + (n % 8) * 16);
+
+    elen = iBSP430framingEncode(mode, payload, len, encoded, sizeof(encoded));
+    BSP430_UNITTEST_ASSERT_TRUE(0 < elen);
+    BSP430_UNITTEST_ASSERT_TRUE(elen <= BSP430_FRAMING_ENCODED_MAX(len));
+    if (BSP430_FRAMING_MODE_COBS == mode) {
+      BSP430_UNITTEST_ASSERT_TRUE(NULL == memchr(encoded, 0, elen - 1));
+      BSP430_UNITTEST_ASSERT_EQUAL_FMTx(encoded[elen - 1], 0);
+    } else {
+      BSP430_UNITTEST_ASSERT_TRUE(NULL == memchr(encoded + 1, 0xC0, elen - 2));
+    }
+
+    /* Too small an output buffer is rejected */
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430framingEncode(mode, payload, len, encoded, elen - 1), -1);
+
+    vBSP430framingDecoderSetBuffer_ni(decoder, rx_buffer, sizeof(rx_buffer));
+    rv = feed(decoder, encoded, elen, &nframes);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(rv, (int)len);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 1);
+    BSP430_UNITTEST_ASSERT_TRUE(rx_buffer == decoder->frame);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->frame_len, len);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(memcmp(rx_buffer, payload, len), 0);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->errors, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->overruns, 0);
+}
+
+static void
+testErrors (int mode)
+{
+  hBSP430framingDecoder decoder;
+  static const uint8_t data[] = { 0x11, 0x00, 0xC0, 0x22, 0xDB, 0x33 };
+  int elen;
+  int nframes;
+
+  decoder = hBSP430framingDecoderInitialize(&decoder_state, mode, NULL);
+  elen = iBSP430framingEncode(mode, data, sizeof(data), encoded, sizeof(encoded));
+
+  /* No buffer: the frame is an overrun */
+  nframes = 0;
+  (void)feed(decoder, encoded, elen, &nframes);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->overruns, 1);
+
+  /* Buffer too small for payload plus CRC */
+  vBSP430framingDecoderSetBuffer_ni(decoder, rx_buffer, sizeof(data) + 1);
+  (void)feed(decoder, encoded, elen, &nframes);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->overruns, 2);
+
+  /* Corrupted payload octet fails the CRC */
+  vBSP430framingDecoderSetBuffer_ni(decoder, rx_buffer, sizeof(rx_buffer));
+  encoded[2] ^= 0x04;
+  (void)feed(decoder, encoded, elen, &nframes);
+  encoded[2] ^= 0x04;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->errors, 1);
+
+  /* Truncated frame: the decoder resynchronizes on the delimiter of
+   * the following frame */
+  if (BSP430_FRAMING_MODE_COBS == mode) {
+    (void)feed(decoder, encoded, elen - 3, &nframes);
+    (void)feed(decoder, encoded + elen - 1, 1, &nframes);
+  } else {
+    (void)feed(decoder, encoded, elen - 3, &nframes);
+  }
+  (void)feed(decoder, encoded, elen, &nframes);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->errors, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(memcmp(decoder->frame, data, sizeof(data)), 0);
+
+  /* After a frame is delivered the decoder has no buffer until one
+   * is supplied */
+  (void)feed(decoder, encoded, elen, &nframes);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->overruns, 3);
+
+  /* Supplying a buffer mid-frame drops the rest of that frame
+   * silently */
+  (void)feed(decoder, encoded, 3, &nframes);
+  vBSP430framingDecoderSetBuffer_ni(decoder, rx_buffer, sizeof(rx_buffer));
+  (void)feed(decoder, encoded + 3, elen - 3, &nframes);
+  (void)feed(decoder, encoded, elen, &nframes);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nframes, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->overruns, 3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(decoder->errors, 2);
+}
+
+static void
+testCOBSLayout (void)
+{
+  static const uint8_t zero[] = { 0 };
+  unsigned int crc = uiBSP430framingCRC16(BSP430_FRAMING_CRC16_INIT, zero, 1);
+  int elen;
+
+  /* A lone zero is an empty block followed by the CRC block */
+  elen = iBSP430framingEncode(BSP430_FRAMING_MODE_COBS, zero, 1, encoded, sizeof(encoded));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(elen, 5);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(encoded[0], 0x01);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(encoded[1], 0x03);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(encoded[2], 0xFF & (crc >> 8));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(encoded[3], 0xFF & crc);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(encoded[4], 0x00);
+
+  BSP430_UNITTEST_ASSERT_TRUE(NULL == hBSP430framingDecoderInitialize(&decoder_state, 2, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430framingEncode(2, zero, 1, encoded, sizeof(encoded)), -1);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testCRC();
+  testCOBSLayout();
+  testRoundTrip(BSP430_FRAMING_MODE_COBS);
+  testRoundTrip(BSP430_FRAMING_MODE_SLIP);
+  testErrors(BSP430_FRAMING_MODE_COBS);
+  testErrors(BSP430_FRAMING_MODE_SLIP);
+
+  vBSP430unittestFinalize();
+}
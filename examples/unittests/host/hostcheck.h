@@ -0,0 +1,66 @@
+/** This file is in the public domain.
+ *
+ * Checks shared by the tests run on the development host.  Each
+ * check is counted; the first ten failures are reported on standard
+ * error with their location, and hostCheckReport() summarizes the run
+ * and provides the exit status.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <stdio.h>
+
+static unsigned long checks;
+static unsigned long errors;
+
+/* Count a check that passed unless @p failed.  Returns nonzero if
+ * the failure should be reported. */
+static __inline__ int
+hostCheckFailed (int failed)
+{
+  ++checks;
+  return failed && (10 > errors++);
+}
+
+/* Print the check and error counts, following @p label if it is not
+ * null.  Returns the exit status of the test. */
+static __inline__ int
+hostCheckReport (const char * label)
+{
+  if (label) {
+    printf("%s: ", label);
+  }
+  printf("%lu checks, %lu errors\n", checks, errors);
+  return 0 != errors;
+}
+
+#define CHECK(cond_) do {                                               \
+    if (hostCheckFailed(! (cond_))) {                                   \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond_);       \
+    }                                                                   \
+  } while (0)
+
+#define CHECK_EQUAL(got_, expected_) do {                               \
+    unsigned long got = (got_);                                         \
+    unsigned long exp = (expected_);                                    \
+    if (hostCheckFailed(got != exp)) {                                  \
+      fprintf(stderr, "%s:%d: %s: got %#lx expected %#lx\n",            \
+              __FILE__, __LINE__, #got_, got, exp);                     \
+    }                                                                   \
+  } while (0)
+
+/* As CHECK_EQUAL() for values that may be negative */
+#define CHECK_EQUAL_SIGNED(got_, expected_) do {                        \
+    long got = (got_);                                                  \
+    long exp = (expected_);                                             \
+    if (hostCheckFailed(got != exp)) {                                  \
+      fprintf(stderr, "%s:%d: %s: got %ld expected %ld\n",              \
+              __FILE__, __LINE__, #got_, got, exp);                     \
+    }                                                                   \
+  } while (0)
+
+#endif /* HOST_CHECK_H */
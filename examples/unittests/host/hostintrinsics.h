@@ -0,0 +1,12 @@
+/* Host builds need the intrinsics used by critical sections.  The
+ * host tests are single-threaded, so they do nothing.  A test that
+ * needs MCU definitions supplies its own msp430.h in its host/
+ * directory, which includes this header. */
+#ifndef HOST_INTRINSICS_H
+#define HOST_INTRINSICS_H
+typedef unsigned int __istate_t;
+static __inline__ __istate_t __get_interrupt_state (void) { return 0; }
+static __inline__ void __set_interrupt_state (__istate_t s) { (void)s; }
+static __inline__ void __disable_interrupt (void) { }
+static __inline__ void __enable_interrupt (void) { }
+#endif /* HOST_INTRINSICS_H */
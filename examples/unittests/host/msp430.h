@@ -0,0 +1,6 @@
+/* Host builds of tests that need no MCU definitions get only the
+ * intrinsics. */
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+#include "hostintrinsics.h"
+#endif /* HOST_MSP430_H */
@@ -0,0 +1,32 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Support the unit-test framework */
+#define configBSP430_UNITTEST 1
+
+/* We need interrupt-driven I2C slave support */
+#define configBSP430_SERIAL_ENABLE_I2C 1
+#define configBSP430_SERIAL_I2C_SLAVE 1
+
+/* The device to which the register file is attached.  No master is
+ * needed: bus events are simulated. */
+#if BSP430_PLATFORM_EXP430FR5739 - 0
+#define APP_I2C_PERIPH_HANDLE BSP430_PERIPH_EUSCI_B0
+#define configBSP430_HAL_EUSCI_B0 1
+#define configBSP430_HAL_EUSCI_B0_ISR 1
+#else /* BSP430_PLATFORM_EXP430FR5739 */
+#define APP_I2C_PERIPH_HANDLE BSP430_PERIPH_USCI5_B3
+#define configBSP430_HAL_USCI5_B3 1
+#define configBSP430_HAL_USCI5_B3_ISR 1
+#endif /* BSP430_PLATFORM_EXP430FR5739 */
+#define APP_I2C_OWN_ADDRESS 0x42
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,176 @@
+/** This file is in the public domain.
+ *
+ * Validate the register pointer and prefetch management of the I2C
+ * slave register file.  A register file is attached to an I2C device
+ * opened in slave mode, but no master is required: bus events are
+ * simulated by invoking the functions that the device interrupt
+ * handler uses, in the order the handler would.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/serial.h>
+
+#define NREGS 8
+
+/* Register 0 is read-only; register 7 is synthesized on read */
+#define RO_REG 0
+#define LIVE_REG 7
+#define LIVE_VALUE 0xA5
+
+static uint8_t regs[NREGS];
+static sBSP430i2cSlave slave_state;
+static int live_reads;
+static int last_first_reg;
+static int last_num_written;
+static int num_stops;
+
+static int
+read_cb_ni (hBSP430i2cSlave slave,
+            unsigned int reg)
+{
+  if (LIVE_REG == reg) {
+    ++live_reads;
+    return LIVE_VALUE;
+  }
+  return -1;
+}
+
+static int
+write_cb_ni (hBSP430i2cSlave slave,
+             unsigned int reg,
+             uint8_t value)
+{
+  return (RO_REG == reg) ? -1 : 0;
+}
+
+static int
+stop_cb_ni (hBSP430i2cSlave slave,
+            unsigned int first_reg,
+            unsigned int num_written)
+{
+  last_first_reg = first_reg;
+  last_num_written = num_written;
+  ++num_stops;
+  return 0;
+}
+
+/* Master writes len octets, the first being the register pointer */
+static void
+masterWrite (hBSP430i2cSlave slave,
+             const uint8_t * data,
+             int len)
+{
+  vBSP430i2cSlaveStart_ni(slave, 0);
+  while (0 < len--) {
+    (void)iBSP430i2cSlaveRx_ni(slave, *data++);
+  }
+}
+
+/* Master reads len octets.  The transmit buffer is refilled as each
+ * octet moves to the shift register, so one more octet is loaded
+ * than the master reads. */
+static void
+masterRead (hBSP430i2cSlave slave,
+            uint8_t * data,
+            int len)
+{
+  vBSP430i2cSlaveStart_ni(slave, 1);
+  while (0 <= len) {
+    uint8_t txbuf = slave->tx_next;
+    vBSP430i2cSlaveTxNext_ni(slave);
+    if (0 < len) {
+      *data++ = txbuf;
+    }
+    --len;
+  }
+}
+
+static void
+testRegisterFile (hBSP430i2cSlave slave)
+{
+  static const uint8_t write_ptr2[] = { 2, 0x21, 0x31 };
+  static const uint8_t write_ro[] = { RO_REG, 0x99 };
+  static const uint8_t set_ptr5[] = { 5 };
+  static const uint8_t write_ptr1[] = { 1, 0x77 };
+  uint8_t rx[4];
+  int i;
+
+  for (i = 0; i < NREGS; ++i) {
+    regs[i] = 0x10 + i;
+  }
+
+  /* Multi-octet write with auto-increment */
+  masterWrite(slave, write_ptr2, sizeof(write_ptr2));
+  (void)iBSP430i2cSlaveStop_ni(slave);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(regs[2], 0x21);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(regs[3], 0x31);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(regs[4], 0x14);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(num_stops, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_first_reg, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_num_written, 2);
+
+  /* Write callback rejects a read-only register */
+  masterWrite(slave, write_ro, sizeof(write_ro));
+  (void)iBSP430i2cSlaveStop_ni(slave);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(regs[RO_REG], 0x10);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_num_written, 1);
+
+  /* Pointer write prefetches, then repeated start read crossing the
+   * synthesized register and wrapping */
+  masterWrite(slave, set_ptr5, sizeof(set_ptr5));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(slave->tx_next, 0x15);
+  masterRead(slave, rx, 4);
+  (void)iBSP430i2cSlaveStop_ni(slave);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[0], 0x15);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[1], 0x16);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[2], LIVE_VALUE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[3], 0x10);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(live_reads, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_first_reg, 5);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(last_num_written, 0);
+
+  /* The octet loaded but not read is the first of the next read */
+  masterRead(slave, rx, 1);
+  (void)iBSP430i2cSlaveStop_ni(slave);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[0], 0x11);
+
+  /* A read after a write without a pointer continues after the
+   * written register, with a fresh value */
+  masterWrite(slave, write_ptr1, sizeof(write_ptr1));
+  (void)iBSP430i2cSlaveStop_ni(slave);
+  masterRead(slave, rx, 2);
+  (void)iBSP430i2cSlaveStop_ni(slave);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(regs[1], 0x77);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[0], 0x21);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx[1], 0x31);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(num_stops, 6);
+}
+
+void main ()
+{
+  hBSP430halSERIAL i2c;
+  hBSP430i2cSlave slave;
+
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  i2c = hBSP430serialOpenI2C(hBSP430serialLookup(APP_I2C_PERIPH_HANDLE),
+                             BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(0),
+                             UCSSEL_2, 1);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != i2c);
+  (void)iBSP430i2cSetAddresses_ni(i2c, APP_I2C_OWN_ADDRESS, -1);
+  slave = hBSP430i2cSlaveInitialize(&slave_state, i2c, regs, NREGS,
+                                    read_cb_ni, write_cb_ni, stop_cb_ni);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != slave);
+  if (slave) {
+    testRegisterFile(slave);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430i2cSlaveRelease(slave), 0);
+  }
+  (void)iBSP430serialClose(i2c);
+
+  vBSP430unittestFinalize();
+}
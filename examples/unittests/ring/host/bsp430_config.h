@@ -0,0 +1,2 @@
+/* Host builds of hardware-independent modules need no
+ * configuration. */
@@ -0,0 +1,132 @@
+/** This file is in the public domain.
+ *
+ * Validate the ring buffer index arithmetic, including wrapping of the
+ * buffer and of the free-running indexes, for both index widths.
+ * Concurrent use is exercised by the host test built with <tt>make
+ * check-host</tt>.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/ring.h>
+
+static uint8_t storage8[8];
+static sBSP430ring8 ring8 = BSP430_RING_INITIALIZER(storage8);
+static uint8_t storage16[256];
+static sBSP430ring16 ring16;
+
+static void
+testRing8 (void)
+{
+  hBSP430ring8 rp = &ring8;
+  uint8_t out[16];
+  uint8_t * wp;
+  const uint8_t * rdp;
+  size_t len;
+  int i;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring8Count(rp), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring8Space(rp), sizeof(storage8));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), -1);
+
+  /* The whole buffer is usable */
+  for (i = 0; i < sizeof(storage8); ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8PutOctet(rp, 0x80 + i), 0x80 + i);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8PutOctet(rp, 0), -1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring8Space(rp), 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8PeekOctet(rp), 0x80);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), 0x80);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring8Count(rp), sizeof(storage8) - 1);
+
+  /* Bulk transfers wrap the buffer; a short pop stops at the data */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(xBSP430ring8Get(rp, out, 5), 5);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(out[4], 0x85);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(xBSP430ring8Put(rp, (const uint8_t *)"abcdefgh", 8), 6);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(xBSP430ring8Get(rp, out, sizeof(out)), 8);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(out[1], 0x87);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(out[2], 'a');
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(out[7], 'f');
+
+  /* Reservations are contiguous: the first ends at the end of the
+   * buffer, the next starts at its beginning */
+  wp = xBSP430ring8Reserve(rp, &len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(len, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(wp, storage8 + 6);
+  wp[0] = 'x';
+  wp[1] = 'y';
+  vBSP430ring8Commit(rp, 2);
+  wp = xBSP430ring8Reserve(rp, &len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(len, 6);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(wp, storage8);
+  wp[0] = 'z';
+  vBSP430ring8Commit(rp, 1);
+  rdp = xBSP430ring8Peek(rp, &len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(len, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rdp[1], 'y');
+  vBSP430ring8Release(rp, len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), 'z');
+
+  /* The newest unread octets can be taken back */
+  (void)xBSP430ring8Put(rp, (const uint8_t *)"abc", 3);
+  vBSP430ring8Withdraw(rp, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring8Count(rp), 1);
+  (void)iBSP430ring8PutOctet(rp, 'd');
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), 'a');
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), 'd');
+
+  /* Run the free-running indexes through their wrap */
+  for (i = 0; i < 300; ++i) {
+    (void)iBSP430ring8PutOctet(rp, i);
+    (void)iBSP430ring8PutOctet(rp, i + 1);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), i & 0xFF);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430ring8GetOctet(rp), (i + 1) & 0xFF);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring8Count(rp), 0);
+}
+
+static void
+testRing16 (void)
+{
+  hBSP430ring16 rp;
+  uint8_t block[200];
+  uint8_t out[200];
+  int i;
+
+  BSP430_UNITTEST_ASSERT_TRUE(NULL == hBSP430ring16Initialize(&ring16, storage16, 100));
+  BSP430_UNITTEST_ASSERT_TRUE(NULL == hBSP430ring8Initialize(&ring8, storage16, sizeof(storage16)));
+  rp = hBSP430ring16Initialize(&ring16, storage16, sizeof(storage16));
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != rp);
+  if (NULL == rp) {
+    return;
+  }
+  for (i = 0; i < sizeof(block); ++i) {
+    block[i] = i;
+  }
+  for (i = 0; i < 400; ++i) {
+    size_t n = 1 + (i % sizeof(block));
+    size_t got;
+
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTu(xBSP430ring16Put(rp, block, n), n);
+    got = xBSP430ring16Get(rp, out, sizeof(out));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTu(got, n);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx(out[n - 1], block[n - 1]);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(xBSP430ring16Put(rp, block, sizeof(block)), sizeof(block));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(xBSP430ring16Put(rp, block, sizeof(block)), sizeof(storage16) - sizeof(block));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(uiBSP430ring16Space(rp), 0);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testRing8();
+  testRing16();
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,216 @@
+/** This file is in the public domain.
+ *
+ * Host concurrency stress test for utility/ring.  A producer thread
+ * and a consumer thread share each ring variant without locks, each
+ * mixing single-octet, bulk, and in-place operations in chunks of
+ * varying size.  The consumer verifies that it receives exactly the
+ * sequence produced.  Build and run with <tt>make check-host</tt>;
+ * the exit status is nonzero on failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/utility/ring.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Octets passed through each ring */
+#ifndef STRESS_OCTETS
+#define STRESS_OCTETS 4000000UL
+#endif /* STRESS_OCTETS */
+
+typedef struct sStress {
+  const char * name;
+  void * ring;
+  /* Operations on the ring, bound to one variant */
+  int (* put_octet) (void * ring, uint8_t c);
+  size_t (* put) (void * ring, const uint8_t * src, size_t len);
+  uint8_t * (* reserve) (void * ring, size_t * lenp);
+  void (* commit) (void * ring, size_t len);
+  int (* get_octet) (void * ring);
+  size_t (* get) (void * ring, uint8_t * dst, size_t len);
+  const uint8_t * (* peek) (void * ring, size_t * lenp);
+  void (* release) (void * ring, size_t len);
+  unsigned long errors;
+} sStress;
+
+/* The octet at a position in the stream; not a multiple of any ring
+ * size, so misplaced data is detected */
+static uint8_t
+stream_octet (unsigned long pos)
+{
+  return (uint8_t)(pos + (pos / 251));
+}
+
+/* Cheap per-thread generator for chunk sizes and operation choice */
+static unsigned int
+next_random (unsigned long * statep)
+{
+  *statep = *statep * 1103515245UL + 12345UL;
+  return (unsigned int)(*statep >> 16);
+}
+
+static void *
+producer (void * arg)
+{
+  sStress * sp = arg;
+  unsigned long state = 1;
+  unsigned long pos = 0;
+  uint8_t chunk[64];
+
+  while (pos < STRESS_OCTETS) {
+    unsigned int r = next_random(&state);
+    size_t n = 1 + (r % sizeof(chunk));
+    unsigned long start = pos;
+    size_t i;
+
+    if (n > STRESS_OCTETS - pos) {
+      n = STRESS_OCTETS - pos;
+    }
+    switch ((r >> 8) % 3) {
+      case 0:
+        if (0 <= sp->put_octet(sp->ring, stream_octet(pos))) {
+          ++pos;
+        }
+        break;
+      case 1:
+        for (i = 0; i < n; ++i) {
+          chunk[i] = stream_octet(pos + i);
+        }
+        pos += sp->put(sp->ring, chunk, n);
+        break;
+      default: {
+        size_t len;
+        uint8_t * dp = sp->reserve(sp->ring, &len);
+
+        if (len > n) {
+          len = n;
+        }
+        for (i = 0; i < len; ++i) {
+          dp[i] = stream_octet(pos + i);
+        }
+        sp->commit(sp->ring, len);
+        pos += len;
+        break;
+      }
+    }
+    if (start == pos) {
+      /* Full: let the consumer run on a single-CPU host */
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void *
+consumer (void * arg)
+{
+  sStress * sp = arg;
+  unsigned long state = 2;
+  unsigned long pos = 0;
+  uint8_t chunk[64];
+
+  while (pos < STRESS_OCTETS) {
+    unsigned int r = next_random(&state);
+    size_t n = 1 + (r % sizeof(chunk));
+    const uint8_t * dp = chunk;
+    size_t len = 0;
+    size_t i;
+    int c;
+
+    switch ((r >> 8) % 3) {
+      case 0:
+        c = sp->get_octet(sp->ring);
+        if (0 <= c) {
+          chunk[0] = c;
+          len = 1;
+        }
+        break;
+      case 1:
+        len = sp->get(sp->ring, chunk, n);
+        break;
+      default:
+        dp = sp->peek(sp->ring, &len);
+        if (len > n) {
+          len = n;
+        }
+        break;
+    }
+    for (i = 0; i < len; ++i) {
+      if (dp[i] != stream_octet(pos + i)) {
+        if (0 == sp->errors++) {
+          fprintf(stderr, "%s: octet %lu: got 0x%02x expected 0x%02x\n",
+                  sp->name, pos + i, dp[i], stream_octet(pos + i));
+        }
+      }
+    }
+    if (dp != chunk) {
+      sp->release(sp->ring, len);
+    }
+    if (0 == len) {
+      /* Empty: let the producer run on a single-CPU host */
+      sched_yield();
+    }
+    pos += len;
+  }
+  return NULL;
+}
+
+/* Bind the operations of one variant to the generic signatures */
+#define STRESS_BIND_(w_)                                                \
+  static int put_octet##w_ (void * r, uint8_t c) { return iBSP430ring##w_##PutOctet(r, c); } \
+  static size_t put##w_ (void * r, const uint8_t * s, size_t n) { return xBSP430ring##w_##Put(r, s, n); } \
+  static uint8_t * reserve##w_ (void * r, size_t * lp) { return xBSP430ring##w_##Reserve(r, lp); } \
+  static void commit##w_ (void * r, size_t n) { vBSP430ring##w_##Commit(r, n); } \
+  static int get_octet##w_ (void * r) { return iBSP430ring##w_##GetOctet(r); } \
+  static size_t get##w_ (void * r, uint8_t * d, size_t n) { return xBSP430ring##w_##Get(r, d, n); } \
+  static const uint8_t * peek##w_ (void * r, size_t * lp) { return xBSP430ring##w_##Peek(r, lp); } \
+  static void release##w_ (void * r, size_t n) { vBSP430ring##w_##Release(r, n); }
+
+#define STRESS_INITIALIZER_(w_, ring_) {                                \
+    .name = "ring" #w_, .ring = (ring_),                                \
+    .put_octet = put_octet##w_, .put = put##w_,                         \
+    .reserve = reserve##w_, .commit = commit##w_,                       \
+    .get_octet = get_octet##w_, .get = get##w_,                         \
+    .peek = peek##w_, .release = release##w_,                           \
+  }
+
+STRESS_BIND_(8)
+STRESS_BIND_(16)
+
+static uint8_t storage8[16];
+static sBSP430ring8 ring8 = BSP430_RING_INITIALIZER(storage8);
+static uint8_t storage16[128];
+static sBSP430ring16 ring16 = BSP430_RING_INITIALIZER(storage16);
+
+static int
+run (sStress * sp)
+{
+  pthread_t pt;
+  pthread_t ct;
+
+  if ((0 != pthread_create(&pt, NULL, producer, sp))
+      || (0 != pthread_create(&ct, NULL, consumer, sp))) {
+    fprintf(stderr, "%s: cannot create threads\n", sp->name);
+    return -1;
+  }
+  pthread_join(pt, NULL);
+  pthread_join(ct, NULL);
+  printf("%s: %lu octets, %lu errors\n", sp->name, STRESS_OCTETS, sp->errors);
+  return sp->errors ? -1 : 0;
+}
+
+int
+main (void)
+{
+  sStress s8 = STRESS_INITIALIZER_(8, &ring8);
+  sStress s16 = STRESS_INITIALIZER_(16, &ring16);
+  int rc = 0;
+
+  rc |= run(&s8);
+  rc |= run(&s16);
+  return rc ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,4 @@
+/* Host builds of the serial module need only the SPI interface,
+ * which the host test implements with its own dispatch table and
+ * interrupt handler. */
+#define configBSP430_SERIAL_ENABLE_SPI 1
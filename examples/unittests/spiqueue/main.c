@@ -0,0 +1,133 @@
+/** This file is in the public domain.
+ *
+ * Validate the asynchronous SPI transaction queue.  The device is
+ * placed in loopback mode, so each octet received is the one
+ * transmitted.  Three chained transactions are submitted at once and
+ * the application sleeps until the queue is idle: the first
+ * completion callback declines to wake it, the second transaction
+ * has no callback, and the third callback requests a wakeup, so
+ * exactly two wakeups are expected.  The host test built with
+ * <tt>make check-host</tt> checks the interrupt return flags octet by
+ * octet.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/serial.h>
+#include <string.h>
+
+static sBSP430spiQueue queue_state;
+static sBSP430spiTransaction txn[3];
+static volatile int completed[3];
+static volatile int selects;
+
+static const uint8_t cmd_a[] = { 0x01, 0x02, 0x03 };
+static const uint8_t cmd_b[] = { 0x9F };
+static const uint8_t cmd_c[] = { 0xA5, 0x5A };
+static uint8_t rx_b[3];
+static uint8_t rx_c[4];
+
+static void
+chip_select_ni (hBSP430spiTransaction tp,
+                int select)
+{
+  selects += select ? 1 : -1;
+}
+
+static int
+sleep_cb_ni (hBSP430spiTransaction tp)
+{
+  ++completed[tp - txn];
+  return 0;
+}
+
+static int
+wake_cb_ni (hBSP430spiTransaction tp)
+{
+  ++completed[tp - txn];
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+static void
+testChained (hBSP430spiQueue queue)
+{
+  int wakeups = 0;
+  int i;
+
+  memset(txn, 0, sizeof(txn));
+  txn[0].tx_data = cmd_a;
+  txn[0].tx_len = sizeof(cmd_a);
+  txn[0].chip_select_ni = chip_select_ni;
+  txn[0].callback_ni = sleep_cb_ni;
+  txn[1].tx_data = cmd_b;
+  txn[1].tx_len = sizeof(cmd_b);
+  txn[1].rx_len = 2;
+  txn[1].rx_data = rx_b;
+  txn[1].chip_select_ni = chip_select_ni;
+  txn[2].tx_data = cmd_c;
+  txn[2].tx_len = sizeof(cmd_c);
+  txn[2].rx_len = 2;
+  txn[2].rx_data = rx_c;
+  txn[2].chip_select_ni = chip_select_ni;
+  txn[2].callback_ni = wake_cb_ni;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  for (i = 0; i < 3; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430spiQueueSubmit_ni(queue, txn + i), 0);
+  }
+  while (! iBSP430spiQueueIdle_ni(queue)) {
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits | GIE);
+    BSP430_CORE_DISABLE_INTERRUPT();
+    ++wakeups;
+  }
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(wakeups, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(selects, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(completed[0], 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(completed[2], 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(txn[0].result, 3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(txn[1].result, 3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(txn[2].result, 4);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_b[0], 0x9F);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_b[1], BSP430_SERIAL_SPI_READ_TX_BYTE(0) & 0xFF);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_b[2], BSP430_SERIAL_SPI_READ_TX_BYTE(1) & 0xFF);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_c[0], 0xA5);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_c[1], 0x5A);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_c[2], BSP430_SERIAL_SPI_READ_TX_BYTE(0) & 0xFF);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(rx_c[3], BSP430_SERIAL_SPI_READ_TX_BYTE(1) & 0xFF);
+}
+
+void main ()
+{
+  hBSP430halSERIAL spi;
+  hBSP430spiQueue queue;
+
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  spi = hBSP430serialOpenSPI(hBSP430serialLookup(APP_SPI_PERIPH_HANDLE),
+                             BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(UCCKPH | UCMSB | UCMST),
+                             UCSSEL_2, 4);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != spi);
+  if (spi) {
+    /* Loop the transmitter back to the receiver */
+#if BSP430_PLATFORM_EXP430FR5739 - 0
+    spi->hpl.euscib->statw |= UCLISTEN;
+#else /* BSP430_PLATFORM_EXP430FR5739 */
+    spi->hpl.usci5->stat |= UCLISTEN;
+#endif /* BSP430_PLATFORM_EXP430FR5739 */
+    queue = hBSP430spiQueueInitialize(&queue_state, spi);
+    BSP430_UNITTEST_ASSERT_TRUE(NULL != queue);
+    if (queue) {
+      testChained(queue);
+      BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430spiQueueRelease(queue), 0);
+    }
+    (void)iBSP430serialClose(spi);
+  }
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,388 @@
+/** This file is in the public domain.
+ *
+ * Host test of the asynchronous SPI transaction queue.  The queue is
+ * attached to a simulated device whose interrupt handler follows the
+ * USCI5 handler: the transmit interrupt obtains an octet through
+ * iBSP430serialTxISRNextOctet_ni(), and the response of a simulated
+ * slave is delivered through the receive callback chain.  Chained
+ * descriptors are checked for the octets exchanged, the order of chip
+ * select and completion events, the return flags of each interrupt,
+ * and submission from a completion callback.  Build and run with
+ * <tt>make check-host</tt>; the exit status is nonzero on failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/serial.h>
+#include <string.h>
+#include "hostcheck.h"
+
+#define MAX_OCTETS 64
+#define MAX_TRACE 32
+
+/* Simulated interrupt enable and flag state of the device */
+static int txie;
+static int txifg = 1;
+static int rxifg;
+static int holds;
+
+/* Octets shifted out on the bus, and the transaction whose chip
+ * select was asserted for each */
+static uint8_t mosi[MAX_OCTETS];
+static char mosi_cs[MAX_OCTETS];
+static unsigned int nmosi;
+
+/* The slave answers each octet with the next in a sequence */
+static uint8_t miso_seq;
+
+/* Chip select and completion events, as a string of pairs: an event
+ * code ('+' select, '-' deselect, '!' callback) and a transaction
+ * tag */
+static char trace[2 * MAX_TRACE + 1];
+static unsigned int ntrace;
+
+/* Return flags of each interrupt that set any other than those
+ * consumed by the handler itself, with the number of octets exchanged
+ * when it occurred */
+static int isr_flags[MAX_TRACE];
+static unsigned int isr_at[MAX_TRACE];
+static unsigned int nisr;
+
+/* The transaction whose chip select is asserted, or 0 */
+static char selected;
+
+static int
+setHold_ni (hBSP430halSERIAL hal,
+            int holdp)
+{
+  holds += holdp ? 1 : -1;
+  return 0;
+}
+
+static void
+wakeupTransmit_ni (hBSP430halSERIAL hal)
+{
+  txie = 1;
+}
+
+static const struct sBSP430serialDispatch dispatch = {
+  .setHold_ni = setHold_ni,
+  .wakeupTransmit_ni = wakeupTransmit_ni,
+};
+
+static sBSP430halSERIAL spi_ = {
+  .dispatch = &dispatch,
+};
+static hBSP430halSERIAL const spi = &spi_;
+
+static sBSP430spiQueue queue_state;
+static hBSP430spiQueue queue;
+
+typedef struct sTestTransaction {
+  sBSP430spiTransaction txn;
+  char tag;
+  int rv;
+  /* Transactions submitted by the first and second completions */
+  struct sTestTransaction * submit[2];
+  unsigned int completions;
+} sTestTransaction;
+
+#define TEST_TXN(p_) ((sTestTransaction *)(p_))
+
+static void
+addTrace (char event,
+          hBSP430spiTransaction txn)
+{
+  if (ntrace < MAX_TRACE) {
+    trace[2 * ntrace] = event;
+    trace[2 * ntrace + 1] = TEST_TXN(txn)->tag;
+    ++ntrace;
+  }
+}
+
+static void
+chip_select_ni (hBSP430spiTransaction txn,
+                int select)
+{
+  addTrace(select ? '+' : '-', txn);
+  CHECK_EQUAL(selected, select ? 0 : TEST_TXN(txn)->tag);
+  selected = select ? TEST_TXN(txn)->tag : 0;
+}
+
+/* Completion returns the configured flags, and optionally submits
+ * another transaction */
+static int
+callback_ni (hBSP430spiTransaction txn)
+{
+  sTestTransaction * ttp = TEST_TXN(txn);
+  unsigned int n = ttp->completions++;
+
+  addTrace('!', txn);
+  CHECK_EQUAL(selected, 0);
+  if ((n < 2) && ttp->submit[n]) {
+    CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &ttp->submit[n]->txn), 0);
+  }
+  return ttp->rv;
+}
+
+static void
+recordISR (int rv)
+{
+  if (rv && (nisr < MAX_TRACE)) {
+    isr_flags[nisr] = rv;
+    isr_at[nisr] = nmosi;
+    ++nisr;
+  }
+}
+
+/* Run the device until it has nothing to do.  As with the USCI5
+ * interrupt vector, a pending reception is serviced before a
+ * transmission.  Writing the transmit buffer moves the octet to the
+ * shift register at once, and the response of the slave arrives
+ * before the next interrupt. */
+static void
+runDevice (void)
+{
+  while (1) {
+    int rv = 0;
+
+    if (rxifg) {
+      rxifg = 0;
+      spi->rx_byte = miso_seq++;
+      ++spi->num_rx;
+      rv = iBSP430callbackInvokeISRVoid_ni(&spi->rx_cbchain_ni, spi, 0);
+    } else if (txie && txifg) {
+      int c = iBSP430serialTxISRNextOctet_ni(spi, &rv);
+
+      if (0 <= c) {
+        CHECK_EQUAL(nmosi < MAX_OCTETS, 1);
+        if (nmosi < MAX_OCTETS) {
+          mosi[nmosi] = c;
+          mosi_cs[nmosi] = selected;
+          ++nmosi;
+        }
+        rxifg = 1;
+      }
+      if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
+        txie = 0;
+      }
+    } else {
+      break;
+    }
+    recordISR(rv & ~(BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN | BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT));
+  }
+}
+
+static void
+resetTrace (void)
+{
+  memset(trace, 0, sizeof(trace));
+  ntrace = 0;
+  nisr = 0;
+  nmosi = 0;
+  miso_seq = 0;
+}
+
+static void
+initTransaction (sTestTransaction * ttp,
+                 char tag,
+                 const uint8_t * tx_data,
+                 size_t tx_len,
+                 size_t rx_len,
+                 uint8_t * rx_data,
+                 int with_callback,
+                 int rv)
+{
+  memset(ttp, 0, sizeof(*ttp));
+  ttp->tag = tag;
+  ttp->txn.tx_data = tx_data;
+  ttp->txn.tx_len = tx_len;
+  ttp->txn.rx_len = rx_len;
+  ttp->txn.rx_data = rx_data;
+  ttp->txn.chip_select_ni = chip_select_ni;
+  if (with_callback) {
+    ttp->txn.callback_ni = callback_ni;
+  }
+  ttp->rv = rv;
+}
+
+static void
+testAttach (void)
+{
+  queue = hBSP430spiQueueInitialize(&queue_state, spi);
+  CHECK_EQUAL(queue == &queue_state, 1);
+  CHECK_EQUAL(NULL != spi->rx_cbchain_ni, 1);
+  CHECK_EQUAL(NULL != spi->tx_cbchain_ni, 1);
+  CHECK_EQUAL(holds, 0);
+  CHECK_EQUAL(iBSP430spiQueueIdle_ni(queue), 1);
+  CHECK_EQUAL(NULL == hBSP430spiQueueInitialize(&queue_state, NULL), 1);
+}
+
+/* A lone transaction without a callback requests exit from low power
+ * mode when, and only when, its last response arrives */
+static void
+testSingle (void)
+{
+  static const uint8_t cmd[] = { 0x9F, 0x03 };
+  sTestTransaction t;
+  uint8_t rx[5];
+  unsigned int i;
+
+  resetTrace();
+  initTransaction(&t, 'A', cmd, sizeof(cmd), 3, rx, 0, 0);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &t.txn), 0);
+  CHECK_EQUAL(t.txn.result, -1);
+  CHECK_EQUAL(iBSP430spiQueueIdle_ni(queue), 0);
+  CHECK_EQUAL(txie, 1);
+  runDevice();
+
+  CHECK_EQUAL(iBSP430spiQueueIdle_ni(queue), 1);
+  CHECK_EQUAL(t.txn.result, 5);
+  CHECK_EQUAL(nmosi, 5);
+  CHECK_EQUAL(mosi[0], 0x9F);
+  CHECK_EQUAL(mosi[1], 0x03);
+  for (i = 0; i < 3; ++i) {
+    CHECK_EQUAL(mosi[2 + i], BSP430_SERIAL_SPI_READ_TX_BYTE(i) & 0xFF);
+  }
+  for (i = 0; i < nmosi; ++i) {
+    CHECK_EQUAL(mosi_cs[i], 'A');
+    CHECK_EQUAL(rx[i], i);
+  }
+  CHECK_EQUAL(0 == strcmp(trace, "+A-A"), 1);
+  CHECK_EQUAL(nisr, 1);
+  CHECK_EQUAL(isr_flags[0], BSP430_HAL_ISR_CALLBACK_EXIT_LPM);
+  CHECK_EQUAL(isr_at[0], 5);
+  CHECK_EQUAL(txie, 0);
+}
+
+/* Descriptors submitted while the queue is busy run in order, each
+ * starting only after the previous one has been deselected and its
+ * callback invoked.  Only completions whose callback asks for it, or
+ * that have no callback, request exit from low power mode. */
+static void
+testChained (void)
+{
+  static const uint8_t cmd_a[] = { 0x01, 0x02, 0x03 };
+  static const uint8_t cmd_b[] = { 0x10 };
+  static const uint8_t cmd_c[] = { 0x20, 0x21 };
+  sTestTransaction a;
+  sTestTransaction b;
+  sTestTransaction c;
+  uint8_t rx_b[3];
+  uint8_t rx_c[4];
+  unsigned int i;
+
+  resetTrace();
+  initTransaction(&a, 'A', cmd_a, sizeof(cmd_a), 0, NULL, 1, 0);
+  initTransaction(&b, 'B', cmd_b, sizeof(cmd_b), 2, rx_b, 0, 0);
+  initTransaction(&c, 'C', cmd_c, sizeof(cmd_c), 2, rx_c, 1, BSP430_HAL_ISR_CALLBACK_EXIT_LPM);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &a.txn), 0);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &b.txn), 0);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &c.txn), 0);
+
+  /* Only the first has been started */
+  CHECK_EQUAL(0 == strcmp(trace, "+A"), 1);
+  CHECK_EQUAL(b.txn.result, -1);
+  CHECK_EQUAL(c.txn.result, -1);
+  runDevice();
+
+  CHECK_EQUAL(iBSP430spiQueueIdle_ni(queue), 1);
+  CHECK_EQUAL(0 == strcmp(trace, "+A-A!A+B-B+C-C!C"), 1);
+  CHECK_EQUAL(a.txn.result, 3);
+  CHECK_EQUAL(b.txn.result, 3);
+  CHECK_EQUAL(c.txn.result, 4);
+  CHECK_EQUAL(nmosi, 10);
+  CHECK_EQUAL(0 == memcmp(mosi, cmd_a, 3), 1);
+  CHECK_EQUAL(mosi[3], 0x10);
+  CHECK_EQUAL(0 == memcmp(mosi + 6, cmd_c, 2), 1);
+  for (i = 0; i < nmosi; ++i) {
+    CHECK_EQUAL(mosi_cs[i], (i < 3) ? 'A' : ((i < 6) ? 'B' : 'C'));
+  }
+  for (i = 0; i < 3; ++i) {
+    CHECK_EQUAL(rx_b[i], 3 + i);
+  }
+  for (i = 0; i < 4; ++i) {
+    CHECK_EQUAL(rx_c[i], 6 + i);
+  }
+
+  /* A's callback declined to wake; B (no callback) and C did, on
+   * their last octet */
+  CHECK_EQUAL(nisr, 2);
+  CHECK_EQUAL(isr_flags[0], BSP430_HAL_ISR_CALLBACK_EXIT_LPM);
+  CHECK_EQUAL(isr_at[0], 6);
+  CHECK_EQUAL(isr_flags[1], BSP430_HAL_ISR_CALLBACK_EXIT_LPM);
+  CHECK_EQUAL(isr_at[1], 10);
+}
+
+/* A callback may submit further work, whether or not transactions
+ * remain queued, and may resubmit its own descriptor */
+static void
+testSubmitFromCallback (void)
+{
+  static const uint8_t cmd[] = { 0x55 };
+  sTestTransaction a;
+  sTestTransaction b;
+  sTestTransaction c;
+  sTestTransaction d;
+
+  resetTrace();
+  initTransaction(&a, 'A', cmd, sizeof(cmd), 0, NULL, 1, 0);
+  initTransaction(&b, 'B', cmd, sizeof(cmd), 1, NULL, 1, 0);
+  initTransaction(&c, 'C', cmd, sizeof(cmd), 0, NULL, 1, 0);
+  initTransaction(&d, 'D', cmd, sizeof(cmd), 0, NULL, 1, BSP430_HAL_ISR_CALLBACK_EXIT_LPM);
+
+  /* A appends C behind the still queued B.  B first resubmits itself
+   * behind C; on its second completion the queue is empty, and the D
+   * it submits is started at once. */
+  a.submit[0] = &c;
+  b.submit[0] = &b;
+  b.submit[1] = &d;
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &a.txn), 0);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &b.txn), 0);
+  runDevice();
+
+  CHECK_EQUAL(iBSP430spiQueueIdle_ni(queue), 1);
+  CHECK_EQUAL(0 == strcmp(trace, "+A-A!A+B-B!B+C-C!C+B-B!B+D-D!D"), 1);
+  CHECK_EQUAL(nmosi, 1 + 2 + 1 + 2 + 1);
+  CHECK_EQUAL(b.completions, 2);
+  CHECK_EQUAL(b.txn.result, 2);
+  CHECK_EQUAL(d.txn.result, 1);
+  CHECK_EQUAL(nisr, 1);
+  CHECK_EQUAL(isr_at[0], 7);
+}
+
+static void
+testRelease (void)
+{
+  static const uint8_t cmd[] = { 0x00 };
+  sTestTransaction t;
+
+  /* Empty transactions are rejected */
+  initTransaction(&t, 'Z', cmd, 0, 0, NULL, 0, 0);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &t.txn), -1);
+  CHECK_EQUAL(iBSP430spiQueueIdle_ni(queue), 1);
+
+  /* A busy queue cannot be released */
+  resetTrace();
+  initTransaction(&t, 'A', cmd, sizeof(cmd), 0, NULL, 0, 0);
+  CHECK_EQUAL(iBSP430spiQueueSubmit_ni(queue, &t.txn), 0);
+  CHECK_EQUAL(iBSP430spiQueueRelease(queue), -1);
+  CHECK_EQUAL(NULL != spi->rx_cbchain_ni, 1);
+  runDevice();
+  CHECK_EQUAL(iBSP430spiQueueRelease(queue), 0);
+  CHECK_EQUAL(NULL == spi->rx_cbchain_ni, 1);
+  CHECK_EQUAL(NULL == spi->tx_cbchain_ni, 1);
+  CHECK_EQUAL(holds, 0);
+}
+
+int main (int argc,
+          char * argv[])
+{
+  testAttach();
+  testSingle();
+  testChained();
+  testSubmitFromCallback();
+  testRelease();
+  return hostCheckReport(NULL);
+}
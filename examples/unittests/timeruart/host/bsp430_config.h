@@ -0,0 +1 @@
+/* Host builds of the timer UART decoder need no configuration. */
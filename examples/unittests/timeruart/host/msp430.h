@@ -0,0 +1,24 @@
+/* Host builds need the port and timer definitions used by the
+ * hardware layer, which the host test never runs. */
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+#include "hostintrinsics.h"
+#define __MSP430_HAS_PORT1_R__
+#define __MSP430_HAS_T0A3__
+#define CM_2 0x8000
+#define CCIS_0 0x0000
+#define SCS 0x0800
+#define SCCI 0x0400
+#define CAP 0x0100
+#define OUTMOD_0 0x0000
+#define OUTMOD_1 0x0020
+#define OUTMOD_5 0x00A0
+#define CCIE 0x0010
+#define OUT 0x0004
+#define CCIFG 0x0001
+#define MC0 0x0010
+#define MC1 0x0020
+#define MC_2 0x0020
+#define TASSEL_2 0x0200
+#define TACLR 0x0004
+#endif /* HOST_MSP430_H */
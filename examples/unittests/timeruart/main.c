@@ -0,0 +1,146 @@
+/** This file is in the public domain.
+ *
+ * Validate the receive decoder of the timer UART by replaying
+ * recorded capture timestamps.  No timer is used: the edges of a
+ * 9600 baud waveform sampled by a 1 MHz timer are fed to
+ * iBSP430timeruartRxEvent_ni() exactly as the capture/compare
+ * interrupt would, with the line level at each requested sample time
+ * reconstructed from the recording.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/timeruart.h>
+
+/* Ticks per bit at 9600 baud from a 1 MHz timer */
+#define BIT_TCK 104
+
+typedef struct sEdge {
+  unsigned int tck;
+  unsigned char level;
+} sEdge;
+
+/* Line transitions from idle (high), with up to 3 ticks of jitter.
+ * The counter wraps during the first character.  Content: "OK\r\n",
+ * 0x00, a 20-tick glitch, 0xFF, 0x55, 0x41 with a low stop bit
+ * followed by a short break, then "Az" sent 2% fast. */
+static const sEdge edges[] = {
+  { 0xfe67, 0 }, { 0xfece, 1 }, { 0x006f, 0 }, { 0x0140, 1 },
+  { 0x01a8, 0 }, { 0x0214, 1 }, { 0x027c, 0 }, { 0x02e0, 1 },
+  { 0x03b0, 0 }, { 0x041d, 1 }, { 0x0485, 0 }, { 0x0552, 1 },
+  { 0x05be, 0 }, { 0x0622, 1 }, { 0x068d, 0 }, { 0x06f6, 1 },
+  { 0x075a, 0 }, { 0x07c4, 1 }, { 0x0893, 0 }, { 0x0a33, 1 },
+  { 0x0aa0, 0 }, { 0x0b70, 1 }, { 0x0bd6, 0 }, { 0x0c3d, 1 },
+  { 0x0ca6, 0 }, { 0x0e47, 1 }, { 0x0eac, 0 }, { 0x1259, 1 },
+  { 0x13f8, 0 }, { 0x140c, 1 }, { 0x14e0, 0 }, { 0x1546, 1 },
+  { 0x18ee, 0 }, { 0x195a, 1 }, { 0x19bc, 0 }, { 0x1a28, 1 },
+  { 0x1a91, 0 }, { 0x1af8, 1 }, { 0x1b61, 0 }, { 0x1bc7, 1 },
+  { 0x1c31, 0 }, { 0x1c99, 1 }, { 0x1d32, 0 }, { 0x1d9d, 1 },
+  { 0x1e05, 0 }, { 0x200c, 1 }, { 0x2077, 0 }, { 0x2214, 1 },
+  { 0x22e9, 0 }, { 0x234c, 1 }, { 0x23b2, 0 }, { 0x25b0, 1 },
+  { 0x2619, 0 }, { 0x267e, 1 }, { 0x26e6, 0 }, { 0x27b0, 1 },
+  { 0x2816, 0 }, { 0x287a, 1 }, { 0x2a12, 0 }, { 0x2a78, 1 },
+};
+
+static const int expected[] = {
+  'O', 'K', '\r', '\n', 0x00,
+  BSP430_TIMERUART_RX_IDLE,
+  0xFF, 0x55,
+  BSP430_TIMERUART_RX_FRAMING,
+  'A', 'z',
+};
+
+#define NUM_EDGES (sizeof(edges) / sizeof(*edges))
+#define NUM_EXPECTED (sizeof(expected) / sizeof(*expected))
+
+/* Offset of a timestamp from the start of the recording, so
+ * comparisons are unaffected by counter wrap. */
+#define SINCE_START(t_) ((unsigned int)((t_) - edges[0].tck))
+
+static int
+levelAt (unsigned int tck)
+{
+  int level = 1;
+  int i;
+
+  for (i = 0; (i < NUM_EDGES) && (SINCE_START(edges[i].tck) <= SINCE_START(tck)); ++i) {
+    level = edges[i].level;
+  }
+  return level;
+}
+
+/* Drive the decoder through the recording as the interrupt handler
+ * would, storing each result other than a sample request.  Returns
+ * the number of results. */
+static int
+replay (sBSP430timeruartRx * rxp,
+        int * results,
+        int max_results)
+{
+  int nresults = 0;
+  int i = 0;
+
+  while (1) {
+    int rc;
+
+    /* Capture event: the next falling edge */
+    while ((i < NUM_EDGES) && edges[i].level) {
+      ++i;
+    }
+    if (i >= NUM_EDGES) {
+      break;
+    }
+    rc = iBSP430timeruartRxEvent_ni(rxp, edges[i].tck, 0);
+
+    /* Compare events: the line is latched at each requested time */
+    while (BSP430_TIMERUART_RX_SAMPLE == rc) {
+      rc = iBSP430timeruartRxEvent_ni(rxp, rxp->sample_tck, levelAt(rxp->sample_tck));
+    }
+    if (nresults < max_results) {
+      results[nresults] = rc;
+    }
+    ++nresults;
+
+    /* Capture resumes after the last sample */
+    while ((i < NUM_EDGES) && (SINCE_START(edges[i].tck) <= SINCE_START(rxp->sample_tck))) {
+      ++i;
+    }
+  }
+  return nresults;
+}
+
+static void
+testDecoder (void)
+{
+  sBSP430timeruartRx rx;
+  int results[NUM_EXPECTED + 2];
+  int nresults;
+  int i;
+
+  /* A high level while idle is not a start edge */
+  vBSP430timeruartRxReset(&rx, BIT_TCK);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430timeruartRxEvent_ni(&rx, 100, 1), BSP430_TIMERUART_RX_IDLE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(iBSP430timeruartRxEvent_ni(&rx, 100, 0), BSP430_TIMERUART_RX_SAMPLE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(rx.sample_tck, 100 + BIT_TCK / 2);
+
+  /* The recording */
+  vBSP430timeruartRxReset(&rx, BIT_TCK);
+  nresults = replay(&rx, results, sizeof(results) / sizeof(*results));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(nresults, NUM_EXPECTED);
+  for (i = 0; (i < nresults) && (i < NUM_EXPECTED); ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(results[i], expected[i]);
+  }
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testDecoder();
+
+  vBSP430unittestFinalize();
+}
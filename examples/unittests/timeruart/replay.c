@@ -0,0 +1,257 @@
+/** This file is in the public domain.
+ *
+ * Host replay test of the timer UART receive decoder.  Capture
+ * timestamps are fed to iBSP430timeruartRxEvent_ni() exactly as the
+ * capture/compare interrupt would, with the line level at each
+ * requested sample time reconstructed from the recording.
+ *
+ * The recording of the on-target test is replayed first, placed so
+ * the counter wraps at the same point in it.  Then pseudo-random
+ * streams are generated and replayed: characters at rates from
+ * #BSP430_TIMERUART_MIN_BIT_TCK ticks per bit upwards, sent up to 2%
+ * fast or slow with jitter, separated by random idle periods, and
+ * mixed with glitches and characters with a low stop bit.  Build and
+ * run with <tt>make check-host</tt>; the exit status is nonzero on
+ * failure.
+ *
+ * An optional argument sets the number of streams, and a second the
+ * seed.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/utility/timeruart.h>
+#include <stdlib.h>
+#include "hostcheck.h"
+
+/* Events in a generated stream */
+#define STREAM_EVENTS 64
+
+/* Up to ten edges per character, two per glitch */
+#define MAX_EDGES (10 * STREAM_EVENTS)
+
+typedef struct sEdge {
+  /* Ticks since the start of the recording */
+  unsigned long at;
+  unsigned char level;
+} sEdge;
+
+static unsigned long prng_state;
+
+static sEdge edges[MAX_EDGES];
+static unsigned int nedges;
+static int expected[STREAM_EVENTS];
+static unsigned int nexpected;
+
+static unsigned long
+prng (void)
+{
+  prng_state = 1103515245UL * prng_state + 12345;
+  return (prng_state >> 16) & 0x7FFF;
+}
+
+/* The recording of the on-target test: a 9600 baud waveform sampled
+ * by a 1 MHz timer.  Content: "OK\r\n", 0x00, a 20-tick glitch, 0xFF,
+ * 0x55, 0x41 with a low stop bit followed by a short break, then
+ * "Az" sent 2% fast. */
+#define RECORDED_BIT_TCK 104
+
+static const struct {
+  uint16_t tck;
+  unsigned char level;
+} recorded[] = {
+  { 0xfe67, 0 }, { 0xfece, 1 }, { 0x006f, 0 }, { 0x0140, 1 },
+  { 0x01a8, 0 }, { 0x0214, 1 }, { 0x027c, 0 }, { 0x02e0, 1 },
+  { 0x03b0, 0 }, { 0x041d, 1 }, { 0x0485, 0 }, { 0x0552, 1 },
+  { 0x05be, 0 }, { 0x0622, 1 }, { 0x068d, 0 }, { 0x06f6, 1 },
+  { 0x075a, 0 }, { 0x07c4, 1 }, { 0x0893, 0 }, { 0x0a33, 1 },
+  { 0x0aa0, 0 }, { 0x0b70, 1 }, { 0x0bd6, 0 }, { 0x0c3d, 1 },
+  { 0x0ca6, 0 }, { 0x0e47, 1 }, { 0x0eac, 0 }, { 0x1259, 1 },
+  { 0x13f8, 0 }, { 0x140c, 1 }, { 0x14e0, 0 }, { 0x1546, 1 },
+  { 0x18ee, 0 }, { 0x195a, 1 }, { 0x19bc, 0 }, { 0x1a28, 1 },
+  { 0x1a91, 0 }, { 0x1af8, 1 }, { 0x1b61, 0 }, { 0x1bc7, 1 },
+  { 0x1c31, 0 }, { 0x1c99, 1 }, { 0x1d32, 0 }, { 0x1d9d, 1 },
+  { 0x1e05, 0 }, { 0x200c, 1 }, { 0x2077, 0 }, { 0x2214, 1 },
+  { 0x22e9, 0 }, { 0x234c, 1 }, { 0x23b2, 0 }, { 0x25b0, 1 },
+  { 0x2619, 0 }, { 0x267e, 1 }, { 0x26e6, 0 }, { 0x27b0, 1 },
+  { 0x2816, 0 }, { 0x287a, 1 }, { 0x2a12, 0 }, { 0x2a78, 1 },
+};
+
+static const int recorded_expected[] = {
+  'O', 'K', '\r', '\n', 0x00,
+  BSP430_TIMERUART_RX_IDLE,
+  0xFF, 0x55,
+  BSP430_TIMERUART_RX_FRAMING,
+  'A', 'z',
+};
+
+/* Drive the decoder through edges[] as the interrupt handler would,
+ * with the recording starting at counter value t0_tck, and compare
+ * each result other than a sample request with expected[]. */
+static void
+replay (unsigned int bit_tck,
+        unsigned int t0_tck)
+{
+  sBSP430timeruartRx rx;
+  unsigned int nresults = 0;
+  unsigned int i = 0;
+  unsigned int level_i = 0;
+  int level = 1;
+
+  vBSP430timeruartRxReset(&rx, bit_tck);
+  while (1) {
+    int rc;
+
+    /* Capture event: the next falling edge */
+    while ((i < nedges) && edges[i].level) {
+      ++i;
+    }
+    if (i >= nedges) {
+      break;
+    }
+    rc = iBSP430timeruartRxEvent_ni(&rx, t0_tck + (unsigned int)edges[i].at, 0);
+
+    /* Compare events: the line is latched at each requested time.
+     * Sample times only advance, so the level is tracked with a
+     * cursor. */
+    while (BSP430_TIMERUART_RX_SAMPLE == rc) {
+      unsigned long at = (unsigned int)(rx.sample_tck - t0_tck);
+
+      while ((level_i < nedges) && (edges[level_i].at <= at)) {
+        level = edges[level_i++].level;
+      }
+      rc = iBSP430timeruartRxEvent_ni(&rx, rx.sample_tck, level);
+    }
+    if (nresults < nexpected) {
+      CHECK_EQUAL_SIGNED(rc, expected[nresults]);
+    }
+    ++nresults;
+
+    /* Capture resumes after the last sample */
+    while ((i < nedges) && (edges[i].at <= (unsigned int)(rx.sample_tck - t0_tck))) {
+      ++i;
+    }
+  }
+  CHECK_EQUAL_SIGNED(nresults, nexpected);
+}
+
+static void
+testRecording (void)
+{
+  unsigned int i;
+
+  nedges = 0;
+  for (i = 0; i < sizeof(recorded) / sizeof(*recorded); ++i) {
+    edges[nedges].at = (uint16_t)(recorded[i].tck - recorded[0].tck);
+    edges[nedges].level = recorded[i].level;
+    ++nedges;
+  }
+  nexpected = 0;
+  for (i = 0; i < sizeof(recorded_expected) / sizeof(*recorded_expected); ++i) {
+    expected[nexpected++] = recorded_expected[i];
+  }
+  /* The 16-bit counter wrapped 0x199 ticks into the recording */
+  replay(RECORDED_BIT_TCK, 0U - (0x10000U - recorded[0].tck));
+}
+
+/* Append a transition to level at the given time, unless the line is
+ * already there. */
+static void
+addEdge (unsigned long at,
+         int level)
+{
+  if ((0 == nedges) ? (! level) : (edges[nedges - 1].level != level)) {
+    edges[nedges].at = at;
+    edges[nedges].level = level;
+    ++nedges;
+  }
+}
+
+/* Generate a stream at bit_tck ticks per bit.  The sender's bit time
+ * differs by up to 2%, and each edge is displaced by up to 1/16 bit. */
+static void
+generate (unsigned int bit_tck)
+{
+  unsigned long send_q8 = (256UL * bit_tck * (980 + prng() % 41)) / 1000;
+  unsigned int jitter_tck = bit_tck / 16;
+  unsigned long at = bit_tck + prng() % (4 * bit_tck);
+  unsigned int n;
+
+  nedges = 0;
+  nexpected = 0;
+  for (n = 0; n < STREAM_EVENTS; ++n) {
+    unsigned int kind = prng() % 16;
+
+    if (0 == kind) {
+      /* A low pulse too short to be a start bit */
+      unsigned long width = 1 + prng() % (bit_tck / 2 - jitter_tck - 1);
+
+      addEdge(at, 0);
+      addEdge(at + width, 1);
+      expected[nexpected++] = BSP430_TIMERUART_RX_IDLE;
+      at += width;
+    } else {
+      /* A character, with a low stop bit if kind is 1 */
+      unsigned int c = prng() & 0xFF;
+      unsigned int frame = ((1 == kind) ? 0 : 0x200) | (c << 1);
+      int k;
+
+      for (k = 0; k < 10; ++k) {
+        int j = (int)(prng() % (2 * jitter_tck + 1)) - (int)jitter_tck;
+
+        addEdge(at + ((k * send_q8) >> 8) + ((0 == k) ? 0 : j), (frame >> k) & 1);
+      }
+      addEdge(at + ((10 * send_q8) >> 8), 1);
+      expected[nexpected++] = (1 == kind) ? BSP430_TIMERUART_RX_FRAMING : (int)c;
+      at += (10 * send_q8) >> 8;
+    }
+    /* Idle for between one and four bit times */
+    at += bit_tck + prng() % (3 * bit_tck);
+  }
+}
+
+static void
+testGenerated (unsigned long nstreams)
+{
+  unsigned long n;
+
+  for (n = 0; n < nstreams; ++n) {
+    unsigned int bit_tck;
+    unsigned int t0_tck;
+
+    switch (n % 3) {
+      case 0:
+        bit_tck = BSP430_TIMERUART_MIN_BIT_TCK + prng() % 32;
+        break;
+      case 1:
+        bit_tck = 64 + prng() % 1024;
+        break;
+      default:
+        bit_tck = 1024 + (prng() << 2) % 30000;
+        break;
+    }
+    /* Start the stream close enough to the counter limit that it
+     * usually wraps */
+    t0_tck = 0U - (unsigned int)(prng() * (unsigned long)bit_tck / 64);
+    generate(bit_tck);
+    replay(bit_tck, t0_tck);
+  }
+}
+
+int main (int argc,
+          char * argv[])
+{
+  unsigned long nstreams = 20000;
+
+  prng_state = 1;
+  if (1 < argc) {
+    nstreams = strtoul(argv[1], NULL, 0);
+  }
+  if (2 < argc) {
+    prng_state = strtoul(argv[2], NULL, 0);
+  }
+  testRecording();
+  testGenerated(nstreams);
+  return hostCheckReport(NULL);
+}
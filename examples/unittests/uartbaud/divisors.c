@@ -0,0 +1,187 @@
+/** This file is in the public domain.
+ *
+ * Host check of the UART baud rate divisor macros.  As in the
+ * on-target test, a table of register settings is generated at
+ * compile time for each nominal clock and standard baud rate and
+ * compared with the settings the runtime path of
+ * hBSP430serialOpenUART() computes from the same values, and, for the
+ * combinations that function accepts, with a reference calculation
+ * that uses the exact ratio.  The program is built once for each
+ * serial peripheral family, selected by defining HOST_SERIAL_EUSCI,
+ * HOST_SERIAL_USCI5, or HOST_SERIAL_USCI.  Build and run with
+ * <tt>make check-host</tt>; the exit status is nonzero on failure.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/serial.h>
+#include "hostcheck.h"
+
+/* UART_DIVISOR_BITS is the width of the largest integer divisor
+ * hBSP430serialOpenUART() accepts */
+#if BSP430_MODULE_EUSCI - 0
+#define UART_BRW(q_) BSP430_EUSCI_UART_BRW(q_)
+#define UART_MCTL(q_) BSP430_EUSCI_UART_MCTLW(q_)
+#define UART_DIVISOR_BITS 20
+#define FAMILY "eUSCI"
+#elif BSP430_MODULE_USCI5 - 0
+#define UART_BRW(q_) BSP430_USCI5_UART_BRW(q_)
+#define UART_MCTL(q_) BSP430_USCI5_UART_MCTL(q_)
+#define UART_DIVISOR_BITS 16
+#define FAMILY "USCI5"
+#elif BSP430_MODULE_USCI - 0
+#define UART_BRW(q_) BSP430_USCI_UART_BRW(q_)
+#define UART_MCTL(q_) BSP430_USCI_UART_MCTL(q_)
+#define UART_DIVISOR_BITS 16
+#define FAMILY "USCI"
+#else
+#error Define one of HOST_SERIAL_EUSCI, HOST_SERIAL_USCI5, HOST_SERIAL_USCI
+#endif
+
+/* As CHECK_EQUAL(), identifying the divisor being checked */
+#define CHECK_DIVISOR(got_, expected_, dp_) do {                        \
+    unsigned long got = (got_);                                         \
+    unsigned long exp = (expected_);                                    \
+    if (hostCheckFailed(got != exp)) {                                  \
+      fprintf(stderr, "%s:%d: %lu Hz %lu baud: %s: got %#lx expected %#lx\n", \
+              __FILE__, __LINE__, (dp_)->brclk_Hz, (dp_)->baud,         \
+              #got_, got, exp);                                         \
+    }                                                                   \
+  } while (0)
+
+typedef struct sDivisor {
+  unsigned long brclk_Hz;
+  unsigned long baud;
+  unsigned int brw;
+  unsigned int mctl;
+} sDivisor;
+
+#define DIVISOR(brclk_Hz_, baud_) {                                     \
+    brclk_Hz_, baud_,                                                   \
+    UART_BRW(BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz_, baud_)),         \
+    UART_MCTL(BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz_, baud_)) }
+
+#define STANDARD_BAUDS(brclk_Hz_)                                       \
+  DIVISOR(brclk_Hz_, 300UL), DIVISOR(brclk_Hz_, 600UL),                 \
+  DIVISOR(brclk_Hz_, 1200UL), DIVISOR(brclk_Hz_, 2400UL),               \
+  DIVISOR(brclk_Hz_, 4800UL), DIVISOR(brclk_Hz_, 9600UL),               \
+  DIVISOR(brclk_Hz_, 14400UL), DIVISOR(brclk_Hz_, 19200UL),             \
+  DIVISOR(brclk_Hz_, 38400UL), DIVISOR(brclk_Hz_, 57600UL),             \
+  DIVISOR(brclk_Hz_, 115200UL), DIVISOR(brclk_Hz_, 230400UL),           \
+  DIVISOR(brclk_Hz_, 460800UL), DIVISOR(brclk_Hz_, 921600UL),           \
+  DIVISOR(brclk_Hz_, 1000000UL)
+
+/* Static initializers must be constant expressions, so this table is
+ * entirely computed by the compiler.  The clocks are the nominal
+ * ACLK and the SMCLK rates the platforms configure. */
+static const sDivisor divisors[] = {
+  STANDARD_BAUDS(32768UL),
+  STANDARD_BAUDS(1000000UL),
+  STANDARD_BAUDS(1048576UL),
+  STANDARD_BAUDS(4000000UL),
+  STANDARD_BAUDS(4194304UL),
+  STANDARD_BAUDS(8000000UL),
+  STANDARD_BAUDS(8388608UL),
+  STANDARD_BAUDS(12000000UL),
+  STANDARD_BAUDS(16000000UL),
+  STANDARD_BAUDS(20000000UL),
+  STANDARD_BAUDS(24000000UL),
+  STANDARD_BAUDS(25000000UL),
+};
+
+#if BSP430_MODULE_EUSCI - 0
+/* UCBRSx selection from the family user's guide, with thresholds in
+ * units of 1/10000. */
+static const struct {
+  unsigned int fraction_e4;
+  unsigned char brs;
+} brs_table[] = {
+  { 9288, 0xFE }, { 9170, 0xFD }, { 9004, 0xFB }, { 8751, 0xF7 },
+  { 8572, 0xEF }, { 8464, 0xDF }, { 8333, 0xBF }, { 8004, 0xEE },
+  { 7861, 0xED }, { 7503, 0xDD }, { 7147, 0xBB }, { 7001, 0xB7 },
+  { 6667, 0xD6 }, { 6432, 0xB6 }, { 6254, 0xB5 }, { 6003, 0xAD },
+  { 5715, 0x6B }, { 5002, 0xAA }, { 4378, 0x55 }, { 4286, 0x53 },
+  { 4003, 0x92 }, { 3753, 0x52 }, { 3575, 0x4A }, { 3335, 0x49 },
+  { 3000, 0x25 }, { 2503, 0x44 }, { 2224, 0x22 }, { 2147, 0x21 },
+  { 1670, 0x11 }, { 1430, 0x20 }, { 1252, 0x10 }, { 1001, 0x08 },
+  { 835, 0x04 }, { 715, 0x02 }, { 529, 0x01 }, { 0, 0x00 },
+};
+
+static void
+referenceDivisor (unsigned long brclk_Hz,
+                  unsigned long baud,
+                  unsigned int * brwp,
+                  unsigned int * mctlp)
+{
+  unsigned long n = brclk_Hz / baud;
+  unsigned long long rem_e4 = 10000ULL * (brclk_Hz % baud);
+  unsigned int i = 0;
+
+  *mctlp = 0;
+  *brwp = n;
+  if (16 <= n) {
+    *brwp = n / 16;
+    *mctlp = UCOS16 | ((n % 16) * UCBRF0);
+  }
+  while (rem_e4 < (unsigned long long)brs_table[i].fraction_e4 * baud) {
+    ++i;
+  }
+  *mctlp |= brs_table[i].brs * UCBRS0;
+}
+#else /* EUSCI */
+/* The calculation used by hBSP430usci5OpenUART() and
+ * hBSP430usciOpenUART() before the divisor macros were introduced */
+static void
+referenceDivisor (unsigned long brclk_Hz,
+                  unsigned long baud,
+                  unsigned int * brwp,
+                  unsigned int * mctlp)
+{
+  unsigned int brw = brclk_Hz / baud;
+  unsigned int brs = (1 + 16 * (brclk_Hz - baud * brw) / baud) / 2;
+
+  *brwp = brw;
+  *mctlp = (0 * UCBRF0) | (brs * UCBRS0);
+}
+#endif /* EUSCI */
+
+static void
+testDivisors (void)
+{
+  const sDivisor * dp = divisors;
+  const sDivisor * const edp = divisors + sizeof(divisors) / sizeof(*divisors);
+
+  while (dp < edp) {
+    /* Volatile prevents the compiler from folding the runtime path */
+    volatile unsigned long brclk_Hz = dp->brclk_Hz;
+    volatile unsigned long baud = dp->baud;
+    unsigned long divisor_q12 = BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz, baud);
+    unsigned int brw;
+    unsigned int mctl;
+
+    CHECK_DIVISOR(UART_BRW(divisor_q12), dp->brw, dp);
+    CHECK_DIVISOR(UART_MCTL(divisor_q12), dp->mctl, dp);
+
+    /* The host long may be wider than the MCU's: confirm the
+     * fraction term is developed without exceeding 32 bits */
+    CHECK_DIVISOR((((unsigned long long)(dp->brclk_Hz % dp->baud)) << 12) >> 32, 0, dp);
+
+    /* Only combinations accepted by hBSP430serialOpenUART() need
+     * match the reference */
+    if ((dp->brclk_Hz >> UART_DIVISOR_BITS) < dp->baud) {
+      CHECK_DIVISOR(divisor_q12 >> 12, dp->brclk_Hz / dp->baud, dp);
+      referenceDivisor(brclk_Hz, baud, &brw, &mctl);
+      CHECK_DIVISOR(brw, dp->brw, dp);
+      CHECK_DIVISOR(mctl, dp->mctl, dp);
+    }
+    ++dp;
+  }
+}
+
+int main (int argc,
+          char * argv[])
+{
+  testDivisors();
+  return hostCheckReport(FAMILY);
+}
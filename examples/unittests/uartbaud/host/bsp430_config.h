@@ -0,0 +1,3 @@
+/* Host builds of the divisor check need only the UART interface,
+ * which declares the divisor macros. */
+#define configBSP430_SERIAL_ENABLE_UART 1
@@ -0,0 +1,23 @@
+/* Host builds select one serial peripheral family with
+ * HOST_SERIAL_EUSCI, HOST_SERIAL_USCI5, or HOST_SERIAL_USCI, and get
+ * the UART modulation register fields of that family. */
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+#include "hostintrinsics.h"
+#if HOST_SERIAL_EUSCI - 0
+#define __MSP430_HAS_EUSCI_A0__
+#define UCOS16 0x0001
+#define UCBRF0 0x0010
+#define UCBRS0 0x0100
+#elif HOST_SERIAL_USCI5 - 0
+#define __MSP430_HAS_USCI_A0__
+#define UCOS16 0x01
+#define UCBRF0 0x10
+#define UCBRS0 0x02
+#elif HOST_SERIAL_USCI - 0
+#define __MSP430_HAS_USCI__
+#define UCOS16 0x01
+#define UCBRF0 0x10
+#define UCBRS0 0x02
+#endif
+#endif /* HOST_MSP430_H */
@@ -0,0 +1,94 @@
+/** This file is in the public domain.
+ *
+ * Compare the cost of logging a message with cprintf() and with
+ * BSP430_BINLOG().  Each round times a batch of calls of each kind
+ * that fit in the console transmit buffer, then waits for the buffer
+ * to drain so transmission time is not measured.  The average number
+ * of MCLK cycles per call is reported.
+ *
+ * The binary records are not readable on a terminal.  Capture the
+ * output and decode it with:
+ *
+ * @code
+ * maintainer/binlogdecode.py app.elf capture.raw
+ * @endcode
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/binlog.h>
+
+/* Calls per batch; each batch must fit in the transmit buffer */
+#define APP_BATCH 4
+
+/* Batches per measurement */
+#define APP_ROUNDS 32
+
+static unsigned long
+cycles_per_call (unsigned long ticks,
+                 unsigned long mclk_Hz,
+                 unsigned long utt_Hz)
+{
+  /* Scale ticks to cycles in two steps to avoid overflow */
+  return (ticks * (mclk_Hz / 1000)) / (utt_Hz / 1000) / (APP_BATCH * APP_ROUNDS);
+}
+
+void main ()
+{
+  unsigned long mclk_Hz;
+  unsigned long utt_Hz;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\nLogging cost: cprintf vs binary log, tx buffer %u\n",
+          BSP430_CONSOLE_TX_BUFFER_SIZE);
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    unsigned long text_utt = 0;
+    unsigned long binlog_utt = 0;
+    unsigned int dropped;
+    int r;
+    int i;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    mclk_Hz = ulBSP430clockMCLK_Hz_ni();
+    utt_Hz = ulBSP430uptimeConversionFrequency_Hz_ni();
+    (void)uiBSP430binlogDropped_ni(1);
+    BSP430_CORE_ENABLE_INTERRUPT();
+
+    for (r = 0; r < APP_ROUNDS; ++r) {
+      unsigned long t0;
+
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        cprintf("%d: temp %d adc 0x%04x\n", i, -40 + r, 0x1234U * i);
+      }
+      text_utt += ulBSP430uptime() - t0;
+      (void)iBSP430consoleFlush();
+
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        BSP430_BINLOG("%d: temp %d adc 0x%04x\n", i, -40 + r, 0x1234U * i);
+      }
+      binlog_utt += ulBSP430uptime() - t0;
+      (void)iBSP430consoleFlush();
+    }
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    dropped = uiBSP430binlogDropped_ni(0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+    cprintf("\n%u calls each: cprintf %lu cycles/call, binlog %lu cycles/call, %u dropped\n",
+            APP_BATCH * APP_ROUNDS,
+            cycles_per_call(text_utt, mclk_Hz, utt_Hz),
+            cycles_per_call(binlog_utt, mclk_Hz, utt_Hz),
+            dropped);
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ);
+  }
+}
@@ -8,8 +8,11 @@
 /* Support console output */
 #define configBSP430_CONSOLE 1
 
-/* Enable an 8-character rx buffer for the console */
-#define BSP430_CONSOLE_RX_BUFFER_SIZE 8
+/* Enable a 64-character rx buffer for the console, assembling lines
+ * in the receive interrupt so the application wakes once per
+ * command */
+#define BSP430_CONSOLE_RX_BUFFER_SIZE 64
+#define configBSP430_CONSOLE_RX_LINE_MODE 1
 
 /* Enable an 80-character command buffer */
 #define BSP430_CLI_CONSOLE_BUFFER_SIZE 80
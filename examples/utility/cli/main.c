@@ -344,6 +344,9 @@ void main ()
   (void)iBSP430consoleInitialize();
   vBSP430cliSetDiagnosticFunction(iBSP430cliConsoleDiagnostic);
   cprintf("\n\n\nAnd we're up and running.\n");
+  if (0 <= iBSP430consoleSetRxLineMode_ni(1)) {
+    cprintf("Input is assembled into lines by the console.\n");
+  }
 #if configBSP430_CLI_COMMAND_COMPLETION - 0
   cprintf("Command completion is available.\n");
 #endif /* configBSP430_CLI_COMMAND_COMPLETION */
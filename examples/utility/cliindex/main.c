@@ -0,0 +1,189 @@
+/** This file is in the public domain.
+ *
+ * Compare the cost of dispatching commands from a large command set
+ * by linear search and through a sorted command index.  The index in
+ * cli_index.h is generated from this file by maintainer/cliindex.py
+ * when the application is built.
+ *
+ * Each round executes a batch of command lines, including unique
+ * prefixes, whole keys, ambiguous prefixes, and unrecognized
+ * commands, first without and then with the index registered.  The
+ * average number of MCLK cycles per command is reported.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/cli.h>
+
+/* Batches per measurement */
+#define APP_ROUNDS 16
+
+static int
+cmd_nop (sBSP430cliCommandLink * chain,
+         void * param,
+         const char * argstr,
+         size_t argstr_len)
+{
+  return 0;
+}
+
+/* A command linked to the previously declared one */
+#define APP_COMMAND(key_, next_)                                        \
+  static const sBSP430cliCommand dcmd_##key_ = {                        \
+    .key = #key_,                                                       \
+    .handler = cmd_nop,                                                 \
+    .next = next_                                                       \
+  }
+
+APP_COMMAND(adc, NULL);
+APP_COMMAND(alarm, &dcmd_adc);
+APP_COMMAND(baud, &dcmd_alarm);
+APP_COMMAND(battery, &dcmd_baud);
+APP_COMMAND(beep, &dcmd_battery);
+APP_COMMAND(boot, &dcmd_beep);
+APP_COMMAND(bsl, &dcmd_boot);
+APP_COMMAND(calib, &dcmd_bsl);
+APP_COMMAND(clock, &dcmd_calib);
+APP_COMMAND(config, &dcmd_clock);
+APP_COMMAND(cpu, &dcmd_config);
+APP_COMMAND(crc, &dcmd_cpu);
+APP_COMMAND(date, &dcmd_crc);
+APP_COMMAND(debug, &dcmd_date);
+APP_COMMAND(dma, &dcmd_debug);
+APP_COMMAND(dump, &dcmd_dma);
+APP_COMMAND(echo, &dcmd_dump);
+APP_COMMAND(erase, &dcmd_echo);
+APP_COMMAND(event, &dcmd_erase);
+APP_COMMAND(fault, &dcmd_event);
+APP_COMMAND(flash, &dcmd_fault);
+APP_COMMAND(freq, &dcmd_flash);
+APP_COMMAND(gain, &dcmd_freq);
+APP_COMMAND(gpio, &dcmd_gain);
+APP_COMMAND(heap, &dcmd_gpio);
+APP_COMMAND(i2c, &dcmd_heap);
+APP_COMMAND(id, &dcmd_i2c);
+APP_COMMAND(irq, &dcmd_id);
+APP_COMMAND(led, &dcmd_irq);
+APP_COMMAND(log, &dcmd_led);
+APP_COMMAND(lpm, &dcmd_log);
+APP_COMMAND(mem, &dcmd_lpm);
+APP_COMMAND(modem, &dcmd_mem);
+APP_COMMAND(mpu, &dcmd_modem);
+APP_COMMAND(nvm, &dcmd_mpu);
+APP_COMMAND(osc, &dcmd_nvm);
+APP_COMMAND(pid, &dcmd_osc);
+APP_COMMAND(pin, &dcmd_pid);
+APP_COMMAND(pmm, &dcmd_pin);
+APP_COMMAND(port, &dcmd_pmm);
+APP_COMMAND(power, &dcmd_port);
+APP_COMMAND(pwm, &dcmd_power);
+APP_COMMAND(radio, &dcmd_pwm);
+APP_COMMAND(reg, &dcmd_radio);
+APP_COMMAND(reset, &dcmd_reg);
+APP_COMMAND(rtc, &dcmd_reset);
+APP_COMMAND(sensor, &dcmd_rtc);
+APP_COMMAND(sleep, &dcmd_sensor);
+APP_COMMAND(spi, &dcmd_sleep);
+APP_COMMAND(stack, &dcmd_spi);
+APP_COMMAND(stats, &dcmd_stack);
+APP_COMMAND(status, &dcmd_stats);
+APP_COMMAND(stop, &dcmd_status);
+APP_COMMAND(sync, &dcmd_stop);
+APP_COMMAND(task, &dcmd_sync);
+APP_COMMAND(temp, &dcmd_task);
+APP_COMMAND(test, &dcmd_temp);
+APP_COMMAND(tick, &dcmd_test);
+APP_COMMAND(timer, &dcmd_tick);
+APP_COMMAND(trace, &dcmd_timer);
+APP_COMMAND(tune, &dcmd_trace);
+APP_COMMAND(uart, &dcmd_tune);
+APP_COMMAND(uptime, &dcmd_uart);
+APP_COMMAND(vcore, &dcmd_uptime);
+APP_COMMAND(volt, &dcmd_vcore);
+APP_COMMAND(watch, &dcmd_volt);
+APP_COMMAND(wdt, &dcmd_watch);
+APP_COMMAND(xtal, &dcmd_wdt);
+#define LAST_COMMAND (&dcmd_xtal)
+
+#if ! (BSP430_CLI_COMMAND_INDEX_GENERATE - 0)
+#include "cli_index.h"
+#endif /* BSP430_CLI_COMMAND_INDEX_GENERATE */
+
+static const char * const commands[] = {
+  "temp", "ua 9600", "xtal", "adc 3", "sta", "pw 50",
+  "st", "reset now", "nosuch", "gpio 1.2 hi", "vc 2", "i",
+};
+
+#define APP_BATCH (sizeof(commands) / sizeof(*commands))
+
+static unsigned long
+cycles_per_call (unsigned long ticks,
+                 unsigned long mclk_Hz,
+                 unsigned long utt_Hz)
+{
+  /* Scale ticks to cycles in two steps to avoid overflow */
+  return (ticks * (mclk_Hz / 1000)) / (utt_Hz / 1000) / (APP_BATCH * APP_ROUNDS);
+}
+
+static unsigned long
+time_batches (void)
+{
+  unsigned long utt = 0;
+  int r;
+  int i;
+
+  for (r = 0; r < APP_ROUNDS; ++r) {
+    unsigned long t0 = ulBSP430uptime();
+
+    for (i = 0; i < APP_BATCH; ++i) {
+      (void)iBSP430cliExecuteCommand(LAST_COMMAND, NULL, commands[i]);
+    }
+    utt += ulBSP430uptime() - t0;
+  }
+  return utt;
+}
+
+void main ()
+{
+  const sBSP430cliCommand * cmd;
+  unsigned int ncommands = 0;
+  unsigned long mclk_Hz;
+  unsigned long utt_Hz;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  for (cmd = LAST_COMMAND; cmd; cmd = cmd->next) {
+    ++ncommands;
+  }
+  cprintf("\nCommand dispatch: linear vs sorted index, %u commands\n", ncommands);
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    unsigned long linear_utt;
+    unsigned long index_utt;
+    int rc;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    mclk_Hz = ulBSP430clockMCLK_Hz_ni();
+    utt_Hz = ulBSP430uptimeConversionFrequency_Hz_ni();
+    BSP430_CORE_ENABLE_INTERRUPT();
+
+    (void)iBSP430cliSetCommandIndex(NULL, 0);
+    linear_utt = time_batches();
+    rc = iBSP430cliSetCommandIndex(cli_index, sizeof(cli_index) / sizeof(*cli_index));
+    index_utt = time_batches();
+
+    cprintf("%u commands each: linear %lu cycles/command, index %lu cycles/command%s\n",
+            APP_BATCH * APP_ROUNDS,
+            cycles_per_call(linear_utt, mclk_Hz, utt_Hz),
+            cycles_per_call(index_utt, mclk_Hz, utt_Hz),
+            (0 == rc) ? "" : " (index rejected)");
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ);
+  }
+}
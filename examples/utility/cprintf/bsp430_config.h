@@ -0,0 +1,29 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Monitor uptime and provide generic ACLK-driven timer */
+#define configBSP430_UPTIME 1
+
+/* Interrupt-driven console output */
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 64
+
+/* Build with EXT_CPPFLAGS=-DBSP430_CONSOLE_FORMAT_BUFFER_SIZE=0 to
+ * compare against formatting with interrupts disabled */
+#ifndef BSP430_CONSOLE_FORMAT_BUFFER_SIZE
+#define BSP430_CONSOLE_FORMAT_BUFFER_SIZE 48
+#endif /* BSP430_CONSOLE_FORMAT_BUFFER_SIZE */
+
+/* A CC block on the uptime timer that measures interrupt latency.
+ * Don't use CC0; we didn't ask for
+ * configBSP430_UPTIME_USE_DEFAULT_CC0_ISR. */
+#define APP_UPTIME_CC_INDEX 1
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,95 @@
+/** This file is in the public domain.
+ *
+ * Measure the longest time cprintf() holds off interrupts.  A
+ * capture/compare block on the uptime timer requests an interrupt
+ * every few ticks, and its handler records how late it ran relative
+ * to the compare time.  The worst lateness observed while the main
+ * loop prints a batch of long formatted lines bounds the time
+ * interrupts were disabled, to within one uptime tick.  Build once
+ * normally and once with
+ * EXT_CPPFLAGS=-DBSP430_CONSOLE_FORMAT_BUFFER_SIZE=0 to compare
+ * formatting into the scratch buffer with formatting directly to the
+ * console.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/periph/timer.h>
+
+#define APP_LINES 16
+
+/* Interval between latency probes, in uptime ticks */
+#define APP_PERIOD_UTT 8
+
+typedef struct sLatency {
+  sBSP430halISRIndexedChainNode cb;
+  unsigned int max_late_utt;
+} sLatency;
+
+static int
+latency_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                void * context,
+                int idx)
+{
+  sLatency * lp = (sLatency *)cb;
+  hBSP430halTIMER timer = (hBSP430halTIMER)context;
+  unsigned int now_utt = ulBSP430uptime_ni();
+  unsigned int late_utt = now_utt - timer->hpl->ccr[idx];
+
+  if (late_utt > lp->max_late_utt) {
+    lp->max_late_utt = late_utt;
+  }
+  /* Schedule from now so a long hold-off does not miss the compare */
+  timer->hpl->ccr[idx] = now_utt + APP_PERIOD_UTT;
+  return 0;
+}
+
+static sLatency latency = {
+  .cb = { .callback = latency_isr_ni },
+};
+
+void main ()
+{
+  hBSP430halTIMER timer;
+  unsigned long utt_Hz;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\ncprintf interrupt hold-off: format buffer %u, tx buffer %u\n",
+          BSP430_CONSOLE_FORMAT_BUFFER_SIZE, BSP430_CONSOLE_TX_BUFFER_SIZE);
+
+  timer = xBSP430uptimeTimer();
+  utt_Hz = ulBSP430uptimeConversionFrequency_Hz_ni();
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, timer->cc_cbchain_ni[APP_UPTIME_CC_INDEX], latency.cb, next_ni);
+  timer->hpl->ccr[APP_UPTIME_CC_INDEX] = ulBSP430uptime_ni() + APP_PERIOD_UTT;
+  timer->hpl->cctl[APP_UPTIME_CC_INDEX] = CCIE;
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    unsigned int max_late_utt;
+    int i;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    latency.max_late_utt = 0;
+    BSP430_CORE_ENABLE_INTERRUPT();
+    for (i = 0; i < APP_LINES; ++i) {
+      cprintf("%2d: %5u 0x%04x %11ld %10lu [%-12s] [%12s]\n",
+              i, 1000U * i, 0x1234U * i, -123456789L * i, 987654321UL / (1 + i),
+              "left", "right");
+    }
+    (void)iBSP430consoleFlush();
+    BSP430_CORE_DISABLE_INTERRUPT();
+    max_late_utt = latency.max_late_utt;
+    BSP430_CORE_ENABLE_INTERRUPT();
+
+    cprintf("Worst hold-off over %u lines: %u ticks, %lu us\n",
+            APP_LINES, max_late_utt, (1000000UL * max_late_utt) / utt_Hz);
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ);
+  }
+}
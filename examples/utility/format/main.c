@@ -0,0 +1,135 @@
+/** This file is in the public domain.
+ *
+ * Compare the cost of formatting numbers with the C library and with
+ * <bsp430/utility/format.h>.  Three measurements are made:
+ *
+ * @li converting a signed 32-bit value to decimal text in memory,
+ * with sprintf() and with uiBSP430formatSigned();
+ * @li the same with ltoa(), where libc provides it;
+ * @li emitting a telemetry line holding a temperature in tenths of a
+ * degree and an ADC sample, with cprintf() and with cputtext_ni() of
+ * the text from uiBSP430formatScaled() and uiBSP430formatHex().  Each
+ * batch of lines fits in the console transmit buffer, which is
+ * drained between batches so transmission time is not measured.
+ *
+ * The average number of MCLK cycles per call is reported.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/format.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Calls per batch; each batch of telemetry lines must fit in the
+ * transmit buffer */
+#define APP_BATCH 8
+
+/* Batches per measurement */
+#define APP_ROUNDS 32
+
+/* Values converted in memory, spanning the digit counts */
+static const long values[APP_BATCH] = {
+  7, -42, 1234, -32768L, 65535L, 1000000L, -87654321L, 2147483647L,
+};
+
+static unsigned long
+cycles_per_call (unsigned long ticks,
+                 unsigned long mclk_Hz,
+                 unsigned long utt_Hz)
+{
+  /* Scale ticks to cycles in two steps to avoid overflow */
+  return (ticks * (mclk_Hz / 1000)) / (utt_Hz / 1000) / (APP_BATCH * APP_ROUNDS);
+}
+
+void main ()
+{
+  unsigned long mclk_Hz;
+  unsigned long utt_Hz;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\nFormatting cost: libc vs utility/format, hardware multiply %s\n",
+          configBSP430_FORMAT_USE_HWMULT ? "used" : "not used");
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  while (1) {
+    char buf[BSP430_FORMAT_BUFFER_SIZE];
+    unsigned long sprintf_utt = 0;
+    unsigned long ltoa_utt = 0;
+    unsigned long format_utt = 0;
+    unsigned long cprintf_utt = 0;
+    unsigned long cput_utt = 0;
+    int r;
+    int i;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    mclk_Hz = ulBSP430clockMCLK_Hz_ni();
+    utt_Hz = ulBSP430uptimeConversionFrequency_Hz_ni();
+    BSP430_CORE_ENABLE_INTERRUPT();
+
+    for (r = 0; r < APP_ROUNDS; ++r) {
+      int temp_dC = -400 + 37 * r;
+      unsigned long t0;
+
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        (void)sprintf(buf, "%ld", values[i]);
+      }
+      sprintf_utt += ulBSP430uptime() - t0;
+
+#if configBSP430_CONSOLE_LIBC_HAS_LTOA - 0
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        (void)ltoa(values[i], buf, 10);
+      }
+      ltoa_utt += ulBSP430uptime() - t0;
+#endif /* configBSP430_CONSOLE_LIBC_HAS_LTOA */
+
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        (void)uiBSP430formatSigned(buf, values[i], 0);
+      }
+      format_utt += ulBSP430uptime() - t0;
+
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        cprintf("temp %d.%d adc 0x%03x\n", temp_dC / 10, abs(temp_dC % 10), 0x123U * i);
+      }
+      cprintf_utt += ulBSP430uptime() - t0;
+      (void)iBSP430consoleFlush();
+
+      t0 = ulBSP430uptime();
+      for (i = 0; i < APP_BATCH; ++i) {
+        BSP430_CORE_DISABLE_INTERRUPT();
+        cputtext_ni("temp ");
+        (void)uiBSP430formatScaled(buf, temp_dC, 1, 0);
+        cputtext_ni(buf);
+        cputtext_ni(" adc 0x");
+        (void)uiBSP430formatHex(buf, 0x123U * i, 3 | BSP430_FORMAT_FLAG_ZERO_PAD);
+        cputtext_ni(buf);
+        cputchar_ni('\n');
+        BSP430_CORE_ENABLE_INTERRUPT();
+      }
+      cput_utt += ulBSP430uptime() - t0;
+      (void)iBSP430consoleFlush();
+    }
+
+    cprintf("\n%u calls each, cycles/call:\n"
+            "  decimal: sprintf %lu, ltoa %lu, format %lu\n"
+            "  telemetry line: cprintf %lu, format %lu\n",
+            APP_BATCH * APP_ROUNDS,
+            cycles_per_call(sprintf_utt, mclk_Hz, utt_Hz),
+            cycles_per_call(ltoa_utt, mclk_Hz, utt_Hz),
+            cycles_per_call(format_utt, mclk_Hz, utt_Hz),
+            cycles_per_call(cprintf_utt, mclk_Hz, utt_Hz),
+            cycles_per_call(cput_utt, mclk_Hz, utt_Hz));
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ);
+  }
+}
@@ -421,6 +421,28 @@
 #define BSP430_CORE_DISABLE_INTERRUPT() __disable_interrupt()
 #endif /* BSP430_CORE_DISABLE_INTERRUPT */
 
+/** @def BSP430_CORE_MEMORY_BARRIER()
+ *
+ * Prevent the compiler from moving memory accesses across this
+ * point.  Data shared with an interrupt handler without disabling
+ * interrupts, such as the contents of a utility/ring buffer, must be
+ * completely written before the index that makes it visible is
+ * updated.  @c volatile orders only the index accesses themselves.
+ *
+ * When a hardware-independent module is compiled for a host, e.g. to
+ * test it with threads, this is a full fence.
+ *
+ * @defaulted */
+#ifndef BSP430_CORE_MEMORY_BARRIER
+#if (BSP430_CORE_TOOLCHAIN_GCC - 0) && defined(__MSP430__)
+#define BSP430_CORE_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+#elif BSP430_CORE_TOOLCHAIN_GCC - 0
+#define BSP430_CORE_MEMORY_BARRIER() __sync_synchronize()
+#else /* TOOLCHAIN */
+#define BSP430_CORE_MEMORY_BARRIER() __memory_changed()
+#endif /* TOOLCHAIN */
+#endif /* BSP430_CORE_MEMORY_BARRIER */
+
 /* See <bsp430/rtos/freertos.h> */
 #if configBSP430_RTOS_FREERTOS - 0
 /* FreeRTOS defines application behavior in a shared header.  Read it
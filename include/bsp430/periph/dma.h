@@ -0,0 +1,565 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * @brief Hardware presentation/abstraction for the DMA controller (DMA)
+ *
+ * The direct memory access controller is available on many 5xx/6xx
+ * and FR5xx MCUs, and supports three or more independent channels
+ * that move bytes or words between memory and peripheral registers
+ * without CPU intervention.  Each channel is triggered by a
+ * peripheral-specific event selected through the DMACTLx registers.
+ *
+ * Only the DMA controller found in 5xx/6xx/FR5xx MCUs (@c DMAX_3 and
+ * @c DMAX_6) is supported.  The 1xx/2xx/4xx DMA has a different
+ * register layout and trigger encoding, and is not recognized by this
+ * module.
+ *
+ * Conventional peripheral handle is #BSP430_PERIPH_DMA.  The handle
+ * is available only when the corresponding @HPL is requested.
+ *
+ * @section h_periph_dma_opt Module Configuration Options
+ *
+ * @li #configBSP430_HPL_DMA to enable the HPL handle declarations
+ *
+ * @li #configBSP430_HAL_DMA to enable the HAL infrastructure
+ *
+ * @li #configBSP430_HAL_DMA_ISR to enable the HAL ISR for channel
+ * completion events
+ *
+ * @section h_periph_dma_hpl Hardware Presentation Layer
+ *
+ * The controller register map is described by #sBSP430hplDMA, which
+ * includes the trigger select registers, the interrupt vector, and an
+ * array of #sBSP430hplDMAChannel structures.  Space is reserved for
+ * eight channels, but only the ones supported by the device
+ * (#BSP430_DMA_CHANNEL_COUNT) should be accessed.
+ *
+ * @section h_periph_dma_hal Hardware Adaptation Layer
+ *
+ * The DMA @HAL uses the sBSP430halDMA structure.
+ *
+ * Channels are a shared resource.  Code that wishes to use a channel
+ * should obtain it through iBSP430dmaChannelAllocate_ni() and return
+ * it with iBSP430dmaChannelRelease_ni() when done.  Allocation is
+ * advisory: the HAL does not prevent direct manipulation of the
+ * registers of a channel that has not been allocated.
+ *
+ * A channel is prepared with iBSP430dmaChannelConfigure_ni(), which
+ * records the trigger source, the addresses, the transfer size, and
+ * the transfer mode (single, block, burst-block, or the repeated
+ * variants of these).  The transfer is armed by
+ * iBSP430dmaChannelEnable_ni(), and for software-triggered transfers
+ * is started by vBSP430dmaChannelTrigger_ni().
+ *
+ * Enabling #configBSP430_HAL_DMA also enables
+ * #configBSP430_HAL_DMA_ISR unless previously disabled.  When this
+ * ISR is enabled and a channel is configured with #DMAIE, completion
+ * of the channel transfer invokes the corresponding chain from
+ * sBSP430halDMA.ch_cbchain_ni.  The index passed to the callback is
+ * the channel number.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_PERIPH_DMA_H
+#define BSP430_PERIPH_DMA_H
+
+#include <bsp430/periph.h>
+
+/* !BSP430! periph=dma */
+/* !BSP430! instance=DMA */
+
+/** @def BSP430_MODULE_DMA
+ *
+ * Defined on inclusion of <bsp430/periph/dma.h>.  The value
+ * evaluates to true if the target MCU supports the DMA controller in
+ * its 5xx/6xx/FR5xx form, and false if it does not.
+ *
+ * @cppflag
+ */
+#define BSP430_MODULE_DMA (defined(__MSP430_HAS_DMAX_3__)       \
+                           || defined(__MSP430_HAS_DMAX_6__))
+
+#if defined(BSP430_DOXYGEN) || (BSP430_MODULE_DMA - 0)
+
+/** @def BSP430_DMA_CHANNEL_COUNT
+ *
+ * The number of channels supported by the DMA controller on the
+ * target MCU.
+ *
+ * @platformdefault */
+#if defined(BSP430_DOXYGEN) || defined(__MSP430_HAS_DMAX_3__)
+#define BSP430_DMA_CHANNEL_COUNT 3
+#else /* DMAX_3 */
+#define BSP430_DMA_CHANNEL_COUNT 6
+#endif /* DMAX_3 */
+
+/** Value for the trigger select field of a channel that causes
+ * transfers to be initiated only by setting #DMAREQ in the channel
+ * control register.  See vBSP430dmaChannelTrigger_ni(). */
+#define BSP430_DMA_TSEL_DMAREQ 0
+
+/** Mask for the trigger select field of a single channel.  The
+ * trigger numbers themselves are MCU-specific; consult the device
+ * data sheet. */
+#define BSP430_DMA_TSEL_MASK 0x1F
+
+/** Register map for a single DMA channel. */
+typedef struct sBSP430hplDMAChannel {
+  unsigned int ctl;             /**< Channel control (DMAxCTL) */
+  unsigned long sa;             /**< Source address (DMAxSA) */
+  unsigned long da;             /**< Destination address (DMAxDA) */
+  unsigned int sz;              /**< Transfer size (DMAxSZ) */
+  unsigned int _reserved_x0C;
+  unsigned int _reserved_x0E;
+} sBSP430hplDMAChannel;
+
+/** Register map for the DMA controller.
+ *
+ * The trigger select field for channel @c n is in the low five bits
+ * of byte @c n of the #ctl array; see iBSP430dmaChannelSetTrigger_ni().
+ */
+typedef struct sBSP430hplDMA {
+  unsigned int ctl[4];          /**< Trigger select registers (DMACTL0..DMACTL3) */
+  unsigned int ctl4;            /**< Controller configuration (DMACTL4) */
+  unsigned int _reserved_x0A;
+  unsigned int _reserved_x0C;
+  unsigned int iv;              /**< Interrupt vector (DMAIV) */
+  sBSP430hplDMAChannel ch[8];   /**< Per-channel registers (indexed) */
+} sBSP430hplDMA;
+
+/** @cond DOXYGEN_INTERNAL */
+#if defined(__MSP430_HAS_DMAX_3__)
+#define BSP430_PERIPH_DMA_BASEADDRESS_ __MSP430_BASEADDRESS_DMAX_3__
+#else /* DMAX_3 */
+#define BSP430_PERIPH_DMA_BASEADDRESS_ __MSP430_BASEADDRESS_DMAX_6__
+#endif /* DMAX_3 */
+/** @endcond */ /* DOXYGEN_INTERNAL */
+
+/** Field value for variant stored in sBSP430halDMA.hal_state.cflags
+ * when HPL reference is to an #sBSP430hplDMA. */
+#define BSP430_DMA_HAL_HPL_VARIANT_DMA 1
+
+/** Structure holding hardware abstraction layer state for the DMA
+ * controller. */
+typedef struct sBSP430halDMA {
+  /** Common header used to extract the correct HPL pointer type from
+   * the hpl union. */
+  sBSP430hplHALStatePrefix hal_state;
+
+  /** The underlying DMA controller register structure */
+  volatile sBSP430hplDMA * const hpl;
+
+  /** Bit @c n is set if channel @c n has been allocated through
+   * iBSP430dmaChannelAllocate_ni().  @note This field must be mutated
+   * only when interrupts are disabled. */
+  unsigned char allocated_ni;
+
+  /** The callback chain to invoke when a channel transfer completes.
+   *
+   * The chains are independent for each channel, but the channel
+   * index is passed into the chain so that a common handler can be
+   * invoked if desired.  Chains are invoked only if
+   * #configBSP430_HAL_DMA_ISR is enabled and the channel was
+   * configured with #DMAIE.
+   *
+   * @note The pointers in this array, and the pointers for any
+   * #sBSP430halISRIndexedChainNode.next_ni fields in chain nodes
+   * accessed through them, must be mutated only when interrupts are
+   * disabled. */
+  const struct sBSP430halISRIndexedChainNode * volatile * const ch_cbchain_ni;
+} sBSP430halDMA;
+
+/** The DMA internal state is protected. */
+typedef struct sBSP430halDMA * hBSP430halDMA;
+
+/** Allocate a DMA channel.
+ *
+ * @param hal the DMA controller from which the channel is allocated
+ *
+ * @param channel the specific channel requested, or a negative value
+ * to request the lowest-numbered channel that is not already in use.
+ * Lower-numbered channels have higher priority unless #ROUNDROBIN is
+ * set in sBSP430hplDMA.ctl4.
+ *
+ * @return the index of the allocated channel, or -1 if the requested
+ * channel is invalid or already allocated, or no channel is
+ * available. */
+int iBSP430dmaChannelAllocate_ni (hBSP430halDMA hal,
+                                  int channel);
+
+/** Release a previously allocated DMA channel.
+ *
+ * The channel is disabled, its interrupt enable and flag are cleared,
+ * and its trigger select is reset to #BSP430_DMA_TSEL_DMAREQ.  The
+ * completion callback chain for the channel is not modified.
+ *
+ * @param hal the DMA controller from which the channel was allocated
+ *
+ * @param channel the channel to be released
+ *
+ * @return 0 if the channel was released, -1 if it was not valid or
+ * not allocated. */
+int iBSP430dmaChannelRelease_ni (hBSP430halDMA hal,
+                                 int channel);
+
+/** Set the trigger source for a DMA channel.
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be configured
+ *
+ * @param tsel the MCU-specific trigger number, e.g.
+ * #BSP430_DMA_TSEL_DMAREQ.  Only the bits in #BSP430_DMA_TSEL_MASK
+ * are used.
+ *
+ * @return 0 if the trigger was set, -1 if the channel is not valid. */
+int iBSP430dmaChannelSetTrigger_ni (hBSP430halDMA hal,
+                                    int channel,
+                                    unsigned int tsel);
+
+/** Configure a DMA channel for a transfer.
+ *
+ * The channel is disabled, then the trigger, source and destination
+ * addresses, size, and control word are written.  The channel is not
+ * enabled; use iBSP430dmaChannelEnable_ni() to arm it.
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be configured
+ *
+ * @param tsel the trigger source, as with
+ * iBSP430dmaChannelSetTrigger_ni()
+ *
+ * @param ctl the value for the channel control register, excluding
+ * #DMAEN.  This is composed from the transfer mode (#DMADT_0 for
+ * single, #DMADT_1 for block, #DMADT_2 for burst-block, and #DMADT_4
+ * through #DMADT_6 for their repeated variants), address increment
+ * modes (e.g., #DMASRCINCR_3, #DMADSTINCR_3), unit sizes (#DMASRCBYTE,
+ * #DMADSTBYTE), trigger sensitivity (#DMALEVEL), and #DMAIE if the
+ * completion callback chain should be invoked.
+ *
+ * @param src the address from which data is read
+ *
+ * @param dst the address to which data is written
+ *
+ * @param size the number of transfer units (bytes or words, per @p
+ * ctl); a value of zero disables the channel
+ *
+ * @return 0 if the channel was configured, -1 if the channel is not
+ * valid. */
+int iBSP430dmaChannelConfigure_ni (hBSP430halDMA hal,
+                                   int channel,
+                                   unsigned int tsel,
+                                   unsigned int ctl,
+                                   const volatile void * src,
+                                   volatile void * dst,
+                                   unsigned int size);
+
+/** Arm a configured DMA channel.
+ *
+ * Sets #DMAEN in the channel control register.  For non-repeated
+ * transfer modes the hardware clears #DMAEN when the transfer
+ * completes; see iBSP430dmaChannelBusy_ni().
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be armed
+ *
+ * @return 0 if the channel was enabled, -1 if it is not valid. */
+static BSP430_CORE_INLINE
+int iBSP430dmaChannelEnable_ni (hBSP430halDMA hal,
+                                int channel)
+{
+  if ((0 > channel) || (BSP430_DMA_CHANNEL_COUNT <= channel)) {
+    return -1;
+  }
+  hal->hpl->ch[channel].ctl |= DMAEN;
+  return 0;
+}
+
+/** Disable a DMA channel, aborting any transfer in progress.
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be disabled
+ *
+ * @return the number of transfer units remaining in an interrupted
+ * block transfer, or -1 if the channel is not valid. */
+static BSP430_CORE_INLINE
+int iBSP430dmaChannelDisable_ni (hBSP430halDMA hal,
+                                 int channel)
+{
+  if ((0 > channel) || (BSP430_DMA_CHANNEL_COUNT <= channel)) {
+    return -1;
+  }
+  hal->hpl->ch[channel].ctl &= ~DMAEN;
+  return hal->hpl->ch[channel].sz;
+}
+
+/** Request a transfer on a channel using the software trigger.
+ *
+ * Sets #DMAREQ in the channel control register.  The channel should
+ * have been configured with #BSP430_DMA_TSEL_DMAREQ and enabled.  In
+ * single transfer mode one unit is transferred per request; in block
+ * modes the entire block is transferred.
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be triggered; must be valid */
+static BSP430_CORE_INLINE
+void vBSP430dmaChannelTrigger_ni (hBSP430halDMA hal,
+                                  int channel)
+{
+  hal->hpl->ch[channel].ctl |= DMAREQ;
+}
+
+/** Determine whether a channel transfer is still pending.
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be checked; must be valid
+ *
+ * @return nonzero if #DMAEN remains set on the channel.  For
+ * repeated transfer modes this is always true until the channel is
+ * disabled. */
+static BSP430_CORE_INLINE
+int iBSP430dmaChannelBusy_ni (hBSP430halDMA hal,
+                              int channel)
+{
+  return 0 != (DMAEN & hal->hpl->ch[channel].ctl);
+}
+
+/** Change the destination address of an enabled repeated-mode
+ * channel.
+ *
+ * In the repeated transfer modes the address registers are copied
+ * to the working registers each time the transfer size reloads, so
+ * the new value takes effect at the start of the next repetition.
+ * This supports alternating ("ping-pong") buffers.
+ *
+ * @param hal the DMA controller
+ *
+ * @param channel the channel to be updated; must be valid
+ *
+ * @param dst the destination address for the next repetition */
+static BSP430_CORE_INLINE
+void vBSP430dmaChannelSetReloadDestination_ni (hBSP430halDMA hal,
+                                               int channel,
+                                               volatile void * dst)
+{
+  hal->hpl->ch[channel].da = (uintptr_t)dst;
+}
+
+/* !BSP430! insert=hal_decl */
+/* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hal_decl] */
+/** @def configBSP430_HAL_DMA
+ *
+ * Define to a true value in @c bsp430_config.h to enable use of the
+ * @c DMA peripheral HAL interface.  This defines a global
+ * object supporting enhanced functionality for the peripheral, and a
+ * macro BSP430_HAL_DMA that is a reference to that object.
+ *
+ * @note Enabling this defaults #configBSP430_HPL_DMA to
+ * true, since the HAL infrastructure requires the underlying HPL
+ * infrastructure.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HAL_DMA
+#define configBSP430_HAL_DMA 0
+#endif /* configBSP430_HAL_DMA */
+
+/** @cond DOXYGEN_EXCLUDE */
+#if configBSP430_HAL_DMA - 0
+/* You don't need to know about this */
+extern sBSP430halDMA xBSP430hal_DMA_;
+#endif /* configBSP430_HAL_DMA */
+/** @endcond */
+
+/** BSP430 HAL handle for DMA.
+ *
+ * The handle may be used only if #configBSP430_HAL_DMA
+ * is defined to a true value.
+ *
+ * @dependency #configBSP430_HAL_DMA */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HAL_DMA - 0)
+#define BSP430_HAL_DMA (&xBSP430hal_DMA_)
+#endif /* configBSP430_HAL_DMA */
+
+/* END AUTOMATICALLY GENERATED CODE [hal_decl] */
+/* !BSP430! end=hal_decl */
+
+/* !BSP430! insert=periph_decl */
+/* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [periph_decl] */
+/** @def configBSP430_HPL_DMA
+ *
+ * Define to a true value in @c bsp430_config.h to enable use of the
+ * @c DMA peripheral HPL interface.  Only do this if the MCU
+ * supports this device.
+ *
+ * @note Enabling #configBSP430_HAL_DMA defaults this to
+ * true, so you only need to explicitly request this if you want the
+ * HPL interface without the HAL interface.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HPL_DMA
+#define configBSP430_HPL_DMA (configBSP430_HAL_DMA - 0)
+#endif /* configBSP430_HPL_DMA */
+
+#if (configBSP430_HAL_DMA - 0) && ! (configBSP430_HPL_DMA - 0)
+#warning configBSP430_HAL_DMA requested without configBSP430_HPL_DMA
+#endif /* HAL and not HPL */
+
+/** Handle for the raw DMA device.
+ *
+ * The handle may be used only if #configBSP430_HPL_DMA
+ * is defined to a true value.
+ *
+ * @dependency #configBSP430_HPL_DMA */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HPL_DMA - 0)
+#define BSP430_PERIPH_DMA ((tBSP430periphHandle)(BSP430_PERIPH_DMA_BASEADDRESS_))
+#endif /* configBSP430_HPL_DMA */
+
+/* END AUTOMATICALLY GENERATED CODE [periph_decl] */
+/* !BSP430! end=periph_decl */
+
+/* !BSP430! insert=hpl_decl */
+/* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hpl_decl] */
+/** HPL pointer for DMA.
+ *
+ * Typed pointer to a volatile structure overlaying the DMA
+ * peripheral register map.
+ *
+ * The pointer may be used only if #configBSP430_HPL_DMA
+ * is defined to a true value.
+ *
+ * @dependency #configBSP430_HPL_DMA */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HPL_DMA - 0)
+#define BSP430_HPL_DMA ((volatile sBSP430hplDMA *)BSP430_PERIPH_DMA)
+#endif /* configBSP430_HPL_DMA */
+
+/* END AUTOMATICALLY GENERATED CODE [hpl_decl] */
+/* !BSP430! end=hpl_decl */
+
+/* !BSP430! insert=hal_isr_decl */
+/* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hal_isr_decl] */
+/** @def configBSP430_HAL_DMA_ISR
+ *
+ * Define to a false value in @c bsp430_config.h if you are using the
+ * BSP430 HAL interface for @c DMA but want to define your
+ * own interrupt service routine for the peripheral.
+ *
+ * Enabling #configBSP430_HAL_DMA defaults this to
+ * true, so you only need to explicitly set it if you do not want to
+ * use the standard ISR provided by BSP430.
+ *
+ * @note Enabling this requires that #configBSP430_HAL_DMA
+ * also be true.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HAL_DMA_ISR
+#define configBSP430_HAL_DMA_ISR (configBSP430_HAL_DMA - 0)
+#endif /* configBSP430_HAL_DMA_ISR */
+
+#if (configBSP430_HAL_DMA_ISR - 0) && ! (configBSP430_HAL_DMA - 0)
+#warning configBSP430_HAL_DMA_ISR requested without configBSP430_HAL_DMA
+#endif /* HAL_ISR and not HAL */
+
+/* END AUTOMATICALLY GENERATED CODE [hal_isr_decl] */
+/* !BSP430! end=hal_isr_decl */
+
+/** Get the HPL handle for the DMA controller.
+ *
+ * @param periph The handle identifier, such as #BSP430_PERIPH_DMA.
+ *
+ * @return A typed pointer that can be used to manipulate the
+ * controller.  A null pointer is returned if the handle does not
+ * correspond to a DMA controller for which the HPL interface been
+ * enabled (e.g., with #configBSP430_HPL_DMA).
+ */
+static BSP430_CORE_INLINE
+volatile sBSP430hplDMA * xBSP430hplLookupDMA (tBSP430periphHandle periph)
+{
+  /* !BSP430! insert=periph_hpl_demux */
+  /* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [periph_hpl_demux] */
+#if configBSP430_HPL_DMA - 0
+  if (BSP430_PERIPH_DMA == periph) {
+    return BSP430_HPL_DMA;
+  }
+#endif /* configBSP430_HPL_DMA */
+
+  /* END AUTOMATICALLY GENERATED CODE [periph_hpl_demux] */
+  /* !BSP430! end=periph_hpl_demux */
+  return NULL;
+}
+
+/** Get the HAL handle for the DMA controller.
+ *
+ * @param periph The handle identifier, such as #BSP430_PERIPH_DMA.
+ *
+ * @return the HAL handle for the controller.  A null pointer is
+ * returned if the handle does not correspond to a DMA controller for
+ * which the HAL interface has been enabled (e.g., with
+ * #configBSP430_HAL_DMA).
+ */
+static BSP430_CORE_INLINE
+hBSP430halDMA hBSP430dmaLookup (tBSP430periphHandle periph)
+{
+  /* !BSP430! insert=periph_hal_demux */
+  /* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [periph_hal_demux] */
+#if configBSP430_HAL_DMA - 0
+  if (BSP430_PERIPH_DMA == periph) {
+    return BSP430_HAL_DMA;
+  }
+#endif /* configBSP430_HAL_DMA */
+
+  /* END AUTOMATICALLY GENERATED CODE [periph_hal_demux] */
+  /* !BSP430! end=periph_hal_demux */
+  return NULL;
+}
+
+/** Get a human-readable identifier for the DMA controller
+ *
+ * @param periph The handle identifier, such as #BSP430_PERIPH_DMA.
+ *
+ * @return The name of the controller, e.g. "DMA".  If the peripheral
+ * is not recognized as a DMA controller, a null pointer is returned.
+ */
+const char * xBSP430dmaName (tBSP430periphHandle periph);
+
+#endif /* BSP430_MODULE_DMA */
+
+#endif /* BSP430_PERIPH_DMA_H */
@@ -112,6 +112,112 @@
 #define BSP430_EUSCI_UART_MAX_BAUD 1000000UL
 #endif /* BSP430_EUSCI_UART_MAX_BAUD */
 
+/** Select the eUSCI UCBRSx second-stage modulation pattern.
+ *
+ * This encodes the table in the eUSCI UART chapter of the family
+ * user's guide, which maps the fractional part of the baud rate
+ * divisor to a modulation pattern.  Each threshold is the tabulated
+ * fraction rounded to the nearest multiple of 1/4096, so that common
+ * ratios such as 2/3 and 5/6, which the table places within 1/10000
+ * of a threshold, select the tabulated pattern.
+ *
+ * @param f_ the fractional part of a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12(), in units of 1/4096
+ *
+ * @return the value of the UCBRSx field, before shifting into
+ * position with #UCBRS0 */
+#define BSP430_EUSCI_UART_BRS(f_)         \
+  ((3804 <= (f_)) ? 0xFE  /* 0.9288 */    \
+   : (3756 <= (f_)) ? 0xFD  /* 0.9170 */  \
+   : (3688 <= (f_)) ? 0xFB  /* 0.9004 */  \
+   : (3584 <= (f_)) ? 0xF7  /* 0.8751 */  \
+   : (3511 <= (f_)) ? 0xEF  /* 0.8572 */  \
+   : (3467 <= (f_)) ? 0xDF  /* 0.8464 */  \
+   : (3413 <= (f_)) ? 0xBF  /* 0.8333 */  \
+   : (3278 <= (f_)) ? 0xEE  /* 0.8004 */  \
+   : (3220 <= (f_)) ? 0xED  /* 0.7861 */  \
+   : (3073 <= (f_)) ? 0xDD  /* 0.7503 */  \
+   : (2927 <= (f_)) ? 0xBB  /* 0.7147 */  \
+   : (2868 <= (f_)) ? 0xB7  /* 0.7001 */  \
+   : (2731 <= (f_)) ? 0xD6  /* 0.6667 */  \
+   : (2635 <= (f_)) ? 0xB6  /* 0.6432 */  \
+   : (2562 <= (f_)) ? 0xB5  /* 0.6254 */  \
+   : (2459 <= (f_)) ? 0xAD  /* 0.6003 */  \
+   : (2341 <= (f_)) ? 0x6B  /* 0.5715 */  \
+   : (2049 <= (f_)) ? 0xAA  /* 0.5002 */  \
+   : (1793 <= (f_)) ? 0x55  /* 0.4378 */  \
+   : (1756 <= (f_)) ? 0x53  /* 0.4286 */  \
+   : (1640 <= (f_)) ? 0x92  /* 0.4003 */  \
+   : (1537 <= (f_)) ? 0x52  /* 0.3753 */  \
+   : (1464 <= (f_)) ? 0x4A  /* 0.3575 */  \
+   : (1366 <= (f_)) ? 0x49  /* 0.3335 */  \
+   : (1229 <= (f_)) ? 0x25  /* 0.3000 */  \
+   : (1025 <= (f_)) ? 0x44  /* 0.2503 */  \
+   : (911 <= (f_)) ? 0x22  /* 0.2224 */   \
+   : (879 <= (f_)) ? 0x21  /* 0.2147 */   \
+   : (684 <= (f_)) ? 0x11  /* 0.1670 */   \
+   : (586 <= (f_)) ? 0x20  /* 0.1430 */   \
+   : (513 <= (f_)) ? 0x10  /* 0.1252 */   \
+   : (410 <= (f_)) ? 0x08  /* 0.1001 */   \
+   : (342 <= (f_)) ? 0x04  /* 0.0835 */   \
+   : (293 <= (f_)) ? 0x02  /* 0.0715 */   \
+   : (217 <= (f_)) ? 0x01  /* 0.0529 */   \
+   : 0x00)
+
+/** Calculate the eUSCI UCAxBRW setting for a baud rate divisor.
+ *
+ * Oversampling mode is used whenever the divisor is at least 16, so
+ * every divisor representable by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() fits the 16-bit register.
+ *
+ * @param divisor_q12_ a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() */
+#define BSP430_EUSCI_UART_BRW(divisor_q12_)                            \
+  ((unsigned int)(((16UL << 12) <= (divisor_q12_))                      \
+                  ? ((divisor_q12_) >> 16)                              \
+                  : ((divisor_q12_) >> 12)))
+
+/** Calculate the eUSCI UCAxMCTLW setting for a baud rate divisor.
+ *
+ * This combines #UCOS16 and the first-stage modulation UCBRFx (when
+ * oversampling) with the UCBRSx pattern selected by
+ * #BSP430_EUSCI_UART_BRS().
+ *
+ * @param divisor_q12_ a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() */
+#define BSP430_EUSCI_UART_MCTLW(divisor_q12_)                          \
+  ((unsigned int)((((16UL << 12) <= (divisor_q12_))                     \
+                   ? (UCOS16 | ((((divisor_q12_) >> 12) & 0x0F) * UCBRF0)) \
+                   : 0)                                                 \
+                  | (BSP430_EUSCI_UART_BRS((divisor_q12_) & 0x0FFF) * UCBRS0)))
+
+/** @def BSP430_EUSCI_A0_DMA_TSEL_RX
+ *
+ * The DMA trigger number corresponding to UCA0RXIFG.  The trigger for
+ * UCA0TXIFG is assumed to be the next value.  Similar macros exist
+ * for EUSCI_A1 and EUSCI_B0 (where the trigger is UCB0RXIFG0); the
+ * remaining instances have no DMA triggers.  Used only when
+ * #configBSP430_SERIAL_SPI_USE_DMA is enabled.
+ *
+ * The default values are those of the MSP430FR57xx family.  Override
+ * them in @c bsp430_config.h if the target MCU data sheet specifies
+ * otherwise.
+ *
+ * @defaulted */
+#ifndef BSP430_EUSCI_A0_DMA_TSEL_RX
+#define BSP430_EUSCI_A0_DMA_TSEL_RX 14
+#endif /* BSP430_EUSCI_A0_DMA_TSEL_RX */
+
+/** @cond DOXYGEN_EXCLUDE */
+#ifndef BSP430_EUSCI_A1_DMA_TSEL_RX
+#define BSP430_EUSCI_A1_DMA_TSEL_RX 16
+#endif /* BSP430_EUSCI_A1_DMA_TSEL_RX */
+
+#ifndef BSP430_EUSCI_B0_DMA_TSEL_RX
+#define BSP430_EUSCI_B0_DMA_TSEL_RX 18
+#endif /* BSP430_EUSCI_B0_DMA_TSEL_RX */
+/** @endcond */
+
 /** Register map for eUSCI_A peripheral hardware presentation layer. */
 typedef struct sBSP430hplEUSCIA {
   union {						/* 0x00 */
@@ -774,6 +880,12 @@ hBSP430halSERIAL hBSP430eusciOpenUART (hBSP430halSERIAL hal,
                                        unsigned char ctl1_byte,
                                        unsigned long baud);
 
+/** eUSCI(A)-specific implementation of hBSP430serialOpenUARTDivisor() */
+hBSP430halSERIAL hBSP430eusciOpenUARTDivisor (hBSP430halSERIAL hal,
+                                              unsigned char ctl0_byte,
+                                              unsigned char ctl1_byte,
+                                              unsigned long divisor_q12);
+
 /** eUSCI(A)-specific implementation of hBSP430serialOpenSPI() */
 hBSP430halSERIAL hBSP430eusciOpenSPI (hBSP430halSERIAL hal,
                                       unsigned char ctl0_byte,
@@ -817,6 +929,12 @@ int iBSP430eusciSPITxRx_ni (hBSP430halSERIAL hal,
                             size_t rx_len,
                             uint8_t * rx_data);
 
+/** eUSCI(A)-specific implementation of iBSP430spiReconfigure_ni() */
+int iBSP430eusciSPIReconfigure_ni (hBSP430halSERIAL hal,
+                                   unsigned char ctl0_byte,
+                                   unsigned char ctl1_byte,
+                                   unsigned int prescaler);
+
 
 /** eUSCI(A)-specific implementation of iBSP430i2cSetAddresses_ni() */
 int iBSP430eusciI2CsetAddresses_ni (hBSP430halSERIAL hal,
@@ -833,6 +951,35 @@ int iBSP430eusciI2CtxData_ni (hBSP430halSERIAL hal,
                               const uint8_t * tx_data,
                               size_t tx_len);
 
+/** eUSCI(B)-specific implementation of iBSP430i2cTxRx_ni() */
+int iBSP430eusciI2CtxRx_ni (hBSP430halSERIAL hal,
+                            const uint8_t * tx_data,
+                            size_t tx_len,
+                            size_t rx_len,
+                            uint8_t * rx_data);
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_USE_ISR - 0)
+/** eUSCI(B)-specific start of the transaction at the head of the
+ * I2C queue attached to @p hal.
+ *
+ * @return 0, since the eUSCI signals the end of each transaction
+ * only once its stop is complete */
+int iBSP430eusciI2CqueueStart_ni (hBSP430halSERIAL hal,
+                                  struct sBSP430i2cTransaction * txn);
+
+/** eUSCI(B)-specific abort of the transaction at the head of the
+ * I2C queue attached to @p hal */
+void vBSP430eusciI2CqueueAbort_ni (hBSP430halSERIAL hal);
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_SLAVE - 0)
+/** eUSCI(B)-specific control of the interrupts that serve the I2C
+ * slave attached to @p hal.  Returns -1 if the device is in master
+ * mode. */
+int iBSP430eusciI2CslaveEnable_ni (hBSP430halSERIAL hal,
+                                   int enablep);
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
 /** Get the HPL handle for a specific EUSCIA instance.
  *
  * @param periph The handle identifier, such as #BSP430_PERIPH_EUSCI_A0.
@@ -115,6 +115,23 @@
 #define BSP430_USCI_UART_MAX_BAUD 1000000UL
 #endif /* BSP430_USCI_UART_MAX_BAUD */
 
+/** Calculate the UCAxBRW setting for a baud rate divisor.
+ *
+ * @param divisor_q12_ a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() */
+#define BSP430_USCI_UART_BRW(divisor_q12_) ((unsigned int)((divisor_q12_) >> 12))
+
+/** Calculate the UCAxMCTL setting for a baud rate divisor.
+ *
+ * The low-frequency baud rate generation mode is used: UCBRSx is the
+ * fractional part of the divisor rounded to the nearest eighth, and
+ * UCBRFx and #UCOS16 are zero.
+ *
+ * @param divisor_q12_ a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() */
+#define BSP430_USCI_UART_MCTL(divisor_q12_) \
+  ((unsigned int)(((1 + (((divisor_q12_) >> 8) & 0x0F)) / 2) * UCBRS0))
+
 /** Register map for USCI_A/USCI_B peripheral on a MSP430 2xx/4xx MCU. */
 typedef struct sBSP430hplUSCI {
   unsigned char ctl0;	/**< UCtxCTL0 */ /* 0x00 */
@@ -579,6 +596,12 @@ hBSP430halSERIAL hBSP430usciOpenUART (hBSP430halSERIAL hal,
                                       unsigned char ctl1_byte,
                                       unsigned long baud);
 
+/** USCI-specific implementation of hBSP430serialOpenUARTDivisor() */
+hBSP430halSERIAL hBSP430usciOpenUARTDivisor (hBSP430halSERIAL hal,
+                                             unsigned char ctl0_byte,
+                                             unsigned char ctl1_byte,
+                                             unsigned long divisor_q12);
+
 /** USCI-specific implementation of hBSP430serialOpenSPI() */
 hBSP430halSERIAL hBSP430usciOpenSPI (hBSP430halSERIAL hal,
                                      unsigned char ctl0_byte,
@@ -622,6 +645,12 @@ int iBSP430usciSPITxRx_ni (hBSP430halSERIAL hal,
                            size_t rx_len,
                            uint8_t * rx_data);
 
+/** USCI-specific implementation of iBSP430spiReconfigure_ni() */
+int iBSP430usciSPIReconfigure_ni (hBSP430halSERIAL hal,
+                                  unsigned char ctl0_byte,
+                                  unsigned char ctl1_byte,
+                                  unsigned int prescaler);
+
 /** USCI-specific implementation of iBSP430i2cSetAddresses_ni() */
 int iBSP430usciI2CsetAddresses_ni (hBSP430halSERIAL hal,
                                    int own_address,
@@ -637,6 +666,13 @@ int iBSP430usciI2CtxData_ni (hBSP430halSERIAL hal,
                              const uint8_t * tx_data,
                              size_t tx_len);
 
+/** USCI-specific implementation of iBSP430i2cTxRx_ni() */
+int iBSP430usciI2CtxRx_ni (hBSP430halSERIAL hal,
+                           const uint8_t * tx_data,
+                           size_t tx_len,
+                           size_t rx_len,
+                           uint8_t * rx_data);
+
 /** Get the HPL handle for a specific USCI instance.
  *
  * @param periph The handle identifier, such as #BSP430_PERIPH_USCI_A0.
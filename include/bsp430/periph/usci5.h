@@ -106,6 +106,54 @@
 #define BSP430_USCI5_UART_MAX_BAUD 1000000UL
 #endif /* BSP430_USCI5_UART_MAX_BAUD */
 
+/** Calculate the UCAxBRW setting for a baud rate divisor.
+ *
+ * @param divisor_q12_ a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() */
+#define BSP430_USCI5_UART_BRW(divisor_q12_) ((unsigned int)((divisor_q12_) >> 12))
+
+/** Calculate the UCAxMCTL setting for a baud rate divisor.
+ *
+ * The low-frequency baud rate generation mode is used: UCBRSx is the
+ * fractional part of the divisor rounded to the nearest eighth, and
+ * UCBRFx and #UCOS16 are zero.
+ *
+ * @param divisor_q12_ a divisor produced by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12() */
+#define BSP430_USCI5_UART_MCTL(divisor_q12_) \
+  ((unsigned int)(((1 + (((divisor_q12_) >> 8) & 0x0F)) / 2) * UCBRS0))
+
+/** @def BSP430_USCI5_A0_DMA_TSEL_RX
+ *
+ * The DMA trigger number corresponding to UCA0RXIFG.  The trigger for
+ * UCA0TXIFG is assumed to be the next value.  Similar macros exist
+ * for USCI5_B0, USCI5_A1, and USCI5_B1; the remaining instances have
+ * no DMA triggers.  Used only when #configBSP430_SERIAL_SPI_USE_DMA
+ * is enabled.
+ *
+ * The default values are those of the MSP430F5438A and MSP430F5529
+ * families.  Override them in @c bsp430_config.h if the target MCU
+ * data sheet specifies otherwise.
+ *
+ * @defaulted */
+#ifndef BSP430_USCI5_A0_DMA_TSEL_RX
+#define BSP430_USCI5_A0_DMA_TSEL_RX 16
+#endif /* BSP430_USCI5_A0_DMA_TSEL_RX */
+
+/** @cond DOXYGEN_EXCLUDE */
+#ifndef BSP430_USCI5_B0_DMA_TSEL_RX
+#define BSP430_USCI5_B0_DMA_TSEL_RX 18
+#endif /* BSP430_USCI5_B0_DMA_TSEL_RX */
+
+#ifndef BSP430_USCI5_A1_DMA_TSEL_RX
+#define BSP430_USCI5_A1_DMA_TSEL_RX 20
+#endif /* BSP430_USCI5_A1_DMA_TSEL_RX */
+
+#ifndef BSP430_USCI5_B1_DMA_TSEL_RX
+#define BSP430_USCI5_B1_DMA_TSEL_RX 22
+#endif /* BSP430_USCI5_B1_DMA_TSEL_RX */
+/** @endcond */
+
 /** Register map for USCI_A/USCI_B peripheral on a MSP430 5xx/6xx MCU. */
 typedef struct sBSP430hplUSCI5 {
   union {						/* 0x00 */
@@ -1005,12 +1053,24 @@ hBSP430halSERIAL hBSP430usci5OpenUART (hBSP430halSERIAL hal,
                                        unsigned char ctl1_byte,
                                        unsigned long baud);
 
+/** USCI5-specific implementation of hBSP430serialOpenUARTDivisor() */
+hBSP430halSERIAL hBSP430usci5OpenUARTDivisor (hBSP430halSERIAL hal,
+                                              unsigned char ctl0_byte,
+                                              unsigned char ctl1_byte,
+                                              unsigned long divisor_q12);
+
 /** USCI5-specific implementation of hBSP430serialOpenSPI() */
 hBSP430halSERIAL hBSP430usci5OpenSPI (hBSP430halSERIAL hal,
                                       unsigned char ctl0_byte,
                                       unsigned char ctl1_byte,
                                       unsigned int prescaler);
 
+/** USCI5-specific implementation of hBSP430serialOpenI2C() */
+hBSP430halSERIAL hBSP430usci5OpenI2C (hBSP430halSERIAL hal,
+                                      unsigned char ctl0_byte,
+                                      unsigned char ctl1_byte,
+                                      unsigned int prescaler);
+
 /** USCI5-specific implementation of iBSP430serialSetHold_ni() */
 int iBSP430usci5SetHold_ni (hBSP430halSERIAL hal, int holdp);
 
@@ -1042,6 +1102,12 @@ int iBSP430usci5SPITxRx_ni (hBSP430halSERIAL hal,
                             size_t rx_len,
                             uint8_t * rx_data);
 
+/** USCI5-specific implementation of iBSP430spiReconfigure_ni() */
+int iBSP430usci5SPIReconfigure_ni (hBSP430halSERIAL hal,
+                                   unsigned char ctl0_byte,
+                                   unsigned char ctl1_byte,
+                                   unsigned int prescaler);
+
 /** USCI5-specific implementation of iBSP430i2cSetAddresses_ni() */
 int iBSP430usci5I2CsetAddresses_ni (hBSP430halSERIAL hal,
                                     int own_address,
@@ -1057,6 +1123,48 @@ int iBSP430usci5I2CtxData_ni (hBSP430halSERIAL hal,
                               const uint8_t * tx_data,
                               size_t tx_len);
 
+/** USCI5-specific implementation of iBSP430i2cTxRx_ni() */
+int iBSP430usci5I2CtxRx_ni (hBSP430halSERIAL hal,
+                            const uint8_t * tx_data,
+                            size_t tx_len,
+                            size_t rx_len,
+                            uint8_t * rx_data);
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_USE_ISR - 0)
+/** The maximum number of iterations spent polling for the address of
+ * a queued single-octet read to be acknowledged.  The USCI5 does not
+ * signal that event, and the stop for such a read must be requested
+ * after it and before the octet has been received.  A slave that
+ * holds the clock longer fails the transaction with
+ * #BSP430_I2C_RESULT_TIMEOUT.
+ *
+ * @defaulted */
+#ifndef BSP430_USCI5_I2C_START_WAIT_LOOPS
+#define BSP430_USCI5_I2C_START_WAIT_LOOPS 1000
+#endif /* BSP430_USCI5_I2C_START_WAIT_LOOPS */
+
+/** USCI5-specific start of the transaction at the head of the
+ * I2C queue attached to @p hal.
+ *
+ * @return 0 if the transaction was started, -1 if the stop that
+ * ended the previous transaction is still in progress, or
+ * #BSP430_I2C_RESULT_TIMEOUT if the address of a single-octet read
+ * was not acknowledged within #BSP430_USCI5_I2C_START_WAIT_LOOPS */
+int iBSP430usci5I2CqueueStart_ni (hBSP430halSERIAL hal,
+                                  struct sBSP430i2cTransaction * txn);
+
+/** USCI5-specific abort of the transaction at the head of the
+ * I2C queue attached to @p hal */
+void vBSP430usci5I2CqueueAbort_ni (hBSP430halSERIAL hal);
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_SLAVE - 0)
+/** USCI5-specific control of the interrupts that serve the I2C slave
+ * attached to @p hal.  Returns -1 if the device is in master mode. */
+int iBSP430usci5I2CslaveEnable_ni (hBSP430halSERIAL hal,
+                                   int enablep);
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
 /** Get the HPL handle for a specific USCI5 instance.
  *
  * @param periph The handle identifier, such as #BSP430_PERIPH_USCI5_A0.
@@ -141,4 +141,16 @@
 #endif /* enable uptime CC0 ISR */
 #endif /* configBSP430_UPTIME */
 
+/* DMA acceleration of SPI transfers, transmit blocks, and UART
+ * reception requires the DMA HAL */
+#if (((configBSP430_SERIAL_SPI_USE_DMA - 0)             \
+      || (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)     \
+      || (configBSP430_SERIAL_UART_RX_USE_DMA - 0))     \
+     && (defined(__MSP430_HAS_DMAX_3__)                 \
+         || defined(__MSP430_HAS_DMAX_6__)))
+#ifndef configBSP430_HAL_DMA
+#define configBSP430_HAL_DMA 1
+#endif /* configBSP430_HAL_DMA */
+#endif /* serial DMA features */
+
 #endif /* BSP430_PLATFORM_BSP430_CONFIG_H */
@@ -95,6 +95,34 @@
 #define configBSP430_SERIAL_USE_EUSCI (defined(__MSP430_HAS_EUSCI_A0__) || defined(__MSP430_HAS_EUSCI_B0__))
 #endif /* configBSP430_SERIAL_USE_EUSCI */
 
+/** @def configBSP430_SERIAL_USE_GPIOSERIAL
+ *
+ * Define to true value to allow the generic serial dispatches to
+ * recognize the software SPI and I2C devices of
+ * <bsp430/utility/gpioserial.h>.  This defaults to true iff one of
+ * #configBSP430_HAL_GPIOSERIAL0 or #configBSP430_HAL_GPIOSERIAL1 is
+ * enabled.
+ *
+ * @cppflag
+ * @defaulted  */
+#ifndef configBSP430_SERIAL_USE_GPIOSERIAL
+#define configBSP430_SERIAL_USE_GPIOSERIAL ((configBSP430_HAL_GPIOSERIAL0 - 0) || (configBSP430_HAL_GPIOSERIAL1 - 0))
+#endif /* configBSP430_SERIAL_USE_GPIOSERIAL */
+
+/** @def configBSP430_SERIAL_USE_TIMERUART
+ *
+ * Define to true value to allow the generic serial dispatches to
+ * recognize the software UART devices of
+ * <bsp430/utility/timeruart.h>.  This defaults to true iff one of
+ * #configBSP430_HAL_TIMERUART0 or #configBSP430_HAL_TIMERUART1 is
+ * enabled.
+ *
+ * @cppflag
+ * @defaulted  */
+#ifndef configBSP430_SERIAL_USE_TIMERUART
+#define configBSP430_SERIAL_USE_TIMERUART ((configBSP430_HAL_TIMERUART0 - 0) || (configBSP430_HAL_TIMERUART1 - 0))
+#endif /* configBSP430_SERIAL_USE_TIMERUART */
+
 /** @def configBSP430_SERIAL_ENABLE_UART
  *
  * Define to a true value to allow the general serial layer to
@@ -146,6 +174,234 @@
 #define configBSP430_SERIAL_ENABLE_I2C 0
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
 
+/** @def configBSP430_SERIAL_SPI_USE_DMA
+ *
+ * Define to a true value to allow iBSP430spiTxRx_ni() to hand long
+ * transfers to the DMA controller on peripherals that have DMA
+ * triggers (USCI5 and eUSCI).  Transfers of at least
+ * #BSP430_SERIAL_SPI_DMA_THRESHOLD octets are performed by a pair of
+ * DMA channels allocated for the duration of the call; shorter
+ * transfers, and transfers for which no channels are available, use
+ * the polled implementation.  The call remains synchronous.
+ *
+ * Enabling this defaults #configBSP430_HAL_DMA to true on MCUs that
+ * have a DMA controller.  The @c periph/dma module must be linked
+ * into the application.
+ *
+ * @note When the receive phase (@p rx_len) is non-empty and @p
+ * rx_data is not null, the outgoing command and the
+ * #BSP430_SERIAL_SPI_READ_TX_BYTE filler are staged in @p rx_data,
+ * which is overwritten in place by the incoming data.  A transfer
+ * with a non-empty receive phase and a null @p rx_data is not
+ * accelerated.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_ENABLE_SPI */
+#ifndef configBSP430_SERIAL_SPI_USE_DMA
+#define configBSP430_SERIAL_SPI_USE_DMA 0
+#endif /* configBSP430_SERIAL_SPI_USE_DMA */
+
+/** @def BSP430_SERIAL_SPI_DMA_THRESHOLD
+ *
+ * The minimum total length (command plus response) of an SPI
+ * transfer that will be performed by DMA when
+ * #configBSP430_SERIAL_SPI_USE_DMA is enabled.  Below this the cost
+ * of configuring two channels exceeds the cost of the polled loop.
+ * The value must be at least 2.
+ *
+ * @defaulted */
+#ifndef BSP430_SERIAL_SPI_DMA_THRESHOLD
+#define BSP430_SERIAL_SPI_DMA_THRESHOLD 16
+#endif /* BSP430_SERIAL_SPI_DMA_THRESHOLD */
+
+/** @def configBSP430_SERIAL_SPI_DMA_USE_LPM
+ *
+ * Define to a true value to have a DMA-accelerated SPI transfer wait
+ * for completion in LPM0 with interrupts enabled, woken by the DMA
+ * completion interrupt, rather than spinning on the channel status.
+ * This requires #configBSP430_HAL_DMA_ISR.  Other interrupts may be
+ * serviced while the transfer is in progress.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_SPI_USE_DMA */
+#ifndef configBSP430_SERIAL_SPI_DMA_USE_LPM
+#define configBSP430_SERIAL_SPI_DMA_USE_LPM 0
+#endif /* configBSP430_SERIAL_SPI_DMA_USE_LPM */
+
+/** @def configBSP430_SERIAL_SPI_BUS
+ *
+ * Define to a true value to enable the SPI bus manager
+ * (hBSP430spiBusInitialize()), which allows several devices with
+ * different clock polarities, phases, and rates to share one SPI
+ * peripheral.  Each device registers its configuration and chip
+ * select once; selecting a device rewrites only the peripheral
+ * registers that differ from the configuration already loaded.
+ *
+ * Chip selects are controlled through the port HAL, so the HAL for
+ * each chip select port must be enabled (e.g.,
+ * #configBSP430_HAL_PORT3).
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_ENABLE_SPI */
+#ifndef configBSP430_SERIAL_SPI_BUS
+#define configBSP430_SERIAL_SPI_BUS 0
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
+/** @def configBSP430_SERIAL_I2C_USE_ISR
+ *
+ * Define to a true value to enable the interrupt-driven I2C master
+ * transaction queue (hBSP430i2cQueueInitialize()) on USCI5 and eUSCI
+ * devices.  This adds a queue reference to each serial HAL instance;
+ * when a queue is attached the interrupt service routine of the
+ * device decodes I2C events and advances the queued transactions,
+ * rather than invoking the receive and transmit callback chains.
+ *
+ * The HAL ISR for the device must be enabled (e.g.,
+ * #configBSP430_HAL_USCI5_B0_ISR).  Per-transaction timeouts require
+ * #configBSP430_UPTIME.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_ENABLE_I2C */
+#ifndef configBSP430_SERIAL_I2C_USE_ISR
+#define configBSP430_SERIAL_I2C_USE_ISR 0
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+/** @def configBSP430_SERIAL_I2C_SLAVE
+ *
+ * Define to a true value to enable interrupt-driven I2C slave
+ * operation (hBSP430i2cSlaveInitialize()) on USCI5 and eUSCI
+ * devices.  This adds a slave reference to each serial HAL instance;
+ * when a slave is attached the interrupt service routine of the
+ * device exposes a register file to the bus master, rather than
+ * invoking the receive and transmit callback chains.
+ *
+ * The HAL ISR for the device must be enabled (e.g.,
+ * #configBSP430_HAL_USCI5_B0_ISR).
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_ENABLE_I2C */
+#ifndef configBSP430_SERIAL_I2C_SLAVE
+#define configBSP430_SERIAL_I2C_SLAVE 0
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
+/** @def configBSP430_SERIAL_TX_BLOCK_USE_DMA
+ *
+ * Define to a true value to have blocks supplied through the
+ * sBSP430halSERIAL.tx_block contract of
+ * sBSP430halSERIAL.tx_cbchain_ni transmitted by the DMA controller on
+ * peripherals that have DMA triggers (USCI5 and eUSCI).  A channel is
+ * allocated when a block of at least
+ * #BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD octets is supplied and
+ * released when the block has been written to the peripheral; if no
+ * channel is available the block is streamed by the transmit
+ * interrupt.
+ *
+ * Enabling this defaults #configBSP430_HAL_DMA to true on MCUs that
+ * have a DMA controller.  The @c periph/dma module must be linked
+ * into the application, and #configBSP430_HAL_DMA_ISR must be
+ * enabled.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_SERIAL_TX_BLOCK_USE_DMA
+#define configBSP430_SERIAL_TX_BLOCK_USE_DMA 0
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+
+/** @def BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD
+ *
+ * The minimum length of a transmit block that will be handed to the
+ * DMA controller when #configBSP430_SERIAL_TX_BLOCK_USE_DMA is
+ * enabled.  Shorter blocks are streamed by the transmit interrupt.
+ * The value must be at least 2.
+ *
+ * @defaulted */
+#ifndef BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD
+#define BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD 8
+#endif /* BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD */
+
+/** @def configBSP430_SERIAL_UART_RX_USE_DMA
+ *
+ * Define to a true value to enable the DMA receive ring
+ * (hBSP430uartRxRingInitialize()) on USCI5 and eUSCI devices.  A DMA
+ * channel copies each received octet into an application-supplied
+ * ring without CPU involvement; the application is notified when
+ * either half of the ring fills and, if #configBSP430_UPTIME is
+ * enabled, when the line goes idle.
+ *
+ * Enabling this defaults #configBSP430_HAL_DMA to true on MCUs that
+ * have a DMA controller.  The @c periph/dma module must be linked
+ * into the application, and #configBSP430_HAL_DMA_ISR must be
+ * enabled.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_ENABLE_UART */
+#ifndef configBSP430_SERIAL_UART_RX_USE_DMA
+#define configBSP430_SERIAL_UART_RX_USE_DMA 0
+#endif /* configBSP430_SERIAL_UART_RX_USE_DMA */
+
+/** @def configBSP430_SERIAL_UART_STATIC_DIVISOR
+ *
+ * Define to a true value to have hBSP430serialOpenUART() compute the
+ * baud rate divisor and modulation settings at compile time when the
+ * requested baud rate is a compile-time constant high enough that
+ * SMCLK would be selected as the baud rate clock anyway (i.e., more
+ * than one third of #BSP430_CLOCK_NOMINAL_XT1CLK_HZ, and more than
+ * 1/65536 of the SMCLK frequency so that the divisor suits every
+ * serial peripheral).  The calculation assumes SMCLK runs at
+ * #BSP430_SERIAL_UART_STATIC_BRCLK_HZ; in exchange, no 32-bit
+ * division is performed at runtime.  Calls with non-constant baud
+ * rates, and calls from code compiled without optimization, use the
+ * runtime calculation.
+ *
+ * Leave this disabled if the application changes the SMCLK frequency
+ * from its nominal value before opening the UART.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_SERIAL_ENABLE_UART */
+#ifndef configBSP430_SERIAL_UART_STATIC_DIVISOR
+#define configBSP430_SERIAL_UART_STATIC_DIVISOR 0
+#endif /* configBSP430_SERIAL_UART_STATIC_DIVISOR */
+
+/** @def BSP430_SERIAL_UART_STATIC_BRCLK_HZ
+ *
+ * The SMCLK frequency assumed when #configBSP430_SERIAL_UART_STATIC_DIVISOR
+ * is enabled.  By default this is derived from
+ * #BSP430_CLOCK_NOMINAL_MCLK_HZ and
+ * #BSP430_CLOCK_NOMINAL_SMCLK_DIVIDING_SHIFT.
+ *
+ * @defaulted */
+#ifndef BSP430_SERIAL_UART_STATIC_BRCLK_HZ
+#define BSP430_SERIAL_UART_STATIC_BRCLK_HZ (BSP430_CLOCK_NOMINAL_MCLK_HZ >> BSP430_CLOCK_NOMINAL_SMCLK_DIVIDING_SHIFT)
+#endif /* BSP430_SERIAL_UART_STATIC_BRCLK_HZ */
+
+/** @def configBSP430_SERIAL_ERROR_COUNTERS
+ *
+ * Define to a true value to maintain sBSP430halSERIAL.errors, a set
+ * of per-device counters for receive overruns, framing and parity
+ * errors, I2C NACKs and arbitration loss, and octets dropped by
+ * software receive buffers such as the console.  Retrieve them with
+ * iBSP430serialSnapshotErrors().
+ *
+ * UART errors are detected by the receive interrupt handler and by
+ * polled reception.  Framing and parity errors are only visible when
+ * the device is opened with @c UCRXEIE set in @c ctl1_byte; otherwise
+ * the peripheral discards erroneous octets without raising an
+ * interrupt.  I2C errors are counted only for transactions processed
+ * through an I2C queue (#configBSP430_SERIAL_I2C_USE_ISR).
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_SERIAL_ERROR_COUNTERS
+#define configBSP430_SERIAL_ERROR_COUNTERS 0
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+
 /** @def BSP430_SERIAL
  *
  * Defined by the infrastructure to a true expression in the case
@@ -159,8 +415,89 @@
    || (configBSP430_SERIAL_ENABLE_SPI - 0)      \
    || (configBSP430_SERIAL_ENABLE_I2C - 0))
 
+/** @def configBSP430_SERIAL_DIRECT_DISPATCH
+ *
+ * Define to a true value to have the generic serial functions such
+ * as iBSP430uartTxByte_ni() call the peripheral-specific
+ * implementation directly, rather than through the function pointers
+ * in the dispatch table of the HAL instance.  This removes an
+ * indirect call from every operation and allows the compiler to
+ * inline the implementation.
+ *
+ * The setting takes effect only when exactly one of
+ * #configBSP430_SERIAL_USE_USCI, #configBSP430_SERIAL_USE_USCI5, and
+ * #configBSP430_SERIAL_USE_EUSCI is true, which is the case for most
+ * MCUs, and neither #configBSP430_SERIAL_USE_GPIOSERIAL nor
+ * #configBSP430_SERIAL_USE_TIMERUART is true.  Otherwise
+ * the dispatch table is used.  See
+ * #BSP430_SERIAL_DIRECT_DISPATCH.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_SERIAL_DIRECT_DISPATCH
+#define configBSP430_SERIAL_DIRECT_DISPATCH 0
+#endif /* configBSP430_SERIAL_DIRECT_DISPATCH */
+
+/** @def BSP430_SERIAL_DIRECT_DISPATCH
+ *
+ * Defined by the infrastructure to a true value when
+ * #configBSP430_SERIAL_DIRECT_DISPATCH is requested and only one
+ * serial peripheral family is supported, so that the generic serial
+ * functions resolve at compile time to the peripheral-specific
+ * implementation.
+ *
+ * @cppflag */
+#if ((configBSP430_SERIAL_DIRECT_DISPATCH - 0)                   \
+     && (1 == ((configBSP430_SERIAL_USE_USCI - 0)                \
+               + (configBSP430_SERIAL_USE_USCI5 - 0)             \
+               + (configBSP430_SERIAL_USE_EUSCI - 0)))           \
+     && ! (configBSP430_SERIAL_USE_GPIOSERIAL - 0)               \
+     && ! (configBSP430_SERIAL_USE_TIMERUART - 0))
+#define BSP430_SERIAL_DIRECT_DISPATCH 1
+#else /* single variant */
+#define BSP430_SERIAL_DIRECT_DISPATCH 0
+#endif /* single variant */
+
 #include <bsp430/serial_.h>
 
+/** @cond DOXYGEN_EXCLUDE */
+/* Resolve a dispatch table member.  In direct mode the
+ * peripheral-specific function, named by its type prefix and
+ * suffix, is called; its declaration must precede the generic
+ * wrappers. */
+#if BSP430_SERIAL_DIRECT_DISPATCH - 0
+#if configBSP430_SERIAL_USE_USCI - 0
+#include <bsp430/periph/usci.h>
+#define BSP430_SERIAL_DISPATCH_(hal_, fld_, pfx_, sfx_) pfx_##BSP430usci##sfx_
+#endif /* configBSP430_SERIAL_USE_USCI */
+#if configBSP430_SERIAL_USE_USCI5 - 0
+#include <bsp430/periph/usci5.h>
+#define BSP430_SERIAL_DISPATCH_(hal_, fld_, pfx_, sfx_) pfx_##BSP430usci5##sfx_
+#endif /* configBSP430_SERIAL_USE_USCI5 */
+#if configBSP430_SERIAL_USE_EUSCI - 0
+#include <bsp430/periph/eusci.h>
+#define BSP430_SERIAL_DISPATCH_(hal_, fld_, pfx_, sfx_) pfx_##BSP430eusci##sfx_
+#endif /* configBSP430_SERIAL_USE_EUSCI */
+#else /* BSP430_SERIAL_DIRECT_DISPATCH */
+#define BSP430_SERIAL_DISPATCH_(hal_, fld_, pfx_, sfx_) (hal_)->dispatch->fld_
+#endif /* BSP430_SERIAL_DIRECT_DISPATCH */
+/** @endcond */
+
+#if (configBSP430_SERIAL_I2C_USE_ISR - 0) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+/* Transaction timeouts and idle-line detection use a timer alarm */
+#include <bsp430/periph/timer.h>
+#endif /* configBSP430_SERIAL_I2C_USE_ISR || configBSP430_SERIAL_UART_RX_USE_DMA */
+
+#if configBSP430_SERIAL_UART_STATIC_DIVISOR - 0
+/* Static divisors are derived from the nominal clock rates */
+#include <bsp430/clock.h>
+#endif /* configBSP430_SERIAL_UART_STATIC_DIVISOR */
+
+#if configBSP430_SERIAL_SPI_BUS - 0
+/* Bus devices identify their chip select through the port HAL */
+#include <bsp430/periph/port.h>
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
 #if defined(BSP430_DOXYGEN) || (BSP430_SERIAL - 0)
 
 /** @def BSP430_SERIAL_ADJUST_CTL0_INITIALIZER
@@ -187,6 +524,67 @@
 
 #if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_ENABLE_UART - 0)
 
+/** Calculate the UART baud rate divisor for a given clock.
+ *
+ * The result is the ratio @p brclk_Hz / @p baud as an unsigned fixed
+ * point value with 12 fractional bits, leaving 20 integer bits for
+ * the divisors used by oversampling baud rate generators at low baud
+ * rates.  This is the only quantity that requires division;
+ * peripheral-specific macros such as #BSP430_USCI5_UART_BRW() and
+ * #BSP430_EUSCI_UART_MCTLW() extract the register settings from it
+ * with shifts and comparisons.  When both arguments are compile-time
+ * constants the entire calculation is performed by the compiler;
+ * otherwise it costs two 32-bit divisions, the quotient being shared
+ * between its terms.
+ *
+ * @param brclk_Hz_ the frequency of the baud rate clock, in Hz
+ *
+ * @param baud_ the desired baud rate, no greater than 1 MHz and
+ * greater than @p brclk_Hz_ / 2<sup>20</sup>
+ *
+ * @return the divisor to be passed to hBSP430serialOpenUARTDivisor() */
+#define BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz_, baud_)                \
+  (((((unsigned long)(brclk_Hz_)) / (baud_)) << 12)                     \
+   + (((((unsigned long)(brclk_Hz_))                                    \
+        - (((unsigned long)(brclk_Hz_)) / (baud_)) * (baud_)) << 12) / (baud_)))
+
+/** Configure a serial device in UART mode using a precomputed divisor.
+ *
+ * This is the back end of hBSP430serialOpenUART(), for use when the
+ * baud rate clock is selected by the caller and the divisor has been
+ * computed in advance, normally at compile time.
+ *
+ * @param hal the handle for the HAL interface for the serial device
+ *
+ * @param ctl0_byte as with hBSP430serialOpenUART()
+ *
+ * @param ctl1_byte as with hBSP430serialOpenUART(), except that the
+ * UCSSEL field is used as given and must select the clock for which
+ * @p divisor_q12 was computed.
+ *
+ * @param divisor_q12 the baud rate divisor as computed by
+ * #BSP430_SERIAL_UART_DIVISOR_Q12().  The integer part must be
+ * nonzero, and no greater than the peripheral's baud rate generator
+ * can express: 65535 for USCI, which does not oversample, and
+ * 2<sup>20</sup>-1 for eUSCI.
+ *
+ * @return A peripheral-specific HAL handle if the allocation and
+ * configuration is successful, and a null handle if something went
+ * wrong.
+ *
+ * @delegated This function exists only as an inline delegate to a
+ * peripheral-specific implementation.
+ *
+ * @dependency #configBSP430_SERIAL_ENABLE_UART */
+static BSP430_CORE_INLINE
+hBSP430halSERIAL hBSP430serialOpenUARTDivisor (hBSP430halSERIAL hal,
+                                               unsigned char ctl0_byte,
+                                               unsigned char ctl1_byte,
+                                               unsigned long divisor_q12)
+{
+  return BSP430_SERIAL_DISPATCH_(hal, openUARTDivisor, h, OpenUARTDivisor)(hal, ctl0_byte, ctl1_byte, divisor_q12);
+}
+
 /** Request and configure a serial device in UART mode.
  *
  * @param hal the handle for the HAL interface for the serial device
@@ -215,6 +613,7 @@
  * requested baud rate; otherwise SMCLK will be used.  The function
  * invokes ulBSP430clockSMCLK_Hz() and uiBSP430clockACLK_Hz() as
  * necessary to determine the actual speed of the baud rate clock.
+ * See also #configBSP430_SERIAL_UART_STATIC_DIVISOR.
  *
  * @return A peripheral-specific HAL handle if the allocation and
  * configuration is successful, and a null handle if something went
@@ -230,7 +629,17 @@ hBSP430halSERIAL hBSP430serialOpenUART (hBSP430halSERIAL hal,
                                         unsigned char ctl1_byte,
                                         unsigned long baud)
 {
-  return hal->dispatch->openUART(hal, ctl0_byte, ctl1_byte, baud);
+#if configBSP430_SERIAL_UART_STATIC_DIVISOR - 0
+  if (__builtin_constant_p(baud)
+      && ((3 * baud) > BSP430_CLOCK_NOMINAL_XT1CLK_HZ)
+      && (1000000UL >= baud)
+      && ((BSP430_SERIAL_UART_STATIC_BRCLK_HZ >> 16) < baud)) {
+    return hBSP430serialOpenUARTDivisor(hal, ctl0_byte,
+                                        (ctl1_byte & ~(UCSSEL1 | UCSSEL0)) | UCSSEL_2,
+                                        BSP430_SERIAL_UART_DIVISOR_Q12(BSP430_SERIAL_UART_STATIC_BRCLK_HZ, baud));
+  }
+#endif /* configBSP430_SERIAL_UART_STATIC_DIVISOR */
+  return BSP430_SERIAL_DISPATCH_(hal, openUART, h, OpenUART)(hal, ctl0_byte, ctl1_byte, baud);
 }
 
 /** Receive a byte from a UART-configured device.
@@ -251,7 +660,7 @@ hBSP430halSERIAL hBSP430serialOpenUART (hBSP430halSERIAL hal,
 static BSP430_CORE_INLINE
 int iBSP430uartRxByte_ni (hBSP430halSERIAL hal)
 {
-  return hal->dispatch->uartRxByte_ni(hal);
+  return BSP430_SERIAL_DISPATCH_(hal, uartRxByte_ni, i, UARTrxByte_ni)(hal);
 }
 
 /** Transmit a byte over a UART-configured device.
@@ -274,7 +683,7 @@ int iBSP430uartRxByte_ni (hBSP430halSERIAL hal)
 static BSP430_CORE_INLINE
 int iBSP430uartTxByte_ni (hBSP430halSERIAL hal, uint8_t c)
 {
-  return hal->dispatch->uartTxByte_ni(hal, c);
+  return BSP430_SERIAL_DISPATCH_(hal, uartTxByte_ni, i, UARTtxByte_ni)(hal, c);
 }
 
 /** Transmit a block of data over a UART-configured device.
@@ -300,7 +709,7 @@ int iBSP430uartTxData_ni (hBSP430halSERIAL hal,
                           const uint8_t * data,
                           size_t len)
 {
-  return hal->dispatch->uartTxData_ni(hal, data, len);
+  return BSP430_SERIAL_DISPATCH_(hal, uartTxData_ni, i, UARTtxData_ni)(hal, data, len);
 }
 
 /** Transmit a sequence of characters over a UART-configured device.
@@ -325,8 +734,154 @@ int iBSP430uartTxData_ni (hBSP430halSERIAL hal,
 static BSP430_CORE_INLINE
 int iBSP430uartTxASCIIZ_ni (hBSP430halSERIAL hal, const char * str)
 {
-  return hal->dispatch->uartTxASCIIZ_ni(hal, str);
+  return BSP430_SERIAL_DISPATCH_(hal, uartTxASCIIZ_ni, i, UARTtxASCIIZ_ni)(hal, str);
 }
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+
+/** Bit set in the events passed to #iBSP430uartRxRingCallback_ni
+ * when no octet has been received for the idle interval and
+ * unconsumed data is present in the ring. */
+#define BSP430_UART_RX_RING_EVENT_IDLE 0x01
+
+/** Bit set in the events passed to #iBSP430uartRxRingCallback_ni
+ * when the first half of the ring has been filled. */
+#define BSP430_UART_RX_RING_EVENT_HALF 0x02
+
+/** Bit set in the events passed to #iBSP430uartRxRingCallback_ni
+ * when the second half of the ring has been filled and reception has
+ * wrapped to the start. */
+#define BSP430_UART_RX_RING_EVENT_FULL 0x04
+
+/** Bit set in the events passed to #iBSP430uartRxRingCallback_ni,
+ * along with #BSP430_UART_RX_RING_EVENT_HALF or
+ * #BSP430_UART_RX_RING_EVENT_FULL, when the application has fallen a
+ * full ring behind the channel, which has therefore overwritten
+ * octets that were not consumed.  Unread octets older than the half
+ * just filled are discarded, so that reading resumes at its start. */
+#define BSP430_UART_RX_RING_EVENT_OVERRUN 0x08
+
+/** A handle to a DMA receive ring. */
+typedef struct sBSP430uartRxRing * hBSP430uartRxRing;
+
+/** Callback invoked from interrupt context when a DMA receive ring
+ * has data for the application.
+ *
+ * The callback may consume data with iBSP430uartRxRingRead_ni().
+ *
+ * @param ring the ring with data available
+ *
+ * @param events a combination of #BSP430_UART_RX_RING_EVENT_IDLE,
+ * #BSP430_UART_RX_RING_EVENT_HALF, #BSP430_UART_RX_RING_EVENT_FULL,
+ * and #BSP430_UART_RX_RING_EVENT_OVERRUN
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+typedef int (* iBSP430uartRxRingCallback_ni) (hBSP430uartRxRing ring,
+                                              int events);
+
+/** State for continuous DMA reception into a ring buffer.
+ *
+ * A DMA channel in repeated single-transfer mode copies each octet
+ * from the receive buffer of the device into alternate halves of the
+ * ring, so the CPU is involved only when a half fills or the line
+ * goes idle.  The application must consume data before the channel
+ * returns to it, i.e. within the time required to receive half the
+ * ring.  Overrun is detected when a half fills: if a full ring is
+ * unread, octets older than that half are discarded,
+ * #BSP430_UART_RX_RING_EVENT_OVERRUN is passed to the callback, and,
+ * if #configBSP430_SERIAL_ERROR_COUNTERS is enabled, the discarded
+ * octets are added to @link sBSP430serialErrors.rx_dropped
+ * rx_dropped@endlink.
+ *
+ * While a ring is attached the receive callback chain of the device
+ * must be empty and iBSP430uartRxByte_ni() must not be used.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430uartRxRing {
+  /** @cond DOXYGEN_EXCLUDE */
+  struct sBSP430halISRIndexedChainNode dma_cb;
+  struct sBSP430timerAlarm alarm;
+  hBSP430timerAlarm alarm_h;
+  hBSP430halSERIAL uart;
+  uint8_t * buffer;
+  unsigned int size;
+  unsigned int tail;
+  int unread;
+  unsigned int idle_mark;
+  unsigned long idle_utt;
+  iBSP430uartRxRingCallback_ni callback_ni;
+  signed char channel;
+  unsigned char second_half;
+  unsigned char idle_reported;
+  /** @endcond */
+} sBSP430uartRxRing;
+
+/** Begin DMA reception into a ring buffer.
+ *
+ * @param ring the ring state structure.  This must remain valid
+ * until the ring is detached with iBSP430uartRxRingRelease().
+ *
+ * @param uart the serial device, already opened with
+ * hBSP430serialOpenUART() and with no receive callbacks registered
+ *
+ * @param buffer storage for received octets
+ *
+ * @param size the length of @p buffer.  This must be even and at
+ * least 2.
+ *
+ * @param callback_ni the function to be notified of ring events
+ *
+ * @param alarm_ccidx the capture/compare register of the uptime timer
+ * to be used for idle-line detection, or a negative value to disable
+ * it.  The register must not be used for any other purpose while the
+ * ring is attached.
+ *
+ * @param idle_utt the idle-line interval, in ticks of the uptime
+ * timer.  The line is sampled at this interval, so an idle event is
+ * raised between one and two intervals after the last octet arrives.
+ *
+ * @return a handle to the ring, or a null pointer if the device has
+ * no DMA trigger or has receive callbacks, the arguments are
+ * invalid, no DMA channel is available, or an idle alarm was
+ * requested but could not be configured. */
+hBSP430uartRxRing hBSP430uartRxRingInitialize (sBSP430uartRxRing * ring,
+                                               hBSP430halSERIAL uart,
+                                               uint8_t * buffer,
+                                               unsigned int size,
+                                               iBSP430uartRxRingCallback_ni callback_ni,
+                                               int alarm_ccidx,
+                                               unsigned long idle_utt);
+
+/** Stop DMA reception and release its resources.
+ *
+ * Unconsumed data in the ring is discarded.
+ *
+ * @param ring the ring to be detached
+ *
+ * @return 0 */
+int iBSP430uartRxRingRelease (hBSP430uartRxRing ring);
+
+/** Determine the number of unconsumed octets in a receive ring.
+ *
+ * @param ring the ring to be inspected
+ *
+ * @return the number of octets that may be read */
+int iBSP430uartRxRingAvailable_ni (hBSP430uartRxRing ring);
+
+/** Consume octets from a receive ring.
+ *
+ * @param ring the ring from which data is read
+ *
+ * @param dst where the octets should be stored
+ *
+ * @param len the maximum number of octets to read
+ *
+ * @return the number of octets stored in @p dst */
+int iBSP430uartRxRingRead_ni (hBSP430uartRxRing ring,
+                              uint8_t * dst,
+                              size_t len);
+
+#endif /* configBSP430_SERIAL_UART_RX_USE_DMA */
 #endif /* configBSP430_SERIAL_ENABLE_UART */
 
 #if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_ENABLE_SPI - 0)
@@ -370,7 +925,7 @@ hBSP430halSERIAL hBSP430serialOpenSPI (hBSP430halSERIAL hal,
                                        unsigned char ctl1_byte,
                                        unsigned int prescaler)
 {
-  return hal->dispatch->openSPI(hal, ctl0_byte, ctl1_byte, prescaler);
+  return BSP430_SERIAL_DISPATCH_(hal, openSPI, h, OpenSPI)(hal, ctl0_byte, ctl1_byte, prescaler);
 }
 
 /** Transmit and receive using a SPI-configured device
@@ -417,9 +972,326 @@ int iBSP430spiTxRx_ni (hBSP430halSERIAL hal,
                        size_t rx_len,
                        uint8_t * rx_data)
 {
-  return hal->dispatch->spiTxRx_ni(hal, tx_data, tx_len, rx_len, rx_data);
+  return BSP430_SERIAL_DISPATCH_(hal, spiTxRx_ni, i, SPITxRx_ni)(hal, tx_data, tx_len, rx_len, rx_data);
+}
+
+/** Change the configuration of an open SPI device in place.
+ *
+ * The device must have been opened with hBSP430serialOpenSPI().  The
+ * new configuration is compared with the one loaded in the
+ * peripheral, and only the registers that differ are rewritten.  If
+ * nothing differs the device is not disturbed at all; otherwise it
+ * is held in reset only for the duration of the update.  Pins are
+ * not reconfigured, so the new configuration must use the same
+ * number of pins (3-wire or 4-wire) as the current one.
+ *
+ * Any transmission in progress is allowed to complete before the
+ * device is changed.  Receive interrupts are re-enabled if a receive
+ * callback is registered.
+ *
+ * @param hal the SPI device to be changed
+ *
+ * @param ctl0_byte as with hBSP430serialOpenSPI()
+ *
+ * @param ctl1_byte as with hBSP430serialOpenSPI()
+ *
+ * @param prescaler as with hBSP430serialOpenSPI()
+ *
+ * @return 0 if the device has the requested configuration, or -1 if
+ * @p prescaler is zero or the requested mode would require different
+ * pins.  On error the device is unchanged, and
+ * iBSP430serialClose() followed by hBSP430serialOpenSPI() must be
+ * used to change it.
+ *
+ * @delegated This function exists only as an inline delegate to a
+ * peripheral-specific implementation. */
+static BSP430_CORE_INLINE
+int iBSP430spiReconfigure_ni (hBSP430halSERIAL hal,
+                              unsigned char ctl0_byte,
+                              unsigned char ctl1_byte,
+                              unsigned int prescaler)
+{
+  return BSP430_SERIAL_DISPATCH_(hal, spiReconfigure_ni, i, SPIReconfigure_ni)(hal, ctl0_byte, ctl1_byte, prescaler);
+}
+
+struct sBSP430spiTransaction;
+
+/** A handle to an asynchronous SPI transaction descriptor. */
+typedef struct sBSP430spiTransaction * hBSP430spiTransaction;
+
+/** Callback invoked from interrupt context when a queued SPI
+ * transaction completes.
+ *
+ * The chip select for the transaction has already been deasserted,
+ * the transaction has been removed from the queue, and
+ * sBSP430spiTransaction.result holds the number of octets exchanged.
+ * The callback may resubmit the transaction.
+ *
+ * @param txn the transaction that completed
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid.  Most callbacks
+ * return #BSP430_HAL_ISR_CALLBACK_EXIT_LPM so that a main loop waiting
+ * in low power mode can process the result. */
+typedef int (* iBSP430spiTransactionCallback_ni) (hBSP430spiTransaction txn);
+
+/** Descriptor for an asynchronous SPI transaction.
+ *
+ * The exchange follows the same protocol as iBSP430spiTxRx_ni(): @a
+ * tx_len octets from @a tx_data are transmitted, followed by @a rx_len
+ * octets of #BSP430_SERIAL_SPI_READ_TX_BYTE filler, and all octets
+ * received are stored in @a rx_data if it is not null.
+ *
+ * The descriptor is owned by the queue from the time it is submitted
+ * through iBSP430spiQueueSubmit_ni() until its completion callback is
+ * invoked, and must not be modified during that period. */
+typedef struct sBSP430spiTransaction {
+  /** Link to the next queued transaction.  Managed by the queue. */
+  struct sBSP430spiTransaction * volatile next_ni;
+
+  /** The command octets to be transmitted.  May be null only if @a
+   * tx_len is zero. */
+  const uint8_t * tx_data;
+
+  /** The number of octets in @a tx_data */
+  size_t tx_len;
+
+  /** The number of additional octets to be received after the
+   * command */
+  size_t rx_len;
+
+  /** Where the @a tx_len + @a rx_len received octets are stored, or a
+   * null pointer if they are not of interest */
+  uint8_t * rx_data;
+
+  /** Optional hook invoked from the queue with a nonzero @p select
+   * immediately before the first octet of the transaction is
+   * transmitted, and with a zero @p select after the last octet has
+   * been received.  This is normally used to control the chip select
+   * line of the device addressed by the transaction. */
+  void (* chip_select_ni) (hBSP430spiTransaction txn, int select);
+
+  /** Optional callback invoked when the transaction completes.  If
+   * null, completion returns #BSP430_HAL_ISR_CALLBACK_EXIT_LPM. */
+  iBSP430spiTransactionCallback_ni callback_ni;
+
+  /** Set to -1 when the transaction is submitted, and to the number
+   * of octets exchanged when it completes. */
+  volatile int result;
+} sBSP430spiTransaction;
+
+/** State for a queue of asynchronous SPI transactions on a single
+ * serial device.
+ *
+ * The queue hooks the receive and transmit callback chains of the
+ * device, so the interrupt service routine for the device must be
+ * enabled (e.g., #configBSP430_HAL_USCI5_B0_ISR).  Transactions are
+ * advanced one octet at a time: the transmit interrupt supplies an
+ * octet, and reception of the response either requests the next
+ * octet or completes the transaction and starts the next one.
+ *
+ * While a queue is attached the synchronous iBSP430spiTxRx_ni() is
+ * unavailable on the device, as it refuses to run when transmit
+ * callbacks are present.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430spiQueue {
+  /** @cond DOXYGEN_EXCLUDE */
+  sBSP430halISRVoidChainNode rx_cb;
+  sBSP430halISRVoidChainNode tx_cb;
+  hBSP430halSERIAL spi;
+  hBSP430spiTransaction volatile head_ni;
+  hBSP430spiTransaction tail_ni;
+  size_t idx;
+  /** @endcond */
+} sBSP430spiQueue;
+
+/** A handle to an asynchronous SPI transaction queue. */
+typedef struct sBSP430spiQueue * hBSP430spiQueue;
+
+/** Attach a transaction queue to an SPI-configured serial device.
+ *
+ * @param queue the queue state structure.  This must remain valid
+ * until the queue is detached with iBSP430spiQueueRelease().
+ *
+ * @param spi the serial device, already opened with
+ * hBSP430serialOpenSPI()
+ *
+ * @return a handle to the queue, or a null pointer if @p spi is
+ * invalid. */
+hBSP430spiQueue hBSP430spiQueueInitialize (sBSP430spiQueue * queue,
+                                           hBSP430halSERIAL spi);
+
+/** Detach a transaction queue from its serial device.
+ *
+ * @param queue the queue to be detached.  It must be idle (see
+ * iBSP430spiQueueIdle_ni()).
+ *
+ * @return 0 if the queue was detached, -1 if transactions remain
+ * queued. */
+int iBSP430spiQueueRelease (hBSP430spiQueue queue);
+
+/** Submit a transaction to a queue.
+ *
+ * The transaction is appended to the queue; if the queue was idle it
+ * begins immediately.  This function returns without waiting for the
+ * transaction to complete.
+ *
+ * @param queue the queue on which the transaction is performed
+ *
+ * @param txn the transaction descriptor
+ *
+ * @return 0 if the transaction was queued, or -1 if it has no octets
+ * to exchange. */
+int iBSP430spiQueueSubmit_ni (hBSP430spiQueue queue,
+                              hBSP430spiTransaction txn);
+
+/** Determine whether a transaction queue has work outstanding.
+ *
+ * @return nonzero if no transactions are queued or in progress. */
+static BSP430_CORE_INLINE
+int iBSP430spiQueueIdle_ni (hBSP430spiQueue queue)
+{
+  return NULL == queue->head_ni;
+}
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_SPI_BUS - 0)
+
+struct sBSP430spiBus;
+
+/** A device sharing an SPI bus.
+ *
+ * The structure records the peripheral configuration the device
+ * requires and the port pin used as its active-low chip select.  It
+ * is filled in by iBSP430spiBusDeviceRegister().
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430spiBusDevice {
+  /** @cond DOXYGEN_EXCLUDE */
+  struct sBSP430spiBus * bus;
+  hBSP430halPORT cs_port;
+  unsigned char cs_bit;
+  unsigned char ctl0_byte;
+  unsigned char ctl1_byte;
+  unsigned int prescaler;
+  /** @endcond */
+} sBSP430spiBusDevice;
+
+/** A handle to a device sharing an SPI bus. */
+typedef struct sBSP430spiBusDevice * hBSP430spiBusDevice;
+
+/** State for an SPI peripheral shared by several devices.
+ *
+ * The bus tracks which device's configuration is loaded into the
+ * peripheral, so that selecting the same device repeatedly, or a
+ * device with a similar configuration, costs little more than
+ * toggling the chip select.  At most one device may be selected at
+ * a time.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430spiBus {
+  /** @cond DOXYGEN_EXCLUDE */
+  hBSP430halSERIAL spi;
+  hBSP430spiBusDevice configured;
+  hBSP430spiBusDevice volatile owner_ni;
+  /** @endcond */
+} sBSP430spiBus;
+
+/** A handle to a shared SPI bus. */
+typedef struct sBSP430spiBus * hBSP430spiBus;
+
+/** Prepare an SPI bus for sharing among devices.
+ *
+ * The peripheral is not opened until a device is first selected,
+ * using the configuration of that device.
+ *
+ * @param bus the bus state structure
+ *
+ * @param spi the serial HAL of the shared peripheral, as obtained
+ * from hBSP430serialLookup().  It must not already be open.
+ *
+ * @return a handle to the bus, or a null pointer if @p spi is
+ * null. */
+hBSP430spiBus hBSP430spiBusInitialize (sBSP430spiBus * bus,
+                                       hBSP430halSERIAL spi);
+
+/** Register a device on a shared SPI bus.
+ *
+ * The chip select pin is configured as a digital output and
+ * deasserted (driven high).
+ *
+ * @param bus the bus to which the device is attached
+ *
+ * @param dev the device state structure
+ *
+ * @param ctl0_byte the peripheral configuration required by the
+ * device, as with hBSP430serialOpenSPI()
+ *
+ * @param ctl1_byte as with hBSP430serialOpenSPI()
+ *
+ * @param prescaler as with hBSP430serialOpenSPI()
+ *
+ * @param cs_port the port HAL for the chip select pin, or a null
+ * pointer if the device has no chip select under bus control
+ *
+ * @param cs_bit the bit of the chip select pin within @p cs_port
+ *
+ * @return a handle to the device, or a null pointer if @p prescaler
+ * is zero. */
+hBSP430spiBusDevice hBSP430spiBusDeviceRegister (hBSP430spiBus bus,
+                                                 sBSP430spiBusDevice * dev,
+                                                 unsigned char ctl0_byte,
+                                                 unsigned char ctl1_byte,
+                                                 unsigned int prescaler,
+                                                 hBSP430halPORT cs_port,
+                                                 unsigned char cs_bit);
+
+/** Take ownership of the bus for a device and assert its chip
+ * select.
+ *
+ * If the peripheral is not configured for @p dev, the registers that
+ * differ are updated with iBSP430spiReconfigure_ni(); if that is not
+ * possible the peripheral is closed and reopened.  On success the
+ * peripheral handle for use with iBSP430spiTxRx_ni() is available
+ * through xBSP430spiBusSerial().
+ *
+ * @param dev the device to be selected
+ *
+ * @return 0 if @p dev owns the bus, or -1 if another device owns
+ * it or the peripheral could not be configured. */
+int iBSP430spiBusSelect_ni (hBSP430spiBusDevice dev);
+
+/** Deassert a device's chip select and release the bus.
+ *
+ * Any transmission in progress is allowed to complete first.  The
+ * peripheral configuration is left loaded, so selecting the same
+ * device again does not touch the peripheral.
+ *
+ * @param dev the device that owns the bus
+ *
+ * @return 0 if the bus was released, or -1 if @p dev did not own
+ * it. */
+int iBSP430spiBusDeselect_ni (hBSP430spiBusDevice dev);
+
+/** Close the peripheral underlying a shared SPI bus.
+ *
+ * Registered devices remain registered; the next selection reopens
+ * the peripheral.
+ *
+ * @param bus the bus to be closed
+ *
+ * @return 0 if the bus was closed, or -1 if a device owns it or
+ * closing the peripheral failed. */
+int iBSP430spiBusClose (hBSP430spiBus bus);
+
+/** Return the serial HAL underlying a shared SPI bus. */
+static BSP430_CORE_INLINE
+hBSP430halSERIAL xBSP430spiBusSerial (hBSP430spiBus bus)
+{
+  return bus->spi;
 }
 
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 
 #if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_ENABLE_I2C - 0)
@@ -462,7 +1334,7 @@ hBSP430halSERIAL hBSP430serialOpenI2C (hBSP430halSERIAL hal,
                                        unsigned char ctl1_byte,
                                        unsigned int prescaler)
 {
-  return hal->dispatch->openI2C(hal, ctl0_byte, ctl1_byte, prescaler);
+  return BSP430_SERIAL_DISPATCH_(hal, openI2C, h, OpenI2C)(hal, ctl0_byte, ctl1_byte, prescaler);
 }
 
 /** Configure I2C addresses
@@ -473,8 +1345,11 @@ hBSP430halSERIAL hBSP430serialOpenI2C (hBSP430halSERIAL hal,
  *
  * @param hal the serial device to be configured
  *
- * @param own_address the value to use as this device's address.  A
- * negative value leaves the current configured own address unchanged.
+ * @param own_address the value to use as this device's address,
+ * to which it responds when operating as a slave (see
+ * hBSP430i2cSlaveInitialize()).  The peripheral is briefly held in
+ * reset while the address is changed.  A negative value leaves the
+ * current configured own address unchanged.
  *
  * @param slave_address the value to use as the slave address.  A
  * negative value leaves the current configured slave address
@@ -486,7 +1361,7 @@ int iBSP430i2cSetAddresses_ni (hBSP430halSERIAL hal,
                                int own_address,
                                int slave_address)
 {
-  return hal->dispatch->i2cSetAddresses_ni(hal, own_address, slave_address);
+  return BSP430_SERIAL_DISPATCH_(hal, i2cSetAddresses_ni, i, I2CsetAddresses_ni)(hal, own_address, slave_address);
 }
 
 /** Transmit using an I2C-configured device
@@ -518,7 +1393,7 @@ int iBSP430i2cTxData_ni (hBSP430halSERIAL hal,
                          const uint8_t * tx_data,
                          size_t tx_len)
 {
-  return hal->dispatch->i2cTxData_ni(hal, tx_data, tx_len);
+  return BSP430_SERIAL_DISPATCH_(hal, i2cTxData_ni, i, I2CtxData_ni)(hal, tx_data, tx_len);
 }
 
 /** Receive using an I2C-configured device
@@ -550,8 +1425,384 @@ int iBSP430i2cRxData_ni (hBSP430halSERIAL hal,
                          uint8_t * rx_data,
                          size_t rx_len)
 {
-  return hal->dispatch->i2cRxData_ni(hal, rx_data, rx_len);
+  return BSP430_SERIAL_DISPATCH_(hal, i2cRxData_ni, i, I2CrxData_ni)(hal, rx_data, rx_len);
+}
+
+/** Write then read using an I2C-configured device
+ *
+ * This routine transmits @p tx_len octets from @p tx_data, then
+ * issues a repeated start and receives @p rx_len octets into @p
+ * rx_data, terminating the transaction with a stop.  This is the
+ * normal way to read a register from an I2C device: the register
+ * pointer and the read occupy a single bus transaction, which some
+ * devices require.  When only one octet is read the stop is requested
+ * as soon as the slave acknowledges its address, so it is correctly
+ * placed after that octet.
+ *
+ * If either phase is empty this is equivalent to
+ * iBSP430i2cTxData_ni() or iBSP430i2cRxData_ni().
+ *
+ * The same restrictions on callbacks apply as for
+ * iBSP430i2cTxData_ni().
+ *
+ * @param hal the serial device over which the data is transmitted and
+ * received
+ *
+ * @param tx_data the data to be transmitted
+ *
+ * @param tx_len the number of bytes to transmit
+ *
+ * @param rx_len the number of bytes expected in response
+ *
+ * @param rx_data where to store the data.  The space available must
+ * be at least @p rx_len octets.
+ *
+ * @return the total number of bytes transmitted and received, or -1
+ * if an error occcured.
+ */
+static BSP430_CORE_INLINE
+int iBSP430i2cTxRx_ni (hBSP430halSERIAL hal,
+                       const uint8_t * tx_data,
+                       size_t tx_len,
+                       size_t rx_len,
+                       uint8_t * rx_data)
+{
+  return BSP430_SERIAL_DISPATCH_(hal, i2cTxRx_ni, i, I2CtxRx_ni)(hal, tx_data, tx_len, rx_len, rx_data);
 }
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_USE_ISR - 0)
+
+/** Value of sBSP430i2cTransaction.result when the addressed slave did
+ * not acknowledge its address or an octet written to it. */
+#define BSP430_I2C_RESULT_NACK -2
+
+/** Value of sBSP430i2cTransaction.result when another master won
+ * arbitration for the bus. */
+#define BSP430_I2C_RESULT_ARBITRATION_LOST -3
+
+/** Value of sBSP430i2cTransaction.result when the transaction did not
+ * complete within sBSP430i2cTransaction.timeout_utt, or on the USCI5
+ * when the address of a single-octet read was not acknowledged within
+ * #BSP430_USCI5_I2C_START_WAIT_LOOPS.  The peripheral is reset to
+ * release the bus. */
+#define BSP430_I2C_RESULT_TIMEOUT -4
+
+/** The interval, in ticks of the uptime timer, after which a queue
+ * retries a transaction that could not be started because the stop
+ * ending the previous transaction was still in progress.  Only the
+ * USCI5 defers starts in this way, since it does not signal the
+ * completion of a stop in master mode.
+ *
+ * @defaulted */
+#ifndef BSP430_I2C_QUEUE_RETRY_UTT
+#define BSP430_I2C_QUEUE_RETRY_UTT (BSP430_TIMER_ALARM_FUTURE_LIMIT + 1)
+#endif /* BSP430_I2C_QUEUE_RETRY_UTT */
+
+/** A handle to an asynchronous I2C transaction descriptor. */
+typedef struct sBSP430i2cTransaction * hBSP430i2cTransaction;
+
+/** Callback invoked from interrupt context when a queued I2C
+ * transaction completes.
+ *
+ * The transaction has been removed from the queue, and
+ * sBSP430i2cTransaction.result holds its outcome.  The callback may
+ * resubmit the transaction.
+ *
+ * @param txn the transaction that completed
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+typedef int (* iBSP430i2cTransactionCallback_ni) (hBSP430i2cTransaction txn);
+
+/** Descriptor for an asynchronous I2C master transaction.
+ *
+ * The transaction writes @a tx_len octets from @a tx_data to the
+ * slave, then reads @a rx_len octets from it into @a rx_data.  Either
+ * phase may be empty.  When both are present the read is introduced
+ * by a repeated start on USCI5; on eUSCI, which is configured for
+ * automatic stop generation, each phase is a separate bus
+ * transaction.
+ *
+ * The descriptor is owned by the queue from the time it is submitted
+ * through iBSP430i2cQueueSubmit_ni() until its completion callback is
+ * invoked, and must not be modified during that period. */
+typedef struct sBSP430i2cTransaction {
+  /** Link to the next queued transaction.  Managed by the queue. */
+  struct sBSP430i2cTransaction * volatile next_ni;
+
+  /** The address of the slave.  A negative value uses the slave
+   * address most recently configured on the device. */
+  int slave_address;
+
+  /** The octets to be written.  May be null only if @a tx_len is
+   * zero. */
+  const uint8_t * tx_data;
+
+  /** The number of octets in @a tx_data */
+  size_t tx_len;
+
+  /** Where the octets read from the slave are stored.  May be null
+   * only if @a rx_len is zero. */
+  uint8_t * rx_data;
+
+  /** The number of octets to be read */
+  size_t rx_len;
+
+  /** The maximum duration of the transaction, in ticks of the uptime
+   * timer, measured from the point where it reaches the head of the
+   * queue.  This includes any wait for the bus to be released by the
+   * previous transaction.  Zero, or a queue initialized without a
+   * timeout alarm, disables the timeout. */
+  unsigned long timeout_utt;
+
+  /** Optional callback invoked when the transaction completes.  If
+   * null, completion returns #BSP430_HAL_ISR_CALLBACK_EXIT_LPM. */
+  iBSP430i2cTransactionCallback_ni callback_ni;
+
+  /** Set to -1 when the transaction is submitted.  On completion
+   * this holds the total number of octets transferred, or one of
+   * #BSP430_I2C_RESULT_NACK, #BSP430_I2C_RESULT_ARBITRATION_LOST, or
+   * #BSP430_I2C_RESULT_TIMEOUT. */
+  volatile int result;
+} sBSP430i2cTransaction;
+
+/** State for a queue of asynchronous I2C master transactions on a
+ * single serial device.
+ *
+ * Start, address, data, and stop phases are sequenced from the
+ * interrupt service routine of the device, so the CPU is only
+ * involved once per octet and at error conditions.  If the queue was
+ * initialized with a timeout alarm, a transaction that exceeds its
+ * sBSP430i2cTransaction.timeout_utt is aborted by the alarm callback.
+ *
+ * A transaction that cannot start because the previous stop is still
+ * on the bus is retried every #BSP430_I2C_QUEUE_RETRY_UTT ticks by
+ * the same alarm.  Without an alarm it is retried by
+ * iBSP430i2cQueueIdle_ni(), so such a queue must be polled rather
+ * than awaited in a low power mode.
+ *
+ * While a queue is attached the synchronous iBSP430i2cTxData_ni() and
+ * iBSP430i2cRxData_ni() must not be used on the device.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430i2cQueue {
+  /** @cond DOXYGEN_EXCLUDE */
+  struct sBSP430timerAlarm alarm;
+  hBSP430timerAlarm alarm_h;
+  hBSP430halSERIAL i2c;
+  hBSP430i2cTransaction volatile head_ni;
+  hBSP430i2cTransaction tail_ni;
+  size_t idx;
+  unsigned long deadline_utt;
+  unsigned char deferred;
+  /** @endcond */
+} sBSP430i2cQueue;
+
+/** A handle to an asynchronous I2C transaction queue. */
+typedef struct sBSP430i2cQueue * hBSP430i2cQueue;
+
+/** Attach a transaction queue to an I2C-configured serial device.
+ *
+ * @param queue the queue state structure.  This must remain valid
+ * until the queue is detached with iBSP430i2cQueueRelease().
+ *
+ * @param i2c the serial device, already opened in master mode with
+ * hBSP430serialOpenI2C()
+ *
+ * @param alarm_ccidx the capture/compare register of the uptime timer
+ * to be used for transaction timeouts, or a negative value if
+ * timeouts are not supported.  The register must not be used for any
+ * other purpose while the queue is attached.
+ *
+ * @return a handle to the queue, or a null pointer if @p i2c does not
+ * support interrupt-driven I2C, already has a queue attached, or a
+ * timeout alarm was requested but could not be configured. */
+hBSP430i2cQueue hBSP430i2cQueueInitialize (sBSP430i2cQueue * queue,
+                                           hBSP430halSERIAL i2c,
+                                           int alarm_ccidx);
+
+/** Detach a transaction queue from its serial device.
+ *
+ * @param queue the queue to be detached.  It must be idle (see
+ * iBSP430i2cQueueIdle_ni()).
+ *
+ * @return 0 if the queue was detached, -1 if transactions remain
+ * queued. */
+int iBSP430i2cQueueRelease (hBSP430i2cQueue queue);
+
+/** Submit a transaction to a queue.
+ *
+ * The transaction is appended to the queue; if the queue was idle it
+ * begins immediately.  This function returns without waiting for the
+ * transaction to complete.
+ *
+ * @param queue the queue on which the transaction is performed
+ *
+ * @param txn the transaction descriptor
+ *
+ * @return 0 if the transaction was queued, or -1 if it has no octets
+ * to transfer, lacks a required buffer, or has a phase longer than
+ * 255 octets. */
+int iBSP430i2cQueueSubmit_ni (hBSP430i2cQueue queue,
+                              hBSP430i2cTransaction txn);
+
+/** Determine whether a transaction queue has work outstanding.
+ *
+ * If the queue has no timeout alarm and the start of the transaction
+ * at its head was deferred until the bus is released, the start is
+ * retried first.
+ *
+ * @return nonzero if no transactions are queued or in progress. */
+int iBSP430i2cQueueIdle_ni (hBSP430i2cQueue queue);
+
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_SLAVE - 0)
+
+/** A handle to an I2C slave register file. */
+typedef struct sBSP430i2cSlave * hBSP430i2cSlave;
+
+/** Callback invoked from interrupt context to obtain the value of a
+ * register that is about to be loaded for transmission to the
+ * master.
+ *
+ * Because the slave prefetches the octet that follows the one being
+ * transmitted, this may be invoked for an octet the master does not
+ * end up reading.  Registers with read side effects (e.g. a FIFO
+ * that is popped when read) must tolerate this.
+ *
+ * @param slave the slave from which the master is reading
+ *
+ * @param reg the index of the register
+ *
+ * @return the value to be transmitted (0 through 255), or a negative
+ * value to transmit the content of the register file. */
+typedef int (* iBSP430i2cSlaveReadCallback_ni) (hBSP430i2cSlave slave,
+                                                unsigned int reg);
+
+/** Callback invoked from interrupt context when the master writes a
+ * register.
+ *
+ * @param slave the slave to which the master is writing
+ *
+ * @param reg the index of the register
+ *
+ * @param value the octet written by the master
+ *
+ * @return a negative value to discard the octet (e.g. for a
+ * read-only register); otherwise the octet is stored in the register
+ * file and the value is interpreted as flags as with
+ * #iBSP430halISRCallbackVoid. */
+typedef int (* iBSP430i2cSlaveWriteCallback_ni) (hBSP430i2cSlave slave,
+                                                 unsigned int reg,
+                                                 uint8_t value);
+
+/** Callback invoked from interrupt context when the master ends a
+ * transaction addressed to the slave with a stop condition.
+ *
+ * @param slave the slave that was addressed
+ *
+ * @param first_reg the register pointer written by the master at the
+ * start of the transaction
+ *
+ * @param num_written the number of register octets written by the
+ * master in the transaction, excluding the register pointer.  This
+ * is zero for a pure read.
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+typedef int (* iBSP430i2cSlaveStopCallback_ni) (hBSP430i2cSlave slave,
+                                                unsigned int first_reg,
+                                                unsigned int num_written);
+
+/** State for an I2C slave that exposes a register file to the bus
+ * master.
+ *
+ * The protocol is the common one used by I2C sensors: the first
+ * octet the master writes after addressing the slave sets the
+ * register pointer, and each further octet written is stored in the
+ * register at the pointer.  The master reads registers starting at
+ * the pointer, optionally after a repeated start following the
+ * pointer write.  The pointer increments after each octet written or
+ * read, wrapping to register zero after the last register (after
+ * register 255 if the file is empty).  Writes to registers beyond
+ * the end of the file are discarded, and reads of them return 0xFF,
+ * unless the callbacks handle them.
+ *
+ * Reads are served entirely from the interrupt service routine of
+ * the device.  The value of the next register is fetched as soon as
+ * the current one is loaded into the transmit buffer, so each octet
+ * is ready before the master clocks for it and the bus is not held
+ * between octets.  The master is held only for interrupt latency
+ * while the first octet of a read is loaded.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430i2cSlave {
+  /** @cond DOXYGEN_EXCLUDE */
+  hBSP430halSERIAL i2c;
+  uint8_t * regs;
+  unsigned int nregs;
+  iBSP430i2cSlaveReadCallback_ni read_cb_ni;
+  iBSP430i2cSlaveWriteCallback_ni write_cb_ni;
+  iBSP430i2cSlaveStopCallback_ni stop_cb_ni;
+  unsigned int reg;
+  unsigned int first_reg;
+  unsigned int num_written;
+  unsigned int tx_reg;
+  unsigned char flags;
+  uint8_t tx_prev;
+  volatile uint8_t tx_next;
+  /** @endcond */
+} sBSP430i2cSlave;
+
+/** Attach a register file to an I2C-configured serial device and
+ * begin responding to the bus master.
+ *
+ * The device must have been opened with hBSP430serialOpenI2C()
+ * without #UCMST, and its own address configured with
+ * iBSP430i2cSetAddresses_ni().
+ *
+ * @param slave the slave state structure.  This must remain valid
+ * until the slave is detached with iBSP430i2cSlaveRelease().
+ *
+ * @param i2c the serial device
+ *
+ * @param regs the register file.  This may be null if @p nregs is
+ * zero, in which case @p read_cb_ni and @p write_cb_ni supply all
+ * register content.
+ *
+ * @param nregs the number of registers in @p regs
+ *
+ * @param read_cb_ni optional callback to supply register values on
+ * read
+ *
+ * @param write_cb_ni optional callback to validate or act on register
+ * writes
+ *
+ * @param stop_cb_ni optional callback invoked at the end of each
+ * transaction
+ *
+ * @return a handle to the slave, or a null pointer if @p i2c does not
+ * support interrupt-driven I2C slave operation, is in master mode, or
+ * already has a slave or transaction queue attached. */
+hBSP430i2cSlave hBSP430i2cSlaveInitialize (sBSP430i2cSlave * slave,
+                                           hBSP430halSERIAL i2c,
+                                           uint8_t * regs,
+                                           unsigned int nregs,
+                                           iBSP430i2cSlaveReadCallback_ni read_cb_ni,
+                                           iBSP430i2cSlaveWriteCallback_ni write_cb_ni,
+                                           iBSP430i2cSlaveStopCallback_ni stop_cb_ni);
+
+/** Detach a register file from its serial device.
+ *
+ * The device stops generating slave interrupts.  It continues to
+ * acknowledge its own address, but holds the bus on any data
+ * transfer, so it should be placed in hold or closed.
+ *
+ * @param slave the slave to be detached
+ *
+ * @return 0 if the slave was detached, -1 if it was not attached. */
+int iBSP430i2cSlaveRelease (hBSP430i2cSlave slave);
+
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
 
 /** Place a serial device in hold mode
@@ -584,7 +1835,7 @@ static BSP430_CORE_INLINE
 int iBSP430serialSetHold_ni (hBSP430halSERIAL hal,
                              int holdp)
 {
-  return hal->dispatch->setHold_ni(hal, holdp);
+  return BSP430_SERIAL_DISPATCH_(hal, setHold_ni, i, SetHold_ni)(hal, holdp);
 }
 
 /** Release a serial device.
@@ -604,7 +1855,7 @@ int iBSP430serialSetHold_ni (hBSP430halSERIAL hal,
 static BSP430_CORE_INLINE
 int iBSP430serialClose (hBSP430halSERIAL hal)
 {
-  return hal->dispatch->close(hal);
+  return BSP430_SERIAL_DISPATCH_(hal, close, i, Close)(hal);
 }
 
 /** Wake up the interrupt-driven transmission if necessary.
@@ -626,7 +1877,7 @@ int iBSP430serialClose (hBSP430halSERIAL hal)
 static BSP430_CORE_INLINE
 void vBSP430serialWakeupTransmit_ni (hBSP430halSERIAL hal)
 {
-  hal->dispatch->wakeupTransmit_ni(hal);
+  BSP430_SERIAL_DISPATCH_(hal, wakeupTransmit_ni, v, WakeupTransmit_ni)(hal);
 }
 
 /** Spin until any in-progress transmission or reception is complete.
@@ -640,9 +1891,32 @@ void vBSP430serialWakeupTransmit_ni (hBSP430halSERIAL hal)
 static BSP430_CORE_INLINE
 void vBSP430serialFlush_ni (hBSP430halSERIAL hal)
 {
-  hal->dispatch->flush_ni(hal);
+  BSP430_SERIAL_DISPATCH_(hal, flush_ni, v, Flush_ni)(hal);
 }
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_ERROR_COUNTERS - 0)
+/** Retrieve the error counters of a serial device.
+ *
+ * The counters are copied with interrupts disabled, so the snapshot
+ * is consistent even while the device is active.
+ *
+ * @param hal a serial HAL handle
+ *
+ * @param snapshot where the counters are stored.  May be null if
+ * only @p reset is of interest.
+ *
+ * @param reset if nonzero, the counters are cleared after being
+ * copied.  This allows the caller to measure errors over an
+ * interval.
+ *
+ * @return 0 on success, or -1 if @p hal is null
+ *
+ * @dependency #configBSP430_SERIAL_ERROR_COUNTERS */
+int iBSP430serialSnapshotErrors (hBSP430halSERIAL hal,
+                                 sBSP430serialErrors * snapshot,
+                                 int reset);
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+
 #endif /* BSP430_SERIAL - 0 */
 
 #if configBSP430_SERIAL_USE_USCI - 0
@@ -654,6 +1928,12 @@ void vBSP430serialFlush_ni (hBSP430halSERIAL hal)
 #if configBSP430_SERIAL_USE_EUSCI - 0
 #include <bsp430/periph/eusci.h>
 #endif /* configBSP430_SERIAL_USE_EUSCI */
+#if configBSP430_SERIAL_USE_GPIOSERIAL - 0
+#include <bsp430/utility/gpioserial.h>
+#endif /* configBSP430_SERIAL_USE_GPIOSERIAL */
+#if configBSP430_SERIAL_USE_TIMERUART - 0
+#include <bsp430/utility/timeruart.h>
+#endif /* configBSP430_SERIAL_USE_TIMERUART */
 
 /** Get the HAL handle for a specific serial peripheral.
  *
@@ -682,6 +1962,16 @@ hBSP430halSERIAL hBSP430serialLookup (tBSP430periphHandle periph)
     rv = hBSP430eusciLookup(periph);
   }
 #endif /* configBSP430_SERIAL_USE_EUSCI */
+#if configBSP430_SERIAL_USE_GPIOSERIAL - 0
+  if (NULL == rv) {
+    rv = hBSP430gpioserialLookup(periph);
+  }
+#endif /* configBSP430_SERIAL_USE_GPIOSERIAL */
+#if configBSP430_SERIAL_USE_TIMERUART - 0
+  if (NULL == rv) {
+    rv = hBSP430timeruartLookup(periph);
+  }
+#endif /* configBSP430_SERIAL_USE_TIMERUART */
   return rv;
 }
 
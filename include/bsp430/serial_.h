@@ -76,6 +76,20 @@
  * #sBSP430hplEUSCIA. */
 #define BSP430_SERIAL_HAL_HPL_VARIANT_EUSCIB 4
 
+/** Field value for variant stored in
+ * sBSP430halSERIAL.hal_state.cflags when the device is implemented in
+ * software on general purpose I/O pins (see
+ * <bsp430/utility/gpioserial.h>).  The HPL pointer is null, and the
+ * state is referenced through sBSP430halSERIAL.hpl_aux. */
+#define BSP430_SERIAL_HAL_HPL_VARIANT_GPIOSERIAL 5
+
+/** Field value for variant stored in
+ * sBSP430halSERIAL.hal_state.cflags when the device is a UART
+ * implemented in software on timer capture/compare blocks (see
+ * <bsp430/utility/timeruart.h>).  The HPL pointer is null, and the
+ * state is referenced through sBSP430halSERIAL.hpl_aux. */
+#define BSP430_SERIAL_HAL_HPL_VARIANT_TIMERUART 6
+
 /* !BSP430! instance=usci,usci5,euscia,euscib */
 /* !BSP430! periph=serial insert=hal_variant_hpl_macro */
 /* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hal_variant_hpl_macro] */
@@ -160,7 +174,42 @@ struct sBSP430usciHPLAux;
 struct sBSP430hplUSCI5;
 struct sBSP430hplEUSCIA;
 struct sBSP430hplEUSCIB;
+struct sBSP430gpioserialState;
+struct sBSP430timeruartState;
 struct sBSP430serialDispatch;
+struct sBSP430i2cQueue;
+struct sBSP430i2cTransaction;
+
+/** Error counters for a serial device.
+ *
+ * These are maintained in sBSP430halSERIAL.errors when
+ * #configBSP430_SERIAL_ERROR_COUNTERS is enabled, and retrieved with
+ * iBSP430serialSnapshotErrors().  All counters wrap. */
+typedef struct sBSP430serialErrors {
+  /** Number of UART octets received while the previous octet was
+   * still unread (UCOE).  The lost octets are not themselves
+   * counted. */
+  unsigned int overrun;
+
+  /** Number of UART octets received with a missing stop bit (UCFE) */
+  unsigned int framing;
+
+  /** Number of UART octets received with a parity error (UCPE) */
+  unsigned int parity;
+
+  /** Number of interrupt-driven I2C transactions terminated because
+   * the slave did not acknowledge */
+  unsigned int nack;
+
+  /** Number of interrupt-driven I2C transactions terminated because
+   * another master won arbitration */
+  unsigned int arbitration_lost;
+
+  /** Number of received octets discarded by a software buffer layered
+   * on the device, such as the console receive buffer or a DMA
+   * receive ring, because it was full */
+  unsigned int rx_dropped;
+} sBSP430serialErrors;
 
 /** Structure holding hardware abstraction layer state for serial
  * devices. */
@@ -210,6 +259,10 @@ typedef struct sBSP430halSERIAL {
     /** Access to the HPL auxiliary pointer for the 2xx/4xx USCI
      * peripheral */
     struct sBSP430usciHPLAux * usci;
+    /** Access to the state of a GPIO serial device */
+    struct sBSP430gpioserialState * gpioserial;
+    /** Access to the state of a timer UART device */
+    struct sBSP430timeruartState * timeruart;
   } const hpl_aux;
 
   /** Location in which an incoming character is stored when an
@@ -240,15 +293,69 @@ typedef struct sBSP430halSERIAL {
    * should also include #BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT if
    * it is known that there will not be data available after the
    * transmission.  If the callback has no data to transmit, it should
-   * return zero. */
+   * return zero.
+   *
+   * Alternatively a callback with several octets available may store
+   * their address in #tx_block and their count in #tx_block_len
+   * before returning #BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN.  The
+   * infrastructure then streams the block from subsequent transmit
+   * interrupts (or by DMA, see
+   * #configBSP430_SERIAL_TX_BLOCK_USE_DMA) without invoking the
+   * chain, and invokes it again only when the last octet of the
+   * block has been written to the peripheral.  The block must remain
+   * valid until then, and the producer must not call
+   * vBSP430serialWakeupTransmit_ni() while it is outstanding.
+   * #BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT is ignored for a block
+   * of more than one octet. */
   const struct sBSP430halISRVoidChainNode * volatile tx_cbchain_ni;
 
+  /** Start of a block of outgoing octets supplied by a
+   * #tx_cbchain_ni callback.  The infrastructure advances this as
+   * octets are transmitted. */
+  const uint8_t * tx_block;
+
+  /** Number of octets remaining in #tx_block.  A callback sets this
+   * to the length of the block it supplies; the infrastructure
+   * decrements it, and the next invocation of #tx_cbchain_ni occurs
+   * when it has reached zero. */
+  size_t tx_block_len;
+
   /** Total number of received octets */
   unsigned long num_rx;
 
   /** Total number of transmitted octets */
   unsigned long num_tx;
 
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+  /** Error counters.  Use iBSP430serialSnapshotErrors() to read them
+   * consistently. */
+  sBSP430serialErrors errors;
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+
+#if configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0
+  /** Callback linked into the DMA channel that is transmitting
+   * #tx_block.  Managed by the infrastructure. */
+  struct sBSP430halISRIndexedChainNode tx_dma_cb;
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  /** The I2C transaction queue attached to the device, if any.
+   *
+   * When non-null the interrupt service routine decodes I2C events
+   * and delegates them to the queue; the receive and transmit
+   * callback chains are not invoked. */
+  struct sBSP430i2cQueue * volatile i2c_queue_ni;
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+  /** The I2C slave register file attached to the device, if any.
+   *
+   * When non-null the interrupt service routine decodes I2C slave
+   * events and delegates them to the register file; the receive and
+   * transmit callback chains are not invoked. */
+  struct sBSP430i2cSlave * volatile i2c_slave_ni;
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
 #if BSP430_SERIAL - 0
   /** @cond DOXYGEN_EXCLUDE */
   const struct sBSP430serialDispatch * const dispatch;
@@ -259,6 +366,35 @@ typedef struct sBSP430halSERIAL {
 /** Handle for a serial HAL instance */
 typedef struct sBSP430halSERIAL * hBSP430halSERIAL;
 
+/** @cond DOXYGEN_EXCLUDE */
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+/* Account for the receive error flags of a UART.  The status register
+ * must be read before the receive buffer, since reading the buffer
+ * clears the flags.  Neither is_uart_ nor stat_ is evaluated when the
+ * counters are disabled. */
+#define BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal_, is_uart_, stat_) do {  \
+    if (is_uart_) {                                                     \
+      unsigned int s_ = (stat_);                                        \
+      if (s_ & UCOE) {                                                  \
+        ++(hal_)->errors.overrun;                                       \
+      }                                                                 \
+      if (s_ & UCFE) {                                                  \
+        ++(hal_)->errors.framing;                                       \
+      }                                                                 \
+      if (s_ & UCPE) {                                                  \
+        ++(hal_)->errors.parity;                                        \
+      }                                                                 \
+    }                                                                   \
+  } while (0)
+#define BSP430_SERIAL_RESET_ERRORS_NI(hal_) do {        \
+    (hal_)->errors = (sBSP430serialErrors){ 0 };        \
+  } while (0)
+#else /* configBSP430_SERIAL_ERROR_COUNTERS */
+#define BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal_, is_uart_, stat_) do { } while (0)
+#define BSP430_SERIAL_RESET_ERRORS_NI(hal_) do { } while (0)
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+/** @endcond */
+
 /** @cond DOXYGEN_EXCLUDE */
 struct sBSP430serialDispatch {
 #if configBSP430_SERIAL_ENABLE_UART - 0
@@ -266,6 +402,10 @@ struct sBSP430serialDispatch {
                                  unsigned char ctl0_byte,
                                  unsigned char ctl1_byte,
                                  unsigned long baud);
+  hBSP430halSERIAL (* openUARTDivisor) (hBSP430halSERIAL hal,
+                                        unsigned char ctl0_byte,
+                                        unsigned char ctl1_byte,
+                                        unsigned long divisor_q12);
   int (* uartRxByte_ni) (hBSP430halSERIAL hal);
   int (* uartTxByte_ni) (hBSP430halSERIAL hal,
                          uint8_t c);
@@ -280,6 +420,10 @@ struct sBSP430serialDispatch {
                                 unsigned char ctl1_byte,
                                 unsigned int prescaler);
   int (* spiTxRx_ni) (hBSP430halSERIAL hal, const uint8_t * tx_data, size_t tx_len, size_t rx_len, uint8_t * rx_data);
+  int (* spiReconfigure_ni) (hBSP430halSERIAL hal,
+                             unsigned char ctl0_byte,
+                             unsigned char ctl1_byte,
+                             unsigned int prescaler);
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 #if configBSP430_SERIAL_ENABLE_I2C - 0
   hBSP430halSERIAL (* openI2C) (hBSP430halSERIAL hal,
@@ -289,12 +433,210 @@ struct sBSP430serialDispatch {
   int (* i2cSetAddresses_ni) (hBSP430halSERIAL hal, int own_address, int slave_address);
   int (* i2cRxData_ni) (hBSP430halSERIAL hal, uint8_t * rx_data, size_t rx_len);
   int (* i2cTxData_ni) (hBSP430halSERIAL hal, const uint8_t * tx_data, size_t tx_len);
+  int (* i2cTxRx_ni) (hBSP430halSERIAL hal, const uint8_t * tx_data, size_t tx_len, size_t rx_len, uint8_t * rx_data);
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  int (* i2cQueueStart_ni) (hBSP430halSERIAL hal, struct sBSP430i2cTransaction * txn);
+  void (* i2cQueueAbort_ni) (hBSP430halSERIAL hal);
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+  int (* i2cSlaveEnable_ni) (hBSP430halSERIAL hal, int enablep);
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   int (* setHold_ni) (hBSP430halSERIAL hal, int holdp);
   int (* close) (hBSP430halSERIAL hal);
   void (* wakeupTransmit_ni) (hBSP430halSERIAL hal);
   void (* flush_ni) (hBSP430halSERIAL hal);
+#if (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+  int (* dmaTarget_ni) (hBSP430halSERIAL hal, const volatile void ** rxbufpp, volatile void ** txbufpp);
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA || configBSP430_SERIAL_UART_RX_USE_DMA */
 };
 /** @endcond */
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_SPI_USE_DMA - 0)
+/** Perform an SPI exchange using the DMA controller.
+ *
+ * This is the shared implementation underlying the DMA fast path of
+ * the peripheral-specific iBSP430spiTxRx_ni() implementations.  It is
+ * not intended to be called by applications.
+ *
+ * @param hal the SPI-configured serial device
+ *
+ * @param rx_tsel the DMA trigger number for the peripheral receive
+ * interrupt flag.  The transmit trigger is assumed to be @p rx_tsel +
+ * 1.  A negative value indicates the peripheral has no DMA triggers.
+ *
+ * @param rxbufp the address of the peripheral receive buffer register
+ *
+ * @param txbufp the address of the peripheral transmit buffer register
+ *
+ * @param tx_data as with iBSP430spiTxRx_ni()
+ * @param tx_len as with iBSP430spiTxRx_ni()
+ * @param rx_len as with iBSP430spiTxRx_ni()
+ * @param rx_data as with iBSP430spiTxRx_ni()
+ *
+ * @return the number of octets exchanged, or -1 if the transfer was
+ * not performed because it is below #BSP430_SERIAL_SPI_DMA_THRESHOLD,
+ * the peripheral or arguments are not suitable for DMA, or DMA
+ * channels could not be allocated.  In that case the caller should
+ * perform the transfer itself.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_USE_DMA */
+int iBSP430serialSPITxRxDMA_ni (hBSP430halSERIAL hal,
+                                int rx_tsel,
+                                const volatile void * rxbufp,
+                                volatile void * txbufp,
+                                const uint8_t * tx_data,
+                                size_t tx_len,
+                                size_t rx_len,
+                                uint8_t * rx_data);
+#endif /* configBSP430_SERIAL_SPI_USE_DMA */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_USE_ISR - 0)
+/** Complete the transaction at the head of an I2C queue.
+ *
+ * This is invoked by the peripheral-specific interrupt handlers when
+ * the transaction at the head of the queue attached to @p hal has
+ * finished, successfully or not.  The timeout alarm is cancelled, the
+ * transaction removed from the queue, its completion callback
+ * invoked, and the next queued transaction started.  It is not
+ * intended to be called by applications.
+ *
+ * @param hal the I2C-configured serial device
+ *
+ * @param result the value to be stored in
+ * sBSP430i2cTransaction.result
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+int iBSP430i2cQueueComplete_ni (hBSP430halSERIAL hal,
+                                int result);
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_SLAVE - 0)
+/** Record a start condition addressed to an I2C slave.
+ *
+ * This and the related iBSP430i2cSlaveRx_ni(),
+ * vBSP430i2cSlaveTxNext_ni(), and iBSP430i2cSlaveStop_ni() are
+ * invoked by the peripheral-specific interrupt handlers to maintain
+ * the register pointer of the slave attached to a device.  They are
+ * not intended to be called by applications.
+ *
+ * @param slave the slave attached to the device
+ *
+ * @param transmitp nonzero if the master addressed the slave for a
+ * read */
+void vBSP430i2cSlaveStart_ni (struct sBSP430i2cSlave * slave,
+                              int transmitp);
+
+/** Process an octet written by the master to an I2C slave.
+ *
+ * @param slave the slave attached to the device
+ *
+ * @param octet the octet read from the receive buffer
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+int iBSP430i2cSlaveRx_ni (struct sBSP430i2cSlave * slave,
+                         uint8_t octet);
+
+/** Advance an I2C slave past the octet just loaded for transmission.
+ *
+ * The peripheral handler writes sBSP430i2cSlave.tx_next to its
+ * transmit buffer before invoking this, so the master is not held
+ * while the register pointer is incremented and the value of the
+ * following register is fetched.
+ *
+ * @param slave the slave attached to the device */
+void vBSP430i2cSlaveTxNext_ni (struct sBSP430i2cSlave * slave);
+
+/** Record a stop condition ending a transaction with an I2C slave.
+ *
+ * @param slave the slave attached to the device
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+int iBSP430i2cSlaveStop_ni (struct sBSP430i2cSlave * slave);
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)
+/** Hand the remainder of a transmit block to the DMA controller.
+ *
+ * This is invoked from iBSP430serialTxISRNextOctet_ni() when a
+ * #tx_cbchain_ni callback supplies a block of at least
+ * #BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD octets.  On success a channel
+ * has been configured to write all but the first octet of the block
+ * to the peripheral; the caller must write the first octet, which
+ * produces the trigger for the rest.  When the channel completes it
+ * is released, the transmit interrupt is re-enabled, and the next
+ * transmit interrupt invokes the callback chain.  It is not intended
+ * to be called by applications.
+ *
+ * @param hal the serial device
+ *
+ * @return the first octet of the block, or -1 if the peripheral has
+ * no DMA trigger or no channel is available.  In the latter case the
+ * block is streamed by the transmit interrupt.
+ *
+ * @dependency #configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+int iBSP430serialTxBlockDMA_ni (hBSP430halSERIAL hal);
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+
+/** Obtain the next octet for interrupt-driven transmission.
+ *
+ * This is the shared transmit half of the peripheral-specific
+ * interrupt handlers.  If a block supplied through
+ * sBSP430halSERIAL.tx_block is being streamed its next octet is
+ * returned without invoking the callback chain; otherwise
+ * sBSP430halSERIAL.tx_cbchain_ni is invoked to obtain either a single
+ * octet or a new block.  It is not intended to be called by
+ * applications.
+ *
+ * @param hal the serial device
+ *
+ * @param rvp where the callback return flags are stored.  This will
+ * include #BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT if the caller
+ * should clear the transmit interrupt enable.
+ *
+ * @return the octet to be written to the transmit buffer, or -1 if
+ * there is nothing to transmit.  When the return value is negative
+ * and the interrupt is disabled the caller should set the transmit
+ * interrupt flag so that it fires when next enabled. */
+static BSP430_CORE_INLINE
+int iBSP430serialTxISRNextOctet_ni (hBSP430halSERIAL hal,
+                                    int * rvp)
+{
+  int rv = 0;
+  int c;
+
+  if (0 == hal->tx_block_len) {
+    rv = iBSP430callbackInvokeISRVoid_ni(&hal->tx_cbchain_ni, hal, 0);
+    if (! (rv & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN)) {
+      /* No data; mark transmission disabled */
+      *rvp = rv | BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+      return -1;
+    }
+    if (0 == hal->tx_block_len) {
+      /* Single octet in tx_byte */
+      ++hal->num_tx;
+      *rvp = rv;
+      return hal->tx_byte;
+    }
+#if configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0
+    if (BSP430_SERIAL_TX_BLOCK_DMA_THRESHOLD <= hal->tx_block_len) {
+      c = iBSP430serialTxBlockDMA_ni(hal);
+      if (0 <= c) {
+        /* DMA owns the rest of the block; its completion re-enables
+         * the interrupt */
+        *rvp = rv | BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+        return c;
+      }
+    }
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+  }
+  c = *hal->tx_block++;
+  ++hal->num_tx;
+  if (0 < --hal->tx_block_len) {
+    rv &= ~BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+  }
+  *rvp = rv;
+  return c;
+}
+
 #endif /* BSP430_SERIAL__H */
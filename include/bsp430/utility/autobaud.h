@@ -0,0 +1,177 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Automatic UART baud rate detection using a timer capture.
+ *
+ * The baud rate of a peer is measured by timestamping the edges of
+ * the first character it sends with a timer capture/compare block
+ * whose input is connected to the receive line, much as
+ * uiBSP430timerCaptureDelta_ni() measures clocks.  The bit time is
+ * the shortest interval between edges, refined by averaging over all
+ * edges of the character.  The result is snapped to a standard rate
+ * when it is close to one, and hBSP430autobaudOpenUART() then opens
+ * the UART with the divisor for that rate.
+ *
+ * The first character must contain an isolated bit, so its shortest
+ * pulse is one bit long.  Any character with its least significant
+ * bit set qualifies, since that bit follows the low start bit:
+ * carriage return works, and the sync character 0x55 ('U'), whose
+ * ten edges are each one bit apart, gives the best accuracy.
+ *
+ * Detection is separated from the hardware in
+ * ulBSP430autobaudBitTicksQ16() and ulBSP430autobaudBaud(), which
+ * depend on nothing but their arguments, so they may be validated
+ * with synthetic edge timestamps (see the unittests/autobaud
+ * example).
+ *
+ * Limitations:
+ * @li Edges are captured by polling with interrupts disabled, so the
+ * timer must tick at least 20 or so times per bit at the highest rate
+ * expected.  A missed edge is detected and makes the measurement
+ * fail rather than produce a wrong rate;
+ * @li The timer must already be running, in continuous mode, from a
+ * source for which ulBSP430timerFrequency_Hz_ni() is accurate;
+ * @li The character used for detection is consumed.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_AUTOBAUD_H
+#define BSP430_UTILITY_AUTOBAUD_H
+
+#include <bsp430/serial.h>
+#include <bsp430/periph/timer.h>
+
+/** The maximum number of edges in one character: the falling edge
+ * of the start bit, and a transition at each following bit
+ * boundary up to the start of the stop bit. */
+#define BSP430_AUTOBAUD_MAX_EDGES 10
+
+/** @def BSP430_AUTOBAUD_SNAP_PPT
+ *
+ * The tolerance, in parts per thousand, within which a measured baud
+ * rate is replaced by the standard rate it is near.  The standard
+ * rates are 1200 through 230400 in the usual sequence.
+ *
+ * @defaulted */
+#ifndef BSP430_AUTOBAUD_SNAP_PPT
+#define BSP430_AUTOBAUD_SNAP_PPT 40
+#endif /* BSP430_AUTOBAUD_SNAP_PPT */
+
+/** Calculate the duration of one bit from the edges of a character.
+ *
+ * @param edge_tck timer counter values at successive edges.  The
+ * first must be the falling edge of a start bit.  Edges beyond the
+ * character that begins there are ignored, so timestamps may be
+ * taken from a longer capture.  Counter wrap between edges is
+ * permitted.
+ *
+ * @param nedges the number of values in @p edge_tck
+ *
+ * @return the bit duration in timer ticks as a 16.16 fixed point
+ * value, or zero if fewer than two edges were provided. */
+unsigned long ulBSP430autobaudBitTicksQ16 (const unsigned int * edge_tck,
+                                           unsigned int nedges);
+
+/** Convert a bit duration to a baud rate.
+ *
+ * @param bit_tck_q16 the bit duration in ticks of a clock, as a 16.16
+ * fixed point value from ulBSP430autobaudBitTicksQ16()
+ *
+ * @param clock_Hz the frequency of the clock
+ *
+ * @return the standard baud rate within #BSP430_AUTOBAUD_SNAP_PPT of
+ * the measured one if there is one, else the measured rate rounded
+ * to an integer.  Zero if @p bit_tck_q16 is too small to be
+ * meaningful. */
+unsigned long ulBSP430autobaudBaud (unsigned long bit_tck_q16,
+                                    unsigned long clock_Hz);
+
+/** Measure the baud rate of the next character on a receive line.
+ *
+ * The function spins until the falling edge of a start bit is
+ * captured, then captures the remaining edges of the character.
+ * Capture ends when #BSP430_AUTOBAUD_MAX_EDGES edges have been seen
+ * or the line has been quiet for ten times the shortest interval
+ * observed.
+ *
+ * @param periph the timer on which the capture is made.  It must be
+ * running in continuous mode.
+ *
+ * @param ccidx the capture/compare block to use.  Its configuration
+ * is destroyed.
+ *
+ * @param ccis the capture/compare input selection (e.g. #CCIS_0)
+ * that connects the block to the receive line.  Consult the
+ * MCU-specific datasheet for the pin functions.
+ *
+ * @param timeout_tck the maximum number of timer ticks to wait for the
+ * start bit and then for each subsequent edge until the bit time is
+ * known, or zero to wait indefinitely
+ *
+ * @return the detected baud rate as from ulBSP430autobaudBaud(), or
+ * zero if the timer is not running, no character arrived within @p
+ * timeout_tck, or an edge was missed. */
+unsigned long ulBSP430autobaudMeasure_ni (tBSP430periphHandle periph,
+                                          int ccidx,
+                                          unsigned int ccis,
+                                          unsigned long timeout_tck);
+
+/** Measure the baud rate of a peer and open a UART to match it.
+ *
+ * This invokes ulBSP430autobaudMeasure_ni() with interrupts disabled
+ * and, if a rate was detected, hBSP430serialOpenUART() with it.
+ *
+ * @param hal the serial device to be opened
+ *
+ * @param ctl0_byte as with hBSP430serialOpenUART()
+ *
+ * @param ctl1_byte as with hBSP430serialOpenUART()
+ *
+ * @param periph as with ulBSP430autobaudMeasure_ni()
+ * @param ccidx as with ulBSP430autobaudMeasure_ni()
+ * @param ccis as with ulBSP430autobaudMeasure_ni()
+ * @param timeout_tck as with ulBSP430autobaudMeasure_ni()
+ *
+ * @return the opened serial device, or a null handle if no rate was
+ * detected or the open failed. */
+hBSP430halSERIAL hBSP430autobaudOpenUART (hBSP430halSERIAL hal,
+                                          unsigned char ctl0_byte,
+                                          unsigned char ctl1_byte,
+                                          tBSP430periphHandle periph,
+                                          int ccidx,
+                                          unsigned int ccis,
+                                          unsigned long timeout_tck);
+
+#endif /* BSP430_UTILITY_AUTOBAUD_H */
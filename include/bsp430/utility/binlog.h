@@ -0,0 +1,238 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Deferred binary logging decoded on the host.
+ *
+ * Formatting text with cprintf() costs thousands of MCU cycles per
+ * call, and the format strings occupy flash.  BSP430_BINLOG() instead
+ * records, in a few dozen octets:
+ *
+ * @li the address of the format string, which serves as its
+ * identifier;
+ * @li a timestamp from ulBSP430uptime_ni() (zero if
+ * #BSP430_UPTIME is not enabled);
+ * @li the raw values of the arguments, each after the integer
+ * promotions (so a @c char is recorded as an @c int).
+ *
+ * The record is wrapped in a SLIP frame with CRC-16 by
+ * iBSP430framingEncode() and queued with
+ * iBSP430consoleTransmitBlock_ni(), to be drained by the console
+ * transmit interrupt along with any text.  If the transmit buffer
+ * does not have room the record is dropped and counted rather than
+ * waiting, so logging is safe in interrupt handlers.  Use
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE to make transmission
+ * interrupt-driven; otherwise records are written to the UART
+ * immediately.
+ *
+ * The MCU never reads the format strings: they are placed in the
+ * section #BSP430_BINLOG_SECTION and read from the application ELF
+ * file by <tt>maintainer/binlogdecode.py</tt>, which copies console
+ * text to its output and replaces each record with the formatted
+ * message.  Supported conversions are those of printf(3) for
+ * integers (with @c h, @c l, and @c ll modifiers), @c c, @c p, and
+ * @c f, @c e, @c g for @c float.  For @c s the string must be in
+ * flash so the host can read it from the ELF file; otherwise its
+ * address is shown.
+ *
+ * To keep the strings out of the loaded image, have the linker place
+ * the section at address zero as a non-loaded section, e.g. with GNU
+ * ld:
+ * @code
+ * .bsp430_binlog 0 (INFO) : { KEEP(*(.bsp430_binlog)) }
+ * @endcode
+ * The identifiers are then offsets into the section, which the
+ * decoder handles as well.
+ *
+ * @note Console text is assumed not to contain the octets 0xC0 and
+ * 0xDB, which delimit and escape SLIP frames.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_BINLOG_H
+#define BSP430_UTILITY_BINLOG_H
+
+#include <bsp430/core.h>
+#include <stddef.h>
+
+/** @def BSP430_BINLOG_SECTION
+ *
+ * The name of the linker section holding format strings.
+ *
+ * @defaulted */
+#ifndef BSP430_BINLOG_SECTION
+#define BSP430_BINLOG_SECTION ".bsp430_binlog"
+#endif /* BSP430_BINLOG_SECTION */
+
+/** @def BSP430_BINLOG_ARGS_MAX
+ *
+ * The maximum number of octets of argument data in a record.  A
+ * BSP430_BINLOG() with larger arguments fails to compile.  This
+ * bounds the stack used to encode a record.
+ *
+ * @defaulted */
+#ifndef BSP430_BINLOG_ARGS_MAX
+#define BSP430_BINLOG_ARGS_MAX 16
+#endif /* BSP430_BINLOG_ARGS_MAX */
+
+/** The number of octets in a record preceding the arguments: the
+ * format identifier and the timestamp. */
+#define BSP430_BINLOG_HEADER_LENGTH (sizeof(uint16_t) + sizeof(uint32_t))
+
+/** Queue a record for transmission.
+ *
+ * This is the implementation of BSP430_BINLOG(), and should not
+ * normally be called directly.  It may be called with interrupts
+ * enabled or disabled.
+ *
+ * @param fmt the format string in #BSP430_BINLOG_SECTION
+ *
+ * @param args the argument values, laid out without padding
+ *
+ * @param len the number of octets at @p args, not exceeding
+ * #BSP430_BINLOG_ARGS_MAX
+ *
+ * @return 0 if the record was queued; -1 if it was dropped. */
+int iBSP430binlogRecord (const char * fmt,
+                         const void * args,
+                         size_t len);
+
+/** Return the number of records dropped.
+ *
+ * Records are dropped when the console is not available or its
+ * transmit buffer lacks room.
+ *
+ * @param reset if nonzero the count is reset to zero after being read
+ *
+ * @return the number of records dropped since the count was last
+ * reset */
+unsigned int uiBSP430binlogDropped_ni (int reset);
+
+/** Log a message for decoding on the host.
+ *
+ * Use like cprintf() with a string literal format and up to six
+ * arguments.  Arguments are evaluated once.
+ *
+ * @code
+ * BSP430_BINLOG("adc %u temp %d.%u\n", sample, whole, tenths);
+ * @endcode
+ *
+ * The record is dropped if the console is not available. */
+#define BSP430_BINLOG(...) BSP430_BINLOG_SELECT_(__VA_ARGS__, _6, _5, _4, _3, _2, _1, _0, ~)(__VA_ARGS__)
+
+/** @cond DOXYGEN_EXCLUDE */
+#define BSP430_BINLOG_SELECT_(f_, a1_, a2_, a3_, a4_, a5_, a6_, n_, ...) BSP430_BINLOG##n_
+
+/* Place the format string where the host will find it */
+#define BSP430_BINLOG_FMT_(f_)                                          \
+  static const char bsp430_binlog_fmt_[] __attribute__((__section__(BSP430_BINLOG_SECTION), __used__)) = f_
+
+/* The type in which an argument is recorded */
+#define BSP430_BINLOG_TYPE_(a_) __typeof__((a_) + 0)
+
+#define BSP430_BINLOG_EMIT_(args_) do {                                 \
+    (void)sizeof(char[(sizeof(args_) <= BSP430_BINLOG_ARGS_MAX) ? 1 : -1]); \
+    (void)iBSP430binlogRecord(bsp430_binlog_fmt_, &(args_), sizeof(args_)); \
+  } while (0)
+
+#define BSP430_BINLOG_0(f_) do {                                        \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    (void)iBSP430binlogRecord(bsp430_binlog_fmt_, NULL, 0);             \
+  } while (0)
+
+#define BSP430_BINLOG_1(f_, a1_) do {                                   \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    const struct __attribute__((__packed__)) {                          \
+      BSP430_BINLOG_TYPE_(a1_) a1;                                      \
+    } args_ = { (a1_) };                                                \
+    BSP430_BINLOG_EMIT_(args_);                                         \
+  } while (0)
+
+#define BSP430_BINLOG_2(f_, a1_, a2_) do {                              \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    const struct __attribute__((__packed__)) {                          \
+      BSP430_BINLOG_TYPE_(a1_) a1;                                      \
+      BSP430_BINLOG_TYPE_(a2_) a2;                                      \
+    } args_ = { (a1_), (a2_) };                                         \
+    BSP430_BINLOG_EMIT_(args_);                                         \
+  } while (0)
+
+#define BSP430_BINLOG_3(f_, a1_, a2_, a3_) do {                         \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    const struct __attribute__((__packed__)) {                          \
+      BSP430_BINLOG_TYPE_(a1_) a1;                                      \
+      BSP430_BINLOG_TYPE_(a2_) a2;                                      \
+      BSP430_BINLOG_TYPE_(a3_) a3;                                      \
+    } args_ = { (a1_), (a2_), (a3_) };                                  \
+    BSP430_BINLOG_EMIT_(args_);                                         \
+  } while (0)
+
+#define BSP430_BINLOG_4(f_, a1_, a2_, a3_, a4_) do {                    \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    const struct __attribute__((__packed__)) {                          \
+      BSP430_BINLOG_TYPE_(a1_) a1;                                      \
+      BSP430_BINLOG_TYPE_(a2_) a2;                                      \
+      BSP430_BINLOG_TYPE_(a3_) a3;                                      \
+      BSP430_BINLOG_TYPE_(a4_) a4;                                      \
+    } args_ = { (a1_), (a2_), (a3_), (a4_) };                           \
+    BSP430_BINLOG_EMIT_(args_);                                         \
+  } while (0)
+
+#define BSP430_BINLOG_5(f_, a1_, a2_, a3_, a4_, a5_) do {               \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    const struct __attribute__((__packed__)) {                          \
+      BSP430_BINLOG_TYPE_(a1_) a1;                                      \
+      BSP430_BINLOG_TYPE_(a2_) a2;                                      \
+      BSP430_BINLOG_TYPE_(a3_) a3;                                      \
+      BSP430_BINLOG_TYPE_(a4_) a4;                                      \
+      BSP430_BINLOG_TYPE_(a5_) a5;                                      \
+    } args_ = { (a1_), (a2_), (a3_), (a4_), (a5_) };                    \
+    BSP430_BINLOG_EMIT_(args_);                                         \
+  } while (0)
+
+#define BSP430_BINLOG_6(f_, a1_, a2_, a3_, a4_, a5_, a6_) do {          \
+    BSP430_BINLOG_FMT_(f_);                                             \
+    const struct __attribute__((__packed__)) {                          \
+      BSP430_BINLOG_TYPE_(a1_) a1;                                      \
+      BSP430_BINLOG_TYPE_(a2_) a2;                                      \
+      BSP430_BINLOG_TYPE_(a3_) a3;                                      \
+      BSP430_BINLOG_TYPE_(a4_) a4;                                      \
+      BSP430_BINLOG_TYPE_(a5_) a5;                                      \
+      BSP430_BINLOG_TYPE_(a6_) a6;                                      \
+    } args_ = { (a1_), (a2_), (a3_), (a4_), (a5_), (a6_) };             \
+    BSP430_BINLOG_EMIT_(args_);                                         \
+  } while (0)
+/** @endcond */
+
+#endif /* BSP430_UTILITY_BINLOG_H */
@@ -171,6 +171,28 @@
 #define configBSP430_CLI_COMMAND_COMPLETION_HELPER 0
 #endif /* configBSP430_CLI_COMMAND_COMPLETION_HELPER */
 
+/** Define to a true value to support sorted command indexes.
+ *
+ * Commands are normally identified by comparing the input token with
+ * the key of every command in a chain, which becomes slow for large
+ * command sets on slow MCUs.  When this is enabled, an application
+ * may register with iBSP430cliSetCommandIndex() an array of
+ * #sBSP430cliCommandIndex structures, each holding the commands of
+ * one chain sorted by key.  iBSP430cliMatchCommand() then locates the
+ * commands that match a token by binary search in any chain that has
+ * an index.  Chains without one are searched as before.
+ *
+ * The indexes are generated from the application source by
+ * <tt>maintainer/cliindex.py</tt>; see the @c CLI_INDEX variable in
+ * <tt>examples/Makefile.common</tt>.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef configBSP430_CLI_COMMAND_INDEX
+#define configBSP430_CLI_COMMAND_INDEX 0
+#endif /* configBSP430_CLI_COMMAND_INDEX */
+
 /** Get the next token in the command string.
  *
  * @param commandp pointer to a pointer into an immutable buffer
@@ -523,6 +545,11 @@ typedef struct sBSP430cliMatchCallback {
  * @return the number of commands in @p cmds for which the first token
  * of @p command was a prefix, or a negative number if @p command is
  * empty (disregarding whitespace) so no prefix could be identified.
+ *
+ * @note If a @link iBSP430cliSetCommandIndex command index@endlink
+ * covers @p cmds the result is the same, and @p match_cb is still
+ * invoked in the order of the chain.  When it is provided and more
+ * than one command matches, the chain is walked to achieve this.
  */
 int iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
                             const char * command,
@@ -532,6 +559,48 @@ int iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
                             const char * * argstrp,
                             size_t * argstr_lenp);
 
+/** A sorted index of the commands in one chain.
+ *
+ * Instances are normally generated by
+ * <tt>maintainer/cliindex.py</tt> rather than written by hand.
+ *
+ * @dependency #configBSP430_CLI_COMMAND_INDEX */
+typedef struct sBSP430cliCommandIndex {
+  /** The first command of the chain, as passed to
+   * iBSP430cliMatchCommand() as its @c cmds parameter. */
+  const struct sBSP430cliCommand * command_set;
+
+  /** Every command in the chain, in increasing order of key as
+   * determined by strcmp(). */
+  const struct sBSP430cliCommand * const * sorted;
+
+  /** The number of commands in @a sorted, which is the number in the
+   * chain. */
+  unsigned int count;
+} sBSP430cliCommandIndex;
+
+/** Register the command indexes used by iBSP430cliMatchCommand().
+ *
+ * Each index is checked against the chain it covers: it must hold
+ * exactly the commands of the chain, in strictly increasing order of
+ * key.  An index that is out of date with respect to the command
+ * declarations thus fails registration rather than causing commands
+ * to be misidentified.
+ *
+ * @param indexes the indexes to use, or a null pointer to use none.
+ * The array must remain valid while it is registered.
+ *
+ * @param len the number of elements in @p indexes.  Ignored if @p
+ * indexes is null.
+ *
+ * @return 0 if the indexes were registered.  -1 if any is
+ * inconsistent with its chain, in which case none are registered and
+ * all chains are searched linearly.
+ *
+ * @dependency #configBSP430_CLI_COMMAND_INDEX */
+int iBSP430cliSetCommandIndex (const sBSP430cliCommandIndex * indexes,
+                               unsigned int len);
+
 /** Entrypoint to command execution.
  *
  * @param cmds the first in a sequence of sibling commands that may
@@ -1175,6 +1244,11 @@ int iBSP430cliConsoleBufferExtend_ni (const char * text, size_t len);
  * and the function returns even if there is additional data to be
  * consumed.
  *
+ * If the console is in line mode (see
+ * iBSP430consoleSetRxLineMode_ni()) the receive interrupt has already
+ * echoed printable characters and applied the editing keys it could,
+ * so the application need only call this when woken.
+ *
  * @return zero if all pending input was consumed and no actions are
  * required.  A positive result encodes bits from #eBSP430cliConsole
  * indicating available commands or other actions that are required.
@@ -47,7 +47,9 @@
  * cputul_ni()) without incurring the stack overhead of printf, which
  * can be quite high (on the order of 100 bytes if 64-bit integer
  * support is included).  These all assume that interrupts are
- * disabled when called.
+ * disabled when called.  For padded, hexadecimal, or fixed-point
+ * values, format the text with <bsp430/utility/format.h> and emit it
+ * with cputtext_ni().
  *
  * All these routines are safe to call even if the console was not
  * initialized, or its initialization failed, or it is temporarily
@@ -75,6 +77,7 @@
 
 #include <bsp430/serial.h>
 #include <bsp430/platform.h>
+#include <bsp430/utility/ring.h>
 #include <stdarg.h>
 
 /** @def configBSP430_CONSOLE
@@ -157,8 +160,8 @@
 /** @def BSP430_CONSOLE_RX_BUFFER_SIZE
  *
  * Define this to the size of a buffer to be used for interrupt-driven
- * console input.  The value must not exceed 254, and buffer
- * management is most efficient if the value is a power of 2.
+ * console input.  The value must be a power of two no larger than
+ * 32768; the entire buffer is usable.
  *
  * If this has a value of zero, character input is not interrupt
  * driven.  cgetchar_ni() will return the most recently received
@@ -172,8 +175,8 @@
 /** @def BSP430_CONSOLE_TX_BUFFER_SIZE
  *
  * Define this to the size of a buffer to be used for interrupt-driven
- * console output.  The value must not exceed 254, and buffer
- * management is most efficient if the value is a power of 2.
+ * console output.  The value must be a power of two no larger than
+ * 32768; the entire buffer is usable.
  *
  * If this has a value of zero, character output is not interrupt
  * driven.  cputchar_ni() will block until the UART is ready to accept
@@ -192,6 +195,174 @@
 #define BSP430_CONSOLE_TX_BUFFER_SIZE 0
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+/** @def BSP430_CONSOLE_FORMAT_BUFFER_SIZE
+ *
+ * Define this to the size of a buffer into which cprintf() and
+ * vcprintf() format their output before it is emitted.
+ *
+ * If this has a value of zero, formatted output is emitted a
+ * character at a time with interrupts disabled for the whole call,
+ * which for a long format holds off every interrupt handler for the
+ * full formatting time.  With a buffer, formatting proceeds with
+ * interrupts in the state the caller left them, and they are disabled
+ * only while the formatted text is copied to the UART or, when
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE is positive, into the transmit
+ * buffer as a block.
+ *
+ * Output longer than the buffer is copied out each time the buffer
+ * fills, so such a message is atomic only per buffer.  The buffer is
+ * shared: a cprintf() invoked while another is formatting (e.g. from
+ * an interrupt handler when interrupt-driven output is not enabled)
+ * falls back to emitting directly with interrupts disabled.
+ *
+ * @defaulted */
+#ifndef BSP430_CONSOLE_FORMAT_BUFFER_SIZE
+#define BSP430_CONSOLE_FORMAT_BUFFER_SIZE 0
+#endif /* BSP430_CONSOLE_FORMAT_BUFFER_SIZE */
+
+/** @def BSP430_CONSOLE_TX_DROP_MARKER
+ *
+ * Text inserted into the console output where octets were discarded
+ * under #BSP430_CONSOLE_TX_POLICY_DROP_NEWEST or
+ * #BSP430_CONSOLE_TX_POLICY_DROP_OLDEST.  Define to an empty string
+ * to insert nothing.  The marker must be shorter than
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE octets.
+ *
+ * @defaulted */
+#ifndef BSP430_CONSOLE_TX_DROP_MARKER
+#define BSP430_CONSOLE_TX_DROP_MARKER "~"
+#endif /* BSP430_CONSOLE_TX_DROP_MARKER */
+
+/** @def configBSP430_CONSOLE_USE_CTS
+ *
+ * Define to a true value to hold console output while the peer
+ * deasserts (drives high) a clear-to-send line connected to
+ * #BSP430_CONSOLE_CTS_PORT_BIT of
+ * #BSP430_CONSOLE_CTS_PORT_PERIPH_HANDLE.
+ *
+ * With interrupt-driven output the line is monitored through a port
+ * interrupt.  When it is deasserted the remainder of the block being
+ * streamed by the serial HAL is returned to the transmit buffer, and
+ * the transmit callback hands out no further data; when it is
+ * reasserted transmission is woken.  At most the octet already in
+ * the UART is sent after deassertion.  Without interrupt-driven
+ * output each octet waits for the line to be asserted.
+ *
+ * The port HAL and its ISR must be enabled in the application
+ * configuration, e.g. with #configBSP430_HAL_PORT1 and
+ * #configBSP430_HAL_PORT1_ISR, and the port must support interrupts.
+ *
+ * @note If #configBSP430_SERIAL_TX_BLOCK_USE_DMA is enabled a block
+ * that has been handed to DMA is transmitted in full regardless of
+ * the line.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_CONSOLE_USE_CTS
+#define configBSP430_CONSOLE_USE_CTS 0
+#endif /* configBSP430_CONSOLE_USE_CTS */
+
+/** @def BSP430_CONSOLE_CTS_PORT_PERIPH_HANDLE
+ *
+ * The port peripheral handle, for example #BSP430_PERIPH_PORT2, on
+ * which the console clear-to-send input is found.  There is no
+ * default; the application must provide this when
+ * #configBSP430_CONSOLE_USE_CTS is enabled.
+ *
+ * @dependency #configBSP430_CONSOLE_USE_CTS */
+#if defined(BSP430_DOXYGEN)
+#define BSP430_CONSOLE_CTS_PORT_PERIPH_HANDLE application-provided
+#endif /* BSP430_DOXYGEN */
+
+/** @def BSP430_CONSOLE_CTS_PORT_BIT
+ *
+ * The port bit, for example @c BIT3, on which the console
+ * clear-to-send input is found.
+ *
+ * @dependency #configBSP430_CONSOLE_USE_CTS */
+#if defined(BSP430_DOXYGEN)
+#define BSP430_CONSOLE_CTS_PORT_BIT application-provided
+#endif /* BSP430_DOXYGEN */
+
+/** @def configBSP430_CONSOLE_USE_RTS
+ *
+ * Define to a true value to drive a request-to-send output on
+ * #BSP430_CONSOLE_RTS_PORT_BIT of
+ * #BSP430_CONSOLE_RTS_PORT_PERIPH_HANDLE from the space available in
+ * the console receive buffer.
+ *
+ * The line is deasserted (driven high) by the receive interrupt when
+ * no more than #BSP430_CONSOLE_RTS_STOP_AVAILABLE octets remain
+ * free, and asserted again by cgetchar_ni() once
+ * #BSP430_CONSOLE_RTS_RESUME_AVAILABLE octets are free.  The port
+ * HAL must be enabled in the application configuration.
+ *
+ * @dependency #BSP430_CONSOLE_RX_BUFFER_SIZE
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_CONSOLE_USE_RTS
+#define configBSP430_CONSOLE_USE_RTS 0
+#endif /* configBSP430_CONSOLE_USE_RTS */
+
+/** @def BSP430_CONSOLE_RTS_PORT_PERIPH_HANDLE
+ *
+ * The port peripheral handle on which the console request-to-send
+ * output is found.  There is no default; the application must
+ * provide this when #configBSP430_CONSOLE_USE_RTS is enabled.
+ *
+ * @dependency #configBSP430_CONSOLE_USE_RTS */
+#if defined(BSP430_DOXYGEN)
+#define BSP430_CONSOLE_RTS_PORT_PERIPH_HANDLE application-provided
+#endif /* BSP430_DOXYGEN */
+
+/** @def BSP430_CONSOLE_RTS_PORT_BIT
+ *
+ * The port bit on which the console request-to-send output is found.
+ *
+ * @dependency #configBSP430_CONSOLE_USE_RTS */
+#if defined(BSP430_DOXYGEN)
+#define BSP430_CONSOLE_RTS_PORT_BIT application-provided
+#endif /* BSP430_DOXYGEN */
+
+/** @def BSP430_CONSOLE_RTS_STOP_AVAILABLE
+ *
+ * The number of free octets in the console receive buffer at or
+ * below which request-to-send is deasserted.  Most bridges send a few
+ * more octets after the line changes, so this should cover the
+ * peer's reaction time at the console baud rate.
+ *
+ * @dependency #configBSP430_CONSOLE_USE_RTS
+ * @defaulted */
+#ifndef BSP430_CONSOLE_RTS_STOP_AVAILABLE
+#define BSP430_CONSOLE_RTS_STOP_AVAILABLE 4
+#endif /* BSP430_CONSOLE_RTS_STOP_AVAILABLE */
+
+/** @def BSP430_CONSOLE_RTS_RESUME_AVAILABLE
+ *
+ * The number of free octets in the console receive buffer at or
+ * above which request-to-send is asserted again.  The difference from
+ * #BSP430_CONSOLE_RTS_STOP_AVAILABLE prevents the line from toggling
+ * on every octet.
+ *
+ * @dependency #configBSP430_CONSOLE_USE_RTS
+ * @defaulted */
+#ifndef BSP430_CONSOLE_RTS_RESUME_AVAILABLE
+#define BSP430_CONSOLE_RTS_RESUME_AVAILABLE (BSP430_CONSOLE_RX_BUFFER_SIZE / 2)
+#endif /* BSP430_CONSOLE_RTS_RESUME_AVAILABLE */
+
+/** @def configBSP430_CONSOLE_RX_LINE_MODE
+ *
+ * Define to a true value to support line assembly in the console
+ * receive interrupt, enabled at runtime by
+ * iBSP430consoleSetRxLineMode_ni().
+ *
+ * @dependency #BSP430_CONSOLE_RX_BUFFER_SIZE
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_CONSOLE_RX_LINE_MODE
+#define configBSP430_CONSOLE_RX_LINE_MODE 0
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+
 /** Return a character that was input to the console.
  *
  * @return the next character that was input to the console, or -1 if
@@ -232,6 +403,48 @@ cgetchar (void)
  * @dependency #BSP430_CONSOLE_RX_BUFFER_SIZE */
 int cpeekchar_ni (void);
 
+/** Select whether the console receive interrupt assembles lines.
+ *
+ * Normally every received octet wakes the application from low power
+ * mode.  In line mode the receive interrupt echoes printable
+ * characters and applies the editing keys backspace (BS), kill line
+ * (C-u) and kill word (C-w) to the text that has not yet been read.
+ * The application is woken only when any other control character
+ * arrives, such as the carriage return that completes a line, or when
+ * the receive buffer fills.  An escape sequence is passed through
+ * without echo, waking the application at its start and end.
+ *
+ * Everything except the echoed characters and the edits applied to
+ * them is passed to cgetchar_ni() as received.  An editing key that
+ * would affect text the application has already read is passed
+ * through for the application to apply; iBSP430cliConsoleBufferProcessInput_ni()
+ * does so, and does not echo again what the interrupt echoed.  When
+ * the buffer is full a printable character is discarded and answered
+ * with a bell, rather than overwriting the oldest input.
+ *
+ * The echo is queued with iBSP430consoleTransmitBlock_ni(), and is
+ * discarded if there is no room for it.  With
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE zero the interrupt waits for the
+ * UART to accept each echoed octet.
+ *
+ * Size #BSP430_CONSOLE_RX_BUFFER_SIZE to hold a complete line, so the
+ * application sees it in one wakeup.
+ *
+ * @param enablep nonzero to assemble lines, zero to wake on every
+ * octet
+ *
+ * @return the previous setting, or -1 if line mode is not available
+ * in which case the setting is unchanged
+ *
+ * @dependency #configBSP430_CONSOLE_RX_LINE_MODE */
+int iBSP430consoleSetRxLineMode_ni (int enablep);
+
+/** Return nonzero if the console receive interrupt is assembling
+ * lines.
+ *
+ * @see iBSP430consoleSetRxLineMode_ni() */
+int iBSP430consoleRxLineMode_ni (void);
+
 /** @def configBSP430_CONSOLE_PROVIDES_PUTCHAR
  *
  * If defined to a true value, the individual character display
@@ -276,7 +489,8 @@ int cpeekchar_ni (void);
 /** @def configBSP430_CONSOLE_LIBC_HAS_ITOA
  *
  * Define to false if your libc does not provide itoa.  msp430-libc
- * does provide this, and it is used to implement cputi.
+ * does provide this, and it is used to implement cputi_ni().  If
+ * false, <bsp430/utility/format.h> is used instead.
  *
  * @cppflag
  * @defaulted */
@@ -287,7 +501,8 @@ int cpeekchar_ni (void);
 /** @def configBSP430_CONSOLE_LIBC_HAS_UTOA
  *
  * Define to false if your libc does not provide utoa.  msp430-libc
- * does provide this, and it is used to implement cputu.
+ * does provide this, and it is used to implement cputu_ni().  If
+ * false, <bsp430/utility/format.h> is used instead.
  *
  * @cppflag
  * @defaulted */
@@ -298,7 +513,8 @@ int cpeekchar_ni (void);
 /** @def configBSP430_CONSOLE_LIBC_HAS_LTOA
  *
  * Define to false if your libc does not provide ltoa.  msp430-libc
- * does provide this, and it is used to implement cputl.
+ * does provide this, and it is used to implement cputl_ni().  If
+ * false, <bsp430/utility/format.h> is used instead.
  *
  * @cppflag
  * @defaulted */
@@ -309,7 +525,8 @@ int cpeekchar_ni (void);
 /** @def configBSP430_CONSOLE_LIBC_HAS_ULTOA
  *
  * Define to false if your libc does not provide ultoa.  msp430-libc
- * does provide this, and it is used to implement cputul.
+ * does provide this, and it is used to implement cputul_ni().  If
+ * false, <bsp430/utility/format.h> is used instead.
  *
  * @cppflag
  * @defaulted */
@@ -323,6 +540,10 @@ int cpeekchar_ni (void);
  * exit, interruptibility state is restored (if entered with
  * interrupts disabled, they remain disabled).
  *
+ * If #BSP430_CONSOLE_FORMAT_BUFFER_SIZE is positive interrupts are
+ * instead left as they were while formatting, and are disabled only
+ * while each filled buffer is copied out.
+ *
  * If xBSP430consoleInitialize() has not assigned a UART device, the
  * call is a no-op.
  *
@@ -346,6 +567,87 @@ __attribute__((__format__(printf, 1, 2)))
  * @return as with cprintf(). */
 int vcprintf (const char * format, va_list ap);
 
+/** @def configBSP430_CONSOLE_SINKS
+ *
+ * Define to a true value to copy console text output to additional
+ * sinks registered with iBSP430consoleAddSink_ni(), and to filter
+ * output to the console UART and each sink by severity level.
+ *
+ * The text is formatted once and the same octets are delivered to
+ * each destination.  With #BSP430_CONSOLE_FORMAT_BUFFER_SIZE positive
+ * cprintf() delivers its text to each sink a buffer at a time rather
+ * than an octet at a time, which is much cheaper.
+ *
+ * Sinks receive output only while the console is initialized, as
+ * console output is discarded otherwise.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_CONSOLE_SINKS
+#define configBSP430_CONSOLE_SINKS 0
+#endif /* configBSP430_CONSOLE_SINKS */
+
+/** Severity level: the system is unusable */
+#define BSP430_CONSOLE_LEVEL_EMERG 0
+/** Severity level: action must be taken immediately */
+#define BSP430_CONSOLE_LEVEL_ALERT 1
+/** Severity level: critical condition */
+#define BSP430_CONSOLE_LEVEL_CRIT 2
+/** Severity level: error condition */
+#define BSP430_CONSOLE_LEVEL_ERR 3
+/** Severity level: warning condition */
+#define BSP430_CONSOLE_LEVEL_WARNING 4
+/** Severity level: normal but significant condition */
+#define BSP430_CONSOLE_LEVEL_NOTICE 5
+/** Severity level: informational message */
+#define BSP430_CONSOLE_LEVEL_INFO 6
+/** Severity level: debug detail */
+#define BSP430_CONSOLE_LEVEL_DEBUG 7
+
+/** @def BSP430_CONSOLE_LEVEL_DEFAULT
+ *
+ * The severity level of console output that does not specify one.
+ * Levels follow syslog(3): #BSP430_CONSOLE_LEVEL_EMERG (0) is the
+ * most severe, #BSP430_CONSOLE_LEVEL_DEBUG (7) the least.
+ *
+ * @dependency #configBSP430_CONSOLE_SINKS
+ * @defaulted */
+#ifndef BSP430_CONSOLE_LEVEL_DEFAULT
+#define BSP430_CONSOLE_LEVEL_DEFAULT BSP430_CONSOLE_LEVEL_INFO
+#endif /* BSP430_CONSOLE_LEVEL_DEFAULT */
+
+/** Like cprintf(), but at a specific severity level.
+ *
+ * The text reaches only those of the console UART and the registered
+ * sinks whose threshold is at least @p level.  If none would accept
+ * it the text is not formatted at all, so disabled debug output costs
+ * little more than the call.
+ *
+ * Output emitted from an interrupt that preempts formatting with
+ * #BSP430_CONSOLE_FORMAT_BUFFER_SIZE positive takes the level of the
+ * interrupted call.
+ *
+ * Without #configBSP430_CONSOLE_SINKS @p level is ignored.
+ *
+ * @param level the severity of the text, from
+ * #BSP430_CONSOLE_LEVEL_EMERG to #BSP430_CONSOLE_LEVEL_DEBUG
+ *
+ * @param format A printf(3) format string
+ *
+ * @return as with cprintf(); 0 if the text was filtered out
+ *
+ * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_LIBC_HAS_VUPRINTF */
+int clprintf (int level, const char * format, ...)
+#if __GNUC__ - 0
+__attribute__((__format__(printf, 2, 3)))
+#endif /* __GNUC__ */
+;
+
+/** Like vcprintf(), but at a specific severity level.
+ *
+ * @see clprintf() */
+int vclprintf (int level, const char * format, va_list ap);
+
 /** Like puts(3) to the console UART
  *
  * As with #cprintf, interrupts are disabled for the duration of the
@@ -400,55 +702,79 @@ cputchar (int c)
 int cputtext_ni (const char * s);
 
 /** Format an int using itoa and emit it to the console.
+ *
+ * Without libc support (#configBSP430_CONSOLE_LIBC_HAS_ITOA false)
+ * radix 10 and 16 are formatted by <bsp430/utility/format.h> and
+ * other radices by division.  As with itoa, a minus sign is
+ * produced only in radix 10; in other radices @p n is formatted as
+ * unsigned.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that @p radix is at least 10.
- * Passing a smaller radix will likely result in stack corruption.
+ * @warning With libc the implementation assumes that the radix is at
+ * least 10.  Passing a smaller radix will likely result in stack
+ * corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_LIBC_HAS_ITOA */
+ * @dependency #BSP430_CONSOLE */
 int cputi_ni (int n, int radix);
 
-/** Format an int using utoa and emit it to the console.
+/** Format an unsigned int using utoa and emit it to the console.
+ *
+ * Without libc support (#configBSP430_CONSOLE_LIBC_HAS_UTOA false)
+ * radix 10 and 16 are formatted by <bsp430/utility/format.h> and
+ * other radices by division.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that the radix is at least 10.
- * Passing a smaller radix will likely result in stack corruption.
+ * @warning With libc the implementation assumes that the radix is at
+ * least 10.  Passing a smaller radix will likely result in stack
+ * corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_LIBC_HAS_UTOA */
+ * @dependency #BSP430_CONSOLE */
 int cputu_ni (unsigned int n, int radix);
 
-/** Format an int using ltoa and emit it to the console.
+/** Format a long using ltoa and emit it to the console.
+ *
+ * Without libc support (#configBSP430_CONSOLE_LIBC_HAS_LTOA false)
+ * radix 10 and 16 are formatted by <bsp430/utility/format.h> and
+ * other radices by division.  As with ltoa, a minus sign is
+ * produced only in radix 10; in other radices @p n is formatted as
+ * unsigned.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that the radix is at least 10.
- * Passing a smaller radix will likely result in stack corruption.
+ * @warning With libc the implementation assumes that the radix is at
+ * least 10.  Passing a smaller radix will likely result in stack
+ * corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_LIBC_HAS_LTOA */
+ * @dependency #BSP430_CONSOLE */
 int cputl_ni (long n, int radix);
 
-/** Format an int using itoa and emit it to the console.
+/** Format an unsigned long using ultoa and emit it to the console.
+ *
+ * Without libc support (#configBSP430_CONSOLE_LIBC_HAS_ULTOA false)
+ * radix 10 and 16 are formatted by <bsp430/utility/format.h> and
+ * other radices by division.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that the radix is at least 10.
- * Passing a smaller radix will likely result in stack corruption.
+ * @warning With libc the implementation assumes that the radix is at
+ * least 10.  Passing a smaller radix will likely result in stack
+ * corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_LIBC_HAS_ULTOA */
+ * @dependency #BSP430_CONSOLE */
 int cputul_ni (unsigned long n, int radix);
 
 /** Initialize and return the console serial HAL instance.
@@ -539,10 +865,220 @@ int iBSP430consoleTransmitUseInterrupts_ni (int enablep);
  * function had to suspend (enabling interrupts) in order to obtain
  * that space;
  * @li -1 if @p want_available is larger than
- * #BSP430_CONSOLE_TX_BUFFER_SIZE-1, which is the maximum number of
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE, which is the maximum number of
  * bytes that can be made available. */
 int iBSP430consoleWaitForTxSpace_ni (int want_available);
 
+/** Queue a block of octets for transmission without waiting.
+ *
+ * The octets are written as they are: no newline translation is
+ * done.  With interrupt-driven transmission the block is copied into
+ * the transmit buffer only if it fits in full, so this may be used
+ * from interrupt handlers that must not block.  Otherwise the octets
+ * are written directly to the UART.
+ *
+ * @param data the octets to transmit
+ *
+ * @param len the number of octets in @p data
+ *
+ * @return @p len if the block was queued or transmitted; -1 if the
+ * console is not available or the transmit buffer does not have room
+ * for the whole block, in which case nothing was queued. */
+int iBSP430consoleTransmitBlock_ni (const uint8_t * data,
+                                    size_t len);
+
+/** Wait for space in the transmit buffer.  This is the only policy
+ * before iBSP430consoleSetTxPolicy_ni() is invoked. */
+#define BSP430_CONSOLE_TX_POLICY_BLOCK 0
+
+/** Discard output that does not fit in the transmit buffer.  The
+ * marker #BSP430_CONSOLE_TX_DROP_MARKER precedes the next output that
+ * does fit. */
+#define BSP430_CONSOLE_TX_POLICY_DROP_NEWEST 1
+
+/** Discard the oldest queued output to make room for new output.  The
+ * oldest output that remains is replaced by
+ * #BSP430_CONSOLE_TX_DROP_MARKER.
+ *
+ * @note If #configBSP430_SERIAL_TX_BLOCK_USE_DMA is enabled output
+ * that has been handed to DMA cannot be discarded.  When that is all
+ * that is queued the new output is discarded instead. */
+#define BSP430_CONSOLE_TX_POLICY_DROP_OLDEST 2
+
+/** Select what console output does when the transmit buffer is full.
+ *
+ * By default the output routines wait, with interrupts enabled, for
+ * the transmit interrupt to make room.  Code that must not be delayed
+ * by a burst of diagnostics can select a policy that discards output
+ * instead, and restore the previous policy when done:
+ *
+ * @code
+ * BSP430_CORE_DISABLE_INTERRUPT();
+ * policy = iBSP430consoleSetTxPolicy_ni(BSP430_CONSOLE_TX_POLICY_DROP_NEWEST);
+ * BSP430_CORE_ENABLE_INTERRUPT();
+ * cprintf("loop %u late by %u\n", n, late);
+ * BSP430_CORE_DISABLE_INTERRUPT();
+ * (void)iBSP430consoleSetTxPolicy_ni(policy);
+ * BSP430_CORE_ENABLE_INTERRUPT();
+ * @endcode
+ *
+ * The policy affects cputchar_ni(), cputs(), cprintf() and the other
+ * text output routines.  Under a discarding policy they never wait,
+ * so they may be used from interrupt handlers.  Octets that are
+ * discarded are counted; see uiBSP430consoleTxDropped_ni().
+ *
+ * @param policy one of #BSP430_CONSOLE_TX_POLICY_BLOCK,
+ * #BSP430_CONSOLE_TX_POLICY_DROP_NEWEST, or
+ * #BSP430_CONSOLE_TX_POLICY_DROP_OLDEST
+ *
+ * @return the previous policy, or -1 if @p policy is not recognized
+ * or #BSP430_CONSOLE_TX_BUFFER_SIZE is zero, in which case the policy
+ * is unchanged.  Without a transmit buffer output always waits for
+ * the UART.
+ *
+ * @dependency #BSP430_CONSOLE_TX_BUFFER_SIZE */
+int iBSP430consoleSetTxPolicy_ni (int policy);
+
+/** Return the number of output octets discarded by the transmit
+ * policy.
+ *
+ * The count includes octets overwritten by the drop marker, but not
+ * the marker itself.  It saturates rather than wrapping.
+ *
+ * @param reset if nonzero the count is reset to zero after being read
+ *
+ * @return the number of octets discarded since the count was last
+ * reset */
+unsigned int uiBSP430consoleTxDropped_ni (int reset);
+
+/* Forward declaration */
+struct sBSP430consoleSink;
+
+/** A handle to a console output sink */
+typedef struct sBSP430consoleSink * hBSP430consoleSink;
+
+/** Deliver console output to a sink.
+ *
+ * Invoked with interrupts disabled, possibly from an interrupt
+ * handler, for each block of output the sink accepts.  The function
+ * must not wait for a transport: a sink for a slow device should
+ * store the text for transmission later, as the ring sink does.
+ *
+ * @param sink the sink receiving the text
+ * @param data the octets to deliver, exactly as sent to the console
+ * UART
+ * @param len the number of octets at @p data */
+typedef void (* vBSP430consoleSinkWrite_ni) (hBSP430consoleSink sink,
+                                             const uint8_t * data,
+                                             size_t len);
+
+/** A destination for a copy of console output.
+ *
+ * Embed this structure at the start of a larger one holding the
+ * sink's own state, as #sBSP430consoleRingSink does. */
+typedef struct sBSP430consoleSink {
+  /** The next registered sink.  Maintained by the console. */
+  struct sBSP430consoleSink * volatile next_ni;
+
+  /** The function that stores or transmits the text */
+  vBSP430consoleSinkWrite_ni write_ni;
+
+  /** The least severe level the sink accepts: output at a level
+   * numerically greater than this is not delivered */
+  unsigned char threshold;
+} sBSP430consoleSink;
+
+/** Register a sink to receive console text output.
+ *
+ * Output from cputchar_ni(), cputtext_ni(), cputs(), cprintf() and
+ * the other text routines is delivered to each registered sink whose
+ * threshold accepts it, after it has been formatted once.  Binary
+ * blocks from iBSP430consoleTransmitBlock_ni() go only to the console
+ * UART.
+ *
+ * @param sink the sink to add.  Its @c write_ni and @c threshold
+ * fields must be set.
+ *
+ * @return 0 if the sink was added, or -1 if it is already registered
+ * or #configBSP430_CONSOLE_SINKS is false
+ *
+ * @dependency #configBSP430_CONSOLE_SINKS */
+int iBSP430consoleAddSink_ni (hBSP430consoleSink sink);
+
+/** Stop delivering console output to a sink.
+ *
+ * @return 0 if the sink was removed, or -1 if it was not registered */
+int iBSP430consoleRemoveSink_ni (hBSP430consoleSink sink);
+
+/** Set the least severe level of output sent to the console UART.
+ *
+ * Use this to keep detail out of the UART while a sink such as a RAM
+ * trace records it.
+ *
+ * @param threshold the least severe level to transmit, from
+ * #BSP430_CONSOLE_LEVEL_EMERG to #BSP430_CONSOLE_LEVEL_DEBUG.  The
+ * initial threshold is #BSP430_CONSOLE_LEVEL_DEBUG.
+ *
+ * @return the previous threshold, or -1 if @p threshold is out of
+ * range or #configBSP430_CONSOLE_SINKS is false
+ *
+ * @dependency #configBSP430_CONSOLE_SINKS */
+int iBSP430consoleSetThreshold_ni (int threshold);
+
+/** A sink that stores console output in a ring buffer.
+ *
+ * The ring may be left for a debugger to read as a trace, or drained
+ * by the application into a secondary transport such as another UART
+ * or an SPI-attached logger:
+ *
+ * @code
+ * static uint8_t log_storage[256];
+ * static sBSP430consoleRingSink log_sink;
+ *
+ * BSP430_CORE_DISABLE_INTERRUPT();
+ * (void)iBSP430consoleAddSink_ni(hBSP430consoleRingSinkInitialize(&log_sink, log_storage, sizeof(log_storage), BSP430_CONSOLE_LEVEL_DEBUG, 0));
+ * BSP430_CORE_ENABLE_INTERRUPT();
+ * ...
+ * BSP430_CORE_DISABLE_INTERRUPT();
+ * dp = xBSP430ring16Peek(&log_sink.ring, &len);
+ * len = write_to_logger(dp, len);
+ * vBSP430ring16Release(&log_sink.ring, len);
+ * BSP430_CORE_ENABLE_INTERRUPT();
+ * @endcode
+ *
+ * The console is the producer.  If the sink overwrites, the consumer
+ * must read with interrupts disabled. */
+typedef struct sBSP430consoleRingSink {
+  /** The sink registered with the console */
+  sBSP430consoleSink sink;
+
+  /** The stored output */
+  sBSP430ring16 ring;
+
+  /** Nonzero to discard the oldest stored output to make room for
+   * new output, as a trace does; zero to discard the new output */
+  unsigned char overwrite;
+
+  /** The number of octets discarded for lack of room */
+  unsigned int dropped;
+} sBSP430consoleRingSink;
+
+/** Prepare a ring sink for registration with iBSP430consoleAddSink_ni().
+ *
+ * @param rsp the sink state
+ * @param buffer storage for the ring
+ * @param size the size of @p buffer, which must satisfy
+ * #BSP430_RING_SIZE_IS_VALID for 16-bit indexes
+ * @param threshold the least severe level the sink accepts
+ * @param overwrite the value for sBSP430consoleRingSink::overwrite
+ *
+ * @return the sink handle, or NULL if the buffer is unusable */
+hBSP430consoleSink hBSP430consoleRingSinkInitialize (sBSP430consoleRingSink * rsp,
+                                                     uint8_t * buffer,
+                                                     size_t size,
+                                                     int threshold,
+                                                     int overwrite);
+
 /** Flush any pending data in the console transmit buffer.
  *
  * The caller may enter low power mode while waiting for the console
@@ -0,0 +1,225 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Integer and fixed-point formatting without libc
+ *
+ * These functions produce the text of a number in a caller-supplied
+ * buffer, for emission with cputtext_ni() or any other channel.  They
+ * cover what telemetry usually needs (decimal, hexadecimal, field
+ * width with space or zero padding, and fixed-point values) without
+ * the code size and stack of vuprintf(), and without 32-bit division:
+ *
+ * @li a 16-bit value is divided by ten by multiplying with a scaled
+ * reciprocal, using the hardware multiplier when the MCU has one (see
+ * #configBSP430_FORMAT_USE_HWMULT) and a shift-and-add sequence
+ * otherwise;
+ * @li a 32-bit value above 65535 converts its upper half as above,
+ * then shifts in the lower half by binary-to-BCD conversion
+ * ("double dabble"), which uses only 16-bit adds and shifts.
+ *
+ * The format of a number is controlled by a @c spec argument: a field
+ * width (#BSP430_FORMAT_WIDTH_MASK) combined with flags such as
+ * #BSP430_FORMAT_FLAG_ZERO_PAD.  A spec of zero produces the shortest
+ * representation.
+ *
+ * Fixed-point values may be given either as a scaled integer, where
+ * for example a temperature of 2345 in hundredths of a degree is
+ * shown as @c 23.45 by uiBSP430formatScaled(), or in a binary Qn
+ * format, where for example 0x1780 in Q8 is shown as @c 23.50 by
+ * uiBSP430formatQ().
+ *
+ * @code
+ * char buf[BSP430_FORMAT_BUFFER_SIZE];
+ *
+ * (void)uiBSP430formatScaled(buf, temp_dC, 1, 5);
+ * cputtext_ni(buf);
+ * cputtext_ni(" C, adc 0x");
+ * (void)uiBSP430formatHex(buf, adc, 3 | BSP430_FORMAT_FLAG_ZERO_PAD);
+ * cputtext_ni(buf);
+ * @endcode
+ *
+ * The module depends on no hardware, and may be compiled for a host
+ * to test it (see the unittests/format example).
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_FORMAT_H
+#define BSP430_UTILITY_FORMAT_H
+
+#include <bsp430/core.h>
+
+/** @def configBSP430_FORMAT_USE_HWMULT
+ *
+ * Define to a true value to divide by ten using a 16x16 multiply,
+ * which is a few cycles on the hardware multiplier, or to false to
+ * use a sequence of shifts and adds, which is faster than the
+ * software multiply on MCUs without one.
+ *
+ * @cppflag
+ * @defaulted true if the MCU has an MPY or MPY32 peripheral */
+#ifndef configBSP430_FORMAT_USE_HWMULT
+#if defined(__MSP430_HAS_MPY__) || defined(__MSP430_HAS_MPY32__)
+#define configBSP430_FORMAT_USE_HWMULT 1
+#else /* MCU has multiplier */
+#define configBSP430_FORMAT_USE_HWMULT 0
+#endif /* MCU has multiplier */
+#endif /* configBSP430_FORMAT_USE_HWMULT */
+
+/** Octets in a buffer large enough for the output of any function in
+ * this module, including the terminating NUL, for any field width. */
+#define BSP430_FORMAT_BUFFER_SIZE 32
+
+/** The bits of a @c spec that hold the minimum field width.  Output
+ * shorter than this is padded on the left. */
+#define BSP430_FORMAT_WIDTH_MASK 0x1F
+
+/** Flag for a @c spec: pad to the field width with zeros following
+ * any sign, rather than with spaces preceding it. */
+#define BSP430_FORMAT_FLAG_ZERO_PAD 0x20
+
+/** Flag for a @c spec: precede a non-negative signed value with a
+ * plus sign. */
+#define BSP430_FORMAT_FLAG_PLUS 0x40
+
+/** Flag for a @c spec: use upper-case hexadecimal digits. */
+#define BSP430_FORMAT_FLAG_UPPER 0x80
+
+/** The largest number of fractional bits supported by
+ * uiBSP430formatQ(). */
+#define BSP430_FORMAT_Q_MAX_FRAC_BITS 16
+
+/** The largest number of decimal places supported by
+ * uiBSP430formatQ(). */
+#define BSP430_FORMAT_Q_MAX_DECIMALS 4
+
+/** The largest number of decimal places supported by
+ * uiBSP430formatScaled(). */
+#define BSP430_FORMAT_SCALED_MAX_DECIMALS 9
+
+/** Format an unsigned value in decimal.
+ *
+ * @param dst where the NUL-terminated text is stored; must have room
+ * for #BSP430_FORMAT_BUFFER_SIZE octets
+ *
+ * @param value the value to format
+ *
+ * @param spec the field width and flags; #BSP430_FORMAT_FLAG_PLUS is
+ * ignored
+ *
+ * @return the number of characters stored, excluding the NUL */
+unsigned int uiBSP430formatUnsigned (char * dst,
+                                     unsigned long value,
+                                     unsigned int spec);
+
+/** Format a signed value in decimal.
+ *
+ * @param dst as with uiBSP430formatUnsigned()
+ *
+ * @param value the value to format
+ *
+ * @param spec the field width and flags
+ *
+ * @return the number of characters stored, excluding the NUL */
+unsigned int uiBSP430formatSigned (char * dst,
+                                   long value,
+                                   unsigned int spec);
+
+/** Format an unsigned value in hexadecimal, without a prefix.
+ *
+ * @param dst as with uiBSP430formatUnsigned()
+ *
+ * @param value the value to format
+ *
+ * @param spec the field width and flags; #BSP430_FORMAT_FLAG_PLUS is
+ * ignored
+ *
+ * @return the number of characters stored, excluding the NUL */
+unsigned int uiBSP430formatHex (char * dst,
+                                unsigned long value,
+                                unsigned int spec);
+
+/** Format a scaled integer as a decimal fraction.
+ *
+ * The value shown is @p value divided by ten to the power @p
+ * decimals, with exactly @p decimals digits following the decimal
+ * point.  No arithmetic is required beyond that of
+ * uiBSP430formatSigned().
+ *
+ * @param dst as with uiBSP430formatUnsigned()
+ *
+ * @param value the value in units of the last decimal place
+ *
+ * @param decimals the number of decimal places, no more than
+ * #BSP430_FORMAT_SCALED_MAX_DECIMALS.  Zero formats @p value as an
+ * integer.
+ *
+ * @param spec the field width and flags
+ *
+ * @return the number of characters stored excluding the NUL, or zero
+ * (with @p dst empty) if @p decimals is out of range */
+unsigned int uiBSP430formatScaled (char * dst,
+                                   long value,
+                                   unsigned int decimals,
+                                   unsigned int spec);
+
+/** Format a binary fixed-point value as a decimal fraction.
+ *
+ * The value shown is @p value divided by two to the power @p
+ * frac_bits, rounded to @p decimals places.  A negative value that
+ * rounds to zero retains its sign, as with printf(3).
+ *
+ * @param dst as with uiBSP430formatUnsigned()
+ *
+ * @param value the value in Qn format, where n is @p frac_bits
+ *
+ * @param frac_bits the number of fractional bits in @p value, no more
+ * than #BSP430_FORMAT_Q_MAX_FRAC_BITS
+ *
+ * @param decimals the number of decimal places to show, no more than
+ * #BSP430_FORMAT_Q_MAX_DECIMALS.  Zero shows the value rounded to an
+ * integer, without a decimal point.
+ *
+ * @param spec the field width and flags
+ *
+ * @return the number of characters stored excluding the NUL, or zero
+ * (with @p dst empty) if @p frac_bits or @p decimals is out of
+ * range */
+unsigned int uiBSP430formatQ (char * dst,
+                              long value,
+                              unsigned int frac_bits,
+                              unsigned int decimals,
+                              unsigned int spec);
+
+#endif /* BSP430_UTILITY_FORMAT_H */
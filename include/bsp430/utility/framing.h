@@ -0,0 +1,279 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief COBS and SLIP packet framing with CRC-16 over serial devices.
+ *
+ * Binary frames are carried over a UART by appending a CRC-16 and
+ * either of two common framings:
+ *
+ * @li <a href="http://www.stuartcheshire.org/papers/COBSforToN.pdf">COBS</a>
+ * (Consistent Overhead Byte Stuffing) removes all zero octets from
+ * the frame at a cost of at most one octet in 254, and terminates it
+ * with a zero;
+ * @li <a href="http://tools.ietf.org/html/rfc1055">SLIP</a> brackets
+ * the frame with 0xC0 and escapes that octet and the escape octet
+ * 0xDB, at a cost of up to double the length.
+ *
+ * The CRC is CRC-16-CCITT (polynomial 0x1021, initial value 0xFFFF,
+ * no reflection, sometimes called CRC-16/CCITT-FALSE), transmitted
+ * most significant octet first.  It is computed by the CRC16 module
+ * where the MCU has one, as with uiBSP430tlvChecksum(), and in
+ * software otherwise.
+ *
+ * Frames are encoded into a buffer with iBSP430framingEncode(), or
+ * transmitted directly with iBSP430framingTxFrame_ni(), which needs no
+ * buffer.  Reception is incremental: a decoder attached to a serial
+ * device with iBSP430framingDecoderAttach_ni() consumes each octet
+ * from the receive callback chain, decoding in place into a buffer
+ * supplied by the application.  When a frame with a valid CRC is
+ * complete the buffer is handed to the application, which supplies
+ * another to continue reception; nothing is copied.
+ *
+ * The encoders and iBSP430framingDecoderRxOctet_ni() depend on no
+ * hardware other than the CRC module, so framing can be validated by
+ * round-trip tests (see the unittests/framing example).
+ *
+ * @warning On MCUs with the CRC16 module this relies on the
+ * bit-reversed input register, which is not present on certain NRND
+ * MCUs like the MSP430F5438; see uiBSP430tlvChecksum().
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_FRAMING_H
+#define BSP430_UTILITY_FRAMING_H
+
+#include <bsp430/serial.h>
+
+/** Mode value selecting COBS framing */
+#define BSP430_FRAMING_MODE_COBS 0
+
+/** Mode value selecting SLIP framing */
+#define BSP430_FRAMING_MODE_SLIP 1
+
+/** The initial value for uiBSP430framingCRC16() */
+#define BSP430_FRAMING_CRC16_INIT 0xFFFF
+
+/** The number of octets of CRC appended to each frame */
+#define BSP430_FRAMING_CRC_LENGTH 2
+
+/** The largest encoded size of a frame with @p len_ octets of
+ * payload, including CRC and delimiters, for either mode. */
+#define BSP430_FRAMING_ENCODED_MAX(len_) (2 * ((len_) + BSP430_FRAMING_CRC_LENGTH) + 2)
+
+/** Update a CRC-16-CCITT with additional data.
+ *
+ * @param crc the CRC of the preceding data, or
+ * #BSP430_FRAMING_CRC16_INIT at the start
+ *
+ * @param data the data to add
+ *
+ * @param len the number of octets in @p data
+ *
+ * @return the updated CRC */
+unsigned int uiBSP430framingCRC16 (unsigned int crc,
+                                   const uint8_t * data,
+                                   size_t len);
+
+/** Encode a frame into a buffer.
+ *
+ * @param mode #BSP430_FRAMING_MODE_COBS or #BSP430_FRAMING_MODE_SLIP
+ *
+ * @param data the frame payload
+ *
+ * @param len the number of octets in @p data
+ *
+ * @param dst where the encoded frame, including CRC and delimiters,
+ * is stored
+ *
+ * @param dst_size the space available at @p dst.
+ * #BSP430_FRAMING_ENCODED_MAX(@p len) is always sufficient.
+ *
+ * @return the number of octets stored in @p dst, or -1 if @p dst_size
+ * is too small or @p mode is not recognized. */
+int iBSP430framingEncode (int mode,
+                          const uint8_t * data,
+                          size_t len,
+                          uint8_t * dst,
+                          size_t dst_size);
+
+/** Encode a frame and transmit it over a UART.
+ *
+ * Octets are encoded as they are transmitted with
+ * iBSP430uartTxByte_ni(), so no buffer is required.
+ *
+ * @param hal the UART over which the frame is transmitted
+ *
+ * @param mode #BSP430_FRAMING_MODE_COBS or #BSP430_FRAMING_MODE_SLIP
+ *
+ * @param data the frame payload
+ *
+ * @param len the number of octets in @p data
+ *
+ * @return @p len, or -1 if @p mode is not recognized or a
+ * transmission failed. */
+int iBSP430framingTxFrame_ni (hBSP430halSERIAL hal,
+                              int mode,
+                              const uint8_t * data,
+                              size_t len);
+
+/** A handle to a frame decoder. */
+typedef struct sBSP430framingDecoder * hBSP430framingDecoder;
+
+/** Callback invoked from interrupt context when a decoder completes a
+ * frame with a valid CRC.
+ *
+ * The buffer now belongs to the application.  The decoder discards
+ * incoming frames until it is given another buffer with
+ * vBSP430framingDecoderSetBuffer_ni(), which the callback may do.
+ *
+ * @param decoder the decoder that completed the frame
+ *
+ * @param frame the buffer holding the frame payload
+ *
+ * @param len the length of the payload, excluding CRC
+ *
+ * @return flags as with #iBSP430halISRCallbackVoid */
+typedef int (* iBSP430framingFrameCallback_ni) (hBSP430framingDecoder decoder,
+                                                uint8_t * frame,
+                                                size_t len);
+
+/** State for incremental decoding of received frames. */
+typedef struct sBSP430framingDecoder {
+  /** The node linked into sBSP430halSERIAL.rx_cbchain_ni by
+   * iBSP430framingDecoderAttach_ni() */
+  sBSP430halISRVoidChainNode cb_node;
+
+  /** The callback invoked when a frame is complete.  If null,
+   * completion returns #BSP430_HAL_ISR_CALLBACK_EXIT_LPM and the
+   * application finds the frame in #frame. */
+  iBSP430framingFrameCallback_ni frame_cb_ni;
+
+  /** The buffer holding the most recently completed frame, or null
+   * if no frame has been completed since the last call to
+   * vBSP430framingDecoderSetBuffer_ni(). */
+  uint8_t * volatile frame;
+
+  /** The payload length of the frame at #frame */
+  volatile size_t frame_len;
+
+  /** The number of frames discarded because of a CRC mismatch or
+   * invalid encoding */
+  unsigned int errors;
+
+  /** The number of frames discarded because they did not fit in the
+   * buffer or no buffer was available */
+  unsigned int overruns;
+
+  /** @cond DOXYGEN_EXCLUDE */
+  uint8_t * buffer;
+  size_t size;
+  size_t len;
+  unsigned int crc;
+  unsigned char mode;
+  unsigned char code;
+  unsigned char flags;
+  /** @endcond */
+} sBSP430framingDecoder;
+
+/** Initialize a frame decoder.
+ *
+ * The decoder has no buffer; supply one with
+ * vBSP430framingDecoderSetBuffer_ni() to begin accepting frames.
+ *
+ * @param decoder the decoder state
+ *
+ * @param mode #BSP430_FRAMING_MODE_COBS or #BSP430_FRAMING_MODE_SLIP
+ *
+ * @param frame_cb_ni optional callback for completed frames
+ *
+ * @return a handle to the decoder, or a null pointer if @p mode is
+ * not recognized. */
+hBSP430framingDecoder hBSP430framingDecoderInitialize (sBSP430framingDecoder * decoder,
+                                                       int mode,
+                                                       iBSP430framingFrameCallback_ni frame_cb_ni);
+
+/** Supply the buffer into which the next frame is decoded.
+ *
+ * Any partially decoded frame is discarded, and #frame is cleared.
+ *
+ * @param decoder the decoder
+ *
+ * @param buffer where the payload and CRC are decoded
+ *
+ * @param size the space available in @p buffer.  Frames whose
+ * payload plus #BSP430_FRAMING_CRC_LENGTH exceeds this are discarded. */
+void vBSP430framingDecoderSetBuffer_ni (hBSP430framingDecoder decoder,
+                                        uint8_t * buffer,
+                                        size_t size);
+
+/** Decode one received octet.
+ *
+ * This is the decoding engine invoked from the receive callback of an
+ * attached decoder.  It may be used directly on octets obtained
+ * elsewhere.
+ *
+ * @param decoder the decoder
+ *
+ * @param octet the received octet
+ *
+ * @return the payload length if @p octet completed a valid frame,
+ * which is now at sBSP430framingDecoder.frame; otherwise -1. */
+int iBSP430framingDecoderRxOctet_ni (hBSP430framingDecoder decoder,
+                                     uint8_t octet);
+
+/** Attach a decoder to the receive callback chain of a serial device.
+ *
+ * @param decoder the decoder
+ *
+ * @param hal the serial device.  The receive interrupt is enabled
+ * only if the callback chain is non-empty when the device is opened,
+ * so attach the decoder before opening it, as the console does.
+ *
+ * @return 0 */
+int iBSP430framingDecoderAttach_ni (hBSP430framingDecoder decoder,
+                                    hBSP430halSERIAL hal);
+
+/** Detach a decoder from the receive callback chain of a serial
+ * device.
+ *
+ * @param decoder the decoder
+ *
+ * @param hal the serial device to which it was attached
+ *
+ * @return 0 */
+int iBSP430framingDecoderDetach_ni (hBSP430framingDecoder decoder,
+                                    hBSP430halSERIAL hal);
+
+#endif /* BSP430_UTILITY_FRAMING_H */
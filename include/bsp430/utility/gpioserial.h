@@ -0,0 +1,422 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Software SPI and I2C on general purpose I/O pins.
+ *
+ * This module provides serial devices that are driven by toggling
+ * port pins rather than by a USCI or eUSCI peripheral.  Each instance
+ * is a regular #sBSP430halSERIAL reached through
+ * hBSP430serialLookup() with a pseudo-peripheral handle such as
+ * #BSP430_PERIPH_GPIOSERIAL0, so hBSP430serialOpenSPI(),
+ * iBSP430spiTxRx_ni(), hBSP430serialOpenI2C(), iBSP430i2cTxRx_ni()
+ * and the related calls work on it unchanged.  An application moves
+ * a device to arbitrary pins by changing only the peripheral handle
+ * in its configuration.
+ *
+ * The clock is generated by the CPU.  The @p prescaler passed to
+ * the open functions divides the nominal rate of the clock selected
+ * in @p ctl1_byte (ACLK for #UCSSEL_1, otherwise SMCLK), and the
+ * resulting half-period is converted to MCLK cycles using
+ * #BSP430_CLOCK_NOMINAL_MCLK_HZ.  When the half-period is shorter
+ * than the overhead of the shift loop the clock runs as fast as the
+ * unrolled loop allows; the serial/gpioserial example reports the
+ * achievable rates.  Alternatively a free-running timer may pace
+ * each clock edge (see #BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE),
+ * which keeps the rate independent of MCLK and of compiler output.
+ *
+ * Limitations:
+ * @li SPI is master only, 8-bit only, and ignores the STE pin;
+ * @li I2C is master only, 7-bit addressing, and requires external
+ * pull-ups on both lines.  Clock stretching by the slave is honored;
+ * loss of arbitration is detected and reported;
+ * @li There are no interrupts: the receive and transmit callback
+ * chains are never invoked, so SPI and I2C transaction queues cannot
+ * be attached, and UART mode is not supported;
+ * @li Interrupts should be disabled during transfers (the @c _ni
+ * functions), as an interrupt stretches the current clock phase.
+ *
+ * @section h_utility_gpioserial_opt Module Configuration Options
+ *
+ * @li #configBSP430_HAL_GPIOSERIAL0 to enable the first instance
+ *
+ * @li #BSP430_GPIOSERIAL0_CLK_PORT_PERIPH_HANDLE and related macros
+ * to identify its pins
+ *
+ * Substitute @b 1 for the second instance.  The port HAL must be
+ * enabled for every port used (e.g., #configBSP430_HAL_PORT3).
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_GPIOSERIAL_H
+#define BSP430_UTILITY_GPIOSERIAL_H
+
+#include <bsp430/serial_.h>
+#include <bsp430/periph/port.h>
+
+/** Handle identifying the first GPIO serial instance.
+ *
+ * This is a pseudo-peripheral handle for use with
+ * hBSP430serialLookup(). */
+#define BSP430_PERIPH_GPIOSERIAL0 ((tBSP430periphHandle)0x4201)
+
+/** Handle identifying the second GPIO serial instance. */
+#define BSP430_PERIPH_GPIOSERIAL1 ((tBSP430periphHandle)0x4203)
+
+/** @def configBSP430_GPIOSERIAL_USE_TIMER
+ *
+ * Define to a true value to support pacing of GPIO serial clock
+ * edges by a timer (see #BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE).
+ * This requires the @c periph/timer module and the HPL of each timer
+ * used.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_GPIOSERIAL_USE_TIMER
+#define configBSP430_GPIOSERIAL_USE_TIMER 0
+#endif /* configBSP430_GPIOSERIAL_USE_TIMER */
+
+/** @def BSP430_GPIOSERIAL_LOOP_CYCLES
+ *
+ * The approximate number of MCLK cycles consumed by one iteration of
+ * the software delay loop that stretches each clock phase.  This is
+ * used to convert a half-period into a loop count, and may be
+ * adjusted for a particular toolchain and optimization level.
+ *
+ * @defaulted */
+#ifndef BSP430_GPIOSERIAL_LOOP_CYCLES
+#define BSP430_GPIOSERIAL_LOOP_CYCLES 8
+#endif /* BSP430_GPIOSERIAL_LOOP_CYCLES */
+
+/** @def BSP430_GPIOSERIAL_SHIFT_CYCLES
+ *
+ * The approximate number of MCLK cycles consumed by the code between
+ * two clock edges when no delay is required.  Half-periods shorter
+ * than this select the unrolled shift loop with no delay.
+ *
+ * @defaulted */
+#ifndef BSP430_GPIOSERIAL_SHIFT_CYCLES
+#define BSP430_GPIOSERIAL_SHIFT_CYCLES 12
+#endif /* BSP430_GPIOSERIAL_SHIFT_CYCLES */
+
+/** @def BSP430_GPIOSERIAL_I2C_STRETCH_LIMIT
+ *
+ * The maximum number of polls of SCL to wait for a slave that is
+ * stretching the clock.  If SCL is still low after this many polls
+ * the I2C operation fails.
+ *
+ * @defaulted */
+#ifndef BSP430_GPIOSERIAL_I2C_STRETCH_LIMIT
+#define BSP430_GPIOSERIAL_I2C_STRETCH_LIMIT 10000U
+#endif /* BSP430_GPIOSERIAL_I2C_STRETCH_LIMIT */
+
+/** The registers and bit of one pin used by a GPIO serial device.
+ *
+ * Resolved from the configured port handle when the device is
+ * opened. */
+typedef struct sBSP430gpioserialPin {
+  /** The PxIN register of the pin */
+  volatile unsigned char * in;
+  /** The PxOUT register of the pin */
+  volatile unsigned char * out;
+  /** The PxDIR register of the pin */
+  volatile unsigned char * dir;
+  /** The bit of the pin within its port */
+  unsigned char bit;
+} sBSP430gpioserialPin;
+
+/** State for a GPIO serial instance.
+ *
+ * This is the object referenced by sBSP430halSERIAL.hpl_aux for a
+ * GPIO serial HAL.  The first group of fields is fixed by the
+ * configuration; the remainder is managed by the implementation.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430gpioserialState {
+  /** @cond DOXYGEN_EXCLUDE */
+  /* SPI SCK or I2C SCL */
+  const tBSP430periphHandle clk_port;
+  const unsigned char clk_bit;
+  /* SPI MOSI or I2C SDA */
+  const tBSP430periphHandle mosi_port;
+  const unsigned char mosi_bit;
+  /* SPI MISO; unused for I2C */
+  const tBSP430periphHandle miso_port;
+  const unsigned char miso_bit;
+  /* Optional free-running timer pacing the clock edges */
+  const tBSP430periphHandle timer;
+
+  sBSP430gpioserialPin clk;
+  sBSP430gpioserialPin mosi;
+  sBSP430gpioserialPin miso;
+  uint8_t (* shift_ni) (struct sBSP430gpioserialState * sp, uint8_t tx);
+  volatile unsigned int * timer_r;
+  unsigned int deadline;
+  /* Half-period in timer ticks, or in delay loop iterations */
+  unsigned int half_period;
+  unsigned int prescaler;
+  unsigned char mode;
+  unsigned char ctl0_byte;
+  unsigned char ctl1_byte;
+  unsigned char slave_address;
+  /** @endcond */
+} sBSP430gpioserialState;
+
+/** @def configBSP430_HAL_GPIOSERIAL0
+ *
+ * Define to a true value in @c bsp430_config.h to enable the first
+ * GPIO serial instance.  This defines a serial HAL object that is
+ * returned by hBSP430serialLookup() for #BSP430_PERIPH_GPIOSERIAL0.
+ * Its pins are identified by #BSP430_GPIOSERIAL0_CLK_PORT_PERIPH_HANDLE
+ * and related macros.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HAL_GPIOSERIAL0
+#define configBSP430_HAL_GPIOSERIAL0 0
+#endif /* configBSP430_HAL_GPIOSERIAL0 */
+
+/** @def configBSP430_HAL_GPIOSERIAL1
+ *
+ * As with #configBSP430_HAL_GPIOSERIAL0 for the second instance,
+ * #BSP430_PERIPH_GPIOSERIAL1.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HAL_GPIOSERIAL1
+#define configBSP430_HAL_GPIOSERIAL1 0
+#endif /* configBSP430_HAL_GPIOSERIAL1 */
+
+#if defined(BSP430_DOXYGEN)
+/** The port carrying the clock (SPI SCK or I2C SCL) of
+ * #BSP430_PERIPH_GPIOSERIAL0, e.g. #BSP430_PERIPH_PORT3.  The HAL for
+ * the port must be enabled.
+ *
+ * Similar macros with @c CLK replaced by @c MOSI identify the SPI
+ * master-out line or the I2C SDA line, and with @c MISO the SPI
+ * master-in line (not needed for I2C).  Each is accompanied by a
+ * @c _BIT macro giving the pin within the port, e.g.
+ * #BSP430_GPIOSERIAL0_CLK_PORT_BIT.
+ *
+ * @dependency #configBSP430_HAL_GPIOSERIAL0 */
+#define BSP430_GPIOSERIAL0_CLK_PORT_PERIPH_HANDLE include <bsp430/platform.h>
+
+/** The pin of #BSP430_GPIOSERIAL0_CLK_PORT_PERIPH_HANDLE carrying the
+ * clock, e.g. @c BIT0.
+ *
+ * @dependency #configBSP430_HAL_GPIOSERIAL0 */
+#define BSP430_GPIOSERIAL0_CLK_PORT_BIT include <bsp430/platform.h>
+#endif /* BSP430_DOXYGEN */
+
+/** @def BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE
+ *
+ * The handle of a timer that, if provided, paces the clock edges of
+ * #BSP430_PERIPH_GPIOSERIAL0 instead of the software delay loop.  The
+ * timer must be running in continuous mode from a clock synchronous
+ * with MCLK (i.e., SMCLK), so that its counter may be read reliably;
+ * it is only read, never reconfigured, so it may be shared with
+ * other uses.  Leave as #BSP430_PERIPH_NONE to use the delay loop.
+ *
+ * @defaulted
+ * @dependency #configBSP430_HAL_GPIOSERIAL0,
+ * #configBSP430_GPIOSERIAL_USE_TIMER */
+#ifndef BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE
+#define BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE BSP430_PERIPH_NONE
+#endif /* BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE */
+
+/** @def BSP430_GPIOSERIAL1_TIMER_PERIPH_HANDLE
+ *
+ * As with #BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE for
+ * #BSP430_PERIPH_GPIOSERIAL1.
+ *
+ * @defaulted
+ * @dependency #configBSP430_HAL_GPIOSERIAL1 */
+#ifndef BSP430_GPIOSERIAL1_TIMER_PERIPH_HANDLE
+#define BSP430_GPIOSERIAL1_TIMER_PERIPH_HANDLE BSP430_PERIPH_NONE
+#endif /* BSP430_GPIOSERIAL1_TIMER_PERIPH_HANDLE */
+
+/** @cond DOXYGEN_EXCLUDE */
+#if configBSP430_HAL_GPIOSERIAL0 - 0
+/* You don't need to know about this */
+extern sBSP430halSERIAL xBSP430hal_GPIOSERIAL0_;
+#endif /* configBSP430_HAL_GPIOSERIAL0 */
+#if configBSP430_HAL_GPIOSERIAL1 - 0
+extern sBSP430halSERIAL xBSP430hal_GPIOSERIAL1_;
+#endif /* configBSP430_HAL_GPIOSERIAL1 */
+/** @endcond */
+
+/** BSP430 HAL handle for GPIOSERIAL0.
+ *
+ * @dependency #configBSP430_HAL_GPIOSERIAL0 */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HAL_GPIOSERIAL0 - 0)
+#define BSP430_HAL_GPIOSERIAL0 (&xBSP430hal_GPIOSERIAL0_)
+#endif /* configBSP430_HAL_GPIOSERIAL0 */
+
+/** BSP430 HAL handle for GPIOSERIAL1.
+ *
+ * @dependency #configBSP430_HAL_GPIOSERIAL1 */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HAL_GPIOSERIAL1 - 0)
+#define BSP430_HAL_GPIOSERIAL1 (&xBSP430hal_GPIOSERIAL1_)
+#endif /* configBSP430_HAL_GPIOSERIAL1 */
+
+/** GPIO-specific implementation of hBSP430serialOpenUART().  UART
+ * mode is not supported; this always returns a null pointer. */
+hBSP430halSERIAL hBSP430gpioserialOpenUART (hBSP430halSERIAL hal,
+                                            unsigned char ctl0_byte,
+                                            unsigned char ctl1_byte,
+                                            unsigned long baud);
+
+/** GPIO-specific implementation of hBSP430serialOpenUARTDivisor().
+ * UART mode is not supported; this always returns a null pointer. */
+hBSP430halSERIAL hBSP430gpioserialOpenUARTDivisor (hBSP430halSERIAL hal,
+                                                   unsigned char ctl0_byte,
+                                                   unsigned char ctl1_byte,
+                                                   unsigned long divisor_q12);
+
+/** GPIO-specific implementation of hBSP430serialOpenSPI().
+ *
+ * @p ctl0_byte uses the USCI byte layout (#UCCKPH, #UCCKPL, #UCMSB,
+ * #UCMST, #UCMODE_0); see #BSP430_SERIAL_ADJUST_CTL0_INITIALIZER() on
+ * eUSCI MCUs.  #UC7BIT and #UCMODE_3 are rejected.  Master mode is
+ * assumed whether or not #UCMST is present. */
+hBSP430halSERIAL hBSP430gpioserialOpenSPI (hBSP430halSERIAL hal,
+                                           unsigned char ctl0_byte,
+                                           unsigned char ctl1_byte,
+                                           unsigned int prescaler);
+
+/** GPIO-specific implementation of hBSP430serialOpenI2C().  Only the
+ * clock selection in @p ctl1_byte is used. */
+hBSP430halSERIAL hBSP430gpioserialOpenI2C (hBSP430halSERIAL hal,
+                                           unsigned char ctl0_byte,
+                                           unsigned char ctl1_byte,
+                                           unsigned int prescaler);
+
+/** GPIO-specific implementation of iBSP430serialSetHold_ni().  While
+ * held the pins are released to inputs. */
+int iBSP430gpioserialSetHold_ni (hBSP430halSERIAL hal,
+                                 int holdp);
+
+/** GPIO-specific implementation of iBSP430serialClose() */
+int iBSP430gpioserialClose (hBSP430halSERIAL hal);
+
+/** GPIO-specific implementation of vBSP430serialWakeupTransmit_ni().
+ * There is no interrupt-driven transmission, so this does nothing. */
+void vBSP430gpioserialWakeupTransmit_ni (hBSP430halSERIAL hal);
+
+/** GPIO-specific implementation of vBSP430serialFlush_ni().  All
+ * operations are synchronous, so this does nothing. */
+void vBSP430gpioserialFlush_ni (hBSP430halSERIAL hal);
+
+/** GPIO-specific implementation of iBSP430uartRxByte_ni().  Always
+ * returns -1. */
+int iBSP430gpioserialUARTrxByte_ni (hBSP430halSERIAL hal);
+
+/** GPIO-specific implementation of iBSP430uartTxByte_ni().  Always
+ * returns -1. */
+int iBSP430gpioserialUARTtxByte_ni (hBSP430halSERIAL hal, uint8_t c);
+
+/** GPIO-specific implementation of iBSP430uartTxData_ni().  Always
+ * returns -1. */
+int iBSP430gpioserialUARTtxData_ni (hBSP430halSERIAL hal, const uint8_t * data, size_t len);
+
+/** GPIO-specific implementation of iBSP430uartTxASCIIZ_ni().  Always
+ * returns -1. */
+int iBSP430gpioserialUARTtxASCIIZ_ni (hBSP430halSERIAL hal, const char * str);
+
+/** GPIO-specific implementation of iBSP430spiTxRx_ni() */
+int iBSP430gpioserialSPITxRx_ni (hBSP430halSERIAL hal,
+                                 const uint8_t * tx_data,
+                                 size_t tx_len,
+                                 size_t rx_len,
+                                 uint8_t * rx_data);
+
+/** GPIO-specific implementation of iBSP430spiReconfigure_ni() */
+int iBSP430gpioserialSPIReconfigure_ni (hBSP430halSERIAL hal,
+                                        unsigned char ctl0_byte,
+                                        unsigned char ctl1_byte,
+                                        unsigned int prescaler);
+
+/** GPIO-specific implementation of iBSP430i2cSetAddresses_ni().  The
+ * own address is ignored, as slave mode is not supported. */
+int iBSP430gpioserialI2CsetAddresses_ni (hBSP430halSERIAL hal,
+                                         int own_address,
+                                         int slave_address);
+
+/** GPIO-specific implementation of iBSP430i2cRxData_ni() */
+int iBSP430gpioserialI2CrxData_ni (hBSP430halSERIAL hal,
+                                   uint8_t * rx_data,
+                                   size_t rx_len);
+
+/** GPIO-specific implementation of iBSP430i2cTxData_ni() */
+int iBSP430gpioserialI2CtxData_ni (hBSP430halSERIAL hal,
+                                   const uint8_t * tx_data,
+                                   size_t tx_len);
+
+/** GPIO-specific implementation of iBSP430i2cTxRx_ni() */
+int iBSP430gpioserialI2CtxRx_ni (hBSP430halSERIAL hal,
+                                 const uint8_t * tx_data,
+                                 size_t tx_len,
+                                 size_t rx_len,
+                                 uint8_t * rx_data);
+
+/** Get the HAL handle for a GPIO serial instance.
+ *
+ * @param periph #BSP430_PERIPH_GPIOSERIAL0 or
+ * #BSP430_PERIPH_GPIOSERIAL1
+ *
+ * @return the HAL handle, or a null pointer if @p periph is not a
+ * GPIO serial instance or the instance is not enabled. */
+static BSP430_CORE_INLINE
+hBSP430halSERIAL hBSP430gpioserialLookup (tBSP430periphHandle periph)
+{
+#if configBSP430_HAL_GPIOSERIAL0 - 0
+  if (BSP430_PERIPH_GPIOSERIAL0 == periph) {
+    return BSP430_HAL_GPIOSERIAL0;
+  }
+#endif /* configBSP430_HAL_GPIOSERIAL0 */
+#if configBSP430_HAL_GPIOSERIAL1 - 0
+  if (BSP430_PERIPH_GPIOSERIAL1 == periph) {
+    return BSP430_HAL_GPIOSERIAL1;
+  }
+#endif /* configBSP430_HAL_GPIOSERIAL1 */
+  return NULL;
+}
+
+/** Get a human-readable identifier for a GPIO serial instance.
+ *
+ * @return "GPIOSERIAL0" or "GPIOSERIAL1", or a null pointer if @p
+ * periph is not a GPIO serial instance. */
+const char * xBSP430gpioserialName (tBSP430periphHandle periph);
+
+#endif /* BSP430_UTILITY_GPIOSERIAL_H */
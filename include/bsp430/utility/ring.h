@@ -0,0 +1,247 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffers
+ *
+ * A ring buffer passes octets from one producer to one consumer, for
+ * example from an interrupt handler to the main loop, without
+ * disabling interrupts.  The producer is the only writer of the head
+ * index and the consumer the only writer of the tail index; each
+ * publishes its index only after the octets it covers have been
+ * written or read, so either side may be interrupted by the other at
+ * any point.
+ *
+ * Indexes run freely and are masked only to address the buffer, whose
+ * size must be a power of two.  The count of queued octets is their
+ * difference, so the full buffer is usable.  Two variants differ in
+ * the width of their indexes:
+ *
+ * @li #sBSP430ring8 holds up to 128 octets;
+ * @li #sBSP430ring16 holds up to 32768 octets.
+ *
+ * An index is read and written with a single instruction on the
+ * MSP430, so neither requires a critical section.
+ *
+ * The operations below are provided for each variant, with @c W
+ * replaced by @c 8 or @c 16:
+ *
+ * @li hBSP430ringWInitialize() and #BSP430_RING_INITIALIZER prepare a
+ * ring, and vBSP430ringWReset() empties one that neither side is
+ * using;
+ * @li uiBSP430ringWCount() and uiBSP430ringWSpace() may be used by
+ * either side, and are exact for the caller's side (the other side
+ * can only make the caller's view more favorable);
+ * @li the producer uses iBSP430ringWPutOctet(), xBSP430ringWPut() to
+ * copy a block, or xBSP430ringWReserve() and vBSP430ringWCommit() to
+ * write in place;
+ * @li the consumer uses iBSP430ringWGetOctet(),
+ * iBSP430ringWPeekOctet(), xBSP430ringWGet() to copy a block, or
+ * xBSP430ringWPeek() and vBSP430ringWRelease() to read in place.
+ *
+ * Operations for one side may run concurrently with those for the
+ * other, but not with each other: if the main loop and an interrupt
+ * handler both produce, the main loop must disable interrupts while it
+ * does so.  Likewise a producer may discard the oldest octets with
+ * vBSP430ringWRelease(), or take back the newest unread octets with
+ * vBSP430ringWWithdraw(), only while the consumer cannot run.
+ *
+ * The module depends on no hardware, and may be compiled for a host
+ * to test it (see the unittests/ring example).
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_RING_H
+#define BSP430_UTILITY_RING_H
+
+#include <bsp430/core.h>
+
+/** True if @p size_ is a valid size for a ring whose indexes have @p
+ * bits_ bits: a power of two no larger than half the index range. */
+#define BSP430_RING_SIZE_IS_VALID(size_, bits_)                         \
+  ((0 < (size_)) && (0 == ((size_) & ((size_) - 1)))                   \
+   && ((size_) <= (1UL << ((bits_) - 1))))
+
+/** Static initializer for a ring over the array @p buffer_, whose
+ * size must satisfy #BSP430_RING_SIZE_IS_VALID.
+ *
+ * @code
+ * static uint8_t rx_storage[32];
+ * static sBSP430ring8 rx_ring = BSP430_RING_INITIALIZER(rx_storage);
+ * @endcode */
+#define BSP430_RING_INITIALIZER(buffer_) {                              \
+    .buffer = (buffer_),                                                \
+    .mask = sizeof(buffer_) - 1,                                        \
+  }
+
+/** @cond DOXYGEN_EXCLUDE */
+
+/* The variants differ only in the type of their indexes; define the
+ * structure and inline operations for one. */
+#define BSP430_RING_DEFINE_(w_)                                         \
+typedef struct sBSP430ring##w_ {                                        \
+  uint8_t * buffer;                                                     \
+  uint##w_##_t mask;                                                    \
+  volatile uint##w_##_t head;                                           \
+  volatile uint##w_##_t tail;                                           \
+} sBSP430ring##w_;                                                      \
+                                                                        \
+typedef sBSP430ring##w_ * hBSP430ring##w_;                              \
+                                                                        \
+hBSP430ring##w_ hBSP430ring##w_##Initialize (sBSP430ring##w_ * ring,   \
+                                             uint8_t * buffer,          \
+                                             size_t size);              \
+size_t xBSP430ring##w_##Put (hBSP430ring##w_ ring,                      \
+                             const uint8_t * src,                       \
+                             size_t len);                               \
+size_t xBSP430ring##w_##Get (hBSP430ring##w_ ring,                      \
+                             uint8_t * dst,                             \
+                             size_t len);                               \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+unsigned int uiBSP430ring##w_##Count (hBSP430ring##w_ ring)             \
+{                                                                       \
+  return (uint##w_##_t)(ring->head - ring->tail);                       \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+unsigned int uiBSP430ring##w_##Space (hBSP430ring##w_ ring)             \
+{                                                                       \
+  return ring->mask + 1U - uiBSP430ring##w_##Count(ring);               \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+int iBSP430ring##w_##PutOctet (hBSP430ring##w_ ring,                    \
+                               uint8_t c)                               \
+{                                                                       \
+  uint##w_##_t head = ring->head;                                       \
+                                                                        \
+  if ((uint##w_##_t)(head - ring->tail) > ring->mask) {                 \
+    return -1;                                                          \
+  }                                                                     \
+  ring->buffer[head & ring->mask] = c;                                  \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  ring->head = head + 1;                                                \
+  return c;                                                             \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+int iBSP430ring##w_##PeekOctet (hBSP430ring##w_ ring)                   \
+{                                                                       \
+  uint##w_##_t tail = ring->tail;                                       \
+                                                                        \
+  if (ring->head == tail) {                                             \
+    return -1;                                                          \
+  }                                                                     \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  return ring->buffer[tail & ring->mask];                               \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+int iBSP430ring##w_##GetOctet (hBSP430ring##w_ ring)                    \
+{                                                                       \
+  uint##w_##_t tail = ring->tail;                                       \
+  int c;                                                                \
+                                                                        \
+  if (ring->head == tail) {                                             \
+    return -1;                                                          \
+  }                                                                     \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  c = ring->buffer[tail & ring->mask];                                  \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  ring->tail = tail + 1;                                                \
+  return c;                                                             \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+uint8_t * xBSP430ring##w_##Reserve (hBSP430ring##w_ ring,               \
+                                    size_t * lenp)                      \
+{                                                                       \
+  unsigned int offset = ring->head & ring->mask;                        \
+  unsigned int space = uiBSP430ring##w_##Space(ring);                   \
+  unsigned int contig = ring->mask + 1U - offset;                       \
+                                                                        \
+  *lenp = (space < contig) ? space : contig;                            \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  return ring->buffer + offset;                                         \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+void vBSP430ring##w_##Commit (hBSP430ring##w_ ring,                     \
+                              size_t len)                               \
+{                                                                       \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  ring->head += len;                                                    \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+void vBSP430ring##w_##Withdraw (hBSP430ring##w_ ring,                   \
+                                size_t len)                             \
+{                                                                       \
+  ring->head -= len;                                                    \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+const uint8_t * xBSP430ring##w_##Peek (hBSP430ring##w_ ring,            \
+                                       size_t * lenp)                   \
+{                                                                       \
+  unsigned int offset = ring->tail & ring->mask;                        \
+  unsigned int count = uiBSP430ring##w_##Count(ring);                   \
+  unsigned int contig = ring->mask + 1U - offset;                       \
+                                                                        \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  *lenp = (count < contig) ? count : contig;                            \
+  return ring->buffer + offset;                                         \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+void vBSP430ring##w_##Release (hBSP430ring##w_ ring,                    \
+                               size_t len)                              \
+{                                                                       \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  ring->tail += len;                                                    \
+}                                                                       \
+                                                                        \
+static BSP430_CORE_INLINE                                               \
+void vBSP430ring##w_##Reset (hBSP430ring##w_ ring)                      \
+{                                                                       \
+  ring->head = ring->tail = 0;                                          \
+}
+
+/** @endcond */
+
+BSP430_RING_DEFINE_(8)
+BSP430_RING_DEFINE_(16)
+
+#endif /* BSP430_UTILITY_RING_H */
@@ -0,0 +1,393 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Software UART on Timer_A/Timer_B capture/compare blocks.
+ *
+ * This module provides UART devices built from two capture/compare
+ * blocks of a timer rather than a USCI or eUSCI peripheral.  Each
+ * instance is a regular #sBSP430halSERIAL reached through
+ * hBSP430serialLookup() with a pseudo-peripheral handle such as
+ * #BSP430_PERIPH_TIMERUART0, so hBSP430serialOpenUART(),
+ * iBSP430uartTxByte_ni() and the receive and transmit callback chains
+ * work on it unchanged.  In particular the console may use one by
+ * setting #BSP430_CONSOLE_SERIAL_PERIPH_HANDLE to its handle.
+ *
+ * Reception uses a block in capture mode to timestamp the falling
+ * edge of the start bit, then switches it to compare mode to latch
+ * the input (@c SCCI) in the middle of each following bit.
+ * Transmission uses a second block in compare mode, with the output
+ * unit setting or resetting the pin exactly at each bit boundary, so
+ * interrupt latency up to nearly one bit time does not distort the
+ * waveform.  Everything is interrupt driven; no delay loops are used.
+ *
+ * Bit decoding is separated from the hardware in
+ * iBSP430timeruartRxEvent_ni(), which may be fed recorded capture
+ * timestamps to validate reception without a timer (see the
+ * unittests/timeruart example).
+ *
+ * Limitations:
+ * @li Only 8 data bits, no parity, one stop bit are supported;
+ * @li The timer must run in continuous mode.  If it is halted when
+ * the device is opened it is started from SMCLK; otherwise its
+ * existing configuration is used, so it may be shared with other
+ * users such as timer alarms;
+ * @li The baud rate is derived from the timer clock: @p ctl1_byte is
+ * ignored, and the divisor passed to hBSP430serialOpenUARTDivisor()
+ * is in timer ticks per bit;
+ * @li Interrupts must be enabled for reception to work reliably.
+ * The polled iBSP430uartRxByte_ni() will service a pending capture
+ * or compare event, but holding interrupts off for more than half a
+ * bit time loses data.
+ *
+ * @section h_utility_timeruart_opt Module Configuration Options
+ *
+ * @li #configBSP430_HAL_TIMERUART0 to enable the first instance
+ *
+ * @li #BSP430_TIMERUART0_TIMER_PERIPH_HANDLE and related macros
+ * to identify its timer, capture/compare blocks, and pins
+ *
+ * Substitute @b 1 for the second instance.  The HAL and primary ISR
+ * of the timer must be enabled (e.g., #configBSP430_HAL_TA1), along
+ * with its CC0 ISR if block 0 is used.  The port HAL must be enabled
+ * for both pins.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_TIMERUART_H
+#define BSP430_UTILITY_TIMERUART_H
+
+#include <bsp430/serial_.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/periph/port.h>
+
+/** Handle identifying the first timer UART instance.
+ *
+ * This is a pseudo-peripheral handle for use with
+ * hBSP430serialLookup(). */
+#define BSP430_PERIPH_TIMERUART0 ((tBSP430periphHandle)0x4301)
+
+/** Handle identifying the second timer UART instance. */
+#define BSP430_PERIPH_TIMERUART1 ((tBSP430periphHandle)0x4303)
+
+/** @def BSP430_TIMERUART_MIN_BIT_TCK
+ *
+ * The smallest number of timer ticks per bit that an open will
+ * accept.  Each bit requires an interrupt, which must be serviced
+ * well within one bit time.
+ *
+ * @defaulted */
+#ifndef BSP430_TIMERUART_MIN_BIT_TCK
+#define BSP430_TIMERUART_MIN_BIT_TCK 16
+#endif /* BSP430_TIMERUART_MIN_BIT_TCK */
+
+/** Value returned by iBSP430timeruartRxEvent_ni() when the next
+ * event is to be a sample of the line at
+ * sBSP430timeruartRx.sample_tck. */
+#define BSP430_TIMERUART_RX_SAMPLE -1
+
+/** Value returned by iBSP430timeruartRxEvent_ni() when the next
+ * event is to be the falling edge of a start bit.  This is the
+ * result when idle, or when a start bit is rejected as a glitch. */
+#define BSP430_TIMERUART_RX_IDLE -2
+
+/** Value returned by iBSP430timeruartRxEvent_ni() when the stop bit
+ * of a character was low.  The character is discarded, and the next
+ * event is to be the falling edge of a start bit. */
+#define BSP430_TIMERUART_RX_FRAMING -3
+
+/** State of the timer UART receive decoder.
+ *
+ * The decoder is independent of the timer hardware: it consumes
+ * timestamped events and reports what it needs next.  Initialize it
+ * with vBSP430timeruartRxReset(). */
+typedef struct sBSP430timeruartRx {
+  /** Duration of one bit, in timer ticks */
+  unsigned int bit_tck;
+
+  /** Timer counter value at which the line should next be sampled,
+   * valid after iBSP430timeruartRxEvent_ni() returns
+   * #BSP430_TIMERUART_RX_SAMPLE */
+  unsigned int sample_tck;
+
+  /** @cond DOXYGEN_EXCLUDE */
+  /* Zero when awaiting a start edge, else the 1-based index of the
+   * next bit to be sampled (1 = start, 10 = stop) */
+  unsigned char bit_idx;
+  unsigned char shift;
+  /** @endcond */
+} sBSP430timeruartRx;
+
+/** Initialize a receive decoder to await a start bit.
+ *
+ * @param rxp the decoder
+ *
+ * @param bit_tck the duration of one bit, in timer ticks */
+void vBSP430timeruartRxReset (sBSP430timeruartRx * rxp,
+                              unsigned int bit_tck);
+
+/** Advance a receive decoder.
+ *
+ * When the decoder is idle the event should be the capture of a
+ * falling edge, with @p event_tck its timestamp and @p level zero;
+ * events with a non-zero level are ignored.  Otherwise the event
+ * should be a sample of the line taken at the
+ * sBSP430timeruartRx.sample_tck requested by the previous call.
+ *
+ * The start bit is confirmed at its midpoint, and each data bit and
+ * the stop bit are sampled at their midpoints.
+ *
+ * @param rxp the decoder
+ *
+ * @param event_tck the timer counter value at the event
+ *
+ * @param level zero if the line was low at the event, non-zero if it
+ * was high
+ *
+ * @return a received octet (0 through 255) when a stop bit has been
+ * validated; otherwise #BSP430_TIMERUART_RX_SAMPLE,
+ * #BSP430_TIMERUART_RX_IDLE, or #BSP430_TIMERUART_RX_FRAMING. */
+int iBSP430timeruartRxEvent_ni (sBSP430timeruartRx * rxp,
+                                unsigned int event_tck,
+                                int level);
+
+/** State for a timer UART instance.
+ *
+ * This is the object referenced by sBSP430halSERIAL.hpl_aux for a
+ * timer UART HAL.  The first group of fields is fixed by the
+ * configuration; the remainder is managed by the implementation.
+ *
+ * The contents of this structure are private. */
+typedef struct sBSP430timeruartState {
+  /** @cond DOXYGEN_EXCLUDE */
+  struct sBSP430halSERIAL * const hal;
+  const tBSP430periphHandle timer_periph;
+  const unsigned char rx_ccidx;
+  const unsigned char tx_ccidx;
+  const tBSP430periphHandle rx_port;
+  const unsigned char rx_bit;
+  const tBSP430periphHandle tx_port;
+  const unsigned char tx_bit;
+
+  hBSP430halTIMER timer;
+  sBSP430halISRIndexedChainNode rx_cb;
+  sBSP430halISRIndexedChainNode tx_cb;
+  sBSP430timeruartRx rx;
+  /* Bits of the character being transmitted that have not yet been
+   * scheduled, LSB first; zero once the stop bit is scheduled */
+  unsigned int tx_frame;
+  /* Earliest time at which a new start bit may begin */
+  unsigned int tx_idle_tck;
+  /* Octet received while no receive callback is installed */
+  unsigned char rx_held;
+  unsigned char rx_ready;
+  unsigned char tx_busy;
+  unsigned char open;
+  /** @endcond */
+} sBSP430timeruartState;
+
+/** @def configBSP430_HAL_TIMERUART0
+ *
+ * Define to a true value in @c bsp430_config.h to enable the first
+ * timer UART instance.  This defines a serial HAL object that is
+ * returned by hBSP430serialLookup() for #BSP430_PERIPH_TIMERUART0.
+ * Its resources are identified by
+ * #BSP430_TIMERUART0_TIMER_PERIPH_HANDLE and related macros.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HAL_TIMERUART0
+#define configBSP430_HAL_TIMERUART0 0
+#endif /* configBSP430_HAL_TIMERUART0 */
+
+/** @def configBSP430_HAL_TIMERUART1
+ *
+ * As with #configBSP430_HAL_TIMERUART0 for the second instance,
+ * #BSP430_PERIPH_TIMERUART1.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_HAL_TIMERUART1
+#define configBSP430_HAL_TIMERUART1 0
+#endif /* configBSP430_HAL_TIMERUART1 */
+
+#if defined(BSP430_DOXYGEN)
+/** The timer providing #BSP430_PERIPH_TIMERUART0, e.g.
+ * #BSP430_PERIPH_TA1.
+ *
+ * @dependency #configBSP430_HAL_TIMERUART0 */
+#define BSP430_TIMERUART0_TIMER_PERIPH_HANDLE include <bsp430/platform.h>
+
+/** The capture/compare block of
+ * #BSP430_TIMERUART0_TIMER_PERIPH_HANDLE used for reception.  The
+ * receive pin must be the @c CCIxA input of this block.
+ *
+ * A similar macro with @c RX replaced by @c TX identifies the block
+ * used for transmission, whose output drives the transmit pin.
+ *
+ * @dependency #configBSP430_HAL_TIMERUART0 */
+#define BSP430_TIMERUART0_RX_CCIDX include <bsp430/platform.h>
+
+/** The port carrying the receive input of #BSP430_PERIPH_TIMERUART0,
+ * e.g. #BSP430_PERIPH_PORT2.
+ *
+ * Similar macros with @c RX replaced by @c TX identify the transmit
+ * output.  Each is accompanied by a @c _BIT macro giving the pin
+ * within the port, e.g. #BSP430_TIMERUART0_RX_PORT_BIT.  The pins are
+ * switched to their timer function when the device is opened.
+ *
+ * @dependency #configBSP430_HAL_TIMERUART0 */
+#define BSP430_TIMERUART0_RX_PORT_PERIPH_HANDLE include <bsp430/platform.h>
+
+/** The pin of #BSP430_TIMERUART0_RX_PORT_PERIPH_HANDLE carrying the
+ * receive input, e.g. @c BIT1.
+ *
+ * @dependency #configBSP430_HAL_TIMERUART0 */
+#define BSP430_TIMERUART0_RX_PORT_BIT include <bsp430/platform.h>
+#endif /* BSP430_DOXYGEN */
+
+/** @cond DOXYGEN_EXCLUDE */
+#if configBSP430_HAL_TIMERUART0 - 0
+/* You don't need to know about this */
+extern sBSP430halSERIAL xBSP430hal_TIMERUART0_;
+#endif /* configBSP430_HAL_TIMERUART0 */
+#if configBSP430_HAL_TIMERUART1 - 0
+extern sBSP430halSERIAL xBSP430hal_TIMERUART1_;
+#endif /* configBSP430_HAL_TIMERUART1 */
+/** @endcond */
+
+/** BSP430 HAL handle for TIMERUART0.
+ *
+ * @dependency #configBSP430_HAL_TIMERUART0 */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HAL_TIMERUART0 - 0)
+#define BSP430_HAL_TIMERUART0 (&xBSP430hal_TIMERUART0_)
+#endif /* configBSP430_HAL_TIMERUART0 */
+
+/** BSP430 HAL handle for TIMERUART1.
+ *
+ * @dependency #configBSP430_HAL_TIMERUART1 */
+#if defined(BSP430_DOXYGEN) || (configBSP430_HAL_TIMERUART1 - 0)
+#define BSP430_HAL_TIMERUART1 (&xBSP430hal_TIMERUART1_)
+#endif /* configBSP430_HAL_TIMERUART1 */
+
+/** Timer-specific implementation of hBSP430serialOpenUART().
+ *
+ * @p ctl0_byte must be zero (8N1).  @p ctl1_byte is ignored; the bit
+ * time is computed from the frequency of the timer.  Returns a null
+ * pointer if the bit time would be less than
+ * #BSP430_TIMERUART_MIN_BIT_TCK ticks. */
+hBSP430halSERIAL hBSP430timeruartOpenUART (hBSP430halSERIAL hal,
+                                           unsigned char ctl0_byte,
+                                           unsigned char ctl1_byte,
+                                           unsigned long baud);
+
+/** Timer-specific implementation of hBSP430serialOpenUARTDivisor().
+ * @p divisor_q12 is the number of timer ticks per bit, in Q12. */
+hBSP430halSERIAL hBSP430timeruartOpenUARTDivisor (hBSP430halSERIAL hal,
+                                                  unsigned char ctl0_byte,
+                                                  unsigned char ctl1_byte,
+                                                  unsigned long divisor_q12);
+
+/** Timer-specific implementation of hBSP430serialOpenSPI().  SPI
+ * mode is not supported; this always returns a null pointer. */
+hBSP430halSERIAL hBSP430timeruartOpenSPI (hBSP430halSERIAL hal,
+                                          unsigned char ctl0_byte,
+                                          unsigned char ctl1_byte,
+                                          unsigned int prescaler);
+
+/** Timer-specific implementation of hBSP430serialOpenI2C().  I2C
+ * mode is not supported; this always returns a null pointer. */
+hBSP430halSERIAL hBSP430timeruartOpenI2C (hBSP430halSERIAL hal,
+                                          unsigned char ctl0_byte,
+                                          unsigned char ctl1_byte,
+                                          unsigned int prescaler);
+
+/** Timer-specific implementation of iBSP430serialSetHold_ni().  While
+ * held both capture/compare blocks are idle, and the transmit pin
+ * remains at the idle (high) level. */
+int iBSP430timeruartSetHold_ni (hBSP430halSERIAL hal,
+                                int holdp);
+
+/** Timer-specific implementation of iBSP430serialClose().  The timer
+ * itself is left running. */
+int iBSP430timeruartClose (hBSP430halSERIAL hal);
+
+/** Timer-specific implementation of vBSP430serialWakeupTransmit_ni() */
+void vBSP430timeruartWakeupTransmit_ni (hBSP430halSERIAL hal);
+
+/** Timer-specific implementation of vBSP430serialFlush_ni().  Waits
+ * until the stop bit of the last queued character has been sent. */
+void vBSP430timeruartFlush_ni (hBSP430halSERIAL hal);
+
+/** Timer-specific implementation of iBSP430uartRxByte_ni() */
+int iBSP430timeruartUARTrxByte_ni (hBSP430halSERIAL hal);
+
+/** Timer-specific implementation of iBSP430uartTxByte_ni() */
+int iBSP430timeruartUARTtxByte_ni (hBSP430halSERIAL hal, uint8_t c);
+
+/** Timer-specific implementation of iBSP430uartTxData_ni() */
+int iBSP430timeruartUARTtxData_ni (hBSP430halSERIAL hal, const uint8_t * data, size_t len);
+
+/** Timer-specific implementation of iBSP430uartTxASCIIZ_ni() */
+int iBSP430timeruartUARTtxASCIIZ_ni (hBSP430halSERIAL hal, const char * str);
+
+/** Get the HAL handle for a timer UART instance.
+ *
+ * @param periph #BSP430_PERIPH_TIMERUART0 or #BSP430_PERIPH_TIMERUART1
+ *
+ * @return the HAL handle, or a null pointer if @p periph is not a
+ * timer UART instance or the instance is not enabled. */
+static BSP430_CORE_INLINE
+hBSP430halSERIAL hBSP430timeruartLookup (tBSP430periphHandle periph)
+{
+#if configBSP430_HAL_TIMERUART0 - 0
+  if (BSP430_PERIPH_TIMERUART0 == periph) {
+    return BSP430_HAL_TIMERUART0;
+  }
+#endif /* configBSP430_HAL_TIMERUART0 */
+#if configBSP430_HAL_TIMERUART1 - 0
+  if (BSP430_PERIPH_TIMERUART1 == periph) {
+    return BSP430_HAL_TIMERUART1;
+  }
+#endif /* configBSP430_HAL_TIMERUART1 */
+  return NULL;
+}
+
+/** Get a human-readable identifier for a timer UART instance.
+ *
+ * @return "TIMERUART0" or "TIMERUART1", or a null pointer if @p
+ * periph is not a timer UART instance. */
+const char * xBSP430timeruartName (tBSP430periphHandle periph);
+
+#endif /* BSP430_UTILITY_TIMERUART_H */
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+#
+# Decode BSP430_BINLOG() records in a console stream back into text.
+#
+# The format strings are read from the BSP430_BINLOG_SECTION section
+# of the application ELF file.  Console text outside records is
+# copied to the output unchanged.
+#
+# Example:
+#   binlogdecode.py --uptime-hz 32768 app.elf < /dev/ttyACM0
+
+import sys
+import re
+import struct
+import argparse
+
+SLIP_END = 0xC0
+SLIP_ESC = 0xDB
+SLIP_ESC_END = 0xDC
+SLIP_ESC_ESC = 0xDD
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+# Format identifier (16-bit) and timestamp (32-bit)
+HEADER_FORMAT = '<HI'
+HEADER_LENGTH = struct.calcsize(HEADER_FORMAT)
+
+conversion_re = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|L|z|j|t)?([diouxXcspfeEgGaA%])')
+
+
+class Image (object):
+    """The sections of an ELF32 file relevant to decoding."""
+
+    def __init__ (self, path, section_name):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] != b'\x7fELF' or data[4] != 1:
+            raise ValueError('%s: not an ELF32 file' % (path,))
+        (shoff,) = struct.unpack_from('<I', data, 0x20)
+        (shentsize, shnum, shstrndx) = struct.unpack_from('<HHH', data, 0x2E)
+        headers = []
+        for i in range(shnum):
+            headers.append(struct.unpack_from('<IIIIII', data, shoff + i * shentsize))
+        strtab_offset = headers[shstrndx][4]
+
+        def section_name_of (hdr):
+            start = strtab_offset + hdr[0]
+            return data[start:data.index(b'\0', start)].decode('ascii')
+
+        self.formats = {}
+        self.memory = []
+        for hdr in headers:
+            (_, sh_type, sh_flags, sh_addr, sh_offset, sh_size) = hdr
+            if SHT_NOBITS == sh_type:
+                continue
+            contents = data[sh_offset:sh_offset + sh_size]
+            if section_name == section_name_of(hdr):
+                self._addFormats(sh_addr, contents)
+            elif sh_flags & SHF_ALLOC:
+                self.memory.append((sh_addr, contents))
+        if not self.formats:
+            raise ValueError('%s: no format strings in section %s' % (path, section_name))
+
+    def _addFormats (self, base, contents):
+        offset = 0
+        while offset < len(contents):
+            end = contents.index(b'\0', offset)
+            if end > offset:
+                fmt = contents[offset:end].decode('latin-1')
+                # Identifiers are the low 16 bits of the address, or
+                # offsets if the section is not loaded.
+                self.formats[(base + offset) & 0xFFFF] = fmt
+                self.formats[offset & 0xFFFF] = fmt
+            offset = end + 1
+
+    def string (self, address):
+        for (base, contents) in self.memory:
+            if base <= address < base + len(contents):
+                offset = address - base
+                end = contents.find(b'\0', offset)
+                if 0 <= end:
+                    return contents[offset:end].decode('latin-1')
+        return None
+
+
+class Decoder (object):
+
+    def __init__ (self, image, pointer_size, uptime_hz):
+        self.image = image
+        self.pointer_size = pointer_size
+        self.uptime_hz = uptime_hz
+
+    def _argFormat (self, modifier, conversion):
+        if conversion in 'fFeEgGaA':
+            return 'f'
+        if 'p' == conversion or 's' == conversion or modifier in ('z', 't'):
+            code = { 2: 'H', 4: 'I' }[self.pointer_size]
+        elif 'll' == modifier:
+            code = 'q'
+        elif modifier in ('l', 'j'):
+            code = 'i'
+        else:
+            # char and short arguments are promoted to int
+            code = 'h'
+        if conversion in 'ouxXp' or 's' == conversion:
+            code = code.upper()
+        return code
+
+    def format (self, fmt, args):
+        """Expand fmt with the raw argument octets args."""
+        out = []
+        pos = 0
+
+        def take (code):
+            value = struct.unpack_from('<' + code, args, take.offset)[0]
+            take.offset += struct.calcsize(code)
+            return value
+        take.offset = 0
+
+        for m in conversion_re.finditer(fmt):
+            out.append(fmt[pos:m.start()])
+            pos = m.end()
+            (flags, width, precision, modifier, conversion) = m.groups()
+            if '%' == conversion:
+                out.append('%')
+                continue
+            if '*' == width:
+                width = str(take('h'))
+            if '*' == precision:
+                precision = str(take('h'))
+            spec = '%' + flags + (width or '')
+            if precision is not None:
+                spec += '.' + precision
+            value = take(self._argFormat(modifier, conversion))
+            if 's' == conversion:
+                text = self.image.string(value)
+                if text is None:
+                    text = '<0x%x>' % (value,)
+                out.append((spec + 's') % (text,))
+            elif 'p' == conversion:
+                out.append('0x%0*x' % (2 * self.pointer_size, value))
+            elif 'c' == conversion:
+                out.append((spec + 'c') % (chr(value & 0xFF),))
+            elif conversion in 'FaA':
+                out.append((spec + 'e') % (value,))
+            else:
+                out.append((spec + conversion) % (value,))
+        out.append(fmt[pos:])
+        if take.offset != len(args):
+            out.append('<%d octets unused>' % (len(args) - take.offset,))
+        return ''.join(out)
+
+    def record (self, frame):
+        """Return the text for an unescaped frame, or None if it is
+        not a valid record."""
+        if HEADER_LENGTH + 2 > len(frame) or 0 != crc16(frame):
+            return None
+        payload = frame[:-2]
+        (fid, timestamp) = struct.unpack_from(HEADER_FORMAT, payload)
+        fmt = self.image.formats.get(fid)
+        if fmt is None:
+            return None
+        try:
+            text = self.format(fmt, payload[HEADER_LENGTH:])
+        except struct.error:
+            text = '<truncated arguments> ' + fmt
+        if self.uptime_hz:
+            stamp = '[%.6f] ' % (timestamp / float(self.uptime_hz),)
+        else:
+            stamp = '[%u] ' % (timestamp,)
+        return stamp + text
+
+    def run (self, instream, outstream):
+        # Bytes after an END that have not been resolved as a record
+        # or text.  None when outside a candidate frame.
+        pending = None
+        while True:
+            data = instream.read(1)
+            if not data:
+                break
+            octet = data[0]
+            if pending is None:
+                if SLIP_END == octet:
+                    pending = bytearray()
+                else:
+                    outstream.write(data)
+                continue
+            if SLIP_END != octet:
+                pending.append(octet)
+                continue
+            text = self.record(unescape(pending))
+            if text is None:
+                # Not a record: this END opens the next frame
+                outstream.write(bytes(pending))
+                pending = bytearray()
+            else:
+                outstream.write(text.encode('latin-1'))
+                pending = None
+            outstream.flush()
+        if pending:
+            outstream.write(bytes(pending))
+        outstream.flush()
+
+
+def unescape (octets):
+    rv = bytearray()
+    escape = False
+    for octet in octets:
+        if escape:
+            rv.append({ SLIP_ESC_END: SLIP_END, SLIP_ESC_ESC: SLIP_ESC }.get(octet, octet))
+            escape = False
+        elif SLIP_ESC == octet:
+            escape = True
+        else:
+            rv.append(octet)
+    return bytes(rv)
+
+
+def crc16 (octets, crc=0xFFFF):
+    """CRC-16/CCITT as computed by uiBSP430framingCRC16().  A frame
+    with its appended CRC yields zero."""
+    for octet in bytearray(octets):
+        crc ^= octet << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def main ():
+    parser = argparse.ArgumentParser(description='Decode BSP430 binary log records in a console stream.')
+    parser.add_argument('elf', help='the application ELF file')
+    parser.add_argument('input', nargs='?', help='captured console output (default stdin)')
+    parser.add_argument('--section', default='.bsp430_binlog', help='the section holding format strings')
+    parser.add_argument('--pointer-size', type=int, choices=(2, 4), default=2, help='octets in a pointer or size_t')
+    parser.add_argument('--uptime-hz', type=float, default=0, help='uptime clock rate, to show timestamps in seconds')
+    args = parser.parse_args()
+
+    decoder = Decoder(Image(args.elf, args.section), args.pointer_size, args.uptime_hz)
+    if args.input is None:
+        instream = sys.stdin.buffer
+    else:
+        instream = open(args.input, 'rb')
+    decoder.run(instream, sys.stdout.buffer)
+
+
+if __name__ == '__main__':
+    main()
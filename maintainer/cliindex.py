@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+#
+# Generate sorted indexes of utility/cli command chains for
+# iBSP430cliSetCommandIndex().
+#
+# The input is application source that has been through the C
+# preprocessor, so the LAST_COMMAND style of linking commands and any
+# conditional compilation have been resolved.  Each sBSP430cliCommand
+# declared with designated initializers is read; each chain of
+# commands linked through .next is indexed if it is long enough to
+# benefit.  The output is C to be included in the same translation
+# unit, after the command declarations.
+#
+# Example:
+#   msp430-gcc $(CPPFLAGS) -DBSP430_CLI_COMMAND_INDEX_GENERATE=1 -E main.c \
+#     | cliindex.py > cli_index.h
+
+import sys
+import re
+import argparse
+
+declaration_re = re.compile(r'\bsBSP430cliCommand\s+(\w+)\s*=\s*\{')
+field_re = re.compile(r'\.(\w+)\s*=\s*')
+string_re = re.compile(r'"((?:[^"\\]|\\.)*)"')
+address_re = re.compile(r'^[\s(]*&[\s(]*(\w+)[\s)]*$')
+
+
+class Command (object):
+
+    def __init__ (self, name, fields):
+        self.name = name
+        self.key = None
+        if 'key' in fields:
+            parts = string_re.findall(fields['key'])
+            if parts:
+                self.key = bytes(''.join(parts), 'latin-1').decode('unicode_escape').encode('latin-1')
+        self.next = self._target(fields.get('next'))
+
+    @staticmethod
+    def _target (expr):
+        """The name of the command whose address is expr, or None for
+        a null pointer."""
+        if expr is None:
+            return None
+        m = address_re.match(expr)
+        if m is None:
+            return None
+        return m.group(1)
+
+
+def initializer_end (text, pos):
+    """The position of the brace closing the initializer whose body
+    starts at pos, skipping string and character literals."""
+    depth = 1
+    while depth:
+        c = text[pos]
+        if c in '"\'':
+            pos += 1
+            while text[pos] != c:
+                pos += 2 if '\\' == text[pos] else 1
+        elif '{' == c:
+            depth += 1
+        elif '}' == c:
+            depth -= 1
+        pos += 1
+    return pos - 1
+
+
+def split_fields (body):
+    """Map each designated field in an initializer body to the text of
+    its value."""
+    fields = {}
+    # Find designators outside string literals, which are blanked
+    # without moving anything
+    masked = string_re.sub(lambda m: '"' + ' ' * len(m.group(1)) + '"', body)
+    matches = list(field_re.finditer(masked))
+    for (i, m) in enumerate(matches):
+        end = matches[i + 1].start() if i + 1 < len(matches) else len(body)
+        fields[m.group(1)] = body[m.end():end].strip().rstrip(',').strip()
+    return fields
+
+
+def read_commands (text):
+    # Drop preprocessor line markers
+    text = re.sub(r'(?m)^#.*$', '', text)
+    commands = {}
+    for m in declaration_re.finditer(text):
+        end = initializer_end(text, m.end())
+        cmd = Command(m.group(1), split_fields(text[m.end():end]))
+        if cmd.key is None:
+            raise ValueError('%s: no .key initializer' % (cmd.name,))
+        commands[cmd.name] = cmd
+    return commands
+
+
+def chains (commands):
+    """The chains of commands, each as a list in link order, keyed by
+    the name of its first command.  A chain begins at any command that
+    is not the successor of another."""
+    successors = set(c.next for c in commands.values() if c.next is not None)
+    rv = {}
+    for name in sorted(commands):
+        if name in successors:
+            continue
+        chain = []
+        while name is not None:
+            if name not in commands:
+                raise ValueError('%s: linked but not declared' % (name,))
+            if name in chain:
+                raise ValueError('%s: chain is circular' % (name,))
+            chain.append(name)
+            name = commands[name].next
+        rv[chain[0]] = chain
+    return rv
+
+
+def generate (commands, min_commands, index_name, source):
+    out = []
+    out.append('/* Generated by maintainer/cliindex.py from %s; do not edit.' % (source,))
+    out.append(' *')
+    out.append(' * Sorted indexes of the utility/cli command chains, for')
+    out.append(' * iBSP430cliSetCommandIndex(). */')
+    entries = []
+    for (head, chain) in sorted(chains(commands).items()):
+        if len(chain) < min_commands:
+            continue
+        ordered = sorted(chain, key=lambda n: commands[n].key)
+        for (a, b) in zip(ordered, ordered[1:]):
+            if commands[a].key == commands[b].key:
+                raise ValueError('%s, %s: duplicate key "%s"' % (a, b, commands[a].key.decode('latin-1')))
+        array = '%s_%s' % (index_name, head)
+        out.append('')
+        out.append('static const sBSP430cliCommand * const %s[] = {' % (array,))
+        for name in ordered:
+            out.append('  &%s,' % (name,))
+        out.append('};')
+        entries.append((head, array))
+    if not entries:
+        raise ValueError('no command chain has at least %d commands' % (min_commands,))
+    out.append('')
+    out.append('static const sBSP430cliCommandIndex %s[] = {' % (index_name,))
+    for (head, array) in entries:
+        out.append('  { .command_set = &%s,' % (head,))
+        out.append('    .sorted = %s,' % (array,))
+        out.append('    .count = sizeof(%s) / sizeof(*%s) },' % (array, array))
+    out.append('};')
+    return '\n'.join(out) + '\n'
+
+
+def main ():
+    parser = argparse.ArgumentParser(description='Generate sorted indexes of BSP430 CLI command chains.')
+    parser.add_argument('input', nargs='?', help='preprocessed application source (default stdin)')
+    parser.add_argument('--name', default='cli_index', help='the name of the generated index array')
+    parser.add_argument('--min-commands', type=int, default=8, help='the shortest chain to index')
+    args = parser.parse_args()
+
+    if args.input is None:
+        text = sys.stdin.read()
+        # The preprocessor names the main file in its first line marker
+        m = re.search(r'(?m)^#\s*\d*\s*"([^"<]+)"', text)
+        source = m.group(1) if m else 'standard input'
+    else:
+        with open(args.input) as f:
+            text = f.read()
+        source = args.input
+    try:
+        sys.stdout.write(generate(read_commands(text), args.min_commands, args.name, source))
+    except ValueError as e:
+        sys.stderr.write('cliindex: %s\n' % (e,))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,193 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/periph/dma.h>
+
+#if BSP430_MODULE_DMA - 0
+
+/* !BSP430! periph=dma */
+/* !BSP430! instance=DMA */
+
+#define CHANNEL_IS_VALID(_ch) ((0 <= (_ch)) && (BSP430_DMA_CHANNEL_COUNT > (_ch)))
+
+#if configBSP430_HAL_DMA - 0
+
+static const sBSP430halISRIndexedChainNode * ch_callback_DMA[BSP430_DMA_CHANNEL_COUNT];
+
+sBSP430halDMA xBSP430hal_DMA_ = {
+  .hal_state = {
+    .cflags = BSP430_DMA_HAL_HPL_VARIANT_DMA
+#if configBSP430_HAL_DMA_ISR - 0
+    | BSP430_PERIPH_HAL_STATE_CFLAGS_ISR
+#endif /* configBSP430_HAL_DMA_ISR */
+  },
+  .hpl = BSP430_HPL_DMA,
+  .ch_cbchain_ni = ch_callback_DMA
+};
+#endif /* configBSP430_HAL_DMA */
+
+int
+iBSP430dmaChannelAllocate_ni (hBSP430halDMA hal,
+                              int channel)
+{
+  if (0 > channel) {
+    for (channel = 0; channel < BSP430_DMA_CHANNEL_COUNT; ++channel) {
+      if (! (hal->allocated_ni & (1 << channel))) {
+        break;
+      }
+    }
+  }
+  if ((! CHANNEL_IS_VALID(channel))
+      || (hal->allocated_ni & (1 << channel))) {
+    return -1;
+  }
+  hal->allocated_ni |= (1 << channel);
+  return channel;
+}
+
+int
+iBSP430dmaChannelRelease_ni (hBSP430halDMA hal,
+                             int channel)
+{
+  if ((! CHANNEL_IS_VALID(channel))
+      || (! (hal->allocated_ni & (1 << channel)))) {
+    return -1;
+  }
+  hal->hpl->ch[channel].ctl = 0;
+  (void)iBSP430dmaChannelSetTrigger_ni(hal, channel, BSP430_DMA_TSEL_DMAREQ);
+  hal->allocated_ni &= ~(1 << channel);
+  return 0;
+}
+
+int
+iBSP430dmaChannelSetTrigger_ni (hBSP430halDMA hal,
+                                int channel,
+                                unsigned int tsel)
+{
+  volatile unsigned int * ctlp;
+  int shift;
+
+  if (! CHANNEL_IS_VALID(channel)) {
+    return -1;
+  }
+  /* Each DMACTLx register holds the trigger selects for two channels,
+   * the even channel in the low byte.  The module is documented for
+   * word access only, so update the field in place. */
+  ctlp = hal->hpl->ctl + (channel / 2);
+  shift = (channel & 1) ? 8 : 0;
+  *ctlp = (*ctlp & ~(BSP430_DMA_TSEL_MASK << shift)) | ((tsel & BSP430_DMA_TSEL_MASK) << shift);
+  return 0;
+}
+
+int
+iBSP430dmaChannelConfigure_ni (hBSP430halDMA hal,
+                               int channel,
+                               unsigned int tsel,
+                               unsigned int ctl,
+                               const volatile void * src,
+                               volatile void * dst,
+                               unsigned int size)
+{
+  volatile sBSP430hplDMAChannel * chp;
+
+  if (! CHANNEL_IS_VALID(channel)) {
+    return -1;
+  }
+  chp = hal->hpl->ch + channel;
+  /* Address registers are written with the channel disabled so the
+   * new values are latched when it is enabled.  A word write to
+   * DMAxSA/DMAxDA clears bits 19-16, so the unsigned long store is
+   * correct for 16-bit pointers regardless of the order in which the
+   * compiler writes the halves. */
+  chp->ctl = 0;
+  (void)iBSP430dmaChannelSetTrigger_ni(hal, channel, tsel);
+  chp->sa = (uintptr_t)src;
+  chp->da = (uintptr_t)dst;
+  chp->sz = size;
+  chp->ctl = ctl & ~(DMAEN | DMAREQ | DMAIFG | DMAABORT);
+  return 0;
+}
+
+#if configBSP430_HAL_DMA_ISR - 0
+static int
+#if (20120406 < __MSPGCC__) && (__MSP430X__ - 0)
+__attribute__ ( ( __c16__ ) )
+#endif /* CPUX */
+/* __attribute__((__always_inline__)) */
+dma_isr (hBSP430halDMA hal)
+{
+  int iv = hal->hpl->iv;
+  int rv = 0;
+
+  /* DMAIV is 2*(channel+1).  Reading it clears the flag for the
+   * highest-priority pending channel; any others will re-enter the
+   * ISR. */
+  if (0 != iv) {
+    int ch = (iv / 2) - 1;
+    rv = iBSP430callbackInvokeISRIndexed_ni(ch + hal->ch_cbchain_ni, hal, ch, rv);
+  }
+  return rv;
+}
+#endif /* configBSP430_HAL_DMA_ISR */
+
+/* !BSP430! insert=hal_isr_defn */
+/* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hal_isr_defn] */
+#if configBSP430_HAL_DMA_ISR - 0
+static void
+__attribute__((__interrupt__(DMA_VECTOR)))
+isr_DMA (void)
+{
+  int rv = dma_isr(BSP430_HAL_DMA);
+  BSP430_HAL_ISR_CALLBACK_TAIL_NI(rv);
+}
+#endif /* configBSP430_HAL_DMA_ISR */
+
+/* END AUTOMATICALLY GENERATED CODE [hal_isr_defn] */
+/* !BSP430! end=hal_isr_defn */
+
+const char *
+xBSP430dmaName (tBSP430periphHandle periph)
+{
+  /* !BSP430! insert=periph_name_demux */
+  /* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [periph_name_demux] */
+#if configBSP430_HPL_DMA - 0
+  if (BSP430_PERIPH_DMA == periph) {
+    return "DMA";
+  }
+#endif /* configBSP430_HPL_DMA */
+
+  /* END AUTOMATICALLY GENERATED CODE [periph_name_demux] */
+  /* !BSP430! end=periph_name_demux */
+  return NULL;
+}
+
+#endif /* BSP430_MODULE_DMA */
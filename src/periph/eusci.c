@@ -123,6 +123,7 @@ eusciConfigure (hBSP430halSERIAL hal,
 
     /* Reset device statistics */
     hal->num_rx = hal->num_tx = 0;
+    BSP430_SERIAL_RESET_ERRORS_NI(hal);
 
     /* Attempt to release the device for use; if that failed, reset it
      * and return an error */
@@ -143,13 +144,7 @@ hBSP430eusciOpenUART (hBSP430halSERIAL hal,
                       unsigned long baud)
 {
   unsigned long brclk_Hz;
-  unsigned long n;
-  unsigned int ctlw0;
-  unsigned int brw;
-  unsigned int mctlw;
-  unsigned int os16 = 0;
-  unsigned int brf = 0;
-  unsigned int brs;
+  unsigned int ssel;
 
   /* Reject unsupported HALs */
   if ((NULL == hal)
@@ -162,41 +157,54 @@ hBSP430eusciOpenUART (hBSP430halSERIAL hal,
     return NULL;
   }
 
-  /* Force to UART async and wipe out the clock select fields */
-  ctlw0 = (ctl0_byte << 8) | ctl1_byte;
-  ctlw0 &= ~(UCMODE1 | UCMODE0 | UCSYNC | UCSSEL1 | UCSSEL0);
+  /* Wipe out the clock select fields */
+  ctl1_byte &= ~(UCSSEL1 | UCSSEL0);
 
   /* Assume ACLK <= 20 kHz is VLOCLK and cannot be trusted.  Prefer
    * 32 KiHz ACLK for rates that are low enough.  Use SMCLK for
    * anything larger.  */
   brclk_Hz = uiBSP430clockACLK_Hz_ni();
   if ((brclk_Hz > 20000) && (brclk_Hz >= (3 * baud))) {
-    ctlw0 |= UCSSEL__ACLK;
+    ssel = UCSSEL__ACLK;
   } else {
-    ctlw0 |= UCSSEL__SMCLK;
+    ssel = UCSSEL__SMCLK;
     brclk_Hz = ulBSP430clockSMCLK_Hz_ni();
   }
 
-#define BR_FRACTION_SHIFT 6
-  /* The value for BRS is supposed to be a table lookup based on the
-   * fractional part of f_brclk / baud.  Rather than replicate the
-   * table, we simply preserve BR_FRACTION_SHIFT bits of the
-   * fraction, then use that as the upper bits of the value of
-   * BRS.  Seems to work, at least for 9600 baud. */
-  n = (brclk_Hz << BR_FRACTION_SHIFT) / baud;
-  brs = n & ((1 << BR_FRACTION_SHIFT) - 1);
-  n >>= BR_FRACTION_SHIFT;
-  brs <<= 8 - BR_FRACTION_SHIFT;
-#undef BR_FRACTION_SHIFT
-  brw = n;
-  if (16 <= brw) {
-    brw = brw / 16;
-    os16 = UCOS16;
-    brf = n - 16 * brw;
+  /* Reject rates too slow for the clock.  With oversampling UCBRW
+   * holds the divisor over 16, so rates down to 1/2^20 of the clock
+   * are attainable (e.g. 300 baud from 24 MHz SMCLK, UCBRW = 5000). */
+  if ((brclk_Hz >> 20) >= baud) {
+    return NULL;
   }
-  mctlw = (brf * UCBRF0) | (brs * UCBRS0) | os16;
 
-  return eusciConfigure(hal, ctlw0, 0, brw, mctlw, 1);
+  return hBSP430eusciOpenUARTDivisor(hal, ctl0_byte, ctl1_byte | ssel, BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz, baud));
+}
+
+hBSP430halSERIAL
+hBSP430eusciOpenUARTDivisor (hBSP430halSERIAL hal,
+                             unsigned char ctl0_byte,
+                             unsigned char ctl1_byte,
+                             unsigned long divisor_q12)
+{
+  unsigned int ctlw0;
+
+  /* Reject unsupported HALs */
+  if ((NULL == hal)
+      || (! BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIA(hal))) {
+    return NULL;
+  }
+
+  /* Reject divisors that would leave the baud rate generator stopped */
+  if (0 == BSP430_EUSCI_UART_BRW(divisor_q12)) {
+    return NULL;
+  }
+
+  /* Force to UART async; the clock select is used as given */
+  ctlw0 = (ctl0_byte << 8) | ctl1_byte;
+  ctlw0 &= ~(UCMODE1 | UCMODE0 | UCSYNC);
+
+  return eusciConfigure(hal, ctlw0, 0, BSP430_EUSCI_UART_BRW(divisor_q12), BSP430_EUSCI_UART_MCTLW(divisor_q12), 1);
 }
 
 hBSP430halSERIAL
@@ -229,6 +237,46 @@ hBSP430eusciOpenSPI (hBSP430halSERIAL hal,
   return eusciConfigure(hal, ctlw0, 0, prescaler, 0, 0);
 }
 
+int
+iBSP430eusciSPIReconfigure_ni (hBSP430halSERIAL hal,
+                               unsigned char ctl0_byte,
+                               unsigned char ctl1_byte,
+                               unsigned int prescaler)
+{
+  unsigned int ctlw0;
+
+  /* Reject invalid prescaler */
+  if (0 == prescaler) {
+    return -1;
+  }
+
+  /* SPI is synchronous; a change of mode would require a change of
+   * pin configuration, which is what this routine avoids. */
+  ctlw0 = ((ctl0_byte << 8) | ctl1_byte | UCSYNC) & ~UCSWRST;
+  if (peripheralConfigFlag(ctlw0) != peripheralConfigFlag(HAL_HPL_FIELD(hal, ctlw0))) {
+    return -1;
+  }
+
+  /* Nothing to do if the device already has this configuration */
+  if ((ctlw0 == (HAL_HPL_FIELD(hal, ctlw0) & ~UCSWRST))
+      && (prescaler == HAL_HPL_FIELD(hal, brw))) {
+    return 0;
+  }
+
+  /* Write only the registers that changed while the module is in
+   * reset, then release it. */
+  SERIAL_HAL_FLUSH_NI(hal);
+  SERIAL_HAL_HOLD_NI(hal);
+  if (ctlw0 != (HAL_HPL_FIELD(hal, ctlw0) & ~UCSWRST)) {
+    HAL_HPL_FIELD(hal, ctlw0) = ctlw0 | UCSWRST;
+  }
+  if (prescaler != HAL_HPL_FIELD(hal, brw)) {
+    HAL_HPL_FIELD(hal, brw) = prescaler;
+  }
+  SERIAL_HAL_RELEASE_NI(hal);
+  return 0;
+}
+
 hBSP430halSERIAL
 hBSP430eusciOpenI2C (hBSP430halSERIAL hal,
                      unsigned char ctl0_byte,
@@ -314,6 +362,7 @@ iBSP430eusciUARTrxByte_ni (hBSP430halSERIAL hal)
     return -1;
   }
   if (SERIAL_HAL_HPL_A(hal)->ifg & UCRXIFG) {
+    BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal, 1, SERIAL_HAL_HPL_A(hal)->statw);
     ++hal->num_rx;
     return SERIAL_HAL_HPL_A(hal)->rxbuf;
   }
@@ -361,6 +410,56 @@ iBSP430eusciUARTtxASCIIZ_ni (hBSP430halSERIAL hal, const char * str)
   return str - in_string;
 }
 
+#if ((configBSP430_SERIAL_SPI_USE_DMA - 0)                \
+     || (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)         \
+     || (configBSP430_SERIAL_UART_RX_USE_DMA - 0))
+/* Identify the DMA trigger for the receive interrupt flag of the
+ * peripheral, or -1 if it has none. */
+static int
+dmaRxTrigger (hBSP430halSERIAL hal)
+{
+#if configBSP430_HPL_EUSCI_A0 - 0
+  if (BSP430_HPL_EUSCI_A0 == SERIAL_HAL_HPL_A(hal)) {
+    return BSP430_EUSCI_A0_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_EUSCI_A0 */
+#if configBSP430_HPL_EUSCI_A1 - 0
+  if (BSP430_HPL_EUSCI_A1 == SERIAL_HAL_HPL_A(hal)) {
+    return BSP430_EUSCI_A1_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_EUSCI_A1 */
+#if configBSP430_HPL_EUSCI_B0 - 0
+  if (BSP430_HPL_EUSCI_B0 == SERIAL_HAL_HPL_B(hal)) {
+    return BSP430_EUSCI_B0_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_EUSCI_B0 */
+  return -1;
+}
+#if (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+/* Identify the DMA receive trigger and the buffer registers of the
+ * peripheral.  The transmit trigger immediately follows the receive
+ * trigger. */
+static int
+dmaTarget_ni (hBSP430halSERIAL hal,
+              const volatile void ** rxbufpp,
+              volatile void ** txbufpp)
+{
+  int tsel = dmaRxTrigger(hal);
+
+  if (0 > tsel) {
+    return -1;
+  }
+  if (rxbufpp) {
+    *rxbufpp = &HAL_HPL_FIELD(hal, rxbuf);
+  }
+  if (txbufpp) {
+    *txbufpp = &HAL_HPL_FIELD(hal, txbuf);
+  }
+  return tsel;
+}
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA || configBSP430_SERIAL_UART_RX_USE_DMA */
+#endif /* SPI_USE_DMA || TX_BLOCK_USE_DMA || UART_RX_USE_DMA */
+
 int
 iBSP430eusciSPITxRx_ni (hBSP430halSERIAL hal,
                         const uint8_t * tx_data,
@@ -378,6 +477,16 @@ iBSP430eusciSPITxRx_ni (hBSP430halSERIAL hal,
   if (hal->tx_cbchain_ni) {
     return -1;
   }
+#if configBSP430_SERIAL_SPI_USE_DMA - 0
+  {
+    int rv = iBSP430serialSPITxRxDMA_ni(hal, dmaRxTrigger(hal),
+                                        rxbp, txbp,
+                                        tx_data, tx_len, rx_len, rx_data);
+    if (0 <= rv) {
+      return rv;
+    }
+  }
+#endif /* configBSP430_SERIAL_SPI_USE_DMA */
   while (i < transaction_length) {
     uint8_t rx_dummy;
 
@@ -404,11 +513,24 @@ iBSP430eusciI2CsetAddresses_ni (hBSP430halSERIAL hal,
                                 int own_address,
                                 int slave_address)
 {
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+
   if (0 <= own_address) {
-    SERIAL_HAL_HPL_B(hal)->i2coa0 = own_address;
+    /* The own address may only be changed while the peripheral is
+     * in reset, which also clears the interrupt enables.  Unlike
+     * USCI5 the address is ignored unless UCOAEN is set. */
+    unsigned int ie = hpl->ie;
+    unsigned int in_reset = hpl->ctlw0 & UCSWRST;
+
+    hpl->ctlw0 |= UCSWRST;
+    hpl->i2coa0 = UCOAEN | own_address;
+    if (! in_reset) {
+      hpl->ctlw0 &= ~UCSWRST;
+      hpl->ie = ie;
+    }
   }
   if (0 <= slave_address) {
-    SERIAL_HAL_HPL_B(hal)->i2csa = slave_address;
+    hpl->i2csa = slave_address;
   }
   return 0;
 }
@@ -498,6 +620,192 @@ iBSP430eusciI2CtxData_ni (hBSP430halSERIAL hal,
   return i;
 }
 
+/* Perform a write followed by a repeated-start read with the device
+ * configured for software stop generation.  The stop must be
+ * requested while the last octet is being received, which for a
+ * single-octet read means as soon as the slave has acknowledged its
+ * address. */
+static int
+eusciI2CtxRxManualStop_ni (hBSP430halSERIAL hal,
+                           const uint8_t * tx_data,
+                           size_t tx_len,
+                           size_t rx_len,
+                           uint8_t * rx_data)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+  uint8_t * dp = rx_data;
+  const uint8_t * dpe = rx_data + rx_len;
+  int i = 0;
+
+  /* Issue a start for transmit */
+  hpl->ctlw0 |= UCTR | UCTXSTT;
+  while (i < tx_len) {
+    do {
+      if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+        return -1;
+      }
+    } while (! (hpl->ifg & UCTXIFG));
+    ++hal->num_tx;
+    hpl->txbuf = tx_data[i];
+    ++i;
+  }
+  /* Wait for the last octet to move to the shift register, then
+   * issue a repeated start for receive */
+  do {
+    if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (! (hpl->ifg & UCTXIFG));
+  hpl->ctlw0 &= ~UCTR;
+  hpl->ctlw0 |= UCTXSTT;
+  while (dp < dpe) {
+    if (dpe == (dp+1)) {
+      /* This will be last character: wait for any in-progress start
+       * to complete then issue stop */
+      do {
+        if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+          return -1;
+        }
+      } while (hpl->ctlw0 & UCTXSTT);
+      hpl->ctlw0 |= UCTXSTP;
+    }
+    do {
+      if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+        return -1;
+      }
+    } while (! (hpl->ifg & UCRXIFG));
+    ++hal->num_rx;
+    *dp++ = hpl->rxbuf;
+  }
+  return i + (dp - rx_data);
+}
+
+int
+iBSP430eusciI2CtxRx_ni (hBSP430halSERIAL hal,
+                        const uint8_t * tx_data,
+                        size_t tx_len,
+                        size_t rx_len,
+                        uint8_t * rx_data)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+  unsigned int ctlw1;
+  unsigned int ie;
+  int rc;
+
+  if (0 == rx_len) {
+    return iBSP430eusciI2CtxData_ni(hal, tx_data, tx_len);
+  }
+  if (0 == tx_len) {
+    return iBSP430eusciI2CrxData_ni(hal, rx_data, rx_len);
+  }
+
+  /* Check for errors while waiting for previous activity to
+   * complete */
+  do {
+    if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (hpl->statw & UCBBUSY);
+
+  /* Automatic stop generation would end the write phase with a stop
+   * rather than allowing a repeated start.  UCASTPx can only be
+   * changed while the device is in reset, which also clears the
+   * interrupt enables. */
+  ctlw1 = hpl->ctlw1;
+  ie = hpl->ie;
+  hpl->ctlw0 |= UCSWRST;
+  hpl->ctlw1 = ctlw1 & ~UCASTP_3;
+  hpl->ctlw0 &= ~UCSWRST;
+
+  rc = eusciI2CtxRxManualStop_ni(hal, tx_data, tx_len, rx_len, rx_data);
+  if ((0 > rc) && (hpl->ifg & UCNACKIFG)) {
+    hpl->ctlw0 |= UCTXSTP;
+  }
+
+  /* Let the stop complete before restoring the configuration */
+  while (hpl->ctlw0 & UCTXSTP) {
+    ;
+  }
+  hpl->ctlw0 |= UCSWRST;
+  hpl->ctlw1 = ctlw1;
+  hpl->ctlw0 &= ~UCSWRST;
+  hpl->ie = ie;
+  return rc;
+}
+
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+/* The device is configured for automatic stop generation when the
+ * byte counter is reached (UCASTP_2), so each phase of a queued
+ * transaction is a complete bus transaction whose end is signalled by
+ * UCSTPIFG. */
+static void
+eusciI2CqueueStartPhase_ni (volatile struct sBSP430hplEUSCIB * hpl,
+                            int transmitp,
+                            size_t len)
+{
+  hpl->tbcnt = len;
+  if (transmitp) {
+    hpl->ctlw0 |= UCTR | UCTXSTT;
+    hpl->ie |= UCTXIE;
+  } else {
+    hpl->ctlw0 &= ~UCTR;
+    hpl->ctlw0 |= UCTXSTT;
+    hpl->ie |= UCRXIE;
+  }
+}
+
+int
+iBSP430eusciI2CqueueStart_ni (hBSP430halSERIAL hal,
+                              hBSP430i2cTransaction txn)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+
+  if (0 <= txn->slave_address) {
+    hpl->i2csa = txn->slave_address;
+  }
+  hpl->ifg &= ~(UCNACKIFG | UCALIFG | UCSTPIFG);
+  hpl->ie |= UCNACKIE | UCALIE | UCSTPIE;
+  if (0 < txn->tx_len) {
+    eusciI2CqueueStartPhase_ni(hpl, 1, txn->tx_len);
+  } else {
+    eusciI2CqueueStartPhase_ni(hpl, 0, txn->rx_len);
+  }
+  return 0;
+}
+
+void
+vBSP430eusciI2CqueueAbort_ni (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+
+  /* Resetting the peripheral releases the bus and clears the
+   * interrupt enables; the configuration is retained. */
+  hpl->ctlw0 |= UCSWRST;
+  hpl->ctlw0 &= ~UCSWRST;
+}
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+int
+iBSP430eusciI2CslaveEnable_ni (hBSP430halSERIAL hal,
+                               int enablep)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+  const unsigned int slave_ie = UCSTTIE | UCSTPIE | UCRXIE | UCTXIE;
+
+  if (enablep) {
+    if (hpl->ctlw0 & UCMST) {
+      return -1;
+    }
+    hpl->ifg &= ~(UCSTTIFG | UCSTPIFG);
+    hpl->ie |= slave_ie;
+  } else {
+    hpl->ie &= ~slave_ie;
+  }
+  return 0;
+}
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
 /* Since the interrupt code is the same for all peripherals, on MCUs
  * with multiple USCI devices it is more space efficient to share it.
  * This does add an extra call/return for some minor cost in stack
@@ -522,7 +830,7 @@ __attribute__ ( ( __c16__ ) )
 /* __attribute__((__always_inline__)) */
 euscia_isr (hBSP430halSERIAL hal)
 {
-  int did_tx;
+  int c;
   int rv = 0;
 
   switch (SERIAL_HAL_HPL_A(hal)->iv) {
@@ -530,16 +838,10 @@ euscia_isr (hBSP430halSERIAL hal)
     case USCI_NONE:
       break;
     case USCI_UART_UCTXIFG: /* == USCI_SPI_UCTXIFG */
-      rv = iBSP430callbackInvokeISRVoid_ni(&hal->tx_cbchain_ni, hal, 0);
-      did_tx = 0;
-      if (rv & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN) {
+      c = iBSP430serialTxISRNextOctet_ni(hal, &rv);
+      if (0 <= c) {
         /* Found some data; send it out */
-        ++hal->num_tx;
-        did_tx = 1;
-        SERIAL_HAL_HPL_A(hal)->txbuf = hal->tx_byte;
-      } else {
-        /* No data; mark transmission disabled */
-        rv |= BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+        SERIAL_HAL_HPL_A(hal)->txbuf = c;
       }
       /* If no more is expected, clear the interrupt so we don't wake
        * again.  Further, if we didn't transmit anything mark that the
@@ -547,12 +849,13 @@ euscia_isr (hBSP430halSERIAL hal)
        * fire. */
       if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
         SERIAL_HAL_HPL_A(hal)->ie &= ~UCTXIE;
-        if (! did_tx) {
+        if (0 > c) {
           SERIAL_HAL_HPL_A(hal)->ifg |= UCTXIFG;
         }
       }
       break;
     case USCI_UART_UCRXIFG: /* == USCI_SPI_UCRXIFG */
+      BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal, ! (SERIAL_HAL_HPL_A(hal)->ctlw0 & UCSYNC), SERIAL_HAL_HPL_A(hal)->statw);
       hal->rx_byte = SERIAL_HAL_HPL_A(hal)->rxbuf;
       ++hal->num_rx;
       rv = iBSP430callbackInvokeISRVoid_ni(&hal->rx_cbchain_ni, hal, 0);
@@ -562,10 +865,157 @@ euscia_isr (hBSP430halSERIAL hal)
 }
 #endif /* EUSCIA ISR */
 
+#if ((configBSP430_HAL_EUSCI_B0_ISR - 0)        \
+     || (configBSP430_HAL_EUSCI_B1_ISR - 0)     \
+     || (configBSP430_HAL_EUSCI_B2_ISR - 0))
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+/* Advance the transaction at the head of the attached I2C queue.
+ * Interrupt vector values differ from those of SPI mode. */
+static int
+euscib_i2c_isr (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+  sBSP430i2cQueue * queue = hal->i2c_queue_ni;
+  hBSP430i2cTransaction txn = queue->head_ni;
+  int rv = 0;
+
+  switch (hpl->iv) {
+    default:
+    case USCI_NONE:
+      break;
+    case USCI_I2C_UCALIFG:
+      /* Losing arbitration drops the peripheral into slave mode */
+      hpl->ie &= ~(UCTXIE | UCRXIE | UCNACKIE | UCALIE | UCSTPIE);
+      hpl->ctlw0 |= UCMST;
+      rv = iBSP430i2cQueueComplete_ni(hal, BSP430_I2C_RESULT_ARBITRATION_LOST);
+      break;
+    case USCI_I2C_UCNACKIFG:
+      hpl->ie &= ~(UCTXIE | UCRXIE | UCNACKIE | UCALIE | UCSTPIE);
+      hpl->ctlw0 |= UCTXSTP;
+      rv = iBSP430i2cQueueComplete_ni(hal, BSP430_I2C_RESULT_NACK);
+      break;
+    case USCI_I2C_UCSTPIFG:
+      if (NULL == txn) {
+        hpl->ie &= ~(UCTXIE | UCRXIE | UCNACKIE | UCALIE | UCSTPIE);
+      } else if ((hpl->ctlw0 & UCTR) && (0 < txn->rx_len)) {
+        hpl->ie &= ~UCTXIE;
+        eusciI2CqueueStartPhase_ni(hpl, 0, txn->rx_len);
+      } else {
+        hpl->ie &= ~(UCTXIE | UCRXIE | UCNACKIE | UCALIE | UCSTPIE);
+        rv = iBSP430i2cQueueComplete_ni(hal, queue->idx);
+      }
+      break;
+    case USCI_I2C_UCTXIFG0:
+      if ((NULL != txn) && (queue->idx < txn->tx_len)) {
+        ++hal->num_tx;
+        hpl->txbuf = txn->tx_data[queue->idx++];
+      } else {
+        /* Device generates the stop */
+        hpl->ie &= ~UCTXIE;
+      }
+      break;
+    case USCI_I2C_UCRXIFG0:
+      if (NULL == txn) {
+        (void)hpl->rxbuf;
+        hpl->ie &= ~UCRXIE;
+      } else {
+        ++hal->num_rx;
+        txn->rx_data[queue->idx++ - txn->tx_len] = hpl->rxbuf;
+      }
+      break;
+  }
+  return rv;
+}
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+/* Serve the register file of the attached I2C slave.  The prefetched
+ * octet is written to the transmit buffer before anything else, so
+ * the master is held only for interrupt latency. */
+static int
+euscib_i2c_slave_isr (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplEUSCIB * hpl = SERIAL_HAL_HPL_B(hal);
+  sBSP430i2cSlave * slave = hal->i2c_slave_ni;
+  int rv = 0;
+
+  switch (hpl->iv) {
+    default:
+    case USCI_NONE:
+      break;
+    case USCI_I2C_UCSTTIFG:
+      /* UCTR reflects the direction requested by the master */
+      vBSP430i2cSlaveStart_ni(slave, hpl->ctlw0 & UCTR);
+      break;
+    case USCI_I2C_UCSTPIFG:
+      rv = iBSP430i2cSlaveStop_ni(slave);
+      break;
+    case USCI_I2C_UCRXIFG0:
+      ++hal->num_rx;
+      rv = iBSP430i2cSlaveRx_ni(slave, hpl->rxbuf);
+      break;
+    case USCI_I2C_UCTXIFG0:
+      hpl->txbuf = slave->tx_next;
+      ++hal->num_tx;
+      vBSP430i2cSlaveTxNext_ni(slave);
+      break;
+  }
+  return rv;
+}
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
+static int
+#if (20120406 < __MSPGCC__) && (__MSP430X__ - 0)
+__attribute__ ( ( __c16__ ) )
+#endif /* CPUX */
+/* __attribute__((__always_inline__)) */
+euscib_isr (hBSP430halSERIAL hal)
+{
+  int c;
+  int rv = 0;
+
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  if (hal->i2c_queue_ni) {
+    return euscib_i2c_isr(hal);
+  }
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+  if (hal->i2c_slave_ni) {
+    return euscib_i2c_slave_isr(hal);
+  }
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+  switch (SERIAL_HAL_HPL_B(hal)->iv) {
+    default:
+    case USCI_NONE:
+      break;
+    case USCI_SPI_UCTXIFG:
+      c = iBSP430serialTxISRNextOctet_ni(hal, &rv);
+      if (0 <= c) {
+        /* Found some data; send it out */
+        SERIAL_HAL_HPL_B(hal)->txbuf = c;
+      }
+      if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
+        SERIAL_HAL_HPL_B(hal)->ie &= ~UCTXIE;
+        if (0 > c) {
+          SERIAL_HAL_HPL_B(hal)->ifg |= UCTXIFG;
+        }
+      }
+      break;
+    case USCI_SPI_UCRXIFG:
+      hal->rx_byte = SERIAL_HAL_HPL_B(hal)->rxbuf;
+      ++hal->num_rx;
+      rv = iBSP430callbackInvokeISRVoid_ni(&hal->rx_cbchain_ni, hal, 0);
+      break;
+  }
+  return rv;
+}
+#endif /* EUSCIB ISR */
+
 #if BSP430_SERIAL - 0
 static struct sBSP430serialDispatch dispatch_ = {
 #if configBSP430_SERIAL_ENABLE_UART - 0
   .openUART = hBSP430eusciOpenUART,
+  .openUARTDivisor = hBSP430eusciOpenUARTDivisor,
   .uartRxByte_ni = iBSP430eusciUARTrxByte_ni,
   .uartTxByte_ni = iBSP430eusciUARTtxByte_ni,
   .uartTxData_ni = iBSP430eusciUARTtxData_ni,
@@ -574,17 +1024,29 @@ static struct sBSP430serialDispatch dispatch_ = {
 #if configBSP430_SERIAL_ENABLE_SPI - 0
   .openSPI = hBSP430eusciOpenSPI,
   .spiTxRx_ni = iBSP430eusciSPITxRx_ni,
+  .spiReconfigure_ni = iBSP430eusciSPIReconfigure_ni,
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 #if configBSP430_SERIAL_ENABLE_I2C - 0
   .openI2C = hBSP430eusciOpenI2C,
   .i2cSetAddresses_ni = iBSP430eusciI2CsetAddresses_ni,
   .i2cRxData_ni = iBSP430eusciI2CrxData_ni,
   .i2cTxData_ni = iBSP430eusciI2CtxData_ni,
+  .i2cTxRx_ni = iBSP430eusciI2CtxRx_ni,
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  .i2cQueueStart_ni = iBSP430eusciI2CqueueStart_ni,
+  .i2cQueueAbort_ni = vBSP430eusciI2CqueueAbort_ni,
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+  .i2cSlaveEnable_ni = iBSP430eusciI2CslaveEnable_ni,
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   .setHold_ni = iBSP430eusciSetHold_ni,
   .close = iBSP430eusciClose,
   .wakeupTransmit_ni = vBSP430eusciWakeupTransmit_ni,
   .flush_ni = vBSP430eusciFlush_ni,
+#if (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+  .dmaTarget_ni = dmaTarget_ni,
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA || configBSP430_SERIAL_UART_RX_USE_DMA */
 };
 #endif /* BSP430_SERIAL */
 
@@ -140,6 +140,7 @@ usciConfigure (hBSP430halSERIAL hal,
 
     /* Mark the hal active */
     hal->num_rx = hal->num_tx = 0;
+    BSP430_SERIAL_RESET_ERRORS_NI(hal);
 
     /* Attempt to release the device for use; if that failed, reset it
      * and return an error */
@@ -161,8 +162,6 @@ hBSP430usciOpenUART (hBSP430halSERIAL hal,
                      unsigned long baud)
 {
   unsigned long brclk_Hz = 0;
-  uint16_t brw = 0;
-  uint16_t brs = 0;
 
   /* Reject unsupported HALs */
   if ((NULL == hal)
@@ -190,10 +189,38 @@ hBSP430usciOpenUART (hBSP430halSERIAL hal,
     brclk_Hz = ulBSP430clockSMCLK_Hz_ni();
   }
 
-  brw = (brclk_Hz / baud);
-  brs = (1 + 16 * (brclk_Hz - baud * brw) / baud) / 2;
+  /* Reject rates too slow for the clock */
+  if ((brclk_Hz >> 16) >= baud) {
+    return NULL;
+  }
 
-  return usciConfigure(hal, ctl0_byte, ctl1_byte, brw, (0 * UCBRF0) | (brs * UCBRS0));
+  return hBSP430usciOpenUARTDivisor(hal, ctl0_byte, ctl1_byte, BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz, baud));
+}
+
+hBSP430halSERIAL
+hBSP430usciOpenUARTDivisor (hBSP430halSERIAL hal,
+                            unsigned char ctl0_byte,
+                            unsigned char ctl1_byte,
+                            unsigned long divisor_q12)
+{
+  /* Reject unsupported HALs */
+  if ((NULL == hal)
+      || (NULL == SERIAL_HAL_HPLAUX(hal))
+      || HAL_HPL_IS_USCI_B(hal)) {
+    return NULL;
+  }
+
+  /* Reject divisors that would leave the baud rate generator stopped
+   * or that do not fit in UCAxBR0/UCAxBR1 */
+  if ((0 == BSP430_USCI_UART_BRW(divisor_q12))
+      || (0xFFFFUL < (divisor_q12 >> 12))) {
+    return NULL;
+  }
+
+  /* Force to UART async; the clock select is used as given */
+  ctl0_byte &= ~(UCMODE1 | UCMODE0 | UCSYNC);
+
+  return usciConfigure(hal, ctl0_byte, ctl1_byte, BSP430_USCI_UART_BRW(divisor_q12), BSP430_USCI_UART_MCTL(divisor_q12));
 }
 
 hBSP430halSERIAL
@@ -221,6 +248,58 @@ hBSP430usciOpenSPI (hBSP430halSERIAL hal,
   return usciConfigure(hal, ctl0_byte, ctl1_byte, prescaler, -1);
 }
 
+int
+iBSP430usciSPIReconfigure_ni (hBSP430halSERIAL hal,
+                              unsigned char ctl0_byte,
+                              unsigned char ctl1_byte,
+                              unsigned int prescaler)
+{
+  volatile sBSP430hplUSCI * const hpl = SERIAL_HAL_HPL(hal);
+  unsigned char br0 = 0xFF & prescaler;
+  unsigned char br1 = prescaler >> 8;
+
+  /* Reject invalid prescaler */
+  if (0 == prescaler) {
+    return -1;
+  }
+
+  /* SPI is synchronous; a change of mode would require a change of
+   * pin configuration, which is what this routine avoids. */
+  ctl0_byte |= UCSYNC;
+  ctl1_byte &= ~UCSWRST;
+  if (peripheralConfigFlag(ctl0_byte) != peripheralConfigFlag(hpl->ctl0)) {
+    return -1;
+  }
+
+  /* Nothing to do if the device already has this configuration */
+  if ((ctl0_byte == hpl->ctl0)
+      && (ctl1_byte == (hpl->ctl1 & ~UCSWRST))
+      && (br0 == hpl->br0)
+      && (br1 == hpl->br1)) {
+    return 0;
+  }
+
+  /* Write only the registers that changed while the module is in
+   * reset, then release it.  Interrupts are disabled and cleared when
+   * UCSWRST is set. */
+  FLUSH_HAL_NI(hal);
+  hpl->ctl1 |= UCSWRST;
+  if (ctl0_byte != hpl->ctl0) {
+    hpl->ctl0 = ctl0_byte;
+  }
+  if (br0 != hpl->br0) {
+    hpl->br0 = br0;
+  }
+  if (br1 != hpl->br1) {
+    hpl->br1 = br1;
+  }
+  hpl->ctl1 = ctl1_byte;
+  if (hal->rx_cbchain_ni) {
+    *SERIAL_HAL_HPLAUX(hal)->iep |= SERIAL_HAL_HPLAUX(hal)->rx_bit;
+  }
+  return 0;
+}
+
 hBSP430halSERIAL
 hBSP430usciOpenI2C (hBSP430halSERIAL hal,
                     unsigned char ctl0_byte,
@@ -306,6 +385,7 @@ iBSP430usciUARTrxByte_ni (hBSP430halSERIAL hal)
     return -1;
   }
   if (*SERIAL_HAL_HPLAUX(hal)->ifgp & SERIAL_HAL_HPLAUX(hal)->rx_bit) {
+    BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal, 1, SERIAL_HAL_HPL(hal)->stat);
     ++hal->num_rx;
     return SERIAL_HAL_HPL(hal)->rxbuf;
   }
@@ -397,26 +477,22 @@ iBSP430usciI2CsetAddresses_ni (hBSP430halSERIAL hal,
   return 0;
 }
 
-int
-iBSP430usciI2CrxData_ni (hBSP430halSERIAL hal,
-                         uint8_t * data,
-                         size_t len)
+/* Receive len octets in a transaction begun by a start (or repeated
+ * start) issued here.  The stop must be requested while the last
+ * octet is being received, which for a single-octet read means as
+ * soon as the slave has acknowledged its address. */
+static int
+usciI2CreceivePhase_ni (hBSP430halSERIAL hal,
+                        uint8_t * data,
+                        size_t len)
 {
   volatile struct sBSP430hplUSCI * hpl = SERIAL_HAL_HPL(hal);
   struct sBSP430usciHPLAux * aux = SERIAL_HAL_HPLAUX(hal);
   uint8_t * dp = data;
   const uint8_t * dpe = data + len;
 
-  /* Set for receive */
+  /* Issue a start for receive */
   hpl->ctl1 &= ~UCTR;
-  /* Delay for any in-progress stop to complete */
-  do {
-    if (hpl->stat & (UCNACKIFG | UCALIFG)) {
-      return -1;
-    }
-  } while (hpl->ctl1 & UCTXSTP);
-
-  /* Issue a start */
   hpl->ctl1 |= UCTXSTT;
   while (dp < dpe) {
     if (dpe == (dp+1)) {
@@ -440,6 +516,23 @@ iBSP430usciI2CrxData_ni (hBSP430halSERIAL hal,
   return dp - data;
 }
 
+int
+iBSP430usciI2CrxData_ni (hBSP430halSERIAL hal,
+                         uint8_t * data,
+                         size_t len)
+{
+  volatile struct sBSP430hplUSCI * hpl = SERIAL_HAL_HPL(hal);
+
+  /* Delay for any in-progress stop to complete */
+  do {
+    if (hpl->stat & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (hpl->ctl1 & UCTXSTP);
+
+  return usciI2CreceivePhase_ni(hal, data, len);
+}
+
 int
 iBSP430usciI2CtxData_ni (hBSP430halSERIAL hal,
                          const uint8_t * data,
@@ -477,10 +570,62 @@ iBSP430usciI2CtxData_ni (hBSP430halSERIAL hal,
   return i;
 }
 
+int
+iBSP430usciI2CtxRx_ni (hBSP430halSERIAL hal,
+                       const uint8_t * tx_data,
+                       size_t tx_len,
+                       size_t rx_len,
+                       uint8_t * rx_data)
+{
+  volatile struct sBSP430hplUSCI * hpl = SERIAL_HAL_HPL(hal);
+  struct sBSP430usciHPLAux * aux = SERIAL_HAL_HPLAUX(hal);
+  int i = 0;
+  int rc;
+
+  if (0 == rx_len) {
+    return iBSP430usciI2CtxData_ni(hal, tx_data, tx_len);
+  }
+  if (0 == tx_len) {
+    return iBSP430usciI2CrxData_ni(hal, rx_data, rx_len);
+  }
+
+  /* Delay for any in-progress stop to complete */
+  do {
+    if (hpl->stat & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (hpl->ctl1 & UCTXSTP);
+
+  /* Issue a start for transmit */
+  hpl->ctl1 |= UCTR | UCTXSTT;
+  while (i < tx_len) {
+    do {
+      if (hpl->stat & (UCNACKIFG | UCALIFG)) {
+        return -1;
+      }
+    } while (! (aux->tx_bit & *aux->ifgp));
+    hpl->txbuf = tx_data[i++];
+    ++hal->num_tx;
+  }
+  /* Wait for the last octet to move to the shift register; the start
+   * issued for the receive phase is then a repeated start. */
+  do {
+    if (hpl->stat & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (! (aux->tx_bit & *aux->ifgp));
+  rc = usciI2CreceivePhase_ni(hal, rx_data, rx_len);
+  if (0 > rc) {
+    return rc;
+  }
+  return i + rc;
+}
+
 #if BSP430_SERIAL - 0
 static struct sBSP430serialDispatch dispatch_ = {
 #if configBSP430_SERIAL_ENABLE_UART - 0
   .openUART = hBSP430usciOpenUART,
+  .openUARTDivisor = hBSP430usciOpenUARTDivisor,
   .uartRxByte_ni = iBSP430usciUARTrxByte_ni,
   .uartTxByte_ni = iBSP430usciUARTtxByte_ni,
   .uartTxData_ni = iBSP430usciUARTtxData_ni,
@@ -489,12 +634,14 @@ static struct sBSP430serialDispatch dispatch_ = {
 #if configBSP430_SERIAL_ENABLE_SPI - 0
   .openSPI = hBSP430usciOpenSPI,
   .spiTxRx_ni = iBSP430usciSPITxRx_ni,
+  .spiReconfigure_ni = iBSP430usciSPIReconfigure_ni,
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 #if configBSP430_SERIAL_ENABLE_I2C - 0
   .openI2C = hBSP430usciOpenI2C,
   .i2cSetAddresses_ni = iBSP430usciI2CsetAddresses_ni,
   .i2cRxData_ni = iBSP430usciI2CrxData_ni,
   .i2cTxData_ni = iBSP430usciI2CtxData_ni,
+  .i2cTxRx_ni = iBSP430usciI2CtxRx_ni,
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   .setHold_ni = iBSP430usciSetHold_ni,
   .close = iBSP430usciClose,
@@ -607,6 +754,7 @@ __attribute__ ( ( __c16__ ) )
 /* __attribute__((__always_inline__)) */
 usciabrx_isr (hBSP430halSERIAL hal)
 {
+  BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal, ! (SERIAL_HAL_HPL(hal)->ctl0 & UCSYNC), SERIAL_HAL_HPL(hal)->stat);
   hal->rx_byte = SERIAL_HAL_HPL(hal)->rxbuf;
   ++hal->num_rx;
   return iBSP430callbackInvokeISRVoid_ni(&hal->rx_cbchain_ni, hal, 0);
@@ -676,16 +824,11 @@ __attribute__ ( ( __c16__ ) )
 /* __attribute__((__always_inline__)) */
 usciabtx_isr (hBSP430halSERIAL hal)
 {
-  int rv = iBSP430callbackInvokeISRVoid_ni(&hal->tx_cbchain_ni, hal, 0);
-  int did_tx = 0;
-  if (rv & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN) {
+  int rv;
+  int c = iBSP430serialTxISRNextOctet_ni(hal, &rv);
+  if (0 <= c) {
     /* Found some data; send it out */
-    ++hal->num_tx;
-    SERIAL_HAL_HPL(hal)->txbuf = hal->tx_byte;
-    did_tx = 1;
-  } else {
-    /* No data; mark transmission disabled */
-    rv |= BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+    SERIAL_HAL_HPL(hal)->txbuf = c;
   }
   /* If no more is expected, clear the interrupt so we don't wake
    * again.  Further, if we didn't transmit anything mark that the
@@ -693,7 +836,7 @@ usciabtx_isr (hBSP430halSERIAL hal)
    * fire. */
   if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
     *SERIAL_HAL_HPLAUX(hal)->iep &= ~SERIAL_HAL_HPLAUX(hal)->tx_bit;
-    if (! did_tx) {
+    if (0 > c) {
       *SERIAL_HAL_HPLAUX(hal)->ifgp |= SERIAL_HAL_HPLAUX(hal)->tx_bit;
     }
   }
@@ -128,6 +128,7 @@ usci5Configure (hBSP430halSERIAL hal,
 
     /* Reset device statistics */
     hal->num_rx = hal->num_tx = 0;
+    BSP430_SERIAL_RESET_ERRORS_NI(hal);
 
     /* Attempt to release the device for use; if that failed, reset it
      * and return an error */
@@ -149,8 +150,6 @@ hBSP430usci5OpenUART (hBSP430halSERIAL hal,
                       unsigned long baud)
 {
   unsigned long brclk_Hz = 0;
-  uint16_t brw = 0;
-  uint16_t brs = 0;
 
   /* Reject unsupported HALs */
   if (NULL == hal) {
@@ -177,10 +176,36 @@ hBSP430usci5OpenUART (hBSP430halSERIAL hal,
     brclk_Hz = ulBSP430clockSMCLK_Hz_ni();
   }
 
-  brw = (brclk_Hz / baud);
-  brs = (1 + 16 * (brclk_Hz - baud * brw) / baud) / 2;
+  /* Reject rates too slow for the clock */
+  if ((brclk_Hz >> 16) >= baud) {
+    return NULL;
+  }
+
+  return hBSP430usci5OpenUARTDivisor(hal, ctl0_byte, ctl1_byte, BSP430_SERIAL_UART_DIVISOR_Q12(brclk_Hz, baud));
+}
+
+hBSP430halSERIAL
+hBSP430usci5OpenUARTDivisor (hBSP430halSERIAL hal,
+                             unsigned char ctl0_byte,
+                             unsigned char ctl1_byte,
+                             unsigned long divisor_q12)
+{
+  /* Reject unsupported HALs */
+  if (NULL == hal) {
+    return NULL;
+  }
+
+  /* Reject divisors that would leave the baud rate generator stopped
+   * or that do not fit in UCAxBRW */
+  if ((0 == BSP430_USCI5_UART_BRW(divisor_q12))
+      || (0xFFFFUL < (divisor_q12 >> 12))) {
+    return NULL;
+  }
 
-  return usci5Configure(hal, ctl0_byte, ctl1_byte, brw, (0 * UCBRF0) | (brs * UCBRS0));
+  /* Force to UART async; the clock select is used as given */
+  ctl0_byte &= ~(UCMODE1 | UCMODE0 | UCSYNC);
+
+  return usci5Configure(hal, ctl0_byte, ctl1_byte, BSP430_USCI5_UART_BRW(divisor_q12), BSP430_USCI5_UART_MCTL(divisor_q12));
 }
 
 hBSP430halSERIAL
@@ -208,6 +233,51 @@ hBSP430usci5OpenSPI (hBSP430halSERIAL hal,
   return usci5Configure(hal, ctl0_byte, ctl1_byte, prescaler, -1);
 }
 
+int
+iBSP430usci5SPIReconfigure_ni (hBSP430halSERIAL hal,
+                               unsigned char ctl0_byte,
+                               unsigned char ctl1_byte,
+                               unsigned int prescaler)
+{
+  volatile sBSP430hplUSCI5 * const hpl = SERIAL_HAL_HPL(hal);
+
+  /* Reject invalid prescaler */
+  if (0 == prescaler) {
+    return -1;
+  }
+
+  /* SPI is synchronous; a change of mode would require a change of
+   * pin configuration, which is what this routine avoids. */
+  ctl0_byte |= UCSYNC;
+  ctl1_byte &= ~UCSWRST;
+  if (peripheralConfigFlag(ctl0_byte) != peripheralConfigFlag(hpl->ctl0)) {
+    return -1;
+  }
+
+  /* Nothing to do if the device already has this configuration */
+  if ((ctl0_byte == hpl->ctl0)
+      && (ctl1_byte == (hpl->ctl1 & ~UCSWRST))
+      && (prescaler == hpl->brw)) {
+    return 0;
+  }
+
+  /* Write only the registers that changed while the module is in
+   * reset, then release it. */
+  SERIAL_HPL_FLUSH_NI(hpl);
+  SERIAL_HPL_HOLD_HPL_NI(hpl);
+  if (ctl0_byte != hpl->ctl0) {
+    hpl->ctl0 = ctl0_byte;
+  }
+  if (ctl1_byte != (hpl->ctl1 & ~UCSWRST)) {
+    hpl->ctl1 = ctl1_byte | UCSWRST;
+  }
+  if (prescaler != hpl->brw) {
+    hpl->brw = prescaler;
+  }
+  SERIAL_HPL_RELEASE_HPL_NI(hal, hpl);
+  return 0;
+}
+
 hBSP430halSERIAL
 hBSP430usci5OpenI2C (hBSP430halSERIAL hal,
                      unsigned char ctl0_byte,
@@ -287,6 +357,7 @@ iBSP430usci5UARTrxByte_ni (hBSP430halSERIAL hal)
     return -1;
   }
   if (SERIAL_HAL_HPL(hal)->ifg & UCRXIFG) {
+    BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal, 1, SERIAL_HAL_HPL(hal)->stat);
     ++hal->num_rx;
     return SERIAL_HAL_HPL(hal)->rxbuf;
   }
@@ -337,6 +408,61 @@ iBSP430usci5UARTtxASCIIZ_ni (hBSP430halSERIAL hal, const char * str)
   return str - in_string;
 }
 
+#if ((configBSP430_SERIAL_SPI_USE_DMA - 0)                \
+     || (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)         \
+     || (configBSP430_SERIAL_UART_RX_USE_DMA - 0))
+/* Identify the DMA trigger for the receive interrupt flag of the
+ * peripheral, or -1 if it has none. */
+static int
+dmaRxTrigger (hBSP430halSERIAL hal)
+{
+#if configBSP430_HPL_USCI5_A0 - 0
+  if (BSP430_HPL_USCI5_A0 == SERIAL_HAL_HPL(hal)) {
+    return BSP430_USCI5_A0_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_USCI5_A0 */
+#if configBSP430_HPL_USCI5_B0 - 0
+  if (BSP430_HPL_USCI5_B0 == SERIAL_HAL_HPL(hal)) {
+    return BSP430_USCI5_B0_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_USCI5_B0 */
+#if configBSP430_HPL_USCI5_A1 - 0
+  if (BSP430_HPL_USCI5_A1 == SERIAL_HAL_HPL(hal)) {
+    return BSP430_USCI5_A1_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_USCI5_A1 */
+#if configBSP430_HPL_USCI5_B1 - 0
+  if (BSP430_HPL_USCI5_B1 == SERIAL_HAL_HPL(hal)) {
+    return BSP430_USCI5_B1_DMA_TSEL_RX;
+  }
+#endif /* configBSP430_HPL_USCI5_B1 */
+  return -1;
+}
+#if (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+/* Identify the DMA receive trigger and the buffer registers of the
+ * peripheral.  The transmit trigger immediately follows the receive
+ * trigger. */
+static int
+dmaTarget_ni (hBSP430halSERIAL hal,
+              const volatile void ** rxbufpp,
+              volatile void ** txbufpp)
+{
+  int tsel = dmaRxTrigger(hal);
+
+  if (0 > tsel) {
+    return -1;
+  }
+  if (rxbufpp) {
+    *rxbufpp = &SERIAL_HAL_HPL(hal)->rxbuf;
+  }
+  if (txbufpp) {
+    *txbufpp = &SERIAL_HAL_HPL(hal)->txbuf;
+  }
+  return tsel;
+}
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA || configBSP430_SERIAL_UART_RX_USE_DMA */
+#endif /* SPI_USE_DMA || TX_BLOCK_USE_DMA || UART_RX_USE_DMA */
+
 int
 iBSP430usci5SPITxRx_ni (hBSP430halSERIAL hal,
                         const uint8_t * tx_data,
@@ -352,6 +478,17 @@ iBSP430usci5SPITxRx_ni (hBSP430halSERIAL hal,
   if (hal->tx_cbchain_ni) {
     return -1;
   }
+#if configBSP430_SERIAL_SPI_USE_DMA - 0
+  {
+    int rv = iBSP430serialSPITxRxDMA_ni(hal, dmaRxTrigger(hal),
+                                        &SERIAL_HAL_HPL(hal)->rxbuf,
+                                        &SERIAL_HAL_HPL(hal)->txbuf,
+                                        tx_data, tx_len, rx_len, rx_data);
+    if (0 <= rv) {
+      return rv;
+    }
+  }
+#endif /* configBSP430_SERIAL_SPI_USE_DMA */
   rxp = rx_data;
   if (NULL == rx_data)  {
     rxp = &rx_dummy;
@@ -374,34 +511,42 @@ iBSP430usci5I2CsetAddresses_ni (hBSP430halSERIAL hal,
                                 int own_address,
                                 int slave_address)
 {
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+
   if (0 <= own_address) {
-    SERIAL_HAL_HPL(hal)->i2coa = own_address;
+    /* The own address may only be changed while the peripheral is
+     * in reset, which also clears the interrupt enables. */
+    unsigned char ie = hpl->ie;
+    unsigned char in_reset = hpl->ctl1 & UCSWRST;
+
+    hpl->ctl1 |= UCSWRST;
+    hpl->i2coa = own_address;
+    if (! in_reset) {
+      hpl->ctl1 &= ~UCSWRST;
+      hpl->ie = ie;
+    }
   }
   if (0 <= slave_address) {
-    SERIAL_HAL_HPL(hal)->i2csa = slave_address;
+    hpl->i2csa = slave_address;
   }
   return 0;
 }
 
-int
-iBSP430usci5I2CrxData_ni (hBSP430halSERIAL hal,
-                          uint8_t * data,
-                          size_t len)
+/* Receive len octets in a transaction begun by a start (or repeated
+ * start) issued here.  The stop must be requested while the last
+ * octet is being received, which for a single-octet read means as
+ * soon as the slave has acknowledged its address. */
+static int
+usci5I2CreceivePhase_ni (hBSP430halSERIAL hal,
+                         uint8_t * data,
+                         size_t len)
 {
   volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
   uint8_t * dp = data;
   const uint8_t * dpe = data + len;
 
-  /* Set for receive */
+  /* Issue a start for receive */
   hpl->ctl1 &= ~UCTR;
-  /* Delay for any in-progress stop to complete */
-  do {
-    if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
-      return -1;
-    }
-  } while (hpl->ctl1 & UCTXSTP);
-
-  /* Issue a start */
   hpl->ctl1 |= UCTXSTT;
   while (dp < dpe) {
     if (dpe == (dp+1)) {
@@ -425,6 +570,23 @@ iBSP430usci5I2CrxData_ni (hBSP430halSERIAL hal,
   return dp - data;
 }
 
+int
+iBSP430usci5I2CrxData_ni (hBSP430halSERIAL hal,
+                          uint8_t * data,
+                          size_t len)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+
+  /* Delay for any in-progress stop to complete */
+  do {
+    if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (hpl->ctl1 & UCTXSTP);
+
+  return usci5I2CreceivePhase_ni(hal, data, len);
+}
+
 int
 iBSP430usci5I2CtxData_ni (hBSP430halSERIAL hal,
                           const uint8_t * data,
@@ -462,6 +624,147 @@ iBSP430usci5I2CtxData_ni (hBSP430halSERIAL hal,
   return i;
 }
 
+int
+iBSP430usci5I2CtxRx_ni (hBSP430halSERIAL hal,
+                        const uint8_t * tx_data,
+                        size_t tx_len,
+                        size_t rx_len,
+                        uint8_t * rx_data)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  int i = 0;
+  int rc;
+
+  if (0 == rx_len) {
+    return iBSP430usci5I2CtxData_ni(hal, tx_data, tx_len);
+  }
+  if (0 == tx_len) {
+    return iBSP430usci5I2CrxData_ni(hal, rx_data, rx_len);
+  }
+
+  /* Delay for any in-progress stop to complete */
+  do {
+    if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (hpl->ctl1 & UCTXSTP);
+
+  /* Issue a start for transmit */
+  hpl->ctl1 |= UCTR | UCTXSTT;
+  while (i < tx_len) {
+    do {
+      if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+        return -1;
+      }
+    } while (! (hpl->ifg & UCTXIFG));
+    ++hal->num_tx;
+    hpl->txbuf = tx_data[i];
+    ++i;
+  }
+  /* Wait for the last octet to move to the shift register; the start
+   * issued for the receive phase is then a repeated start. */
+  do {
+    if (hpl->ifg & (UCNACKIFG | UCALIFG)) {
+      return -1;
+    }
+  } while (! (hpl->ifg & UCTXIFG));
+  rc = usci5I2CreceivePhase_ni(hal, rx_data, rx_len);
+  if (0 > rc) {
+    return rc;
+  }
+  return i + rc;
+}
+
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+/* Begin the receive phase of a queued transaction.  This is a
+ * repeated start if a transmit phase preceded it.  The stop for a
+ * single-octet read must be requested while the address is
+ * transmitted, which is only visible by polling UCTXSTT.  Returns -1
+ * if the address was not acknowledged within the polling limit;
+ * the caller must then reset the peripheral. */
+static int
+usci5I2CqueueStartRx_ni (volatile struct sBSP430hplUSCI5 * hpl,
+                         size_t rx_len)
+{
+  unsigned int loops = BSP430_USCI5_I2C_START_WAIT_LOOPS;
+
+  hpl->ctl1 &= ~UCTR;
+  hpl->ctl1 |= UCTXSTT;
+  if (1 == rx_len) {
+    while ((hpl->ctl1 & UCTXSTT) && ! (hpl->ifg & (UCNACKIFG | UCALIFG))) {
+      if (0 == loops--) {
+        return -1;
+      }
+    }
+    /* A NACK or arbitration loss is handled by its interrupt */
+    if (! (hpl->ifg & (UCNACKIFG | UCALIFG))) {
+      hpl->ctl1 |= UCTXSTP;
+    }
+  }
+  hpl->ie |= UCRXIE;
+  return 0;
+}
+
+int
+iBSP430usci5I2CqueueStart_ni (hBSP430halSERIAL hal,
+                              hBSP430i2cTransaction txn)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+
+  /* The USCI5 does not signal completion of a stop in master mode,
+   * so a stop issued at the end of the previous transaction may
+   * still be in progress.  The queue retries the start later. */
+  if (hpl->ctl1 & UCTXSTP) {
+    return -1;
+  }
+  if (0 <= txn->slave_address) {
+    hpl->i2csa = txn->slave_address;
+  }
+  hpl->ifg &= ~(UCNACKIFG | UCALIFG);
+  hpl->ie |= UCNACKIE | UCALIE;
+  if (0 < txn->tx_len) {
+    hpl->ctl1 |= UCTR | UCTXSTT;
+    hpl->ie |= UCTXIE;
+  } else if (0 != usci5I2CqueueStartRx_ni(hpl, txn->rx_len)) {
+    vBSP430usci5I2CqueueAbort_ni(hal);
+    return BSP430_I2C_RESULT_TIMEOUT;
+  }
+  return 0;
+}
+
+void
+vBSP430usci5I2CqueueAbort_ni (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+
+  /* Resetting the peripheral releases the bus and clears the
+   * interrupt enables; the configuration is retained. */
+  hpl->ctl1 |= UCSWRST;
+  hpl->ctl1 &= ~UCSWRST;
+}
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+int
+iBSP430usci5I2CslaveEnable_ni (hBSP430halSERIAL hal,
+                               int enablep)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  const unsigned char slave_ie = UCSTTIE | UCSTPIE | UCRXIE | UCTXIE;
+
+  if (enablep) {
+    if (hpl->ctl0 & UCMST) {
+      return -1;
+    }
+    hpl->ifg &= ~(UCSTTIFG | UCSTPIFG);
+    hpl->ie |= slave_ie;
+  } else {
+    hpl->ie &= ~slave_ie;
+  }
+  return 0;
+}
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
 /* Since the interrupt code is the same for all peripherals, on MCUs
  * with multiple USCI5 devices it is more space efficient to share it.
  * This does add an extra call/return for some minor cost in stack
@@ -485,6 +788,113 @@ iBSP430usci5I2CtxData_ni (hBSP430halSERIAL hal,
      || (configBSP430_HAL_USCI5_B2_ISR - 0)     \
      || (configBSP430_HAL_USCI5_B3_ISR - 0)     \
      )
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+/* Advance the transaction at the head of the attached I2C queue.
+ * Interrupt vector values differ from those of UART and SPI mode. */
+static int
+usci5_i2c_isr (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  sBSP430i2cQueue * queue = hal->i2c_queue_ni;
+  hBSP430i2cTransaction txn = queue->head_ni;
+  size_t idx;
+  int rv = 0;
+
+  switch (hpl->iv) {
+    default:
+    case USCI_NONE:
+      break;
+    case USCI_I2C_UCALIFG:
+      /* Losing arbitration drops the peripheral into slave mode */
+      hpl->ie &= ~(UCTXIE | UCRXIE | UCNACKIE | UCALIE);
+      hpl->ctl0 |= UCMST;
+      rv = iBSP430i2cQueueComplete_ni(hal, BSP430_I2C_RESULT_ARBITRATION_LOST);
+      break;
+    case USCI_I2C_UCNACKIFG:
+      hpl->ie &= ~(UCTXIE | UCRXIE | UCNACKIE | UCALIE);
+      hpl->ctl1 |= UCTXSTP;
+      rv = iBSP430i2cQueueComplete_ni(hal, BSP430_I2C_RESULT_NACK);
+      break;
+    case USCI_I2C_UCTXIFG:
+      if (NULL == txn) {
+        hpl->ie &= ~UCTXIE;
+      } else if (queue->idx < txn->tx_len) {
+        ++hal->num_tx;
+        hpl->txbuf = txn->tx_data[queue->idx++];
+      } else {
+        /* Last octet has moved to the shift register */
+        hpl->ie &= ~UCTXIE;
+        if (0 < txn->rx_len) {
+          if (0 != usci5I2CqueueStartRx_ni(hpl, txn->rx_len)) {
+            vBSP430usci5I2CqueueAbort_ni(hal);
+            rv = iBSP430i2cQueueComplete_ni(hal, BSP430_I2C_RESULT_TIMEOUT);
+          }
+        } else {
+          hpl->ctl1 |= UCTXSTP;
+          hpl->ifg &= ~UCTXIFG;
+          hpl->ie &= ~(UCNACKIE | UCALIE);
+          rv = iBSP430i2cQueueComplete_ni(hal, txn->tx_len);
+        }
+      }
+      break;
+    case USCI_I2C_UCRXIFG:
+      if (NULL == txn) {
+        (void)hpl->rxbuf;
+        hpl->ie &= ~UCRXIE;
+        break;
+      }
+      idx = queue->idx++ - txn->tx_len;
+      ++hal->num_rx;
+      txn->rx_data[idx++] = hpl->rxbuf;
+      if (txn->rx_len == idx) {
+        hpl->ie &= ~(UCRXIE | UCNACKIE | UCALIE);
+        rv = iBSP430i2cQueueComplete_ni(hal, txn->tx_len + txn->rx_len);
+      } else if (txn->rx_len == (idx + 1)) {
+        /* Stop after the octet now being received */
+        hpl->ctl1 |= UCTXSTP;
+      }
+      break;
+  }
+  return rv;
+}
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+/* Serve the register file of the attached I2C slave.  The prefetched
+ * octet is written to the transmit buffer before anything else, so
+ * the master is held only for interrupt latency. */
+static int
+usci5_i2c_slave_isr (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  sBSP430i2cSlave * slave = hal->i2c_slave_ni;
+  int rv = 0;
+
+  switch (hpl->iv) {
+    default:
+    case USCI_NONE:
+      break;
+    case USCI_I2C_UCSTTIFG:
+      /* UCTR reflects the direction requested by the master */
+      vBSP430i2cSlaveStart_ni(slave, hpl->ctl1 & UCTR);
+      break;
+    case USCI_I2C_UCSTPIFG:
+      rv = iBSP430i2cSlaveStop_ni(slave);
+      break;
+    case USCI_I2C_UCRXIFG:
+      ++hal->num_rx;
+      rv = iBSP430i2cSlaveRx_ni(slave, hpl->rxbuf);
+      break;
+    case USCI_I2C_UCTXIFG:
+      hpl->txbuf = slave->tx_next;
+      ++hal->num_tx;
+      vBSP430i2cSlaveTxNext_ni(slave);
+      break;
+  }
+  return rv;
+}
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
 static int
 #if (20120406 < __MSPGCC__) && (__MSP430X__ - 0)
 __attribute__ ( ( __c16__ ) )
@@ -492,24 +902,28 @@ __attribute__ ( ( __c16__ ) )
 /* __attribute__((__always_inline__)) */
 usci5_isr (hBSP430halSERIAL hal)
 {
-  int did_tx;
+  int c;
   int rv = 0;
 
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  if (hal->i2c_queue_ni) {
+    return usci5_i2c_isr(hal);
+  }
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+  if (hal->i2c_slave_ni) {
+    return usci5_i2c_slave_isr(hal);
+  }
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
   switch (SERIAL_HAL_HPL(hal)->iv) {
     default:
     case USCI_NONE:
       break;
     case USCI_UCTXIFG:
-      rv = iBSP430callbackInvokeISRVoid_ni(&hal->tx_cbchain_ni, hal, 0);
-      did_tx = 0;
-      if (rv & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN) {
+      c = iBSP430serialTxISRNextOctet_ni(hal, &rv);
+      if (0 <= c) {
         /* Found some data; send it out */
-        ++hal->num_tx;
-        did_tx = 1;
-        SERIAL_HAL_HPL(hal)->txbuf = hal->tx_byte;
-      } else {
-        /* No data; disable transmission interrupt */
-        rv |= BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+        SERIAL_HAL_HPL(hal)->txbuf = c;
       }
       /* If no more is expected, clear the interrupt so we don't wake
        * again.  Further, if we didn't transmit anything mark that the
@@ -517,12 +931,13 @@ usci5_isr (hBSP430halSERIAL hal)
        * fire. */
       if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
         SERIAL_HAL_HPL(hal)->ie &= ~UCTXIE;
-        if (! did_tx) {
+        if (0 > c) {
           SERIAL_HAL_HPL(hal)->ifg |= UCTXIFG;
         }
       }
       break;
     case USCI_UCRXIFG:
+      BSP430_SERIAL_COUNT_UART_ERRORS_NI(hal, ! (SERIAL_HAL_HPL(hal)->ctl0 & UCSYNC), SERIAL_HAL_HPL(hal)->stat);
       hal->rx_byte = SERIAL_HAL_HPL(hal)->rxbuf;
       ++hal->num_rx;
       rv = iBSP430callbackInvokeISRVoid_ni(&hal->rx_cbchain_ni, hal, 0);
@@ -536,6 +951,7 @@ usci5_isr (hBSP430halSERIAL hal)
 static struct sBSP430serialDispatch dispatch_ = {
 #if configBSP430_SERIAL_ENABLE_UART - 0
   .openUART = hBSP430usci5OpenUART,
+  .openUARTDivisor = hBSP430usci5OpenUARTDivisor,
   .uartRxByte_ni = iBSP430usci5UARTrxByte_ni,
   .uartTxByte_ni = iBSP430usci5UARTtxByte_ni,
   .uartTxData_ni = iBSP430usci5UARTtxData_ni,
@@ -544,17 +960,29 @@ static struct sBSP430serialDispatch dispatch_ = {
 #if configBSP430_SERIAL_ENABLE_SPI - 0
   .openSPI = hBSP430usci5OpenSPI,
   .spiTxRx_ni = iBSP430usci5SPITxRx_ni,
+  .spiReconfigure_ni = iBSP430usci5SPIReconfigure_ni,
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 #if configBSP430_SERIAL_ENABLE_I2C - 0
   .openI2C = hBSP430usci5OpenI2C,
   .i2cSetAddresses_ni = iBSP430usci5I2CsetAddresses_ni,
   .i2cRxData_ni = iBSP430usci5I2CrxData_ni,
   .i2cTxData_ni = iBSP430usci5I2CtxData_ni,
+  .i2cTxRx_ni = iBSP430usci5I2CtxRx_ni,
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+  .i2cQueueStart_ni = iBSP430usci5I2CqueueStart_ni,
+  .i2cQueueAbort_ni = vBSP430usci5I2CqueueAbort_ni,
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+  .i2cSlaveEnable_ni = iBSP430usci5I2CslaveEnable_ni,
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   .setHold_ni = iBSP430usci5SetHold_ni,
   .close = iBSP430usci5Close,
   .wakeupTransmit_ni = vBSP430usci5WakeupTransmit_ni,
   .flush_ni = vBSP430usci5Flush_ni,
+#if (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0) || (configBSP430_SERIAL_UART_RX_USE_DMA - 0)
+  .dmaTarget_ni = dmaTarget_ni,
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA || configBSP430_SERIAL_UART_RX_USE_DMA */
 };
 #endif /* BSP430_SERIAL */
 
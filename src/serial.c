@@ -37,6 +37,7 @@
  */
 
 #include <bsp430/serial.h>
+#include <string.h>
 
 const char *
 xBSP430serialName (tBSP430periphHandle periph)
@@ -57,5 +58,1056 @@ xBSP430serialName (tBSP430periphHandle periph)
     rv = xBSP430eusciName(periph);
   }
 #endif /* configBSP430_SERIAL_USE_EUSCI */
+#if configBSP430_SERIAL_USE_GPIOSERIAL - 0
+  if (NULL == rv) {
+    rv = xBSP430gpioserialName(periph);
+  }
+#endif /* configBSP430_SERIAL_USE_GPIOSERIAL */
+#if configBSP430_SERIAL_USE_TIMERUART - 0
+  if (NULL == rv) {
+    rv = xBSP430timeruartName(periph);
+  }
+#endif /* configBSP430_SERIAL_USE_TIMERUART */
+  return rv;
+}
+
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+int
+iBSP430serialSnapshotErrors (hBSP430halSERIAL hal,
+                             sBSP430serialErrors * snapshot,
+                             int reset)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+
+  if (NULL == hal) {
+    return -1;
+  }
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (snapshot) {
+    *snapshot = hal->errors;
+  }
+  if (reset) {
+    BSP430_SERIAL_RESET_ERRORS_NI(hal);
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return 0;
+}
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+
+#if configBSP430_SERIAL_SPI_USE_DMA - 0
+#include <bsp430/periph/dma.h>
+
+#if configBSP430_SERIAL_SPI_DMA_USE_LPM - 0
+static int
+spi_dma_complete_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                     void * context,
+                     int idx)
+{
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+static sBSP430halISRIndexedChainNode spi_dma_cb_ = {
+  .callback = spi_dma_complete_ni
+};
+#endif /* configBSP430_SERIAL_SPI_DMA_USE_LPM */
+
+int
+iBSP430serialSPITxRxDMA_ni (hBSP430halSERIAL hal,
+                            int rx_tsel,
+                            const volatile void * rxbufp,
+                            volatile void * txbufp,
+                            const uint8_t * tx_data,
+                            size_t tx_len,
+                            size_t rx_len,
+                            uint8_t * rx_data)
+{
+  hBSP430halDMA dma = BSP430_HAL_DMA;
+  size_t transaction_length = tx_len + rx_len;
+  const uint8_t * txp = tx_data;
+  uint8_t rx_dummy;
+  unsigned int rx_ctl;
+  int rx_ch;
+  int tx_ch;
+
+  if ((0 > rx_tsel)
+      || (BSP430_SERIAL_SPI_DMA_THRESHOLD > transaction_length)
+      || ((NULL == rx_data) && (0 < rx_len))) {
+    return -1;
+  }
+  /* Allocate receive first: lower channels have higher priority, and
+   * the received byte must be taken before the next one arrives. */
+  rx_ch = iBSP430dmaChannelAllocate_ni(dma, -1);
+  tx_ch = iBSP430dmaChannelAllocate_ni(dma, -1);
+  if (0 > tx_ch) {
+    if (0 <= rx_ch) {
+      (void)iBSP430dmaChannelRelease_ni(dma, rx_ch);
+    }
+    return -1;
+  }
+
+  /* DMA can't synthesize the dummy bytes, so when there's a response
+   * phase stage the whole outgoing sequence in rx_data.  The
+   * transmit channel always reads an octet before the receive
+   * channel overwrites it. */
+  if (0 < rx_len) {
+    size_t i;
+
+    if (0 < tx_len) {
+      memmove(rx_data, tx_data, tx_len);
+    }
+    for (i = 0; i < rx_len; ++i) {
+      rx_data[tx_len + i] = BSP430_SERIAL_SPI_READ_TX_BYTE(i);
+    }
+    txp = rx_data;
+  }
+
+  rx_ctl = DMADT_0 | DMASRCBYTE | DMADSTBYTE;
+  if (rx_data) {
+    rx_ctl |= DMADSTINCR_3;
+  }
+#if configBSP430_SERIAL_SPI_DMA_USE_LPM - 0
+  rx_ctl |= DMAIE;
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[rx_ch], spi_dma_cb_, next_ni);
+#endif /* configBSP430_SERIAL_SPI_DMA_USE_LPM */
+
+  /* Triggers are edge-sensitive: discard any stale received octet so
+   * the first reception raises RXIFG.  The first octet is written by
+   * the CPU; each subsequent TXIFG edge has the transmit channel
+   * supply the next. */
+  (void)*(const volatile uint8_t *)rxbufp;
+  (void)iBSP430dmaChannelConfigure_ni(dma, rx_ch, rx_tsel, rx_ctl,
+                                      rxbufp, rx_data ? rx_data : &rx_dummy,
+                                      transaction_length);
+  (void)iBSP430dmaChannelConfigure_ni(dma, tx_ch, rx_tsel + 1,
+                                      DMADT_0 | DMASRCINCR_3 | DMASRCBYTE | DMADSTBYTE,
+                                      txp + 1, txbufp, transaction_length - 1);
+  (void)iBSP430dmaChannelEnable_ni(dma, rx_ch);
+  (void)iBSP430dmaChannelEnable_ni(dma, tx_ch);
+  *(volatile uint8_t *)txbufp = *txp;
+
+  while (iBSP430dmaChannelBusy_ni(dma, rx_ch)) {
+#if configBSP430_SERIAL_SPI_DMA_USE_LPM - 0
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits | GIE);
+    BSP430_CORE_DISABLE_INTERRUPT();
+#endif /* configBSP430_SERIAL_SPI_DMA_USE_LPM */
+  }
+
+#if configBSP430_SERIAL_SPI_DMA_USE_LPM - 0
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[rx_ch], spi_dma_cb_, next_ni);
+#endif /* configBSP430_SERIAL_SPI_DMA_USE_LPM */
+  (void)iBSP430dmaChannelRelease_ni(dma, tx_ch);
+  (void)iBSP430dmaChannelRelease_ni(dma, rx_ch);
+  hal->num_tx += transaction_length;
+  hal->num_rx += transaction_length;
+  return transaction_length;
+}
+#endif /* configBSP430_SERIAL_SPI_USE_DMA */
+
+#if configBSP430_SERIAL_ENABLE_SPI - 0
+
+#define SPI_QUEUE_FROM_TX_CB(cb_) ((sBSP430spiQueue *)((char *)(cb_) - offsetof(sBSP430spiQueue, tx_cb)))
+
+static void
+spi_queue_start_ni (sBSP430spiQueue * queue)
+{
+  hBSP430spiTransaction txn = queue->head_ni;
+
+  if (txn) {
+    queue->idx = 0;
+    if (txn->chip_select_ni) {
+      txn->chip_select_ni(txn, 1);
+    }
+    vBSP430serialWakeupTransmit_ni(queue->spi);
+  }
+}
+
+static int
+spi_queue_tx_ni (const struct sBSP430halISRVoidChainNode * cb,
+                 void * context)
+{
+  sBSP430spiQueue * queue = SPI_QUEUE_FROM_TX_CB(cb);
+  hBSP430halSERIAL spi = (hBSP430halSERIAL)context;
+  hBSP430spiTransaction txn = queue->head_ni;
+  size_t idx = queue->idx;
+
+  if (NULL == txn) {
+    return 0;
+  }
+  /* Only one octet is in flight at a time; the receive side requests
+   * the next one, so always disable the transmit interrupt. */
+  spi->tx_byte = (idx < txn->tx_len) ? txn->tx_data[idx] : BSP430_SERIAL_SPI_READ_TX_BYTE(idx - txn->tx_len);
+  return BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN | BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+}
+
+static int
+spi_queue_rx_ni (const struct sBSP430halISRVoidChainNode * cb,
+                 void * context)
+{
+  sBSP430spiQueue * queue = (sBSP430spiQueue *)cb;
+  hBSP430halSERIAL spi = (hBSP430halSERIAL)context;
+  hBSP430spiTransaction txn = queue->head_ni;
+  size_t transaction_length;
+  int more_queued;
+  int rv;
+
+  if (NULL == txn) {
+    return 0;
+  }
+  if (txn->rx_data) {
+    txn->rx_data[queue->idx] = spi->rx_byte;
+  }
+  transaction_length = txn->tx_len + txn->rx_len;
+  if (++queue->idx < transaction_length) {
+    vBSP430serialWakeupTransmit_ni(spi);
+    return 0;
+  }
+  if (txn->chip_select_ni) {
+    txn->chip_select_ni(txn, 0);
+  }
+  queue->head_ni = txn->next_ni;
+  more_queued = (NULL != queue->head_ni);
+  if (! more_queued) {
+    queue->tail_ni = NULL;
+  }
+  txn->next_ni = NULL;
+  txn->result = transaction_length;
+  rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  if (txn->callback_ni) {
+    rv = txn->callback_ni(txn);
+  }
+  /* A submission from the callback to an empty queue has already
+   * been started. */
+  if (more_queued) {
+    spi_queue_start_ni(queue);
+  }
+  return rv;
+}
+
+hBSP430spiQueue
+hBSP430spiQueueInitialize (sBSP430spiQueue * queue,
+                           hBSP430halSERIAL spi)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+
+  if (NULL == spi) {
+    return NULL;
+  }
+  memset(queue, 0, sizeof(*queue));
+  queue->rx_cb.callback = spi_queue_rx_ni;
+  queue->tx_cb.callback = spi_queue_tx_ni;
+  queue->spi = spi;
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  iBSP430serialSetHold_ni(spi, 1);
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, spi->rx_cbchain_ni, queue->rx_cb, next_ni);
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, spi->tx_cbchain_ni, queue->tx_cb, next_ni);
+  iBSP430serialSetHold_ni(spi, 0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return queue;
+}
+
+int
+iBSP430spiQueueRelease (hBSP430spiQueue queue)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430halSERIAL spi = queue->spi;
+  int rv = -1;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (NULL == queue->head_ni) {
+    iBSP430serialSetHold_ni(spi, 1);
+    BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, spi->tx_cbchain_ni, queue->tx_cb, next_ni);
+    BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, spi->rx_cbchain_ni, queue->rx_cb, next_ni);
+    iBSP430serialSetHold_ni(spi, 0);
+    rv = 0;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430spiQueueSubmit_ni (hBSP430spiQueue queue,
+                          hBSP430spiTransaction txn)
+{
+  if (0 == (txn->tx_len + txn->rx_len)) {
+    return -1;
+  }
+  txn->next_ni = NULL;
+  txn->result = -1;
+  if (queue->tail_ni) {
+    queue->tail_ni->next_ni = txn;
+    queue->tail_ni = txn;
+  } else {
+    queue->head_ni = queue->tail_ni = txn;
+    spi_queue_start_ni(queue);
+  }
+  return 0;
+}
+
+#if configBSP430_SERIAL_SPI_BUS - 0
+
+hBSP430spiBus
+hBSP430spiBusInitialize (sBSP430spiBus * bus,
+                         hBSP430halSERIAL spi)
+{
+  if (NULL == spi) {
+    return NULL;
+  }
+  memset(bus, 0, sizeof(*bus));
+  bus->spi = spi;
+  return bus;
+}
+
+hBSP430spiBusDevice
+hBSP430spiBusDeviceRegister (hBSP430spiBus bus,
+                             sBSP430spiBusDevice * dev,
+                             unsigned char ctl0_byte,
+                             unsigned char ctl1_byte,
+                             unsigned int prescaler,
+                             hBSP430halPORT cs_port,
+                             unsigned char cs_bit)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+
+  if (0 == prescaler) {
+    return NULL;
+  }
+  dev->bus = bus;
+  dev->ctl0_byte = ctl0_byte;
+  dev->ctl1_byte = ctl1_byte;
+  dev->prescaler = prescaler;
+  dev->cs_port = cs_port;
+  dev->cs_bit = cs_bit;
+  if (cs_port) {
+    /* Deassert before driving so the device never sees a glitch */
+    BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_PORT_HAL_HPL_OUT(cs_port) |= cs_bit;
+    BSP430_PORT_HAL_HPL_SEL(cs_port) &= ~cs_bit;
+    BSP430_PORT_HAL_HPL_DIR(cs_port) |= cs_bit;
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  }
+  return dev;
+}
+
+int
+iBSP430spiBusSelect_ni (hBSP430spiBusDevice dev)
+{
+  hBSP430spiBus bus = dev->bus;
+  hBSP430spiBusDevice configured = bus->configured;
+
+  if (bus->owner_ni) {
+    return (dev == bus->owner_ni) ? 0 : -1;
+  }
+  if (dev != configured) {
+    /* Prefer an in-place update of the differing registers; fall back
+     * to a full open (which also configures the pins) when the
+     * peripheral is closed or the change requires different pins. */
+    if ((NULL == configured)
+        || (0 != iBSP430spiReconfigure_ni(bus->spi, dev->ctl0_byte, dev->ctl1_byte, dev->prescaler))) {
+      if (configured) {
+        (void)iBSP430serialClose(bus->spi);
+        bus->configured = NULL;
+      }
+      if (NULL == hBSP430serialOpenSPI(bus->spi, dev->ctl0_byte, dev->ctl1_byte, dev->prescaler)) {
+        return -1;
+      }
+    }
+    bus->configured = dev;
+  }
+  if (dev->cs_port) {
+    BSP430_PORT_HAL_HPL_OUT(dev->cs_port) &= ~dev->cs_bit;
+  }
+  bus->owner_ni = dev;
+  return 0;
+}
+
+int
+iBSP430spiBusDeselect_ni (hBSP430spiBusDevice dev)
+{
+  hBSP430spiBus bus = dev->bus;
+
+  if (dev != bus->owner_ni) {
+    return -1;
+  }
+  vBSP430serialFlush_ni(bus->spi);
+  if (dev->cs_port) {
+    BSP430_PORT_HAL_HPL_OUT(dev->cs_port) |= dev->cs_bit;
+  }
+  bus->owner_ni = NULL;
+  return 0;
+}
+
+int
+iBSP430spiBusClose (hBSP430spiBus bus)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  int rv = 0;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (bus->owner_ni) {
+    rv = -1;
+  } else if (bus->configured) {
+    rv = iBSP430serialClose(bus->spi);
+    bus->configured = NULL;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
+#endif /* configBSP430_SERIAL_ENABLE_SPI */
+
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+
+#define I2C_QUEUE_FROM_ALARM(alarm_) ((sBSP430i2cQueue *)((char *)(alarm_) - offsetof(sBSP430i2cQueue, alarm)))
+
+/* Start the transaction at the head of the queue.  If the device
+ * is not ready the start is deferred, to be retried by the alarm or
+ * by iBSP430i2cQueueIdle_ni().  A transaction that timed out while
+ * being started is completed immediately. */
+static void
+i2c_queue_start_ni (sBSP430i2cQueue * queue)
+{
+  hBSP430i2cTransaction txn = queue->head_ni;
+  int rc;
+
+  if (NULL == txn) {
+    return;
+  }
+  queue->idx = 0;
+#if BSP430_UPTIME - 0
+  if (! queue->deferred) {
+    queue->deadline_utt = ulBSP430uptime_ni() + txn->timeout_utt;
+  }
+#endif /* BSP430_UPTIME */
+  rc = queue->i2c->dispatch->i2cQueueStart_ni(queue->i2c, txn);
+  if (BSP430_I2C_RESULT_TIMEOUT == rc) {
+    (void)iBSP430i2cQueueComplete_ni(queue->i2c, rc);
+    return;
+  }
+  queue->deferred = (0 != rc);
+#if BSP430_UPTIME - 0
+  if (queue->alarm_h) {
+    if (queue->deferred) {
+      (void)iBSP430timerAlarmSet_ni(queue->alarm_h, ulBSP430uptime_ni() + BSP430_I2C_QUEUE_RETRY_UTT);
+    } else if (0 != txn->timeout_utt) {
+      (void)iBSP430timerAlarmSet_ni(queue->alarm_h, queue->deadline_utt);
+    }
+  }
+#endif /* BSP430_UPTIME */
+}
+
+#if BSP430_UPTIME - 0
+static int
+i2c_queue_alarm_ni (hBSP430timerAlarm alarm)
+{
+  sBSP430i2cQueue * queue = I2C_QUEUE_FROM_ALARM(alarm);
+  hBSP430i2cTransaction txn = queue->head_ni;
+  hBSP430halSERIAL i2c = queue->i2c;
+
+  if (NULL == txn) {
+    return 0;
+  }
+  if (queue->deferred
+      && ((0 == txn->timeout_utt)
+          || (0 < (long)(queue->deadline_utt - ulBSP430uptime_ni())))) {
+    i2c_queue_start_ni(queue);
+    return 0;
+  }
+  i2c->dispatch->i2cQueueAbort_ni(i2c);
+  return iBSP430i2cQueueComplete_ni(i2c, BSP430_I2C_RESULT_TIMEOUT);
+}
+#endif /* BSP430_UPTIME */
+
+int
+iBSP430i2cQueueComplete_ni (hBSP430halSERIAL hal,
+                            int result)
+{
+  sBSP430i2cQueue * queue = hal->i2c_queue_ni;
+  hBSP430i2cTransaction txn;
+  int more_queued;
+  int rv;
+
+  if ((NULL == queue) || (NULL == queue->head_ni)) {
+    return 0;
+  }
+  txn = queue->head_ni;
+  queue->deferred = 0;
+  if (queue->alarm_h && (BSP430_TIMER_ALARM_FLAG_SET & queue->alarm_h->flags)) {
+    (void)iBSP430timerAlarmCancel_ni(queue->alarm_h);
+  }
+  queue->head_ni = txn->next_ni;
+  more_queued = (NULL != queue->head_ni);
+  if (! more_queued) {
+    queue->tail_ni = NULL;
+  }
+  txn->next_ni = NULL;
+  txn->result = result;
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+  if (BSP430_I2C_RESULT_NACK == result) {
+    ++hal->errors.nack;
+  } else if (BSP430_I2C_RESULT_ARBITRATION_LOST == result) {
+    ++hal->errors.arbitration_lost;
+  }
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+  rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  if (txn->callback_ni) {
+    rv = txn->callback_ni(txn);
+  }
+  /* A submission from the callback to an empty queue has already
+   * been started. */
+  if (more_queued) {
+    i2c_queue_start_ni(queue);
+  }
+  return rv;
+}
+
+hBSP430i2cQueue
+hBSP430i2cQueueInitialize (sBSP430i2cQueue * queue,
+                           hBSP430halSERIAL i2c,
+                           int alarm_ccidx)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430i2cQueue rv = NULL;
+
+  if ((NULL == i2c) || (NULL == i2c->dispatch->i2cQueueStart_ni)) {
+    return NULL;
+  }
+  memset(queue, 0, sizeof(*queue));
+  queue->i2c = i2c;
+  if (0 <= alarm_ccidx) {
+#if BSP430_UPTIME - 0
+    queue->alarm_h = hBSP430timerAlarmInitialize(&queue->alarm, BSP430_UPTIME_TIMER_PERIPH_HANDLE, alarm_ccidx, i2c_queue_alarm_ni);
+#endif /* BSP430_UPTIME */
+    if (NULL == queue->alarm_h) {
+      return NULL;
+    }
+  }
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if ((NULL == i2c->i2c_queue_ni)
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+      && (NULL == i2c->i2c_slave_ni)
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+     ) {
+    if (queue->alarm_h) {
+      (void)iBSP430timerAlarmSetEnabled_ni(queue->alarm_h, 1);
+    }
+    i2c->i2c_queue_ni = queue;
+    rv = queue;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430i2cQueueRelease (hBSP430i2cQueue queue)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  int rv = -1;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (NULL == queue->head_ni) {
+    if (queue->alarm_h) {
+      (void)iBSP430timerAlarmSetEnabled_ni(queue->alarm_h, 0);
+    }
+    queue->i2c->i2c_queue_ni = NULL;
+    rv = 0;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430i2cQueueSubmit_ni (hBSP430i2cQueue queue,
+                          hBSP430i2cTransaction txn)
+{
+  if ((0 == (txn->tx_len + txn->rx_len))
+      || ((0 < txn->tx_len) && (NULL == txn->tx_data))
+      || ((0 < txn->rx_len) && (NULL == txn->rx_data))
+      || (255 < txn->tx_len)
+      || (255 < txn->rx_len)) {
+    return -1;
+  }
+  txn->next_ni = NULL;
+  txn->result = -1;
+  if (queue->tail_ni) {
+    queue->tail_ni->next_ni = txn;
+    queue->tail_ni = txn;
+  } else {
+    queue->head_ni = queue->tail_ni = txn;
+    i2c_queue_start_ni(queue);
+  }
+  return 0;
+}
+
+int
+iBSP430i2cQueueIdle_ni (hBSP430i2cQueue queue)
+{
+  if (queue->deferred && (NULL == queue->alarm_h)) {
+    i2c_queue_start_ni(queue);
+  }
+  return NULL == queue->head_ni;
+}
+
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+
+#if configBSP430_SERIAL_I2C_SLAVE - 0
+
+/* The next octet written by the master sets the register pointer */
+#define I2C_SLAVE_FLAG_POINTER 0x01
+/* An octet has been loaded for transmission since the last start or
+ * stop.  The master ends a read by not acknowledging the last octet
+ * it wants, so the octet loaded after that one is never sent. */
+#define I2C_SLAVE_FLAG_TX_LOADED 0x02
+/* The prefetched octet does not reflect the register pointer */
+#define I2C_SLAVE_FLAG_STALE 0x04
+
+static uint8_t
+i2c_slave_fetch_ni (sBSP430i2cSlave * slave)
+{
+  int rv = -1;
+
+  if (slave->read_cb_ni) {
+    rv = slave->read_cb_ni(slave, slave->reg);
+  }
+  if (0 > rv) {
+    rv = (slave->reg < slave->nregs) ? slave->regs[slave->reg] : 0xFF;
+  }
+  return rv;
+}
+
+static void
+i2c_slave_increment_ni (sBSP430i2cSlave * slave)
+{
+  ++slave->reg;
+  if ((0 < slave->nregs) ? (slave->nregs <= slave->reg) : (255 < slave->reg)) {
+    slave->reg = 0;
+  }
+}
+
+/* Return the pointer to the octet that was loaded but not read, so
+ * the next read begins with it. */
+static void
+i2c_slave_rewind_ni (sBSP430i2cSlave * slave)
+{
+  if (slave->flags & I2C_SLAVE_FLAG_TX_LOADED) {
+    slave->reg = slave->tx_reg;
+    slave->tx_next = slave->tx_prev;
+    slave->flags &= ~I2C_SLAVE_FLAG_TX_LOADED;
+  }
+}
+
+void
+vBSP430i2cSlaveStart_ni (sBSP430i2cSlave * slave,
+                         int transmitp)
+{
+  i2c_slave_rewind_ni(slave);
+  if (transmitp) {
+    if (slave->flags & I2C_SLAVE_FLAG_STALE) {
+      slave->tx_next = i2c_slave_fetch_ni(slave);
+      slave->flags &= ~I2C_SLAVE_FLAG_STALE;
+    }
+  } else {
+    slave->flags |= I2C_SLAVE_FLAG_POINTER;
+  }
+}
+
+int
+iBSP430i2cSlaveRx_ni (sBSP430i2cSlave * slave,
+                      uint8_t octet)
+{
+  int rv = 0;
+
+  if (slave->flags & I2C_SLAVE_FLAG_POINTER) {
+    /* Prefetch now so a read following a repeated start is ready
+     * before the master addresses the slave. */
+    slave->flags &= ~(I2C_SLAVE_FLAG_POINTER | I2C_SLAVE_FLAG_STALE);
+    slave->reg = slave->first_reg = octet;
+    slave->tx_next = i2c_slave_fetch_ni(slave);
+    return 0;
+  }
+  if (slave->write_cb_ni) {
+    rv = slave->write_cb_ni(slave, slave->reg, octet);
+  }
+  if (0 > rv) {
+    rv = 0;
+  } else if (slave->reg < slave->nregs) {
+    slave->regs[slave->reg] = octet;
+  }
+  ++slave->num_written;
+  i2c_slave_increment_ni(slave);
+  slave->flags |= I2C_SLAVE_FLAG_STALE;
+  return rv;
+}
+
+void
+vBSP430i2cSlaveTxNext_ni (sBSP430i2cSlave * slave)
+{
+  slave->tx_reg = slave->reg;
+  slave->tx_prev = slave->tx_next;
+  slave->flags |= I2C_SLAVE_FLAG_TX_LOADED;
+  i2c_slave_increment_ni(slave);
+  slave->tx_next = i2c_slave_fetch_ni(slave);
+}
+
+int
+iBSP430i2cSlaveStop_ni (sBSP430i2cSlave * slave)
+{
+  unsigned int num_written = slave->num_written;
+  int rv = 0;
+
+  i2c_slave_rewind_ni(slave);
+  slave->flags &= ~I2C_SLAVE_FLAG_POINTER;
+  slave->num_written = 0;
+  if (slave->stop_cb_ni) {
+    rv = slave->stop_cb_ni(slave, slave->first_reg, num_written);
+  }
+  return rv;
+}
+
+hBSP430i2cSlave
+hBSP430i2cSlaveInitialize (sBSP430i2cSlave * slave,
+                           hBSP430halSERIAL i2c,
+                           uint8_t * regs,
+                           unsigned int nregs,
+                           iBSP430i2cSlaveReadCallback_ni read_cb_ni,
+                           iBSP430i2cSlaveWriteCallback_ni write_cb_ni,
+                           iBSP430i2cSlaveStopCallback_ni stop_cb_ni)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430i2cSlave rv = NULL;
+
+  if ((NULL == i2c) || (NULL == i2c->dispatch->i2cSlaveEnable_ni)) {
+    return NULL;
+  }
+  memset(slave, 0, sizeof(*slave));
+  slave->i2c = i2c;
+  slave->regs = regs;
+  slave->nregs = nregs;
+  slave->read_cb_ni = read_cb_ni;
+  slave->write_cb_ni = write_cb_ni;
+  slave->stop_cb_ni = stop_cb_ni;
+  slave->flags = I2C_SLAVE_FLAG_STALE;
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if ((NULL == i2c->i2c_slave_ni)
+#if configBSP430_SERIAL_I2C_USE_ISR - 0
+      && (NULL == i2c->i2c_queue_ni)
+#endif /* configBSP430_SERIAL_I2C_USE_ISR */
+     ) {
+    i2c->i2c_slave_ni = slave;
+    if (0 == i2c->dispatch->i2cSlaveEnable_ni(i2c, 1)) {
+      rv = slave;
+    } else {
+      i2c->i2c_slave_ni = NULL;
+    }
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430i2cSlaveRelease (hBSP430i2cSlave slave)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430halSERIAL i2c = slave->i2c;
+  int rv = -1;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (slave == i2c->i2c_slave_ni) {
+    (void)i2c->dispatch->i2cSlaveEnable_ni(i2c, 0);
+    i2c->i2c_slave_ni = NULL;
+    rv = 0;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+#endif /* configBSP430_SERIAL_I2C_SLAVE */
+
+#if configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0
+#include <bsp430/periph/dma.h>
+
+#define HAL_FROM_TX_DMA_CB(cb_) ((hBSP430halSERIAL)((char *)(cb_) - offsetof(sBSP430halSERIAL, tx_dma_cb)))
+
+static int
+tx_block_dma_complete_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                          void * context,
+                          int idx)
+{
+  hBSP430halSERIAL hal = HAL_FROM_TX_DMA_CB(cb);
+  hBSP430halDMA dma = (hBSP430halDMA)context;
+
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[idx], hal->tx_dma_cb, next_ni);
+  (void)iBSP430dmaChannelRelease_ni(dma, idx);
+  hal->num_tx += hal->tx_block_len;
+  hal->tx_block += hal->tx_block_len;
+  hal->tx_block_len = 0;
+  /* The transmit interrupt fires when the last octet leaves the
+   * buffer, and asks the producer for more. */
+  vBSP430serialWakeupTransmit_ni(hal);
+  return BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
+}
+
+int
+iBSP430serialTxBlockDMA_ni (hBSP430halSERIAL hal)
+{
+  hBSP430halDMA dma = BSP430_HAL_DMA;
+  volatile void * txbufp;
+  int tx_tsel;
+  int ch;
+
+  if (NULL == hal->dispatch->dmaTarget_ni) {
+    return -1;
+  }
+  tx_tsel = hal->dispatch->dmaTarget_ni(hal, NULL, &txbufp);
+  if (0 > tx_tsel) {
+    return -1;
+  }
+  ++tx_tsel;
+  ch = iBSP430dmaChannelAllocate_ni(dma, -1);
+  if (0 > ch) {
+    return -1;
+  }
+  hal->tx_dma_cb.callback = tx_block_dma_complete_ni;
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[ch], hal->tx_dma_cb, next_ni);
+  /* The caller writes the first octet; the TXIFG edge when it moves
+   * to the shift register triggers the channel for the rest. */
+  --hal->tx_block_len;
+  ++hal->num_tx;
+  (void)iBSP430dmaChannelConfigure_ni(dma, ch, tx_tsel,
+                                      DMADT_0 | DMASRCINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAIE,
+                                      hal->tx_block + 1, txbufp, hal->tx_block_len);
+  (void)iBSP430dmaChannelEnable_ni(dma, ch);
+  return *hal->tx_block++;
+}
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+
+#if configBSP430_SERIAL_UART_RX_USE_DMA - 0
+#include <bsp430/periph/dma.h>
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+
+#define RX_RING_FROM_DMA_CB(cb_) ((sBSP430uartRxRing *)((char *)(cb_) - offsetof(sBSP430uartRxRing, dma_cb)))
+#define RX_RING_FROM_ALARM(alarm_) ((sBSP430uartRxRing *)((char *)(alarm_) - offsetof(sBSP430uartRxRing, alarm)))
+
+/* Offset in the ring at which the channel will store the next
+ * octet. */
+static unsigned int
+rx_ring_head_ni (sBSP430uartRxRing * ring)
+{
+  volatile sBSP430hplDMAChannel * chp = BSP430_HAL_DMA->hpl->ch + ring->channel;
+  unsigned int half = ring->size / 2;
+  unsigned int base;
+  unsigned int ifg;
+  unsigned int sz;
+
+  /* A completed half whose interrupt has not yet been serviced has
+   * already been reloaded to fill the other half.  Re-read if the
+   * completion occurs while sampling. */
+  do {
+    ifg = DMAIFG & chp->ctl;
+    sz = chp->sz;
+  } while (ifg != (DMAIFG & chp->ctl));
+  base = ring->second_half ? half : 0;
+  if (ifg) {
+    base = half - base;
+  }
+  return (base + half - sz) % ring->size;
+}
+
+static int
+rx_ring_dma_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                void * context,
+                int idx)
+{
+  sBSP430uartRxRing * ring = RX_RING_FROM_DMA_CB(cb);
+  hBSP430halDMA dma = (hBSP430halDMA)context;
+  unsigned int half = ring->size / 2;
+  unsigned int completed;
+  int events;
+
+  /* The channel has reloaded and is filling the other half; point
+   * the following reload back at the half that just completed. */
+  if (ring->second_half) {
+    events = BSP430_UART_RX_RING_EVENT_FULL;
+    completed = half;
+  } else {
+    events = BSP430_UART_RX_RING_EVENT_HALF;
+    completed = 0;
+  }
+  vBSP430dmaChannelSetReloadDestination_ni(dma, idx, ring->buffer + completed);
+  ring->second_half = ! ring->second_half;
+  ring->uart->num_rx += half;
+
+  /* A full ring unread means the channel has caught up with the
+   * reader and overwritten octets it had not consumed.  Keep only the
+   * half just completed and resume reading at its start. */
+  ring->unread += half;
+  if (ring->unread >= (int)ring->size) {
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+    ring->uart->errors.rx_dropped += ring->unread - half;
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+    ring->unread = half;
+    ring->tail = completed;
+    events |= BSP430_UART_RX_RING_EVENT_OVERRUN;
+  }
+  return BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN | ring->callback_ni(ring, events);
+}
+
+#if BSP430_UPTIME - 0
+static int
+rx_ring_idle_ni (hBSP430timerAlarm alarm)
+{
+  sBSP430uartRxRing * ring = RX_RING_FROM_ALARM(alarm);
+  unsigned int head = rx_ring_head_ni(ring);
+  int rv = 0;
+
+  if (head != ring->idle_mark) {
+    ring->idle_mark = head;
+    ring->idle_reported = 0;
+  } else if ((! ring->idle_reported) && (head != ring->tail)) {
+    ring->idle_reported = 1;
+    rv = ring->callback_ni(ring, BSP430_UART_RX_RING_EVENT_IDLE);
+  }
+  if (0 != iBSP430timerAlarmSet_ni(alarm, alarm->setting_tck + ring->idle_utt)) {
+    /* Sampling fell behind; resynchronize to the current time */
+    (void)iBSP430timerAlarmSet_ni(alarm, ulBSP430uptime_ni() + ring->idle_utt);
+  }
+  return rv;
+}
+#endif /* BSP430_UPTIME */
+
+hBSP430uartRxRing
+hBSP430uartRxRingInitialize (sBSP430uartRxRing * ring,
+                             hBSP430halSERIAL uart,
+                             uint8_t * buffer,
+                             unsigned int size,
+                             iBSP430uartRxRingCallback_ni callback_ni,
+                             int alarm_ccidx,
+                             unsigned long idle_utt)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430halDMA dma = BSP430_HAL_DMA;
+  hBSP430uartRxRing rv = NULL;
+  const volatile void * rxbufp;
+  int rx_tsel;
+
+  if ((NULL == uart) || (NULL == buffer) || (NULL == callback_ni)
+      || (2 > size) || (size & 1)
+      || (NULL == uart->dispatch->dmaTarget_ni)) {
+    return NULL;
+  }
+  memset(ring, 0, sizeof(*ring));
+  ring->uart = uart;
+  ring->buffer = buffer;
+  ring->size = size;
+  ring->callback_ni = callback_ni;
+  ring->dma_cb.callback = rx_ring_dma_ni;
+  ring->idle_utt = idle_utt;
+  if (0 <= alarm_ccidx) {
+#if BSP430_UPTIME - 0
+    ring->alarm_h = hBSP430timerAlarmInitialize(&ring->alarm, BSP430_UPTIME_TIMER_PERIPH_HANDLE, alarm_ccidx, rx_ring_idle_ni);
+#endif /* BSP430_UPTIME */
+    if ((NULL == ring->alarm_h) || (0 == idle_utt)) {
+      return NULL;
+    }
+  }
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    if (uart->rx_cbchain_ni) {
+      break;
+    }
+    rx_tsel = uart->dispatch->dmaTarget_ni(uart, &rxbufp, NULL);
+    if (0 > rx_tsel) {
+      break;
+    }
+    ring->channel = iBSP430dmaChannelAllocate_ni(dma, -1);
+    if (0 > ring->channel) {
+      break;
+    }
+    BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[ring->channel], ring->dma_cb, next_ni);
+    (void)iBSP430dmaChannelConfigure_ni(dma, ring->channel, rx_tsel,
+                                        DMADT_4 | DMADSTINCR_3 | DMASRCBYTE | DMADSTBYTE | DMAIE,
+                                        rxbufp, buffer, size / 2);
+    /* Triggers are edge-sensitive: discard any stale octet so the
+     * next reception raises RXIFG. */
+    (void)*(const volatile uint8_t *)rxbufp;
+    (void)iBSP430dmaChannelEnable_ni(dma, ring->channel);
+    /* The first half is now latched; the first reload fills the
+     * second. */
+    vBSP430dmaChannelSetReloadDestination_ni(dma, ring->channel, buffer + size / 2);
+#if BSP430_UPTIME - 0
+    if (ring->alarm_h) {
+      (void)iBSP430timerAlarmSetEnabled_ni(ring->alarm_h, 1);
+      (void)iBSP430timerAlarmSet_ni(ring->alarm_h, ulBSP430uptime_ni() + idle_utt);
+    }
+#endif /* BSP430_UPTIME */
+    rv = ring;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430uartRxRingRelease (hBSP430uartRxRing ring)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430halDMA dma = BSP430_HAL_DMA;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (ring->alarm_h) {
+    (void)iBSP430timerAlarmSetEnabled_ni(ring->alarm_h, 0);
+  }
+  (void)iBSP430dmaChannelDisable_ni(dma, ring->channel);
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, dma->ch_cbchain_ni[ring->channel], ring->dma_cb, next_ni);
+  (void)iBSP430dmaChannelRelease_ni(dma, ring->channel);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return 0;
+}
+
+int
+iBSP430uartRxRingAvailable_ni (hBSP430uartRxRing ring)
+{
+  unsigned int head = rx_ring_head_ni(ring);
+
+  return (head >= ring->tail) ? (head - ring->tail) : (ring->size + head - ring->tail);
+}
+
+int
+iBSP430uartRxRingRead_ni (hBSP430uartRxRing ring,
+                          uint8_t * dst,
+                          size_t len)
+{
+  size_t available = iBSP430uartRxRingAvailable_ni(ring);
+  size_t rv = 0;
+
+  if (len > available) {
+    len = available;
+  }
+  while (rv < len) {
+    size_t run = ring->size - ring->tail;
+
+    if (run > (len - rv)) {
+      run = len - rv;
+    }
+    memcpy(dst + rv, ring->buffer + ring->tail, run);
+    rv += run;
+    ring->tail = (ring->tail + run) % ring->size;
+  }
+  ring->unread -= rv;
   return rv;
 }
+#endif /* configBSP430_SERIAL_UART_RX_USE_DMA */
@@ -0,0 +1,201 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of automatic UART baud rate detection
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/utility/autobaud.h>
+
+static const unsigned long standard_baud[] = {
+  1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400,
+};
+
+unsigned long
+ulBSP430autobaudBitTicksQ16 (const unsigned int * edge_tck,
+                             unsigned int nedges)
+{
+  unsigned int min_tck = 0;
+  unsigned long bit_tck_q16;
+  unsigned int i;
+
+  /* The shortest pulse is one bit */
+  for (i = 1; i < nedges; ++i) {
+    unsigned int delta_tck = edge_tck[i] - edge_tck[i-1];
+
+    if ((0 < delta_tck) && ((0 == min_tck) || (delta_tck < min_tck))) {
+      min_tck = delta_tck;
+    }
+  }
+  if (0 == min_tck) {
+    return 0;
+  }
+
+  /* Refine the estimate with each edge of the first character,
+   * counting the bits to the edge with the estimate so far.  Rounding
+   * the shortest pulse alone can be off by most of a tick, which
+   * over nine bits may miscount. */
+  bit_tck_q16 = (unsigned long)min_tck << 16;
+  for (i = 1; i < nedges; ++i) {
+    unsigned long delta_tck_q16 = (unsigned long)(unsigned int)(edge_tck[i] - edge_tck[0]) << 16;
+    unsigned int nbits = (delta_tck_q16 + bit_tck_q16 / 2) / bit_tck_q16;
+
+    /* The last edge of a character starts the stop bit, nine bits
+     * after the start edge */
+    if (9 < nbits) {
+      break;
+    }
+    if (0 < nbits) {
+      bit_tck_q16 = (delta_tck_q16 + nbits / 2) / nbits;
+    }
+  }
+  return bit_tck_q16;
+}
+
+unsigned long
+ulBSP430autobaudBaud (unsigned long bit_tck_q16,
+                      unsigned long clock_Hz)
+{
+  /* Divide in two steps with 8 fractional bits, so nothing
+   * overflows for bit times up to 65535 ticks. */
+  unsigned long bit_tck_q8 = bit_tck_q16 >> 8;
+  unsigned long baud;
+  int i;
+
+  if (0 == bit_tck_q8) {
+    return 0;
+  }
+  baud = ((clock_Hz / bit_tck_q8) << 8)
+    + ((((clock_Hz % bit_tck_q8) << 8) + bit_tck_q8 / 2) / bit_tck_q8);
+  for (i = 0; i < sizeof(standard_baud) / sizeof(*standard_baud); ++i) {
+    unsigned long delta = (baud > standard_baud[i]) ? (baud - standard_baud[i]) : (standard_baud[i] - baud);
+
+    if ((1000 * delta) <= (BSP430_AUTOBAUD_SNAP_PPT * standard_baud[i])) {
+      return standard_baud[i];
+    }
+  }
+  return baud;
+}
+
+unsigned long
+ulBSP430autobaudMeasure_ni (tBSP430periphHandle periph,
+                            int ccidx,
+                            unsigned int ccis,
+                            unsigned long timeout_tck)
+{
+  volatile sBSP430hplTIMER * tp = xBSP430hplLookupTIMER(periph);
+  unsigned int edge_tck[BSP430_AUTOBAUD_MAX_EDGES];
+  unsigned int nedges = 0;
+  unsigned int min_tck = 0;
+  unsigned int last_tck;
+  unsigned long quiet_tck = 0;
+  unsigned long limit_tck = timeout_tck;
+  unsigned long clock_Hz;
+
+  /* Fail if timer is unrecognized, stopped, or of unknown rate */
+  if ((NULL == tp)
+      || (0 == (tp->ctl & (MC0 | MC1)))) {
+    return 0;
+  }
+  clock_Hz = ulBSP430timerFrequency_Hz_ni(periph);
+  if ((0 == clock_Hz) || ((unsigned long)-1 == clock_Hz)) {
+    return 0;
+  }
+  ccis &= CCIS0 | CCIS1;
+
+  /* Synchronous capture on the falling edge of the start bit, then on
+   * every edge. */
+  tp->cctl[ccidx] = CM_2 | ccis | CAP | SCS;
+  last_tck = tp->r;
+  while (nedges < BSP430_AUTOBAUD_MAX_EDGES) {
+    while (! (tp->cctl[ccidx] & CCIFG)) {
+      unsigned int now_tck = tp->r;
+
+      quiet_tck += (unsigned int)(now_tck - last_tck);
+      last_tck = now_tck;
+      if ((0 != limit_tck) && (quiet_tck >= limit_tck)) {
+        break;
+      }
+      BSP430_CORE_WATCHDOG_CLEAR();
+    }
+    if (! (tp->cctl[ccidx] & CCIFG)) {
+      break;
+    }
+    if (tp->cctl[ccidx] & COV) {
+      /* An edge arrived before the previous one was read */
+      nedges = 0;
+      break;
+    }
+    edge_tck[nedges] = tp->ccr[ccidx];
+    if (0 == nedges) {
+      tp->cctl[ccidx] = CM_3 | ccis | CAP | SCS;
+    } else {
+      unsigned int delta_tck = edge_tck[nedges] - edge_tck[nedges-1];
+
+      tp->cctl[ccidx] &= ~CCIFG;
+      if ((0 == min_tck) || (delta_tck < min_tck)) {
+        min_tck = delta_tck;
+        limit_tck = 10UL * min_tck;
+      }
+    }
+    ++nedges;
+    last_tck = tp->r;
+    quiet_tck = (unsigned int)(last_tck - edge_tck[nedges-1]);
+  }
+  tp->cctl[ccidx] = 0;
+  return ulBSP430autobaudBaud(ulBSP430autobaudBitTicksQ16(edge_tck, nedges), clock_Hz);
+}
+
+hBSP430halSERIAL
+hBSP430autobaudOpenUART (hBSP430halSERIAL hal,
+                         unsigned char ctl0_byte,
+                         unsigned char ctl1_byte,
+                         tBSP430periphHandle periph,
+                         int ccidx,
+                         unsigned int ccis,
+                         unsigned long timeout_tck)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  unsigned long baud;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  baud = ulBSP430autobaudMeasure_ni(periph, ccidx, ccis, timeout_tck);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  if (0 == baud) {
+    return NULL;
+  }
+  return hBSP430serialOpenUART(hal, ctl0_byte, ctl1_byte, baud);
+}
@@ -0,0 +1,104 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of deferred binary logging
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/utility/binlog.h>
+#include <bsp430/utility/framing.h>
+#include <bsp430/utility/console.h>
+#if BSP430_UPTIME - 0
+#include <bsp430/utility/uptime.h>
+#endif /* BSP430_UPTIME */
+#include <string.h>
+
+#define RECORD_MAX (BSP430_BINLOG_HEADER_LENGTH + BSP430_BINLOG_ARGS_MAX)
+
+static unsigned int dropped_;
+
+int
+iBSP430binlogRecord (const char * fmt,
+                     const void * args,
+                     size_t len)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  uint8_t record[RECORD_MAX];
+  uint8_t frame[BSP430_FRAMING_ENCODED_MAX(RECORD_MAX)];
+  uint16_t id = (uint16_t)(uintptr_t)fmt;
+  unsigned long timestamp = 0;
+  int flen;
+  int rv;
+
+  /* Records are little-endian, as is the MCU */
+  memcpy(record, &id, sizeof(id));
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+#if BSP430_UPTIME - 0
+  timestamp = ulBSP430uptime_ni();
+#endif /* BSP430_UPTIME */
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  memcpy(record + sizeof(id), &timestamp, sizeof(uint32_t));
+  if (BSP430_BINLOG_ARGS_MAX < len) {
+    len = BSP430_BINLOG_ARGS_MAX;
+  }
+  if (0 < len) {
+    memcpy(record + BSP430_BINLOG_HEADER_LENGTH, args, len);
+  }
+
+  /* Encode with interrupts enabled; only the enqueue is atomic, so
+   * concurrent records do not interleave. */
+  flen = iBSP430framingEncode(BSP430_FRAMING_MODE_SLIP, record, BSP430_BINLOG_HEADER_LENGTH + len, frame, sizeof(frame));
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = -1;
+  if (0 < flen) {
+    rv = iBSP430consoleTransmitBlock_ni(frame, flen);
+  }
+  if (0 > rv) {
+    ++dropped_;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return (0 > rv) ? -1 : 0;
+}
+
+unsigned int
+uiBSP430binlogDropped_ni (int reset)
+{
+  unsigned int rv = dropped_;
+  if (reset) {
+    dropped_ = 0;
+  }
+  return rv;
+}
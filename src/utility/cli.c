@@ -141,6 +141,97 @@ xBSP430cliNextQToken (const char * * commandp,
   return rv;
 }
 
+#if configBSP430_CLI_COMMAND_INDEX - 0
+static const sBSP430cliCommandIndex * commandIndex_;
+static unsigned int commandIndexLen_;
+
+/* The position of the first command in the index whose key is not
+ * less than the first len characters of key.  Truncating keys
+ * preserves their order, so the commands having the token as a prefix
+ * follow contiguously. */
+static unsigned int
+indexLowerBound_ (const sBSP430cliCommandIndex * ip,
+                  const char * key,
+                  size_t len)
+{
+  unsigned int lo = 0;
+  unsigned int hi = ip->count;
+
+  while (lo < hi) {
+    unsigned int mid = lo + (hi - lo) / 2;
+
+    if (0 > strncmp(ip->sorted[mid]->key, key, len)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static const sBSP430cliCommandIndex *
+findIndex_ (const sBSP430cliCommand * cmds)
+{
+  unsigned int i;
+
+  for (i = 0; i < commandIndexLen_; ++i) {
+    if (cmds == commandIndex_[i].command_set) {
+      return commandIndex_ + i;
+    }
+  }
+  return NULL;
+}
+
+/* Verify that every command in the chain is present at the position
+ * its key selects, the keys strictly increase, and nothing else is
+ * present. */
+static int
+indexIsValid_ (const sBSP430cliCommandIndex * ip)
+{
+  const sBSP430cliCommand * cmd;
+  unsigned int nchain = 0;
+  unsigned int i;
+
+  if ((NULL == ip->command_set) || (NULL == ip->sorted)) {
+    return 0;
+  }
+  for (i = 1; i < ip->count; ++i) {
+    if (0 <= strcmp(ip->sorted[i-1]->key, ip->sorted[i]->key)) {
+      return 0;
+    }
+  }
+  for (cmd = ip->command_set; cmd; cmd = cmd->next) {
+    i = indexLowerBound_(ip, cmd->key, strlen(cmd->key) + 1);
+    if ((i >= ip->count) || (cmd != ip->sorted[i])) {
+      return 0;
+    }
+    ++nchain;
+  }
+  return nchain == ip->count;
+}
+
+int
+iBSP430cliSetCommandIndex (const sBSP430cliCommandIndex * indexes,
+                           unsigned int len)
+{
+  unsigned int i;
+
+  commandIndex_ = NULL;
+  commandIndexLen_ = 0;
+  if (NULL == indexes) {
+    return 0;
+  }
+  for (i = 0; i < len; ++i) {
+    if (! indexIsValid_(indexes + i)) {
+      return -1;
+    }
+  }
+  commandIndex_ = indexes;
+  commandIndexLen_ = len;
+  return 0;
+}
+#endif /* configBSP430_CLI_COMMAND_INDEX */
+
 int
 iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
                         const char * command,
@@ -163,6 +254,33 @@ iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
     *argstr_lenp = command_len;
   }
   nmatches = 0;
+#if configBSP430_CLI_COMMAND_INDEX - 0
+  if (0 < len) {
+    const sBSP430cliCommandIndex * ip = findIndex_(cmds);
+
+    if (NULL != ip) {
+      unsigned int lo = indexLowerBound_(ip, key, len);
+      unsigned int hi = lo;
+
+      while ((hi < ip->count) && (0 == strncmp(ip->sorted[hi]->key, key, len))) {
+        ++hi;
+      }
+      nmatches = hi - lo;
+      if (0 < nmatches) {
+        match = ip->sorted[lo];
+      }
+      if ((0 == match_callback) || (1 >= nmatches)) {
+        if ((0 != match_callback) && (0 < nmatches)) {
+          match_callback->callback(match_callback, match);
+        }
+        cmds = NULL;
+      } else {
+        /* Let the walk below present the matches in chain order */
+        nmatches = 0;
+      }
+    }
+  }
+#endif /* configBSP430_CLI_COMMAND_INDEX */
   while (cmds) {
     if (0 == strncmp(key, cmds->key, len)) {
       ++nmatches;
@@ -530,6 +648,9 @@ iBSP430cliConsoleBufferExtend_ni (const char * text,
 int
 iBSP430cliConsoleBufferProcessInput_ni ()
 {
+  /* In line mode the console has already echoed printable
+   * characters */
+  int line_mode = iBSP430consoleRxLineMode_ni();
   int rv;
   int c;
 
@@ -567,20 +688,28 @@ iBSP430cliConsoleBufferProcessInput_ni ()
       *cbEnd_ = 0;
     } else if (KEY_KILL_WORD == c) {
       char * kp = cbEnd_;
-      while (--kp > consoleBuffer_ && isspace(*kp)) {
+      while (kp > consoleBuffer_ && isspace(kp[-1])) {
+        --kp;
       }
-      while (--kp > consoleBuffer_ && !isspace(*kp)) {
+      while (kp > consoleBuffer_ && !isspace(kp[-1])) {
+        --kp;
       }
-      ++kp;
       cprintf("\e[%uD\e[K", (unsigned int)(cbEnd_ - kp));
       cbEnd_ = kp;
       *cbEnd_ = 0;
     } else {
+      int echoed = line_mode && (' ' <= c) && (0x7f > c);
+
       if ((1+cbEnd_) >= (consoleBuffer_ + sizeof(consoleBuffer_))) {
+        if (echoed) {
+          cputtext_ni("\b \b");
+        }
         cputchar_ni(KEY_BEL);
       } else {
         *cbEnd_++ = c;
-        cputchar_ni(c);
+        if (! echoed) {
+          cputchar_ni(c);
+        }
       }
     }
   }
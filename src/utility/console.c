@@ -39,9 +39,13 @@
 
 #include <bsp430/platform.h>
 #include <bsp430/utility/console.h>
+#include <bsp430/utility/ring.h>
+#include <bsp430/utility/format.h>
+#include <bsp430/periph/port.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if BSP430_CONSOLE - 0
 
@@ -49,80 +53,321 @@
 
 static hBSP430halSERIAL console_hal_;
 
+#if (configBSP430_CONSOLE_USE_RTS - 0) && ! (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
+#error configBSP430_CONSOLE_USE_RTS requires BSP430_CONSOLE_RX_BUFFER_SIZE
+#endif /* validate configBSP430_CONSOLE_USE_RTS */
+
+#if configBSP430_CONSOLE_USE_CTS - 0
+static hBSP430halPORT cts_port_;
+
+/* CTS is active low */
+#define CONSOLE_CTS_ASSERTED() (! (BSP430_PORT_HAL_HPL_IN(cts_port_) & BSP430_CONSOLE_CTS_PORT_BIT))
+#else /* configBSP430_CONSOLE_USE_CTS */
+#define CONSOLE_CTS_ASSERTED() 1
+#endif /* configBSP430_CONSOLE_USE_CTS */
+
+#if configBSP430_CONSOLE_USE_RTS - 0
+static hBSP430halPORT rts_port_;
+
+/* RTS is active low */
+#define CONSOLE_RTS_ASSERT_NI() do {                                    \
+    BSP430_PORT_HAL_HPL_OUT(rts_port_) &= ~BSP430_CONSOLE_RTS_PORT_BIT; \
+  } while (0)
+#define CONSOLE_RTS_DEASSERT_NI() do {                                  \
+    BSP430_PORT_HAL_HPL_OUT(rts_port_) |= BSP430_CONSOLE_RTS_PORT_BIT;  \
+  } while (0)
+#endif /* configBSP430_CONSOLE_USE_RTS */
+
+/* Each buffer is a ring using the narrowest indexes that cover its
+ * size.  RING_FN_(w_, pfx_, op_) names the ring operation op_ with
+ * return-type prefix pfx_ for index width w_. */
+#define RING_FN_(w_, pfx_, op_) RING_FN2_(w_, pfx_, op_)
+#define RING_FN2_(w_, pfx_, op_) pfx_##BSP430ring##w_##op_
+#define RING_T_(w_) RING_T2_(w_)
+#define RING_T2_(w_) sBSP430ring##w_
+#define RING_INDEX_T_(w_) RING_INDEX_T2_(w_)
+#define RING_INDEX_T2_(w_) uint##w_##_t
+
 #if BSP430_CONSOLE_RX_BUFFER_SIZE - 0
-#if 254 < (BSP430_CONSOLE_RX_BUFFER_SIZE)
-#error BSP430_CONSOLE_RX_BUFFER_SIZE is too large
+#if ! BSP430_RING_SIZE_IS_VALID(BSP430_CONSOLE_RX_BUFFER_SIZE, 16)
+#error BSP430_CONSOLE_RX_BUFFER_SIZE must be a power of two no larger than 32768
 #endif /* validate BSP430_CONSOLE_RX_BUFFER_SIZE */
 
+#if BSP430_RING_SIZE_IS_VALID(BSP430_CONSOLE_RX_BUFFER_SIZE, 8)
+#define RX_RING_W 8
+#else /* RX ring width */
+#define RX_RING_W 16
+#endif /* RX ring width */
+#define RX_RING_FN(pfx_, op_) RING_FN_(RX_RING_W, pfx_, op_)
+
 typedef struct sConsoleRxBuffer {
   sBSP430halISRVoidChainNode cb_node;
-  char buffer[BSP430_CONSOLE_RX_BUFFER_SIZE];
-  volatile unsigned char head;
-  volatile unsigned char tail;
+  RING_T_(RX_RING_W) ring;
+#if configBSP430_CONSOLE_RX_LINE_MODE - 0
+  /* Nonzero when assembling lines */
+  unsigned char line_mode;
+  /* Zero outside an escape sequence, 1 after ESC, 2 within a control
+   * sequence */
+  unsigned char esc_state;
+  /* Nonzero if the text after edit_head is the whole of the current
+   * line: nothing has been passed through or read since the last
+   * line terminator */
+  unsigned char line_fresh;
+  /* Ring head after the last octet passed through unechoed.  The
+   * unread octets after it are echoed text that may be edited. */
+  RING_INDEX_T_(RX_RING_W) edit_head;
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
 } sConsoleRxBuffer;
 
+#if configBSP430_CONSOLE_RX_LINE_MODE - 0
+
+#define KEY_BS '\b'
+#define KEY_LF '\n'
+#define KEY_CR '\r'
+#define KEY_BEL '\a'
+#define KEY_ESC '\e'
+#define KEY_CSI '['
+#define KEY_KILL_LINE 0x15
+#define KEY_KILL_WORD 0x17
+
+/* Characters echoed and edited by the interrupt */
+#define KEY_IS_PRINTABLE(c_) ((' ' <= (c_)) && (0x7f > (c_)))
+
+/* Echo from the receive interrupt.  Discarded if the transmit buffer
+ * has no room. */
+static void
+console_rx_echo_ni (const char * text,
+                    size_t len)
+{
+  (void)iBSP430consoleTransmitBlock_ni((const uint8_t *)text, len);
+}
+
+/* Erase the last n echoed characters from the display */
+static void
+console_rx_echo_erase_ni (unsigned int n)
+{
+  char seq[sizeof("\e[32768D\e[K")];
+  char digits[5];
+  char * sp = seq;
+  int nd = 0;
+
+  do {
+    digits[nd++] = '0' + (n % 10);
+    n /= 10;
+  } while (0 != n);
+  *sp++ = KEY_ESC;
+  *sp++ = KEY_CSI;
+  while (0 < nd) {
+    *sp++ = digits[--nd];
+  }
+  *sp++ = 'D';
+  *sp++ = KEY_ESC;
+  *sp++ = KEY_CSI;
+  *sp++ = 'K';
+  console_rx_echo_ni(seq, sp - seq);
+}
+
+/* Discard an octet that does not fit.  Overwriting the oldest input
+ * would corrupt the line, so the newest is lost instead. */
+static int
+console_rx_reject_ni (sBSP430halSERIAL * hal)
+{
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+  ++hal->errors.rx_dropped;
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+  console_rx_echo_ni("\a", 1);
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+/* Handle a received octet in line mode.  Returns the callback flags
+ * for the interrupt. */
+static int
+console_rx_line_ni (sConsoleRxBuffer * bufp,
+                    sBSP430halSERIAL * hal)
+{
+  RING_T_(RX_RING_W) * rp = &bufp->ring;
+  uint8_t c = hal->rx_byte;
+  unsigned int count = RX_RING_FN(ui, Count)(rp);
+  unsigned int editable = (RING_INDEX_T_(RX_RING_W))(rp->head - bufp->edit_head);
+
+  if (editable > count) {
+    /* The application has read some of the echoed text */
+    editable = count;
+    bufp->edit_head = rp->head - count;
+    bufp->line_fresh = 0;
+  }
+  if (0 != bufp->esc_state) {
+    /* Pass the sequence through unechoed, waking at its end */
+    if (0 > RX_RING_FN(i, PutOctet)(rp, c)) {
+      return console_rx_reject_ni(hal);
+    }
+    bufp->edit_head = rp->head;
+    if ((1 == bufp->esc_state) && (KEY_CSI == c)) {
+      bufp->esc_state = 2;
+      return 0;
+    }
+    if ((2 == bufp->esc_state) && ! ((64 <= c) && (c <= 126))) {
+      return 0;
+    }
+    bufp->esc_state = 0;
+    return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  }
+  if (KEY_IS_PRINTABLE(c)) {
+    if (0 > RX_RING_FN(i, PutOctet)(rp, c)) {
+      return console_rx_reject_ni(hal);
+    }
+    console_rx_echo_ni((const char *)&c, 1);
+    /* Let the application make room */
+    return (0 == RX_RING_FN(ui, Space)(rp)) ? BSP430_HAL_ISR_CALLBACK_EXIT_LPM : 0;
+  }
+  if ((KEY_BS == c) || (KEY_KILL_LINE == c) || (KEY_KILL_WORD == c)) {
+    unsigned int n = editable;
+
+    if ((0 == editable) && bufp->line_fresh) {
+      /* Nothing to erase */
+      console_rx_echo_ni("\a", 1);
+      return 0;
+    }
+    if (KEY_BS == c) {
+      n = (0 < editable);
+    } else if (KEY_KILL_WORD == c) {
+      /* Trailing spaces and the word before them */
+      n = 0;
+      while ((n < editable) && (' ' == rp->buffer[(rp->head - n - 1) & rp->mask])) {
+        ++n;
+      }
+      while ((n < editable) && (' ' != rp->buffer[(rp->head - n - 1) & rp->mask])) {
+        ++n;
+      }
+    }
+    /* Apply the edit here unless it reaches into text that has been
+     * passed through or read, which only the application has */
+    if ((0 < n) && ((n < editable) || bufp->line_fresh || (KEY_BS == c))) {
+      RX_RING_FN(v, Withdraw)(rp, n);
+      if (KEY_BS == c) {
+        console_rx_echo_ni("\b \b", 3);
+      } else {
+        console_rx_echo_erase_ni(n);
+      }
+      return 0;
+    }
+  }
+  /* Pass anything else to the application and wake it */
+  if (0 > RX_RING_FN(i, PutOctet)(rp, c)) {
+    return console_rx_reject_ni(hal);
+  }
+  bufp->edit_head = rp->head;
+  bufp->line_fresh = (KEY_CR == c) || (KEY_LF == c);
+  if (KEY_ESC == c) {
+    bufp->esc_state = 1;
+  }
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+
 static int
 console_rx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
                    void * context)
 {
   sConsoleRxBuffer * bufp = (sConsoleRxBuffer *)cb;
   sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
-  unsigned char head = bufp->head;
-
-  bufp->buffer[head] = hal->rx_byte;
-  head = (head + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
-  if (head == bufp->tail) {
-    bufp->tail = (bufp->tail + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+  int rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+
+#if configBSP430_CONSOLE_RX_LINE_MODE - 0
+  if (bufp->line_mode) {
+    rv = console_rx_line_ni(bufp, hal);
+  } else
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+  if (0 > RX_RING_FN(i, PutOctet)(&bufp->ring, hal->rx_byte)) {
+    /* Full: discard the oldest octet.  The consumer runs with
+     * interrupts disabled, so it cannot be using it. */
+    RX_RING_FN(v, Release)(&bufp->ring, 1);
+    (void)RX_RING_FN(i, PutOctet)(&bufp->ring, hal->rx_byte);
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+    ++hal->errors.rx_dropped;
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
   }
-  bufp->head = head;
-  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+#if configBSP430_CONSOLE_USE_RTS - 0
+  if (BSP430_CONSOLE_RTS_STOP_AVAILABLE >= RX_RING_FN(ui, Space)(&bufp->ring)) {
+    CONSOLE_RTS_DEASSERT_NI();
+  }
+#endif /* configBSP430_CONSOLE_USE_RTS */
+  return rv;
 }
 
+static uint8_t rx_storage_[BSP430_CONSOLE_RX_BUFFER_SIZE];
+
 static sConsoleRxBuffer rx_buffer_ = {
   .cb_node = { .callback = console_rx_isr_ni },
+  .ring = BSP430_RING_INITIALIZER(rx_storage_),
 };
 
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 #if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
-#if 254 < (BSP430_CONSOLE_TX_BUFFER_SIZE)
-#error BSP430_CONSOLE_TX_BUFFER_SIZE is too large
+#if ! BSP430_RING_SIZE_IS_VALID(BSP430_CONSOLE_TX_BUFFER_SIZE, 16)
+#error BSP430_CONSOLE_TX_BUFFER_SIZE must be a power of two no larger than 32768
 #endif /* validate BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+#if BSP430_RING_SIZE_IS_VALID(BSP430_CONSOLE_TX_BUFFER_SIZE, 8)
+#define TX_RING_W 8
+#else /* TX ring width */
+#define TX_RING_W 16
+#endif /* TX ring width */
+#define TX_RING_FN(pfx_, op_) RING_FN_(TX_RING_W, pfx_, op_)
+
 typedef struct sConsoleTxBuffer {
   sBSP430halISRVoidChainNode cb_node;
-  char buffer[BSP430_CONSOLE_TX_BUFFER_SIZE];
-  volatile unsigned char head;
-  volatile unsigned char tail;
+  RING_T_(TX_RING_W) ring;
+  /* Length of the block at the start of the ring that has been handed
+   * to the HAL for transmission.  Its space is released when the HAL
+   * next invokes the callback. */
+  unsigned int block_len;
   volatile int wake_available;
+  /* BSP430_CONSOLE_TX_POLICY_* applied when the buffer is full */
+  unsigned char policy;
+  /* Octets have been discarded and the marker has yet to be queued */
+  unsigned char marker_pending;
+  /* The marker occupies the start of the buffer and has not been
+   * handed to the HAL */
+  unsigned char marker_at_tail;
+  unsigned int dropped;
 } sConsoleTxBuffer;
 
-/* Calculate the number of bytes available in the buffer given the
- * head and tail indexes. */
-#define TX_BUFFER_AVAILABLE_(bp_,h_,t_) (((h_) >= (t_))                 \
-                                         ? (sizeof((bp_)->buffer) + (t_) - (h_) - 1) \
-                                         : ((t_) - (h_) - 1))
-
 static int
 console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
                    void * context)
 {
   sConsoleTxBuffer * bufp = (sConsoleTxBuffer *)cb;
   sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
-  unsigned char tail = bufp->tail;
-  unsigned char head = bufp->head;
   int wake_available;
   int rv = 0;
 
-  /* If there's data available here, store it and mark that we have
-   * done so. */
-  if (head != tail) {
-    hal->tx_byte = bufp->buffer[tail];
-    rv |= BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
-    bufp->tail = tail = (tail + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+  /* Being called means the previous block has been drained; release
+   * its space. */
+  if (0 != bufp->block_len) {
+    TX_RING_FN(v, Release)(&bufp->ring, bufp->block_len);
+    bufp->block_len = 0;
+  }
+  /* If there's data available here, hand the HAL the contiguous run
+   * up to the head or the end of the buffer, whichever comes
+   * first.  While the peer is not clear to receive nothing is handed
+   * over; the CTS interrupt wakes transmission when it is. */
+  if (CONSOLE_CTS_ASSERTED()) {
+    size_t len;
+    const uint8_t * bp = TX_RING_FN(x, Peek)(&bufp->ring, &len);
+
+    if (0 != len) {
+      bufp->block_len = len;
+      hal->tx_block = bp;
+      hal->tx_block_len = len;
+      bufp->marker_at_tail = 0;
+      rv |= BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
+    }
   }
   wake_available = bufp->wake_available;
-  if (head == tail) {
+  if (0 == TX_RING_FN(ui, Count)(&bufp->ring)) {
     /* Ran out of data.  Turn off the interrupt infrastructure. */
     rv |= BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
     /* If somebody wants to know when there's space available, well,
@@ -133,9 +378,7 @@ console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
       rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
     }
   } else if (0 < wake_available) {
-    int available = TX_BUFFER_AVAILABLE_(bufp, head, tail);
-
-    if (available >= wake_available) {
+    if (TX_RING_FN(ui, Space)(&bufp->ring) >= wake_available) {
       bufp->wake_available = 0;
       rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
     }
@@ -143,19 +386,206 @@ console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
   return rv;
 }
 
+static uint8_t tx_storage_[BSP430_CONSOLE_TX_BUFFER_SIZE];
+
 static sConsoleTxBuffer tx_buffer_ = {
   .cb_node = { .callback = console_tx_isr_ni },
+  .ring = BSP430_RING_INITIALIZER(tx_storage_),
 };
 
+static const char tx_drop_marker_[] = BSP430_CONSOLE_TX_DROP_MARKER;
+
+#define TX_DROP_MARKER_LEN (sizeof(tx_drop_marker_) - 1)
+
+/* Copy n octets into the buffer.  The caller has verified they
+ * fit. */
+static void
+tx_buffer_store_ni (hBSP430halSERIAL uart,
+                    sConsoleTxBuffer * bufp,
+                    const char * src,
+                    size_t n)
+{
+  int was_empty = (0 == TX_RING_FN(ui, Count)(&bufp->ring));
+
+  (void)TX_RING_FN(x, Put)(&bufp->ring, (const uint8_t *)src, n);
+  if (was_empty) {
+    vBSP430serialWakeupTransmit_ni(uart);
+  }
+}
+
+static void
+tx_count_dropped_ni (sConsoleTxBuffer * bufp,
+                     unsigned int n)
+{
+  unsigned int dropped = bufp->dropped + n;
+
+  bufp->dropped = (dropped < n) ? (unsigned int)-1 : dropped;
+}
+
+/* Make room for one octet by discarding the oldest octet not yet
+ * transmitted, leaving the drop marker at the start of the buffer.
+ * Returns -1 if the queued data cannot be discarded. */
+static int
+tx_discard_oldest_ni (hBSP430halSERIAL uart,
+                      sConsoleTxBuffer * bufp)
+{
+  RING_T_(TX_RING_W) * rp = &bufp->ring;
+  unsigned int i;
+
+#if ! (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)
+  if (0 != bufp->block_len) {
+    /* Release what the HAL has sent and take back the rest.  The
+     * next transmit interrupt asks for a new block. */
+    TX_RING_FN(v, Release)(rp, bufp->block_len - uart->tx_block_len);
+    bufp->block_len = 0;
+    uart->tx_block_len = 0;
+  }
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+  if ((0 != bufp->block_len)
+      || (TX_DROP_MARKER_LEN >= TX_RING_FN(ui, Count)(rp))) {
+    return -1;
+  }
+  /* Interrupts are disabled, so the producer may act as consumer */
+  TX_RING_FN(v, Release)(rp, 1);
+  /* A marker already at the start moves forward over one octet;
+   * otherwise the discarded octet and those the marker overwrites are
+   * lost. */
+  tx_count_dropped_ni(bufp, bufp->marker_at_tail ? 1 : (1 + TX_DROP_MARKER_LEN));
+  for (i = 0; i < TX_DROP_MARKER_LEN; ++i) {
+    rp->buffer[(rp->tail + i) & rp->mask] = tx_drop_marker_[i];
+  }
+  bufp->marker_at_tail = 0 < TX_DROP_MARKER_LEN;
+  bufp->marker_pending = 0;
+  return 0;
+}
+
 int
 console_tx_queue_ni (hBSP430halSERIAL uart, uint8_t c)
 {
   sConsoleTxBuffer * bufp = &tx_buffer_;
 
   while (1) {
-    unsigned char head = bufp->head;
-    unsigned char next_head = (head + 1) % (sizeof(bufp->buffer)/sizeof(*bufp->buffer));
-    if (next_head == bufp->tail) {
+    if ((! bufp->marker_pending)
+        && (0 <= TX_RING_FN(i, PutOctet)(&bufp->ring, c))) {
+      if (1 == TX_RING_FN(ui, Count)(&bufp->ring)) {
+        vBSP430serialWakeupTransmit_ni(uart);
+      }
+      break;
+    }
+    /* Octets were discarded: mark the spot once there is room for the
+     * marker and this octet. */
+    if (bufp->marker_pending
+        && (TX_RING_FN(ui, Space)(&bufp->ring) > TX_DROP_MARKER_LEN)) {
+      bufp->marker_pending = 0;
+      tx_buffer_store_ni(uart, bufp, tx_drop_marker_, TX_DROP_MARKER_LEN);
+      continue;
+    }
+    if ((BSP430_CONSOLE_TX_POLICY_DROP_OLDEST == bufp->policy)
+        && (0 == tx_discard_oldest_ni(uart, bufp))) {
+      continue;
+    }
+    if (BSP430_CONSOLE_TX_POLICY_BLOCK != bufp->policy) {
+      tx_count_dropped_ni(bufp, 1);
+      bufp->marker_pending = 1;
+      break;
+    }
+    if (0 == bufp->wake_available) {
+      bufp->wake_available = 1;
+    }
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits | GIE);
+    BSP430_CORE_DISABLE_INTERRUPT();
+  }
+  return c;
+}
+
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+
+#if configBSP430_CONSOLE_USE_CTS - 0
+/* Polled transmission holds each octet until the peer is clear to
+ * receive it. */
+static int
+console_tx_polled_ni (hBSP430halSERIAL uart, uint8_t c)
+{
+  while (! CONSOLE_CTS_ASSERTED()) {
+    ;
+  }
+  return iBSP430uartTxByte_ni(uart, c);
+}
+
+#define CONSOLE_TX_POLLED_NI console_tx_polled_ni
+
+static int
+console_cts_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                    void * context,
+                    int idx)
+{
+  volatile sBSP430hplPORTIE * hpl = BSP430_PORT_HAL_GET_HPL_PORTIE(cts_port_);
+  int asserted;
+
+  /* Arm for the opposite edge.  If the line changed while doing so
+   * the flag may not have been set, so look again. */
+  do {
+    asserted = CONSOLE_CTS_ASSERTED();
+    if (asserted) {
+      hpl->ies &= ~BSP430_CONSOLE_CTS_PORT_BIT;
+    } else {
+      hpl->ies |= BSP430_CONSOLE_CTS_PORT_BIT;
+    }
+    hpl->ifg &= ~BSP430_CONSOLE_CTS_PORT_BIT;
+  } while (asserted != CONSOLE_CTS_ASSERTED());
+
+#if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
+  if (NULL != console_hal_) {
+    if (! asserted) {
+#if ! (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)
+      /* Take back the part of the block the HAL has not yet sent.
+       * The callback releases only what was transmitted, and will
+       * not hand out more until CTS is asserted. */
+      if (0 != tx_buffer_.block_len) {
+        tx_buffer_.block_len -= console_hal_->tx_block_len;
+        console_hal_->tx_block_len = 0;
+      }
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
+    } else if (0 != TX_RING_FN(ui, Count)(&tx_buffer_.ring)) {
+      vBSP430serialWakeupTransmit_ni(console_hal_);
+    }
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  return 0;
+}
+
+static sBSP430halISRIndexedChainNode cts_cb_ = {
+  .callback = console_cts_isr_ni,
+};
+
+#else /* configBSP430_CONSOLE_USE_CTS */
+
+#define CONSOLE_TX_POLLED_NI iBSP430uartTxByte_ni
+
+#endif /* configBSP430_CONSOLE_USE_CTS */
+
+#if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
+
+/* Copy a block into the transmit buffer, applying the transmit policy
+ * as console_tx_queue_ni() does. */
+static void
+console_tx_queue_block_ni (hBSP430halSERIAL uart,
+                           const char * src,
+                           size_t len)
+{
+  sConsoleTxBuffer * bufp = &tx_buffer_;
+
+  while (0 < len) {
+    size_t n = TX_RING_FN(ui, Space)(&bufp->ring);
+
+    if (bufp->marker_pending
+        || ((0 == n) && (BSP430_CONSOLE_TX_POLICY_BLOCK != bufp->policy))) {
+      /* Let the octet path place the marker or apply the policy */
+      (void)console_tx_queue_ni(uart, *src++);
+      --len;
+      continue;
+    }
+    if (0 == n) {
       if (0 == bufp->wake_available) {
         bufp->wake_available = 1;
       }
@@ -163,14 +593,13 @@ console_tx_queue_ni (hBSP430halSERIAL uart, uint8_t c)
       BSP430_CORE_DISABLE_INTERRUPT();
       continue;
     }
-    bufp->buffer[head] = c;
-    bufp->head = next_head;
-    if (head == bufp->tail) {
-      vBSP430serialWakeupTransmit_ni(uart);
+    if (n > len) {
+      n = len;
     }
-    break;
+    tx_buffer_store_ni(uart, bufp, src, n);
+    src += n;
+    len -= n;
   }
-  return c;
 }
 
 static int (* uartTransmit_ni) (hBSP430halSERIAL uart, uint8_t c);
@@ -179,10 +608,59 @@ static int (* uartTransmit_ni) (hBSP430halSERIAL uart, uint8_t c);
 
 #else /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
-#define UART_TRANSMIT(uart_, c_) iBSP430uartTxByte_ni(uart_, c_)
+#define UART_TRANSMIT(uart_, c_) CONSOLE_TX_POLLED_NI(uart_, c_)
 
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+#if configBSP430_CONSOLE_SINKS - 0
+/* Registered sinks, most recently added first */
+static hBSP430consoleSink volatile sinks_ni_;
+
+/* Severity of the text being emitted */
+static int output_level_ = BSP430_CONSOLE_LEVEL_DEFAULT;
+
+/* Least severe text transmitted on the console UART */
+static unsigned char uart_threshold_ = BSP430_CONSOLE_LEVEL_DEBUG;
+
+/* Deliver text to each sink that accepts its level */
+static void
+sinks_write_ni (const uint8_t * data,
+                size_t len)
+{
+  hBSP430consoleSink sp = sinks_ni_;
+
+  while (sp) {
+    if (output_level_ <= sp->threshold) {
+      sp->write_ni(sp, data, len);
+    }
+    sp = sp->next_ni;
+  }
+}
+
+/* Send one octet of text to the UART and the sinks that accept it */
+static int
+emit_octet_ni (hBSP430halSERIAL uart,
+               uint8_t c)
+{
+  int rv = c;
+
+  if (output_level_ <= uart_threshold_) {
+    rv = UART_TRANSMIT(uart, c);
+  }
+  if (NULL != sinks_ni_) {
+    sinks_write_ni(&c, 1);
+  }
+  return rv;
+}
+
+#define EMIT_OCTET(uart_, c_) emit_octet_ni(uart_, c_)
+
+#else /* configBSP430_CONSOLE_SINKS */
+
+#define EMIT_OCTET(uart_, c_) UART_TRANSMIT(uart_, c_)
+
+#endif /* configBSP430_CONSOLE_SINKS */
+
 /* Optimized version used inline.  Assumes that the uart is not
  * null. */
 static
@@ -192,10 +670,10 @@ emit_char2_ni (int c, hBSP430halSERIAL uart)
 {
 #if configBSP430_CONSOLE_USE_ONLCR - 0
   if ('\n' == c) {
-    UART_TRANSMIT(uart, '\r');
+    EMIT_OCTET(uart, '\r');
   }
 #endif /* configBSP430_CONSOLE_USE_ONLCR */
-  return UART_TRANSMIT(uart, c);
+  return EMIT_OCTET(uart, c);
 }
 
 /* Base version used by cprintf.  This has to re-read the console_hal_
@@ -265,43 +743,172 @@ cputtext_ni (const char * s)
   return emit_text_ni(s, console_hal_);
 }
 
-#if configBSP430_CONSOLE_LIBC_HAS_ITOA - 0
+#if ! ((configBSP430_CONSOLE_LIBC_HAS_ITOA - 0)        \
+       && (configBSP430_CONSOLE_LIBC_HAS_UTOA - 0)      \
+       && (configBSP430_CONSOLE_LIBC_HAS_LTOA - 0)      \
+       && (configBSP430_CONSOLE_LIBC_HAS_ULTOA - 0))
+/* Emit n without sign in the given radix.  Decimal and hexadecimal
+ * avoid division; other radices are rare enough to divide. */
+static int
+emit_radix_ni (unsigned long n,
+               int radix)
+{
+  char buffer[sizeof(unsigned long) * 8 + 1];
+  char * bp;
+
+  if (10 == radix) {
+    (void)uiBSP430formatUnsigned(buffer, n, 0);
+    return emit_text_ni(buffer, console_hal_);
+  }
+  if (16 == radix) {
+    (void)uiBSP430formatHex(buffer, n, 0);
+    return emit_text_ni(buffer, console_hal_);
+  }
+  if ((2 > radix) || (36 < radix)) {
+    return 0;
+  }
+  bp = buffer + sizeof(buffer);
+  *--bp = 0;
+  do {
+    unsigned int d = n % radix;
+
+    *--bp = d + ((10 > d) ? '0' : ('a' - 10));
+    n /= radix;
+  } while (n);
+  return emit_text_ni(bp, console_hal_);
+}
+#endif /* any libc integer conversion missing */
+
+#if ! ((configBSP430_CONSOLE_LIBC_HAS_ITOA - 0) && (configBSP430_CONSOLE_LIBC_HAS_LTOA - 0))
+static int
+emit_signed_ni (long n,
+                unsigned long un,
+                int radix)
+{
+  char buffer[BSP430_FORMAT_BUFFER_SIZE];
+
+  if (10 != radix) {
+    return emit_radix_ni(un, radix);
+  }
+  (void)uiBSP430formatSigned(buffer, n, 0);
+  return emit_text_ni(buffer, console_hal_);
+}
+#endif /* libc signed conversion missing */
+
 int
 cputi_ni (int n, int radix)
 {
+#if configBSP430_CONSOLE_LIBC_HAS_ITOA - 0
   char buffer[sizeof("-32767")];
   return emit_text_ni(itoa(n, buffer, radix), console_hal_);
-}
+#else /* configBSP430_CONSOLE_LIBC_HAS_ITOA */
+  return emit_signed_ni(n, (unsigned int)n, radix);
 #endif /* configBSP430_CONSOLE_LIBC_HAS_ITOA */
+}
 
-#if configBSP430_CONSOLE_LIBC_HAS_UTOA - 0
 int
 cputu_ni (unsigned int n, int radix)
 {
+#if configBSP430_CONSOLE_LIBC_HAS_UTOA - 0
   char buffer[sizeof("65535")];
   return emit_text_ni(utoa(n, buffer, radix), console_hal_);
-}
+#else /* configBSP430_CONSOLE_LIBC_HAS_UTOA */
+  return emit_radix_ni(n, radix);
 #endif /* configBSP430_CONSOLE_LIBC_HAS_UTOA */
+}
 
-#if configBSP430_CONSOLE_LIBC_HAS_LTOA - 0
 int
 cputl_ni (long n, int radix)
 {
+#if configBSP430_CONSOLE_LIBC_HAS_LTOA - 0
   char buffer[sizeof("-2147483647")];
   return emit_text_ni(ltoa(n, buffer, radix), console_hal_);
-}
+#else /* configBSP430_CONSOLE_LIBC_HAS_LTOA */
+  return emit_signed_ni(n, (unsigned long)n, radix);
 #endif /* configBSP430_CONSOLE_LIBC_HAS_LTOA */
+}
 
-#if configBSP430_CONSOLE_LIBC_HAS_ULTOA - 0
 int
 cputul_ni (unsigned long n, int radix)
 {
+#if configBSP430_CONSOLE_LIBC_HAS_ULTOA - 0
   char buffer[sizeof("4294967295")];
   return emit_text_ni(ultoa(n, buffer, radix), console_hal_);
-}
+#else /* configBSP430_CONSOLE_LIBC_HAS_ULTOA */
+  return emit_radix_ni(n, radix);
 #endif /* configBSP430_CONSOLE_LIBC_HAS_ULTOA */
+}
 
 #if configBSP430_CONSOLE_LIBC_HAS_VUPRINTF - 0
+
+#if BSP430_CONSOLE_FORMAT_BUFFER_SIZE - 0
+typedef struct sConsoleFormatBuffer {
+  char buffer[BSP430_CONSOLE_FORMAT_BUFFER_SIZE];
+  unsigned int len;
+  /* Set while a vcprintf() owns the buffer */
+  volatile unsigned char busy;
+} sConsoleFormatBuffer;
+
+static sConsoleFormatBuffer format_buffer_;
+
+/* Emit the formatted text with interrupts disabled, then empty the
+ * buffer. */
+static void
+format_flush (void)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  const char * sp = format_buffer_.buffer;
+  const char * const spe = sp + format_buffer_.len;
+  hBSP430halSERIAL uart;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  uart = console_hal_;
+  if (uart) {
+#if configBSP430_CONSOLE_SINKS - 0
+    if (NULL != sinks_ni_) {
+      sinks_write_ni((const uint8_t *)sp, spe - sp);
+    }
+    if (output_level_ > uart_threshold_) {
+      sp = spe;
+    }
+#endif /* configBSP430_CONSOLE_SINKS */
+#if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
+    if (console_tx_queue_ni == uartTransmit_ni) {
+      console_tx_queue_block_ni(uart, sp, spe - sp);
+      sp = spe;
+    }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+    while (sp < spe) {
+      UART_TRANSMIT(uart, *sp++);
+    }
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  format_buffer_.len = 0;
+}
+
+static void
+format_store (char c)
+{
+  if ((sizeof(format_buffer_.buffer) / sizeof(*format_buffer_.buffer)) == format_buffer_.len) {
+    format_flush();
+  }
+  format_buffer_.buffer[format_buffer_.len++] = c;
+}
+
+static int
+format_char (int c)
+{
+#if configBSP430_CONSOLE_USE_ONLCR - 0
+  if ('\n' == c) {
+    format_store('\r');
+  }
+#endif /* configBSP430_CONSOLE_USE_ONLCR */
+  format_store(c);
+  return c;
+}
+#endif /* BSP430_CONSOLE_FORMAT_BUFFER_SIZE */
+
 int
 #if __GNUC__ - 0
 __attribute__((__format__(printf, 1, 2)))
@@ -328,11 +935,78 @@ vcprintf (const char * fmt, va_list ap)
   }
   BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
   BSP430_CORE_DISABLE_INTERRUPT();
+#if BSP430_CONSOLE_FORMAT_BUFFER_SIZE - 0
+  if (! format_buffer_.busy) {
+    /* Format with interrupts as the caller had them; only the copy
+     * out disables them. */
+    format_buffer_.busy = 1;
+    format_buffer_.len = 0;
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    rv = vuprintf(format_char, fmt, ap);
+    if (0 != format_buffer_.len) {
+      format_flush();
+    }
+    format_buffer_.busy = 0;
+    return rv;
+  }
+  /* Buffer in use by the call we interrupted: emit directly */
+#endif /* BSP430_CONSOLE_FORMAT_BUFFER_SIZE */
   rv = vuprintf(emit_char_ni, fmt, ap);
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
   return rv;
 }
 
+int
+#if __GNUC__ - 0
+__attribute__((__format__(printf, 2, 3)))
+#endif /* __GNUC__ */
+clprintf (int level,
+          const char *fmt, ...)
+{
+  int rv;
+  va_list argp;
+  va_start(argp, fmt);
+  rv = vclprintf(level, fmt, argp);
+  va_end(argp);
+  return rv;
+}
+
+int
+vclprintf (int level,
+           const char * fmt,
+           va_list ap)
+{
+#if configBSP430_CONSOLE_SINKS - 0
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  hBSP430consoleSink sp;
+  int saved_level;
+  int accepted;
+  int rv;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  /* Don't format text nobody will receive */
+  accepted = (level <= uart_threshold_);
+  for (sp = sinks_ni_; (! accepted) && (NULL != sp); sp = sp->next_ni) {
+    accepted = (level <= sp->threshold);
+  }
+  if (! accepted) {
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    return 0;
+  }
+  saved_level = output_level_;
+  output_level_ = level;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  rv = vcprintf(fmt, ap);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  output_level_ = saved_level;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+#else /* configBSP430_CONSOLE_SINKS */
+  return vcprintf(fmt, ap);
+#endif /* configBSP430_CONSOLE_SINKS */
+}
+
 #endif /* configBSP430_CONSOLE_LIBC_HAS_VUPRINTF */
 
 hBSP430halSERIAL
@@ -346,13 +1020,18 @@ hBSP430console (void)
 static int
 console_getchar_ (int do_pop)
 {
-  int rv = -1;
-  if (rx_buffer_.head != rx_buffer_.tail) {
-    rv = rx_buffer_.buffer[rx_buffer_.tail];
-    if (do_pop) {
-      rx_buffer_.tail = (rx_buffer_.tail + 1) & ((sizeof(rx_buffer_.buffer) / sizeof(*rx_buffer_.buffer)) - 1);
-    }
+  int rv;
+
+  if (! do_pop) {
+    return RX_RING_FN(i, PeekOctet)(&rx_buffer_.ring);
+  }
+  rv = RX_RING_FN(i, GetOctet)(&rx_buffer_.ring);
+#if configBSP430_CONSOLE_USE_RTS - 0
+  if ((0 <= rv)
+      && (BSP430_CONSOLE_RTS_RESUME_AVAILABLE <= RX_RING_FN(ui, Space)(&rx_buffer_.ring))) {
+    CONSOLE_RTS_ASSERT_NI();
   }
+#endif /* configBSP430_CONSOLE_USE_RTS */
   return rv;
 }
 
@@ -393,16 +1072,26 @@ iBSP430consoleTransmitUseInterrupts_ni (int enablep)
       iBSP430serialSetHold_ni(console_hal_, 1);
       BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
       iBSP430serialSetHold_ni(console_hal_, 0);
-      if (tx_buffer_.head != tx_buffer_.tail) {
+      if (0 != TX_RING_FN(ui, Count)(&tx_buffer_.ring)) {
         vBSP430serialWakeupTransmit_ni(console_hal_);
       }
     }
   } else {
-    if (uartTransmit_ni != iBSP430uartTxByte_ni) {
-      uartTransmit_ni = iBSP430uartTxByte_ni;
+    if (uartTransmit_ni != CONSOLE_TX_POLLED_NI) {
+      uartTransmit_ni = CONSOLE_TX_POLLED_NI;
       vBSP430serialFlush_ni(console_hal_);
       iBSP430serialSetHold_ni(console_hal_, 1);
       BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
+      /* Reclaim the part of any outstanding block that the HAL did
+       * not transmit, so it is sent when interrupts are re-enabled.
+       * A block may instead be owned by a DMA channel, which cannot be
+       * recalled; it is left to complete, and its space is released
+       * by the first callback after interrupts are re-enabled. */
+#if ! (configBSP430_SERIAL_TX_BLOCK_USE_DMA - 0)
+      TX_RING_FN(v, Release)(&tx_buffer_.ring, tx_buffer_.block_len - console_hal_->tx_block_len);
+      tx_buffer_.block_len = 0;
+      console_hal_->tx_block_len = 0;
+#endif /* configBSP430_SERIAL_TX_BLOCK_USE_DMA */
       iBSP430serialSetHold_ni(console_hal_, 0);
     }
   }
@@ -412,6 +1101,21 @@ iBSP430consoleTransmitUseInterrupts_ni (int enablep)
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 }
 
+#if (configBSP430_CONSOLE_USE_CTS - 0) || (configBSP430_CONSOLE_USE_RTS - 0)
+/* Stop monitoring CTS and tell the peer to stop sending. */
+static void
+console_flow_release_ni (void)
+{
+#if configBSP430_CONSOLE_USE_CTS - 0
+  BSP430_PORT_HAL_GET_HPL_PORTIE(cts_port_)->ie &= ~BSP430_CONSOLE_CTS_PORT_BIT;
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, cts_port_->pin_cbchain_ni[iBSP430portBitPosition(BSP430_CONSOLE_CTS_PORT_BIT)], cts_cb_, next_ni);
+#endif /* configBSP430_CONSOLE_USE_CTS */
+#if configBSP430_CONSOLE_USE_RTS - 0
+  CONSOLE_RTS_DEASSERT_NI();
+#endif /* configBSP430_CONSOLE_USE_RTS */
+}
+#endif /* configBSP430_CONSOLE_USE_CTS || configBSP430_CONSOLE_USE_RTS */
+
 int
 iBSP430consoleInitialize (void)
 {
@@ -427,6 +1131,18 @@ iBSP430consoleInitialize (void)
   if (NULL == hal) {
     return -1;
   }
+#if configBSP430_CONSOLE_USE_CTS - 0
+  cts_port_ = hBSP430portLookup(BSP430_CONSOLE_CTS_PORT_PERIPH_HANDLE);
+  if ((NULL == cts_port_) || (NULL == BSP430_PORT_HAL_GET_HPL_PORTIE(cts_port_))) {
+    return -1;
+  }
+#endif /* configBSP430_CONSOLE_USE_CTS */
+#if configBSP430_CONSOLE_USE_RTS - 0
+  rts_port_ = hBSP430portLookup(BSP430_CONSOLE_RTS_PORT_PERIPH_HANDLE);
+  if (NULL == rts_port_) {
+    return -1;
+  }
+#endif /* configBSP430_CONSOLE_USE_RTS */
 
   rv = -1;
   BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
@@ -436,17 +1152,41 @@ iBSP430consoleInitialize (void)
 #if BSP430_CONSOLE_RX_BUFFER_SIZE - 0
     /* Associate the callback before opening the device, so the
      * interrupts are enabled properly. */
-    rx_buffer_.head = rx_buffer_.tail = 0;
+    RX_RING_FN(v, Reset)(&rx_buffer_.ring);
+#if configBSP430_CONSOLE_RX_LINE_MODE - 0
+    rx_buffer_.esc_state = 0;
+    rx_buffer_.line_fresh = 1;
+    rx_buffer_.edit_head = rx_buffer_.ring.head;
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
     BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, hal->rx_cbchain_ni, rx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 #if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
     uartTransmit_ni = console_tx_queue_ni;
     tx_buffer_.wake_available = 0;
-    tx_buffer_.head = tx_buffer_.tail = 0;
+    TX_RING_FN(v, Reset)(&tx_buffer_.ring);
+    tx_buffer_.block_len = 0;
+    hal->tx_block_len = 0;
     BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, hal->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+#if configBSP430_CONSOLE_USE_RTS - 0
+    /* The buffer is empty: peer may send */
+    BSP430_PORT_HAL_HPL_SEL(rts_port_) &= ~BSP430_CONSOLE_RTS_PORT_BIT;
+    CONSOLE_RTS_ASSERT_NI();
+    BSP430_PORT_HAL_HPL_DIR(rts_port_) |= BSP430_CONSOLE_RTS_PORT_BIT;
+#endif /* configBSP430_CONSOLE_USE_RTS */
+
+#if configBSP430_CONSOLE_USE_CTS - 0
+    BSP430_PORT_HAL_HPL_SEL(cts_port_) &= ~BSP430_CONSOLE_CTS_PORT_BIT;
+    BSP430_PORT_HAL_HPL_DIR(cts_port_) &= ~BSP430_CONSOLE_CTS_PORT_BIT;
+    BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, cts_port_->pin_cbchain_ni[iBSP430portBitPosition(BSP430_CONSOLE_CTS_PORT_BIT)], cts_cb_, next_ni);
+    /* Arm the edge for the current level.  The console is not yet
+     * installed so transmission is unaffected. */
+    (void)console_cts_isr_ni(&cts_cb_, cts_port_, 0);
+    BSP430_PORT_HAL_GET_HPL_PORTIE(cts_port_)->ie |= BSP430_CONSOLE_CTS_PORT_BIT;
+#endif /* configBSP430_CONSOLE_USE_CTS */
+
     /* Attempt to configure and install the console */
     console_hal_ = hBSP430serialOpenUART(hal, 0, 0, BSP430_CONSOLE_BAUD_RATE);
     if (! console_hal_) {
@@ -454,6 +1194,9 @@ iBSP430consoleInitialize (void)
 #if BSP430_CONSOLE_RX_BUFFER_SIZE - 0
       BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, hal->rx_cbchain_ni, rx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
+#if (configBSP430_CONSOLE_USE_CTS - 0) || (configBSP430_CONSOLE_USE_RTS - 0)
+      console_flow_release_ni();
+#endif /* configBSP430_CONSOLE_USE_CTS || configBSP430_CONSOLE_USE_RTS */
       break;
     }
 #if BSP430_PLATFORM_SPIN_FOR_JUMPER - 0
@@ -484,6 +1227,9 @@ iBSP430consoleDeconfigure (void)
 #if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
   BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+#if (configBSP430_CONSOLE_USE_CTS - 0) || (configBSP430_CONSOLE_USE_RTS - 0)
+  console_flow_release_ni();
+#endif /* configBSP430_CONSOLE_USE_CTS || configBSP430_CONSOLE_USE_RTS */
   console_hal_ = NULL;
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
   return rv;
@@ -494,21 +1240,16 @@ iBSP430consoleWaitForTxSpace_ni (int want_available)
 {
   int rv = 0;
 #if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
-  if (((int)sizeof(tx_buffer_.buffer) - 1) < want_available) {
+  if (BSP430_CONSOLE_TX_BUFFER_SIZE < want_available) {
     return -1;
   }
   while (1) {
-    int available;
-    unsigned char head = tx_buffer_.head;
-    unsigned char tail = tx_buffer_.tail;
-
     if (0 > want_available) {
-      if (head == tail) {
+      if (0 == TX_RING_FN(ui, Count)(&tx_buffer_.ring)) {
         break;
       }
     } else {
-      available = TX_BUFFER_AVAILABLE_(&tx_buffer_, head, tail);
-      if (available >= want_available) {
+      if (TX_RING_FN(ui, Space)(&tx_buffer_.ring) >= want_available) {
         break;
       }
     }
@@ -523,6 +1264,214 @@ iBSP430consoleWaitForTxSpace_ni (int want_available)
   return rv;
 }
 
+int
+iBSP430consoleSetTxPolicy_ni (int policy)
+{
+#if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
+  int rv = tx_buffer_.policy;
+
+  if ((BSP430_CONSOLE_TX_POLICY_BLOCK != policy)
+      && (BSP430_CONSOLE_TX_POLICY_DROP_NEWEST != policy)
+      && (BSP430_CONSOLE_TX_POLICY_DROP_OLDEST != policy)) {
+    return -1;
+  }
+  tx_buffer_.policy = policy;
+  return rv;
+#else /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  return -1;
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+}
+
+int
+iBSP430consoleSetRxLineMode_ni (int enablep)
+{
+#if (BSP430_CONSOLE_RX_BUFFER_SIZE - 0) && (configBSP430_CONSOLE_RX_LINE_MODE - 0)
+  int rv = rx_buffer_.line_mode;
+
+  enablep = !!enablep;
+  if (enablep != rv) {
+    /* Whatever is pending may be part of a line the application has
+     * begun reading */
+    rx_buffer_.esc_state = 0;
+    rx_buffer_.line_fresh = 0;
+    rx_buffer_.edit_head = rx_buffer_.ring.head;
+    rx_buffer_.line_mode = enablep;
+  }
+  return rv;
+#else /* configBSP430_CONSOLE_RX_LINE_MODE */
+  return -1;
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+}
+
+int
+iBSP430consoleRxLineMode_ni (void)
+{
+#if (BSP430_CONSOLE_RX_BUFFER_SIZE - 0) && (configBSP430_CONSOLE_RX_LINE_MODE - 0)
+  return rx_buffer_.line_mode;
+#else /* configBSP430_CONSOLE_RX_LINE_MODE */
+  return 0;
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+}
+
+unsigned int
+uiBSP430consoleTxDropped_ni (int reset)
+{
+#if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
+  unsigned int rv = tx_buffer_.dropped;
+
+  if (reset) {
+    tx_buffer_.dropped = 0;
+  }
+  return rv;
+#else /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  return 0;
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+}
+
+int
+iBSP430consoleAddSink_ni (hBSP430consoleSink sink)
+{
+#if configBSP430_CONSOLE_SINKS - 0
+  hBSP430consoleSink sp;
+
+  for (sp = sinks_ni_; NULL != sp; sp = sp->next_ni) {
+    if (sp == sink) {
+      return -1;
+    }
+  }
+  sink->next_ni = sinks_ni_;
+  sinks_ni_ = sink;
+  return 0;
+#else /* configBSP430_CONSOLE_SINKS */
+  return -1;
+#endif /* configBSP430_CONSOLE_SINKS */
+}
+
+int
+iBSP430consoleRemoveSink_ni (hBSP430consoleSink sink)
+{
+#if configBSP430_CONSOLE_SINKS - 0
+  hBSP430consoleSink volatile * spp = &sinks_ni_;
+
+  while (NULL != *spp) {
+    if (*spp == sink) {
+      *spp = sink->next_ni;
+      sink->next_ni = NULL;
+      return 0;
+    }
+    spp = &(*spp)->next_ni;
+  }
+#endif /* configBSP430_CONSOLE_SINKS */
+  return -1;
+}
+
+int
+iBSP430consoleSetThreshold_ni (int threshold)
+{
+#if configBSP430_CONSOLE_SINKS - 0
+  int rv = uart_threshold_;
+
+  if ((BSP430_CONSOLE_LEVEL_EMERG > threshold)
+      || (BSP430_CONSOLE_LEVEL_DEBUG < threshold)) {
+    return -1;
+  }
+  uart_threshold_ = threshold;
+  return rv;
+#else /* configBSP430_CONSOLE_SINKS */
+  return -1;
+#endif /* configBSP430_CONSOLE_SINKS */
+}
+
+#if configBSP430_CONSOLE_SINKS - 0
+static void
+ring_sink_count_dropped_ni (sBSP430consoleRingSink * rsp,
+                            size_t n)
+{
+  unsigned int dropped = rsp->dropped + n;
+
+  /* Saturate rather than wrap */
+  rsp->dropped = (dropped < rsp->dropped) ? (unsigned int)-1 : dropped;
+}
+
+static void
+ring_sink_write_ni (hBSP430consoleSink sink,
+                    const uint8_t * data,
+                    size_t len)
+{
+  sBSP430consoleRingSink * rsp = (sBSP430consoleRingSink *)sink;
+  size_t n;
+
+  if (rsp->overwrite) {
+    size_t size = rsp->ring.mask + 1U;
+    size_t space;
+
+    /* Keep the newest text: only the end of an oversize block fits,
+     * and the oldest stored text gives way to the rest */
+    if (len > size) {
+      ring_sink_count_dropped_ni(rsp, len - size);
+      data += len - size;
+      len = size;
+    }
+    space = uiBSP430ring16Space(&rsp->ring);
+    if (space < len) {
+      vBSP430ring16Release(&rsp->ring, len - space);
+      ring_sink_count_dropped_ni(rsp, len - space);
+    }
+  }
+  n = xBSP430ring16Put(&rsp->ring, data, len);
+  if (n < len) {
+    ring_sink_count_dropped_ni(rsp, len - n);
+  }
+}
+#endif /* configBSP430_CONSOLE_SINKS */
+
+hBSP430consoleSink
+hBSP430consoleRingSinkInitialize (sBSP430consoleRingSink * rsp,
+                                  uint8_t * buffer,
+                                  size_t size,
+                                  int threshold,
+                                  int overwrite)
+{
+#if configBSP430_CONSOLE_SINKS - 0
+  if (NULL == hBSP430ring16Initialize(&rsp->ring, buffer, size)) {
+    return NULL;
+  }
+  rsp->sink.next_ni = NULL;
+  rsp->sink.write_ni = ring_sink_write_ni;
+  rsp->sink.threshold = threshold;
+  rsp->overwrite = !!overwrite;
+  rsp->dropped = 0;
+  return &rsp->sink;
+#else /* configBSP430_CONSOLE_SINKS */
+  return NULL;
+#endif /* configBSP430_CONSOLE_SINKS */
+}
+
+int
+iBSP430consoleTransmitBlock_ni (const uint8_t * data,
+                                size_t len)
+{
+  hBSP430halSERIAL uart = console_hal_;
+  const uint8_t * const dpe = data + len;
+
+  if (NULL == uart) {
+    return -1;
+  }
+#if BSP430_CONSOLE_TX_BUFFER_SIZE - 0
+  if (console_tx_queue_ni == uartTransmit_ni) {
+    if (TX_RING_FN(ui, Space)(&tx_buffer_.ring) < len) {
+      return -1;
+    }
+    tx_buffer_store_ni(uart, &tx_buffer_, (const char *)data, len);
+    return len;
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  while (data < dpe) {
+    UART_TRANSMIT(uart, *data++);
+  }
+  return len;
+}
+
 int
 iBSP430consoleFlush (void)
 {
@@ -0,0 +1,310 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of libc-independent number formatting
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/utility/format.h>
+
+/* Digits are generated from the right into a scratch buffer of this
+ * size, which holds the longest unpadded output: sign, ten integer
+ * digits, point, and fraction. */
+#define SCRATCH_SIZE 16
+
+static const uint16_t pow10_[] = { 1, 10, 100, 1000, 10000 };
+
+/* Quotient of a 16-bit value by ten.  0xCCCD / 2^19 exceeds 1/10 by
+ * less than 2^-16 / 10, so the product is exact for any 16-bit
+ * dividend.  Without a multiplier the same reciprocal is built from
+ * shifts, which can fall one short; the remainder corrects it. */
+static BSP430_CORE_INLINE uint16_t
+div10_u16 (uint16_t v)
+{
+#if configBSP430_FORMAT_USE_HWMULT - 0
+  return (uint16_t)(((uint32_t)v * 0xCCCDU) >> 19);
+#else /* configBSP430_FORMAT_USE_HWMULT */
+  uint16_t q = (v >> 1) + (v >> 2);
+  uint16_t r;
+
+  q += q >> 4;
+  q += q >> 8;
+  q >>= 3;
+  r = v - ((q << 3) + (q << 1));
+  return q + (9 < r);
+#endif /* configBSP430_FORMAT_USE_HWMULT */
+}
+
+/* Store the decimal digits of v ending before ep, at least min_digits
+ * of them.  Returns the position of the first digit. */
+static char *
+decimal16 (char * ep,
+           uint16_t v,
+           unsigned int min_digits)
+{
+  char * const end = ep;
+
+  do {
+    uint16_t q = div10_u16(v);
+
+    *--ep = '0' + (v - ((q << 3) + (q << 1)));
+    v = q;
+  } while (v);
+  while ((unsigned int)(end - ep) < min_digits) {
+    *--ep = '0';
+  }
+  return ep;
+}
+
+/* As decimal16 for a 32-bit value.  The upper half is converted by
+ * division and packed into BCD; the lower half is then shifted in
+ * most significant bit first, doubling the BCD value each time.
+ * Before each shift any digit of five or more is increased by three,
+ * so that it carries into the next digit when doubled.  The digits
+ * are adjusted four at a time: adding three to each yields bit 3 set
+ * exactly in those that need the adjustment. */
+static char *
+decimal32 (char * ep,
+           uint32_t v,
+           unsigned int min_digits)
+{
+  uint16_t bcd[3];
+  uint16_t hi = (uint16_t)(v >> 16);
+  uint16_t lo = (uint16_t)v;
+  unsigned int shift;
+  unsigned int i;
+
+  if (0 == hi) {
+    return decimal16(ep, lo, min_digits);
+  }
+  bcd[0] = bcd[1] = bcd[2] = 0;
+  shift = 0;
+  do {
+    uint16_t q = div10_u16(hi);
+
+    bcd[shift / 16] |= (uint16_t)(hi - ((q << 3) + (q << 1))) << (shift % 16);
+    shift += 4;
+    hi = q;
+  } while (hi);
+  for (i = 0; i < 16; ++i) {
+    int w;
+
+    for (w = 0; w < 3; ++w) {
+      uint16_t a = ((uint16_t)(bcd[w] + 0x3333) & 0x8888) >> 3;
+
+      bcd[w] += a + (a << 1);
+    }
+    bcd[2] = (bcd[2] << 1) | (bcd[1] >> 15);
+    bcd[1] = (bcd[1] << 1) | (bcd[0] >> 15);
+    bcd[0] = (bcd[0] << 1) | (lo >> 15);
+    lo <<= 1;
+  }
+  /* A value above 65535 has at least six digits; drop leading zeros
+   * from the ten available. */
+  for (i = 0; i < 10; ++i) {
+    *--ep = '0' + ((bcd[i / 4] >> (4 * (i % 4))) & 0x0F);
+  }
+  for (i = 10; (i > min_digits) && ('0' == *ep); --i) {
+    ++ep;
+  }
+  while (i++ < min_digits) {
+    *--ep = '0';
+  }
+  return ep;
+}
+
+/* Copy the characters from sp to ep to dst, preceded by sign if it is
+ * not NUL and padded as spec requires. */
+static unsigned int
+emit (char * dst,
+      const char * sp,
+      const char * ep,
+      char sign,
+      unsigned int spec)
+{
+  char * dp = dst;
+  unsigned int len = (ep - sp) + (sign ? 1 : 0);
+  unsigned int width = spec & BSP430_FORMAT_WIDTH_MASK;
+
+  if (sign && (spec & BSP430_FORMAT_FLAG_ZERO_PAD)) {
+    *dp++ = sign;
+    sign = 0;
+  }
+  while (len < width--) {
+    *dp++ = (spec & BSP430_FORMAT_FLAG_ZERO_PAD) ? '0' : ' ';
+  }
+  if (sign) {
+    *dp++ = sign;
+  }
+  while (sp < ep) {
+    *dp++ = *sp++;
+  }
+  *dp = 0;
+  return dp - dst;
+}
+
+/* The sign for a value and its magnitude, which is correct for the
+ * most negative value as well. */
+static char
+sign_of (long value,
+         unsigned long * magp,
+         unsigned int spec)
+{
+  if (0 > value) {
+    *magp = 0UL - (unsigned long)value;
+    return '-';
+  }
+  *magp = value;
+  return (spec & BSP430_FORMAT_FLAG_PLUS) ? '+' : 0;
+}
+
+unsigned int
+uiBSP430formatUnsigned (char * dst,
+                        unsigned long value,
+                        unsigned int spec)
+{
+  char scratch[SCRATCH_SIZE];
+  char * const ep = scratch + sizeof(scratch);
+
+  return emit(dst, decimal32(ep, value, 1), ep, 0, spec);
+}
+
+unsigned int
+uiBSP430formatSigned (char * dst,
+                      long value,
+                      unsigned int spec)
+{
+  char scratch[SCRATCH_SIZE];
+  char * const ep = scratch + sizeof(scratch);
+  unsigned long mag;
+  char sign = sign_of(value, &mag, spec);
+
+  return emit(dst, decimal32(ep, mag, 1), ep, sign, spec);
+}
+
+unsigned int
+uiBSP430formatHex (char * dst,
+                   unsigned long value,
+                   unsigned int spec)
+{
+  char scratch[SCRATCH_SIZE];
+  char * const ep = scratch + sizeof(scratch);
+  char * sp = ep;
+  char alpha = ((spec & BSP430_FORMAT_FLAG_UPPER) ? 'A' : 'a') - 10;
+
+  do {
+    unsigned int d = value & 0x0F;
+
+    *--sp = d + ((10 > d) ? '0' : alpha);
+    value >>= 4;
+  } while (value);
+  return emit(dst, sp, ep, 0, spec);
+}
+
+unsigned int
+uiBSP430formatScaled (char * dst,
+                      long value,
+                      unsigned int decimals,
+                      unsigned int spec)
+{
+  char scratch[SCRATCH_SIZE];
+  char * const ep = scratch + sizeof(scratch);
+  char * sp;
+  unsigned long mag;
+  char sign;
+  unsigned int nint;
+  unsigned int i;
+
+  if (BSP430_FORMAT_SCALED_MAX_DECIMALS < decimals) {
+    *dst = 0;
+    return 0;
+  }
+  sign = sign_of(value, &mag, spec);
+  if (0 == decimals) {
+    return emit(dst, decimal32(ep, mag, 1), ep, sign, spec);
+  }
+  /* Generate at least one integer digit, then move the integer digits
+   * left to open the point. */
+  sp = decimal32(ep, mag, decimals + 1);
+  nint = (ep - sp) - decimals;
+  --sp;
+  for (i = 0; i < nint; ++i) {
+    sp[i] = sp[i + 1];
+  }
+  sp[nint] = '.';
+  return emit(dst, sp, ep, sign, spec);
+}
+
+unsigned int
+uiBSP430formatQ (char * dst,
+                 long value,
+                 unsigned int frac_bits,
+                 unsigned int decimals,
+                 unsigned int spec)
+{
+  char scratch[SCRATCH_SIZE];
+  char * const ep = scratch + sizeof(scratch);
+  char * sp = ep;
+  unsigned long mag;
+  unsigned long ipart;
+  uint16_t frac;
+  char sign;
+
+  if ((BSP430_FORMAT_Q_MAX_FRAC_BITS < frac_bits)
+      || (BSP430_FORMAT_Q_MAX_DECIMALS < decimals)) {
+    *dst = 0;
+    return 0;
+  }
+  sign = sign_of(value, &mag, spec);
+  ipart = mag >> frac_bits;
+  frac = (uint16_t)(mag & ((1UL << frac_bits) - 1));
+  if (0 < frac_bits) {
+    /* The fraction in units of the last place, rounded: a 16x16
+     * multiply, then a shift. */
+    uint16_t scale = pow10_[decimals];
+    uint32_t t = ((uint32_t)frac * scale + (1UL << (frac_bits - 1))) >> frac_bits;
+
+    if (scale <= t) {
+      ++ipart;
+      t -= scale;
+    }
+    frac = (uint16_t)t;
+  }
+  if (decimals) {
+    sp = decimal16(sp, frac, decimals);
+    *--sp = '.';
+  }
+  return emit(dst, decimal32(sp, ipart, 1), ep, sign, spec);
+}
@@ -0,0 +1,414 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of COBS and SLIP packet framing with CRC-16
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/utility/framing.h>
+#include <string.h>
+
+#define SLIP_END 0xC0
+#define SLIP_ESC 0xDB
+#define SLIP_ESC_END 0xDC
+#define SLIP_ESC_ESC 0xDD
+
+/* Longest run of non-zero octets in a COBS block */
+#define COBS_MAX_RUN 254
+
+/* At least one octet of the current frame has been received */
+#define DECODER_FLAG_IN_FRAME 0x01
+/* COBS: the next block is preceded by a zero */
+#define DECODER_FLAG_ZERO_PENDING 0x02
+/* SLIP: the previous octet was an escape */
+#define DECODER_FLAG_ESCAPE 0x04
+/* The current frame is malformed */
+#define DECODER_FLAG_ERROR 0x08
+/* The current frame does not fit or there is no buffer */
+#define DECODER_FLAG_OVERRUN 0x10
+/* The current frame began before the buffer was supplied */
+#define DECODER_FLAG_DISCARD 0x20
+
+static BSP430_CORE_INLINE
+unsigned int
+crc16_update_ni (unsigned int crc,
+                 uint8_t octet)
+{
+#ifdef __MSP430_HAS_CRC__
+  CRCINIRES = crc;
+  /* @warning Reversed CRC not available on certain MCUs; see
+   * uiBSP430tlvChecksum() */
+  CRCDIRB_L = octet;
+  return CRCINIRES;
+#else /* __MSP430_HAS_CRC__ */
+  int i;
+
+  crc ^= (unsigned int)octet << 8;
+  for (i = 0; i < 8; ++i) {
+    crc = 0xFFFF & ((crc << 1) ^ ((crc & 0x8000) ? 0x1021 : 0));
+  }
+  return crc;
+#endif /* __MSP430_HAS_CRC__ */
+}
+
+unsigned int
+uiBSP430framingCRC16 (unsigned int crc,
+                      const uint8_t * data,
+                      size_t len)
+{
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  const uint8_t * const dpe = data + len;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  while (data < dpe) {
+    crc = crc16_update_ni(crc, *data++);
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return crc;
+}
+
+/* The payload followed by its CRC, most significant octet first */
+typedef struct sFrameSource {
+  const uint8_t * data;
+  size_t len;
+  uint8_t crc[BSP430_FRAMING_CRC_LENGTH];
+} sFrameSource;
+
+static uint8_t
+sourceOctet (const sFrameSource * sp,
+             size_t idx)
+{
+  return (idx < sp->len) ? sp->data[idx] : sp->crc[idx - sp->len];
+}
+
+/* Store an encoded octet; returns a negative value on failure */
+typedef int (* iEmit) (void * context,
+                       uint8_t octet);
+
+static int
+encodeFrame (int mode,
+             const uint8_t * data,
+             size_t len,
+             iEmit emit,
+             void * context)
+{
+  sFrameSource src;
+  const size_t n = len + BSP430_FRAMING_CRC_LENGTH;
+  unsigned int crc;
+  size_t i;
+
+  src.data = data;
+  src.len = len;
+  crc = uiBSP430framingCRC16(BSP430_FRAMING_CRC16_INIT, data, len);
+  src.crc[0] = crc >> 8;
+  src.crc[1] = crc;
+
+  if (BSP430_FRAMING_MODE_COBS == mode) {
+    i = 0;
+    while (1) {
+      size_t run = 0;
+      size_t j;
+
+      while ((i + run < n) && (COBS_MAX_RUN > run) && (0 != sourceOctet(&src, i + run))) {
+        ++run;
+      }
+      if (0 > emit(context, run + 1)) {
+        return -1;
+      }
+      for (j = 0; j < run; ++j) {
+        if (0 > emit(context, sourceOctet(&src, i++))) {
+          return -1;
+        }
+      }
+      if (i >= n) {
+        break;
+      }
+      /* A short block stopped at a zero, which it represents.  If that
+       * was the last octet an empty block follows. */
+      if (COBS_MAX_RUN > run) {
+        ++i;
+      }
+    }
+    return emit(context, 0);
+  }
+  if (BSP430_FRAMING_MODE_SLIP == mode) {
+    if (0 > emit(context, SLIP_END)) {
+      return -1;
+    }
+    for (i = 0; i < n; ++i) {
+      uint8_t c = sourceOctet(&src, i);
+      int rc;
+
+      if (SLIP_END == c) {
+        rc = emit(context, SLIP_ESC);
+        c = SLIP_ESC_END;
+      } else if (SLIP_ESC == c) {
+        rc = emit(context, SLIP_ESC);
+        c = SLIP_ESC_ESC;
+      } else {
+        rc = 0;
+      }
+      if ((0 > rc) || (0 > emit(context, c))) {
+        return -1;
+      }
+    }
+    return emit(context, SLIP_END);
+  }
+  return -1;
+}
+
+typedef struct sBufferSink {
+  uint8_t * dst;
+  size_t size;
+  size_t len;
+} sBufferSink;
+
+static int
+emitBuffer (void * context,
+            uint8_t octet)
+{
+  sBufferSink * sp = (sBufferSink *)context;
+
+  if (sp->len >= sp->size) {
+    return -1;
+  }
+  sp->dst[sp->len++] = octet;
+  return 0;
+}
+
+static int
+emitUART (void * context,
+          uint8_t octet)
+{
+  return iBSP430uartTxByte_ni((hBSP430halSERIAL)context, octet);
+}
+
+int
+iBSP430framingEncode (int mode,
+                      const uint8_t * data,
+                      size_t len,
+                      uint8_t * dst,
+                      size_t dst_size)
+{
+  sBufferSink sink;
+
+  sink.dst = dst;
+  sink.size = dst_size;
+  sink.len = 0;
+  if (0 > encodeFrame(mode, data, len, emitBuffer, &sink)) {
+    return -1;
+  }
+  return sink.len;
+}
+
+int
+iBSP430framingTxFrame_ni (hBSP430halSERIAL hal,
+                          int mode,
+                          const uint8_t * data,
+                          size_t len)
+{
+  if (0 > encodeFrame(mode, data, len, emitUART, hal)) {
+    return -1;
+  }
+  return len;
+}
+
+static void
+decoderStore_ni (hBSP430framingDecoder decoder,
+                 uint8_t octet)
+{
+  if ((NULL == decoder->buffer) || (decoder->len >= decoder->size)) {
+    decoder->flags |= DECODER_FLAG_OVERRUN;
+    return;
+  }
+  decoder->buffer[decoder->len++] = octet;
+  decoder->crc = crc16_update_ni(decoder->crc, octet);
+}
+
+/* Finish the current frame at a delimiter, handing over the buffer if
+ * the frame is valid. */
+static int
+decoderComplete_ni (hBSP430framingDecoder decoder,
+                    int valid)
+{
+  int rv = -1;
+
+  if (decoder->flags & DECODER_FLAG_DISCARD) {
+    ;
+  } else if (decoder->flags & DECODER_FLAG_OVERRUN) {
+    ++decoder->overruns;
+  } else if ((! valid)
+             || (decoder->flags & DECODER_FLAG_ERROR)
+             || (BSP430_FRAMING_CRC_LENGTH > decoder->len)
+             || (0 != decoder->crc)) {
+    /* The CRC of a frame including its own CRC is zero */
+    ++decoder->errors;
+  } else {
+    rv = decoder->len - BSP430_FRAMING_CRC_LENGTH;
+    decoder->frame_len = rv;
+    decoder->frame = decoder->buffer;
+    decoder->buffer = NULL;
+    decoder->size = 0;
+  }
+  decoder->len = 0;
+  decoder->crc = BSP430_FRAMING_CRC16_INIT;
+  decoder->code = 0;
+  decoder->flags = 0;
+  return rv;
+}
+
+int
+iBSP430framingDecoderRxOctet_ni (hBSP430framingDecoder decoder,
+                                 uint8_t octet)
+{
+  if (BSP430_FRAMING_MODE_COBS == decoder->mode) {
+    if (0 == octet) {
+      if (decoder->flags & DECODER_FLAG_IN_FRAME) {
+        return decoderComplete_ni(decoder, 0 == decoder->code);
+      }
+      return -1;
+    }
+    decoder->flags |= DECODER_FLAG_IN_FRAME;
+    if (0 == decoder->code) {
+      /* Start of a block */
+      if (decoder->flags & DECODER_FLAG_ZERO_PENDING) {
+        decoderStore_ni(decoder, 0);
+      }
+      decoder->code = octet - 1;
+      if (0xFF == octet) {
+        decoder->flags &= ~DECODER_FLAG_ZERO_PENDING;
+      } else {
+        decoder->flags |= DECODER_FLAG_ZERO_PENDING;
+      }
+    } else {
+      decoderStore_ni(decoder, octet);
+      --decoder->code;
+    }
+    return -1;
+  }
+
+  /* SLIP */
+  if (SLIP_END == octet) {
+    if (decoder->flags & DECODER_FLAG_IN_FRAME) {
+      return decoderComplete_ni(decoder, ! (decoder->flags & DECODER_FLAG_ESCAPE));
+    }
+    return -1;
+  }
+  decoder->flags |= DECODER_FLAG_IN_FRAME;
+  if (decoder->flags & DECODER_FLAG_ESCAPE) {
+    decoder->flags &= ~DECODER_FLAG_ESCAPE;
+    if (SLIP_ESC_END == octet) {
+      octet = SLIP_END;
+    } else if (SLIP_ESC_ESC == octet) {
+      octet = SLIP_ESC;
+    } else {
+      decoder->flags |= DECODER_FLAG_ERROR;
+    }
+  } else if (SLIP_ESC == octet) {
+    decoder->flags |= DECODER_FLAG_ESCAPE;
+    return -1;
+  }
+  decoderStore_ni(decoder, octet);
+  return -1;
+}
+
+static int
+framing_rx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
+                   void * context)
+{
+  hBSP430framingDecoder decoder = (hBSP430framingDecoder)cb;
+  hBSP430halSERIAL hal = (hBSP430halSERIAL)context;
+  int len;
+
+  len = iBSP430framingDecoderRxOctet_ni(decoder, hal->rx_byte);
+  if (0 > len) {
+    return 0;
+  }
+  if (decoder->frame_cb_ni) {
+    return decoder->frame_cb_ni(decoder, decoder->frame, len);
+  }
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+hBSP430framingDecoder
+hBSP430framingDecoderInitialize (sBSP430framingDecoder * decoder,
+                                 int mode,
+                                 iBSP430framingFrameCallback_ni frame_cb_ni)
+{
+  if ((BSP430_FRAMING_MODE_COBS != mode)
+      && (BSP430_FRAMING_MODE_SLIP != mode)) {
+    return NULL;
+  }
+  memset(decoder, 0, sizeof(*decoder));
+  decoder->cb_node.callback = framing_rx_isr_ni;
+  decoder->frame_cb_ni = frame_cb_ni;
+  decoder->mode = mode;
+  decoder->crc = BSP430_FRAMING_CRC16_INIT;
+  return decoder;
+}
+
+void
+vBSP430framingDecoderSetBuffer_ni (hBSP430framingDecoder decoder,
+                                   uint8_t * buffer,
+                                   size_t size)
+{
+  /* The remainder of a frame in progress is dropped without being
+   * counted. */
+  if (decoder->flags & DECODER_FLAG_IN_FRAME) {
+    decoder->flags |= DECODER_FLAG_DISCARD;
+  }
+  decoder->buffer = buffer;
+  decoder->size = size;
+  decoder->len = 0;
+  decoder->frame = NULL;
+  decoder->frame_len = 0;
+}
+
+int
+iBSP430framingDecoderAttach_ni (hBSP430framingDecoder decoder,
+                                hBSP430halSERIAL hal)
+{
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, hal->rx_cbchain_ni, decoder->cb_node, next_ni);
+  return 0;
+}
+
+int
+iBSP430framingDecoderDetach_ni (hBSP430framingDecoder decoder,
+                                hBSP430halSERIAL hal)
+{
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, hal->rx_cbchain_ni, decoder->cb_node, next_ni);
+  return 0;
+}
@@ -0,0 +1,894 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of software SPI and I2C on GPIO pins
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/serial.h>
+#include <bsp430/utility/gpioserial.h>
+#include <bsp430/clock.h>
+#if configBSP430_GPIOSERIAL_USE_TIMER - 0
+#include <bsp430/periph/timer.h>
+#endif /* configBSP430_GPIOSERIAL_USE_TIMER */
+
+/* Control register bits in the USCI byte layout.  These are spelled
+ * out so the module does not depend on which serial peripheral the
+ * MCU headers describe. */
+#define CTL0_CKPH 0x80
+#define CTL0_CKPL 0x40
+#define CTL0_MSB 0x20
+#define CTL0_7BIT 0x10
+#define CTL0_MODE 0x06
+#define CTL1_SSEL 0xC0
+#define CTL1_SSEL_ACLK 0x40
+
+enum {
+  MODE_CLOSED = 0,
+  MODE_SPI,
+  MODE_I2C,
+};
+
+/* Internal I2C failure codes */
+enum {
+  I2C_ERR_TIMEOUT = -1,
+  I2C_ERR_ARBITRATION = -2,
+  I2C_ERR_NACK = -3,
+};
+
+#define SERIAL_HAL_STATE(_hal) ((_hal)->hpl_aux.gpioserial)
+
+/* I2C lines are open drain: PxOUT is held clear, and a line is driven
+ * low by making it an output or released to the pull-up by making it
+ * an input. */
+#define I2C_RELEASE(_p) do {                    \
+    *(_p).dir &= ~(_p).bit;                     \
+  } while (0)
+#define I2C_DRIVE_LOW(_p) do {                  \
+    *(_p).dir |= (_p).bit;                      \
+  } while (0)
+#define I2C_IS_HIGH(_p) (*(_p).in & (_p).bit)
+
+static int
+resolvePin (sBSP430gpioserialPin * pp,
+            tBSP430periphHandle periph,
+            unsigned char bit)
+{
+  hBSP430halPORT port = hBSP430portLookup(periph);
+
+  if ((NULL == port) || (0 == bit)) {
+    return -1;
+  }
+  pp->in = &BSP430_PORT_HAL_HPL_IN(port);
+  pp->out = &BSP430_PORT_HAL_HPL_OUT(port);
+  pp->dir = &BSP430_PORT_HAL_HPL_DIR(port);
+  pp->bit = bit;
+  BSP430_PORT_HAL_HPL_SEL(port) &= ~bit;
+  return 0;
+}
+
+/* Stretch a clock phase to the configured half-period. */
+static void
+halfPeriodDelay (sBSP430gpioserialState * sp)
+{
+#if configBSP430_GPIOSERIAL_USE_TIMER - 0
+  if (sp->timer_r) {
+    unsigned int now;
+
+    sp->deadline += sp->half_period;
+    while (0 < (int)(sp->deadline - (now = *sp->timer_r))) {
+      ;
+    }
+    /* Don't try to catch up after an interrupt or clock stretch */
+    if ((int)(now - sp->deadline) > (int)sp->half_period) {
+      sp->deadline = now;
+    }
+    return;
+  }
+#endif /* configBSP430_GPIOSERIAL_USE_TIMER */
+  {
+    volatile unsigned int n = sp->half_period;
+    while (0 < n--) {
+      ;
+    }
+  }
+}
+
+static void
+startTiming (sBSP430gpioserialState * sp)
+{
+#if configBSP430_GPIOSERIAL_USE_TIMER - 0
+  if (sp->timer_r) {
+    sp->deadline = *sp->timer_r;
+  }
+#endif /* configBSP430_GPIOSERIAL_USE_TIMER */
+}
+
+static uint8_t
+reverseBits (uint8_t v)
+{
+  v = (v >> 4) | (v << 4);
+  v = ((v & 0xCC) >> 2) | ((v & 0x33) << 2);
+  v = ((v & 0xAA) >> 1) | ((v & 0x55) << 1);
+  return v;
+}
+
+/* Unrolled shift of one octet, MSB first, with data captured on the
+ * first clock edge (UCCKPH set) and no delay between edges.  The
+ * clock idles at the polarity set when the device was opened, so
+ * each edge is a toggle. */
+static uint8_t
+spiShiftCapture_ni (sBSP430gpioserialState * sp,
+                    uint8_t tx)
+{
+  volatile unsigned char * const clk = sp->clk.out;
+  const unsigned char clk_bit = sp->clk.bit;
+  volatile unsigned char * const mosi = sp->mosi.out;
+  const unsigned char mosi_bit = sp->mosi.bit;
+  volatile unsigned char * const miso = sp->miso.in;
+  const unsigned char miso_bit = sp->miso.bit;
+  uint8_t rx = 0;
+
+#define SHIFT_BIT(_m) do {                      \
+    if (tx & (_m)) {                            \
+      *mosi |= mosi_bit;                        \
+    } else {                                    \
+      *mosi &= ~mosi_bit;                       \
+    }                                           \
+    *clk ^= clk_bit;                            \
+    if (*miso & miso_bit) {                     \
+      rx |= (_m);                               \
+    }                                           \
+    *clk ^= clk_bit;                            \
+  } while (0)
+  SHIFT_BIT(0x80);
+  SHIFT_BIT(0x40);
+  SHIFT_BIT(0x20);
+  SHIFT_BIT(0x10);
+  SHIFT_BIT(0x08);
+  SHIFT_BIT(0x04);
+  SHIFT_BIT(0x02);
+  SHIFT_BIT(0x01);
+#undef SHIFT_BIT
+  return rx;
+}
+
+/* As spiShiftCapture_ni() but with data changed on the first clock
+ * edge and captured on the second (UCCKPH clear). */
+static uint8_t
+spiShiftChange_ni (sBSP430gpioserialState * sp,
+                   uint8_t tx)
+{
+  volatile unsigned char * const clk = sp->clk.out;
+  const unsigned char clk_bit = sp->clk.bit;
+  volatile unsigned char * const mosi = sp->mosi.out;
+  const unsigned char mosi_bit = sp->mosi.bit;
+  volatile unsigned char * const miso = sp->miso.in;
+  const unsigned char miso_bit = sp->miso.bit;
+  uint8_t rx = 0;
+
+#define SHIFT_BIT(_m) do {                      \
+    *clk ^= clk_bit;                            \
+    if (tx & (_m)) {                            \
+      *mosi |= mosi_bit;                        \
+    } else {                                    \
+      *mosi &= ~mosi_bit;                       \
+    }                                           \
+    *clk ^= clk_bit;                            \
+    if (*miso & miso_bit) {                     \
+      rx |= (_m);                               \
+    }                                           \
+  } while (0)
+  SHIFT_BIT(0x80);
+  SHIFT_BIT(0x40);
+  SHIFT_BIT(0x20);
+  SHIFT_BIT(0x10);
+  SHIFT_BIT(0x08);
+  SHIFT_BIT(0x04);
+  SHIFT_BIT(0x02);
+  SHIFT_BIT(0x01);
+#undef SHIFT_BIT
+  return rx;
+}
+
+/* Shift one octet, MSB first, with each clock phase stretched to the
+ * configured half-period. */
+static uint8_t
+spiShiftPaced_ni (sBSP430gpioserialState * sp,
+                  uint8_t tx)
+{
+  const int capture_first = !! (sp->ctl0_byte & CTL0_CKPH);
+  uint8_t rx = 0;
+  uint8_t m;
+
+  for (m = 0x80; 0 != m; m >>= 1) {
+    if (! capture_first) {
+      *sp->clk.out ^= sp->clk.bit;
+    }
+    if (tx & m) {
+      *sp->mosi.out |= sp->mosi.bit;
+    } else {
+      *sp->mosi.out &= ~sp->mosi.bit;
+    }
+    halfPeriodDelay(sp);
+    *sp->clk.out ^= sp->clk.bit;
+    if (*sp->miso.in & sp->miso.bit) {
+      rx |= m;
+    }
+    halfPeriodDelay(sp);
+    if (capture_first) {
+      *sp->clk.out ^= sp->clk.bit;
+    }
+  }
+  return rx;
+}
+
+/* Derive the clock timing from the configuration.  The half-period
+ * is in timer ticks when a timer paces the clock, and otherwise in
+ * iterations of the delay loop. */
+static int
+configureTiming (sBSP430gpioserialState * sp,
+                 unsigned char ctl1_byte,
+                 unsigned int prescaler)
+{
+  unsigned long src_hz;
+  unsigned long bit_hz;
+  unsigned long half;
+
+  if (CTL1_SSEL_ACLK == (ctl1_byte & CTL1_SSEL)) {
+    src_hz = BSP430_CLOCK_NOMINAL_XT1CLK_HZ;
+  } else {
+    src_hz = BSP430_CLOCK_NOMINAL_MCLK_HZ >> BSP430_CLOCK_NOMINAL_SMCLK_DIVIDING_SHIFT;
+  }
+  bit_hz = src_hz / prescaler;
+  if (0 == bit_hz) {
+    bit_hz = 1;
+  }
+  sp->timer_r = NULL;
+#if configBSP430_GPIOSERIAL_USE_TIMER - 0
+  if (BSP430_PERIPH_NONE != sp->timer) {
+    volatile sBSP430hplTIMER * tp = xBSP430hplLookupTIMER(sp->timer);
+
+    if (NULL == tp) {
+      return -1;
+    }
+    sp->timer_r = &tp->r;
+    half = ulBSP430timerFrequency_Hz_ni(sp->timer) / (2 * bit_hz);
+    if (0 == half) {
+      half = 1;
+    }
+  } else
+#endif /* configBSP430_GPIOSERIAL_USE_TIMER */
+  {
+    half = BSP430_CLOCK_NOMINAL_MCLK_HZ / (2 * bit_hz);
+    if (half > BSP430_GPIOSERIAL_SHIFT_CYCLES) {
+      half = (half - BSP430_GPIOSERIAL_SHIFT_CYCLES) / BSP430_GPIOSERIAL_LOOP_CYCLES;
+    } else {
+      half = 0;
+    }
+  }
+  if (half > 0xFFFF) {
+    half = 0xFFFF;
+  }
+  sp->half_period = half;
+  sp->prescaler = prescaler;
+  sp->ctl1_byte = ctl1_byte;
+  return 0;
+}
+
+static void
+configureSPIShift (sBSP430gpioserialState * sp)
+{
+  if ((0 != sp->half_period) || (NULL != sp->timer_r)) {
+    sp->shift_ni = spiShiftPaced_ni;
+  } else if (sp->ctl0_byte & CTL0_CKPH) {
+    sp->shift_ni = spiShiftCapture_ni;
+  } else {
+    sp->shift_ni = spiShiftChange_ni;
+  }
+}
+
+/* Drive (or, if held, release) the pins for the current mode. */
+static void
+configurePins (sBSP430gpioserialState * sp,
+               int holdp)
+{
+  if (MODE_SPI == sp->mode) {
+    if (sp->ctl0_byte & CTL0_CKPL) {
+      *sp->clk.out |= sp->clk.bit;
+    } else {
+      *sp->clk.out &= ~sp->clk.bit;
+    }
+    *sp->mosi.out &= ~sp->mosi.bit;
+    *sp->miso.dir &= ~sp->miso.bit;
+    if (holdp) {
+      *sp->clk.dir &= ~sp->clk.bit;
+      *sp->mosi.dir &= ~sp->mosi.bit;
+    } else {
+      *sp->clk.dir |= sp->clk.bit;
+      *sp->mosi.dir |= sp->mosi.bit;
+    }
+  } else if (MODE_I2C == sp->mode) {
+    I2C_RELEASE(sp->clk);
+    I2C_RELEASE(sp->mosi);
+    *sp->clk.out &= ~sp->clk.bit;
+    *sp->mosi.out &= ~sp->mosi.bit;
+  }
+}
+
+static hBSP430halSERIAL
+gpioserialConfigure (hBSP430halSERIAL hal,
+                     unsigned char mode,
+                     unsigned char ctl0_byte,
+                     unsigned char ctl1_byte,
+                     unsigned int prescaler)
+{
+  sBSP430gpioserialState * sp;
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+
+  /* Reject unsupported HALs and invalid prescaler */
+  if ((NULL == hal) || (0 == prescaler)) {
+    return NULL;
+  }
+  sp = SERIAL_HAL_STATE(hal);
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    sp->mode = MODE_CLOSED;
+    if ((0 != resolvePin(&sp->clk, sp->clk_port, sp->clk_bit))
+        || (0 != resolvePin(&sp->mosi, sp->mosi_port, sp->mosi_bit))
+        || ((MODE_SPI == mode)
+            && (0 != resolvePin(&sp->miso, sp->miso_port, sp->miso_bit)))
+        || (0 != configureTiming(sp, ctl1_byte, prescaler))) {
+      hal = NULL;
+      break;
+    }
+    sp->ctl0_byte = ctl0_byte;
+    sp->mode = mode;
+    if (MODE_SPI == mode) {
+      configureSPIShift(sp);
+    }
+    configurePins(sp, 0);
+
+    /* Reset device statistics */
+    hal->num_rx = hal->num_tx = 0;
+    BSP430_SERIAL_RESET_ERRORS_NI(hal);
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return hal;
+}
+
+hBSP430halSERIAL
+hBSP430gpioserialOpenUART (hBSP430halSERIAL hal,
+                           unsigned char ctl0_byte,
+                           unsigned char ctl1_byte,
+                           unsigned long baud)
+{
+  return NULL;
+}
+
+hBSP430halSERIAL
+hBSP430gpioserialOpenUARTDivisor (hBSP430halSERIAL hal,
+                                  unsigned char ctl0_byte,
+                                  unsigned char ctl1_byte,
+                                  unsigned long divisor_q12)
+{
+  return NULL;
+}
+
+hBSP430halSERIAL
+hBSP430gpioserialOpenSPI (hBSP430halSERIAL hal,
+                          unsigned char ctl0_byte,
+                          unsigned char ctl1_byte,
+                          unsigned int prescaler)
+{
+  /* Reject I2C mode and 7-bit characters */
+  if ((CTL0_MODE == (ctl0_byte & CTL0_MODE))
+      || (ctl0_byte & CTL0_7BIT)) {
+    return NULL;
+  }
+  return gpioserialConfigure(hal, MODE_SPI, ctl0_byte, ctl1_byte, prescaler);
+}
+
+hBSP430halSERIAL
+hBSP430gpioserialOpenI2C (hBSP430halSERIAL hal,
+                          unsigned char ctl0_byte,
+                          unsigned char ctl1_byte,
+                          unsigned int prescaler)
+{
+  return gpioserialConfigure(hal, MODE_I2C, ctl0_byte, ctl1_byte, prescaler);
+}
+
+int
+iBSP430gpioserialSPIReconfigure_ni (hBSP430halSERIAL hal,
+                                    unsigned char ctl0_byte,
+                                    unsigned char ctl1_byte,
+                                    unsigned int prescaler)
+{
+  sBSP430gpioserialState * sp = SERIAL_HAL_STATE(hal);
+
+  if ((MODE_SPI != sp->mode)
+      || (0 == prescaler)
+      || (CTL0_MODE == (ctl0_byte & CTL0_MODE))
+      || (ctl0_byte & CTL0_7BIT)) {
+    return -1;
+  }
+  if ((ctl1_byte != sp->ctl1_byte) || (prescaler != sp->prescaler)) {
+    if (0 != configureTiming(sp, ctl1_byte, prescaler)) {
+      return -1;
+    }
+  }
+  if (ctl0_byte != sp->ctl0_byte) {
+    sp->ctl0_byte = ctl0_byte;
+    configurePins(sp, 0);
+  }
+  configureSPIShift(sp);
+  return 0;
+}
+
+int
+iBSP430gpioserialSetHold_ni (hBSP430halSERIAL hal,
+                             int holdp)
+{
+  sBSP430gpioserialState * sp = SERIAL_HAL_STATE(hal);
+
+  if (MODE_CLOSED == sp->mode) {
+    return -1;
+  }
+  configurePins(sp, holdp);
+  return 0;
+}
+
+int
+iBSP430gpioserialClose (hBSP430halSERIAL hal)
+{
+  sBSP430gpioserialState * sp = SERIAL_HAL_STATE(hal);
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (MODE_CLOSED != sp->mode) {
+    configurePins(sp, 1);
+    sp->mode = MODE_CLOSED;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return 0;
+}
+
+void
+vBSP430gpioserialWakeupTransmit_ni (hBSP430halSERIAL hal)
+{
+}
+
+void
+vBSP430gpioserialFlush_ni (hBSP430halSERIAL hal)
+{
+}
+
+int
+iBSP430gpioserialUARTrxByte_ni (hBSP430halSERIAL hal)
+{
+  return -1;
+}
+
+int
+iBSP430gpioserialUARTtxByte_ni (hBSP430halSERIAL hal,
+                                uint8_t c)
+{
+  return -1;
+}
+
+int
+iBSP430gpioserialUARTtxData_ni (hBSP430halSERIAL hal,
+                                const uint8_t * data,
+                                size_t len)
+{
+  return -1;
+}
+
+int
+iBSP430gpioserialUARTtxASCIIZ_ni (hBSP430halSERIAL hal,
+                                  const char * str)
+{
+  return -1;
+}
+
+int
+iBSP430gpioserialSPITxRx_ni (hBSP430halSERIAL hal,
+                             const uint8_t * tx_data,
+                             size_t tx_len,
+                             size_t rx_len,
+                             uint8_t * rx_data)
+{
+  sBSP430gpioserialState * sp = SERIAL_HAL_STATE(hal);
+  const int lsb_first = ! (sp->ctl0_byte & CTL0_MSB);
+  size_t transaction_length = tx_len + rx_len;
+  size_t i;
+
+  if (MODE_SPI != sp->mode) {
+    return -1;
+  }
+  startTiming(sp);
+  for (i = 0; i < transaction_length; ++i) {
+    uint8_t txd = (i < tx_len) ? tx_data[i] : BSP430_SERIAL_SPI_READ_TX_BYTE(i-tx_len);
+    uint8_t rxd;
+
+    if (lsb_first) {
+      txd = reverseBits(txd);
+    }
+    rxd = sp->shift_ni(sp, txd);
+    if (lsb_first) {
+      rxd = reverseBits(rxd);
+    }
+    if (rx_data) {
+      rx_data[i] = rxd;
+    }
+  }
+  hal->num_tx += transaction_length;
+  hal->num_rx += transaction_length;
+  return transaction_length;
+}
+
+/* Release SCL and wait for any clock stretching by the slave to
+ * end. */
+static int
+i2cReleaseSCL (sBSP430gpioserialState * sp)
+{
+  unsigned int limit = BSP430_GPIOSERIAL_I2C_STRETCH_LIMIT;
+
+  I2C_RELEASE(sp->clk);
+  while (! I2C_IS_HIGH(sp->clk)) {
+    if (0 == --limit) {
+      return I2C_ERR_TIMEOUT;
+    }
+  }
+  return 0;
+}
+
+/* Issue a start, or a repeated start if SCL is low.  Either way SDA
+ * falls while SCL is high, and both are low on return. */
+static int
+i2cStart (sBSP430gpioserialState * sp)
+{
+  I2C_RELEASE(sp->mosi);
+  halfPeriodDelay(sp);
+  if (0 != i2cReleaseSCL(sp)) {
+    return I2C_ERR_TIMEOUT;
+  }
+  if (! I2C_IS_HIGH(sp->mosi)) {
+    /* Another master holds the bus */
+    return I2C_ERR_ARBITRATION;
+  }
+  halfPeriodDelay(sp);
+  I2C_DRIVE_LOW(sp->mosi);
+  halfPeriodDelay(sp);
+  I2C_DRIVE_LOW(sp->clk);
+  return 0;
+}
+
+/* Issue a stop.  SCL is low on entry; both lines are released on
+ * return. */
+static void
+i2cStop (sBSP430gpioserialState * sp)
+{
+  I2C_DRIVE_LOW(sp->mosi);
+  halfPeriodDelay(sp);
+  (void)i2cReleaseSCL(sp);
+  halfPeriodDelay(sp);
+  I2C_RELEASE(sp->mosi);
+  halfPeriodDelay(sp);
+}
+
+static int
+i2cWriteBit (sBSP430gpioserialState * sp,
+             int bit)
+{
+  int rc = 0;
+
+  if (bit) {
+    I2C_RELEASE(sp->mosi);
+  } else {
+    I2C_DRIVE_LOW(sp->mosi);
+  }
+  halfPeriodDelay(sp);
+  if (0 != i2cReleaseSCL(sp)) {
+    return I2C_ERR_TIMEOUT;
+  }
+  if (bit && ! I2C_IS_HIGH(sp->mosi)) {
+    rc = I2C_ERR_ARBITRATION;
+  }
+  halfPeriodDelay(sp);
+  I2C_DRIVE_LOW(sp->clk);
+  return rc;
+}
+
+/* Read one bit.  Returns the bit value, or a negative error code. */
+static int
+i2cReadBit (sBSP430gpioserialState * sp)
+{
+  int bit;
+
+  I2C_RELEASE(sp->mosi);
+  halfPeriodDelay(sp);
+  if (0 != i2cReleaseSCL(sp)) {
+    return I2C_ERR_TIMEOUT;
+  }
+  bit = !! I2C_IS_HIGH(sp->mosi);
+  halfPeriodDelay(sp);
+  I2C_DRIVE_LOW(sp->clk);
+  return bit;
+}
+
+/* Write an octet and read the acknowledgement. */
+static int
+i2cWriteByte (sBSP430gpioserialState * sp,
+              uint8_t v)
+{
+  uint8_t m;
+  int rc;
+
+  for (m = 0x80; 0 != m; m >>= 1) {
+    rc = i2cWriteBit(sp, v & m);
+    if (0 != rc) {
+      return rc;
+    }
+  }
+  rc = i2cReadBit(sp);
+  if (0 < rc) {
+    rc = I2C_ERR_NACK;
+  }
+  return rc;
+}
+
+/* Read an octet and acknowledge it if more are to follow.  Returns
+ * the octet, or a negative error code. */
+static int
+i2cReadByte (sBSP430gpioserialState * sp,
+             int ack)
+{
+  unsigned int v = 0;
+  int i;
+  int rc;
+
+  for (i = 0; i < 8; ++i) {
+    rc = i2cReadBit(sp);
+    if (0 > rc) {
+      return rc;
+    }
+    v = (v << 1) | rc;
+  }
+  rc = i2cWriteBit(sp, ! ack);
+  if (0 != rc) {
+    return rc;
+  }
+  return v;
+}
+
+static int
+i2cTransaction_ni (hBSP430halSERIAL hal,
+                   const uint8_t * tx_data,
+                   size_t tx_len,
+                   size_t rx_len,
+                   uint8_t * rx_data)
+{
+  sBSP430gpioserialState * sp = SERIAL_HAL_STATE(hal);
+  size_t i;
+  int rc = 0;
+
+  if (MODE_I2C != sp->mode) {
+    return -1;
+  }
+  startTiming(sp);
+  do {
+    if ((0 < tx_len) || (0 == rx_len)) {
+      rc = i2cStart(sp);
+      if (0 == rc) {
+        rc = i2cWriteByte(sp, sp->slave_address << 1);
+      }
+      for (i = 0; (0 == rc) && (i < tx_len); ++i) {
+        rc = i2cWriteByte(sp, tx_data[i]);
+        if (0 == rc) {
+          ++hal->num_tx;
+        }
+      }
+      if (0 != rc) {
+        break;
+      }
+    }
+    if (0 < rx_len) {
+      rc = i2cStart(sp);
+      if (0 == rc) {
+        rc = i2cWriteByte(sp, (sp->slave_address << 1) | 1);
+      }
+      for (i = 0; (0 == rc) && (i < rx_len); ++i) {
+        rc = i2cReadByte(sp, (i + 1) < rx_len);
+        if (0 <= rc) {
+          rx_data[i] = rc;
+          ++hal->num_rx;
+          rc = 0;
+        }
+      }
+      if (0 != rc) {
+        break;
+      }
+    }
+    i2cStop(sp);
+    return tx_len + rx_len;
+  } while (0);
+
+  if (I2C_ERR_ARBITRATION == rc) {
+    /* The bus belongs to somebody else: let go without a stop */
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+    ++hal->errors.arbitration_lost;
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+    I2C_RELEASE(sp->mosi);
+    I2C_RELEASE(sp->clk);
+  } else {
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+    if (I2C_ERR_NACK == rc) {
+      ++hal->errors.nack;
+    }
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+    i2cStop(sp);
+  }
+  return -1;
+}
+
+int
+iBSP430gpioserialI2CsetAddresses_ni (hBSP430halSERIAL hal,
+                                     int own_address,
+                                     int slave_address)
+{
+  if (0 <= slave_address) {
+    SERIAL_HAL_STATE(hal)->slave_address = slave_address;
+  }
+  return 0;
+}
+
+int
+iBSP430gpioserialI2CrxData_ni (hBSP430halSERIAL hal,
+                               uint8_t * rx_data,
+                               size_t rx_len)
+{
+  return i2cTransaction_ni(hal, NULL, 0, rx_len, rx_data);
+}
+
+int
+iBSP430gpioserialI2CtxData_ni (hBSP430halSERIAL hal,
+                               const uint8_t * tx_data,
+                               size_t tx_len)
+{
+  return i2cTransaction_ni(hal, tx_data, tx_len, 0, NULL);
+}
+
+int
+iBSP430gpioserialI2CtxRx_ni (hBSP430halSERIAL hal,
+                             const uint8_t * tx_data,
+                             size_t tx_len,
+                             size_t rx_len,
+                             uint8_t * rx_data)
+{
+  return i2cTransaction_ni(hal, tx_data, tx_len, rx_len, rx_data);
+}
+
+const char *
+xBSP430gpioserialName (tBSP430periphHandle periph)
+{
+  if (BSP430_PERIPH_GPIOSERIAL0 == periph) {
+    return "GPIOSERIAL0";
+  }
+  if (BSP430_PERIPH_GPIOSERIAL1 == periph) {
+    return "GPIOSERIAL1";
+  }
+  return NULL;
+}
+
+#if BSP430_SERIAL - 0
+static struct sBSP430serialDispatch dispatch_ = {
+#if configBSP430_SERIAL_ENABLE_UART - 0
+  .openUART = hBSP430gpioserialOpenUART,
+  .openUARTDivisor = hBSP430gpioserialOpenUARTDivisor,
+  .uartRxByte_ni = iBSP430gpioserialUARTrxByte_ni,
+  .uartTxByte_ni = iBSP430gpioserialUARTtxByte_ni,
+  .uartTxData_ni = iBSP430gpioserialUARTtxData_ni,
+  .uartTxASCIIZ_ni = iBSP430gpioserialUARTtxASCIIZ_ni,
+#endif /* configBSP430_SERIAL_ENABLE_UART */
+#if configBSP430_SERIAL_ENABLE_SPI - 0
+  .openSPI = hBSP430gpioserialOpenSPI,
+  .spiTxRx_ni = iBSP430gpioserialSPITxRx_ni,
+  .spiReconfigure_ni = iBSP430gpioserialSPIReconfigure_ni,
+#endif /* configBSP430_SERIAL_ENABLE_SPI */
+#if configBSP430_SERIAL_ENABLE_I2C - 0
+  .openI2C = hBSP430gpioserialOpenI2C,
+  .i2cSetAddresses_ni = iBSP430gpioserialI2CsetAddresses_ni,
+  .i2cRxData_ni = iBSP430gpioserialI2CrxData_ni,
+  .i2cTxData_ni = iBSP430gpioserialI2CtxData_ni,
+  .i2cTxRx_ni = iBSP430gpioserialI2CtxRx_ni,
+#endif /* configBSP430_SERIAL_ENABLE_I2C */
+  .setHold_ni = iBSP430gpioserialSetHold_ni,
+  .close = iBSP430gpioserialClose,
+  .wakeupTransmit_ni = vBSP430gpioserialWakeupTransmit_ni,
+  .flush_ni = vBSP430gpioserialFlush_ni,
+};
+#endif /* BSP430_SERIAL */
+
+#if configBSP430_HAL_GPIOSERIAL0 - 0
+static sBSP430gpioserialState gpioserial0_ = {
+  .clk_port = BSP430_GPIOSERIAL0_CLK_PORT_PERIPH_HANDLE,
+  .clk_bit = BSP430_GPIOSERIAL0_CLK_PORT_BIT,
+  .mosi_port = BSP430_GPIOSERIAL0_MOSI_PORT_PERIPH_HANDLE,
+  .mosi_bit = BSP430_GPIOSERIAL0_MOSI_PORT_BIT,
+#if defined(BSP430_GPIOSERIAL0_MISO_PORT_PERIPH_HANDLE)
+  .miso_port = BSP430_GPIOSERIAL0_MISO_PORT_PERIPH_HANDLE,
+  .miso_bit = BSP430_GPIOSERIAL0_MISO_PORT_BIT,
+#endif /* BSP430_GPIOSERIAL0_MISO_PORT_PERIPH_HANDLE */
+  .timer = BSP430_GPIOSERIAL0_TIMER_PERIPH_HANDLE,
+};
+
+struct sBSP430halSERIAL xBSP430hal_GPIOSERIAL0_ = {
+  .hal_state = {
+    .cflags = BSP430_SERIAL_HAL_HPL_VARIANT_GPIOSERIAL
+  },
+  .hpl_aux = { .gpioserial = &gpioserial0_ },
+#if BSP430_SERIAL - 0
+  .dispatch = &dispatch_,
+#endif /* BSP430_SERIAL */
+};
+#endif /* configBSP430_HAL_GPIOSERIAL0 */
+
+#if configBSP430_HAL_GPIOSERIAL1 - 0
+static sBSP430gpioserialState gpioserial1_ = {
+  .clk_port = BSP430_GPIOSERIAL1_CLK_PORT_PERIPH_HANDLE,
+  .clk_bit = BSP430_GPIOSERIAL1_CLK_PORT_BIT,
+  .mosi_port = BSP430_GPIOSERIAL1_MOSI_PORT_PERIPH_HANDLE,
+  .mosi_bit = BSP430_GPIOSERIAL1_MOSI_PORT_BIT,
+#if defined(BSP430_GPIOSERIAL1_MISO_PORT_PERIPH_HANDLE)
+  .miso_port = BSP430_GPIOSERIAL1_MISO_PORT_PERIPH_HANDLE,
+  .miso_bit = BSP430_GPIOSERIAL1_MISO_PORT_BIT,
+#endif /* BSP430_GPIOSERIAL1_MISO_PORT_PERIPH_HANDLE */
+  .timer = BSP430_GPIOSERIAL1_TIMER_PERIPH_HANDLE,
+};
+
+struct sBSP430halSERIAL xBSP430hal_GPIOSERIAL1_ = {
+  .hal_state = {
+    .cflags = BSP430_SERIAL_HAL_HPL_VARIANT_GPIOSERIAL
+  },
+  .hpl_aux = { .gpioserial = &gpioserial1_ },
+#if BSP430_SERIAL - 0
+  .dispatch = &dispatch_,
+#endif /* BSP430_SERIAL */
+};
+#endif /* configBSP430_HAL_GPIOSERIAL1 */
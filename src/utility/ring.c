@@ -0,0 +1,105 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of lock-free ring buffers
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/utility/ring.h>
+#include <string.h>
+
+/* Copy in two segments: up to the end of the buffer, then from its
+ * start.  Only the caller's index is updated, after the copy. */
+#define RING_IMPLEMENT_(w_)                                             \
+hBSP430ring##w_                                                         \
+hBSP430ring##w_##Initialize (sBSP430ring##w_ * ring,                    \
+                             uint8_t * buffer,                          \
+                             size_t size)                               \
+{                                                                       \
+  if ((NULL == buffer) || ! BSP430_RING_SIZE_IS_VALID(size, w_)) {      \
+    return NULL;                                                        \
+  }                                                                     \
+  ring->buffer = buffer;                                                \
+  ring->mask = size - 1;                                                \
+  ring->head = ring->tail = 0;                                          \
+  return ring;                                                          \
+}                                                                       \
+                                                                        \
+size_t                                                                  \
+xBSP430ring##w_##Put (hBSP430ring##w_ ring,                             \
+                      const uint8_t * src,                              \
+                      size_t len)                                       \
+{                                                                       \
+  unsigned int offset = ring->head & ring->mask;                        \
+  size_t space = uiBSP430ring##w_##Space(ring);                         \
+  size_t seg = ring->mask + 1U - offset;                                \
+                                                                        \
+  if (len > space) {                                                    \
+    len = space;                                                        \
+  }                                                                     \
+  if (seg > len) {                                                      \
+    seg = len;                                                          \
+  }                                                                     \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  memcpy(ring->buffer + offset, src, seg);                              \
+  memcpy(ring->buffer, src + seg, len - seg);                           \
+  vBSP430ring##w_##Commit(ring, len);                                   \
+  return len;                                                           \
+}                                                                       \
+                                                                        \
+size_t                                                                  \
+xBSP430ring##w_##Get (hBSP430ring##w_ ring,                             \
+                      uint8_t * dst,                                    \
+                      size_t len)                                       \
+{                                                                       \
+  unsigned int offset = ring->tail & ring->mask;                        \
+  size_t count = uiBSP430ring##w_##Count(ring);                         \
+  size_t seg = ring->mask + 1U - offset;                                \
+                                                                        \
+  if (len > count) {                                                    \
+    len = count;                                                        \
+  }                                                                     \
+  if (seg > len) {                                                      \
+    seg = len;                                                          \
+  }                                                                     \
+  BSP430_CORE_MEMORY_BARRIER();                                         \
+  memcpy(dst, ring->buffer + offset, seg);                              \
+  memcpy(dst + seg, ring->buffer, len - seg);                           \
+  vBSP430ring##w_##Release(ring, len);                                  \
+  return len;                                                           \
+}
+
+RING_IMPLEMENT_(8)
+RING_IMPLEMENT_(16)
@@ -0,0 +1,610 @@
+/* Copyright (c) 2012, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Implementation of a software UART on timer capture/compare blocks
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/serial.h>
+#include <bsp430/utility/timeruart.h>
+#include <stddef.h>
+
+#define SERIAL_HAL_STATE(_hal) ((_hal)->hpl_aux.timeruart)
+
+/* Receive block awaiting the falling edge of a start bit */
+#define RX_CCTL_CAPTURE (CM_2 | CCIS_0 | SCS | CAP | CCIE)
+/* Receive block latching the input at the next bit midpoint */
+#define RX_CCTL_SAMPLE (CCIS_0 | SCS | CCIE)
+/* Transmit block idle, output high */
+#define TX_CCTL_IDLE (OUTMOD_0 | OUT)
+
+/* Start bit (low) in bit 0, data LSB first, stop bit (high) last */
+#define TX_FRAME(_c) (0x200 | ((unsigned int)(_c) << 1))
+
+void
+vBSP430timeruartRxReset (sBSP430timeruartRx * rxp,
+                         unsigned int bit_tck)
+{
+  rxp->bit_tck = bit_tck;
+  rxp->sample_tck = 0;
+  rxp->bit_idx = 0;
+  rxp->shift = 0;
+}
+
+int
+iBSP430timeruartRxEvent_ni (sBSP430timeruartRx * rxp,
+                            unsigned int event_tck,
+                            int level)
+{
+  if (0 == rxp->bit_idx) {
+    if (level) {
+      return BSP430_TIMERUART_RX_IDLE;
+    }
+    /* Falling edge: confirm the start bit at its midpoint */
+    rxp->sample_tck = event_tck + rxp->bit_tck / 2;
+    rxp->bit_idx = 1;
+    return BSP430_TIMERUART_RX_SAMPLE;
+  }
+  if (1 == rxp->bit_idx) {
+    if (level) {
+      /* Too short to be a start bit */
+      rxp->bit_idx = 0;
+      return BSP430_TIMERUART_RX_IDLE;
+    }
+    rxp->shift = 0;
+  } else if (10 > rxp->bit_idx) {
+    rxp->shift >>= 1;
+    if (level) {
+      rxp->shift |= 0x80;
+    }
+  } else {
+    rxp->bit_idx = 0;
+    return level ? rxp->shift : BSP430_TIMERUART_RX_FRAMING;
+  }
+  ++rxp->bit_idx;
+  rxp->sample_tck += rxp->bit_tck;
+  return BSP430_TIMERUART_RX_SAMPLE;
+}
+
+/* Capture/compare callback for the receive block.  In capture mode
+ * the event is a start edge; in compare mode it is a sample of the
+ * line latched in SCCI. */
+static int
+rxCCcb_ni (const struct sBSP430halISRIndexedChainNode * cb,
+           void * context,
+           int idx)
+{
+  sBSP430timeruartState * sp = (sBSP430timeruartState *)(-offsetof(sBSP430timeruartState, rx_cb) + (unsigned char *)cb);
+  hBSP430halSERIAL hal = sp->hal;
+  volatile sBSP430hplTIMER * const hpl = sp->timer->hpl;
+  unsigned int cctl = hpl->cctl[idx];
+  int level = (cctl & CAP) ? 0 : !! (cctl & SCCI);
+  int rv = 0;
+  int rc;
+
+  rc = iBSP430timeruartRxEvent_ni(&sp->rx, hpl->ccr[idx], level);
+  if (BSP430_TIMERUART_RX_SAMPLE == rc) {
+    hpl->ccr[idx] = sp->rx.sample_tck;
+    hpl->cctl[idx] = RX_CCTL_SAMPLE;
+    return 0;
+  }
+  if (! (cctl & CAP)) {
+    hpl->cctl[idx] = RX_CCTL_CAPTURE;
+  }
+  if (0 <= rc) {
+    if (hal->rx_cbchain_ni) {
+      hal->rx_byte = rc;
+      ++hal->num_rx;
+      rv = iBSP430callbackInvokeISRVoid_ni(&hal->rx_cbchain_ni, hal, 0);
+    } else {
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+      if (sp->rx_ready) {
+        ++hal->errors.overrun;
+      }
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+      sp->rx_held = rc;
+      sp->rx_ready = 1;
+      rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+    }
+  }
+#if configBSP430_SERIAL_ERROR_COUNTERS - 0
+  else if (BSP430_TIMERUART_RX_FRAMING == rc) {
+    ++hal->errors.framing;
+  }
+#endif /* configBSP430_SERIAL_ERROR_COUNTERS */
+  return rv & ~(BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN | BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT);
+}
+
+/* Program the transmit block to emit the next bit of the frame at
+ * the next bit boundary. */
+static void
+txScheduleBit_ni (sBSP430timeruartState * sp,
+                  volatile sBSP430hplTIMER * hpl,
+                  unsigned int ie)
+{
+  unsigned int bit = sp->tx_frame & 1;
+
+  sp->tx_frame >>= 1;
+  hpl->ccr[sp->tx_ccidx] += sp->rx.bit_tck;
+  hpl->cctl[sp->tx_ccidx] = (bit ? OUTMOD_1 : OUTMOD_5) | ie;
+}
+
+/* Begin transmitting an octet.  The start bit is placed one bit time
+ * in the future, or at the end of the previous stop bit if that is
+ * still pending and far enough away to be scheduled safely. */
+static void
+txStart_ni (sBSP430timeruartState * sp,
+            volatile sBSP430hplTIMER * hpl,
+            uint8_t c,
+            unsigned int ie)
+{
+  unsigned int bit_tck = sp->rx.bit_tck;
+  unsigned int now = hpl->r;
+  unsigned int lead = sp->tx_idle_tck - now;
+
+  if ((lead < (bit_tck / 4)) || (lead > bit_tck)) {
+    lead = bit_tck;
+  }
+  sp->tx_frame = TX_FRAME(c);
+  /* txScheduleBit_ni() advances by one bit time */
+  hpl->ccr[sp->tx_ccidx] = now + lead - bit_tck;
+  txScheduleBit_ni(sp, hpl, ie);
+}
+
+/* Capture/compare callback for the transmit block, invoked at each
+ * bit boundary. */
+static int
+txCCcb_ni (const struct sBSP430halISRIndexedChainNode * cb,
+           void * context,
+           int idx)
+{
+  sBSP430timeruartState * sp = (sBSP430timeruartState *)(-offsetof(sBSP430timeruartState, tx_cb) + (unsigned char *)cb);
+  volatile sBSP430hplTIMER * const hpl = sp->timer->hpl;
+  int rv = 0;
+  int c;
+
+  if (0 != sp->tx_frame) {
+    txScheduleBit_ni(sp, hpl, CCIE);
+    return 0;
+  }
+  /* The stop bit has just begun.  Chain the next octet so its start
+   * bit follows immediately, or go idle. */
+  sp->tx_idle_tck = hpl->ccr[idx] + sp->rx.bit_tck;
+  c = iBSP430serialTxISRNextOctet_ni(sp->hal, &rv);
+  if (0 <= c) {
+    sp->tx_frame = TX_FRAME(c);
+    txScheduleBit_ni(sp, hpl, CCIE);
+  } else {
+    hpl->cctl[idx] = TX_CCTL_IDLE;
+    sp->tx_busy = 0;
+  }
+  return rv & ~(BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN | BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT);
+}
+
+/* Process a capture/compare event that is pending because interrupts
+ * are disabled.  This allows the _ni functions to make progress when
+ * called from a critical section. */
+static int
+serviceCC_ni (sBSP430timeruartState * sp,
+              const struct sBSP430halISRIndexedChainNode * cb,
+              int idx)
+{
+  volatile sBSP430hplTIMER * const hpl = sp->timer->hpl;
+
+  if (! (hpl->cctl[idx] & CCIFG)) {
+    return 0;
+  }
+  hpl->cctl[idx] &= ~CCIFG;
+  return cb->callback(cb, sp->timer, idx);
+}
+
+static void
+configurePins (sBSP430timeruartState * sp,
+               int enablep)
+{
+  hBSP430halPORT rx_port = hBSP430portLookup(sp->rx_port);
+  hBSP430halPORT tx_port = hBSP430portLookup(sp->tx_port);
+
+  if (enablep) {
+    BSP430_PORT_HAL_HPL_DIR(tx_port) |= sp->tx_bit;
+    BSP430_PORT_HAL_HPL_SEL(tx_port) |= sp->tx_bit;
+    BSP430_PORT_HAL_HPL_DIR(rx_port) &= ~sp->rx_bit;
+    BSP430_PORT_HAL_HPL_SEL(rx_port) |= sp->rx_bit;
+  } else {
+    BSP430_PORT_HAL_HPL_SEL(tx_port) &= ~sp->tx_bit;
+    BSP430_PORT_HAL_HPL_DIR(tx_port) &= ~sp->tx_bit;
+    BSP430_PORT_HAL_HPL_SEL(rx_port) &= ~sp->rx_bit;
+  }
+}
+
+static hBSP430halSERIAL
+timeruartConfigure (hBSP430halSERIAL hal,
+                    unsigned char ctl0_byte,
+                    unsigned long baud,
+                    unsigned long divisor_q12)
+{
+  sBSP430timeruartState * sp;
+  volatile sBSP430hplTIMER * hpl;
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+  unsigned long bit_tck;
+
+  /* Only 8N1 is supported */
+  if ((NULL == hal) || (0 != ctl0_byte)) {
+    return NULL;
+  }
+  sp = SERIAL_HAL_STATE(hal);
+  sp->timer = hBSP430timerLookup(sp->timer_periph);
+  if ((NULL == sp->timer)
+      || (NULL == hBSP430portLookup(sp->rx_port))
+      || (NULL == hBSP430portLookup(sp->tx_port))) {
+    return NULL;
+  }
+  hpl = sp->timer->hpl;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    /* Start a halted timer in continuous mode; otherwise assume its
+     * owner has it in continuous mode already. */
+    if (0 == (hpl->ctl & (MC0 | MC1))) {
+      hpl->ctl = TASSEL_2 | MC_2 | TACLR;
+    }
+    if (0 != baud) {
+      unsigned long timer_Hz = ulBSP430timerFrequency_Hz_ni(sp->timer_periph);
+      bit_tck = (timer_Hz + baud / 2) / baud;
+    } else {
+      bit_tck = (divisor_q12 + 0x800UL) >> 12;
+    }
+    if ((BSP430_TIMERUART_MIN_BIT_TCK > bit_tck) || (0xFFFF < bit_tck)) {
+      hal = NULL;
+      break;
+    }
+
+    /* Idle the blocks and drive the output high before handing the
+     * pins to the timer */
+    hpl->cctl[sp->rx_ccidx] = 0;
+    hpl->cctl[sp->tx_ccidx] = TX_CCTL_IDLE;
+    configurePins(sp, 1);
+
+    vBSP430timeruartRxReset(&sp->rx, bit_tck);
+    sp->tx_frame = 0;
+    sp->tx_idle_tck = hpl->r;
+    sp->rx_ready = 0;
+    sp->tx_busy = 0;
+    if (! sp->open) {
+      sp->rx_cb.callback = rxCCcb_ni;
+      sp->tx_cb.callback = txCCcb_ni;
+      BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode,
+                                      sp->timer->cc_cbchain_ni[sp->rx_ccidx],
+                                      sp->rx_cb,
+                                      next_ni);
+      BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode,
+                                      sp->timer->cc_cbchain_ni[sp->tx_ccidx],
+                                      sp->tx_cb,
+                                      next_ni);
+      sp->open = 1;
+    }
+    hpl->cctl[sp->rx_ccidx] = RX_CCTL_CAPTURE;
+
+    /* Reset device statistics */
+    hal->num_rx = hal->num_tx = 0;
+    BSP430_SERIAL_RESET_ERRORS_NI(hal);
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return hal;
+}
+
+hBSP430halSERIAL
+hBSP430timeruartOpenUART (hBSP430halSERIAL hal,
+                          unsigned char ctl0_byte,
+                          unsigned char ctl1_byte,
+                          unsigned long baud)
+{
+  if (0 == baud) {
+    return NULL;
+  }
+  return timeruartConfigure(hal, ctl0_byte, baud, 0);
+}
+
+hBSP430halSERIAL
+hBSP430timeruartOpenUARTDivisor (hBSP430halSERIAL hal,
+                                 unsigned char ctl0_byte,
+                                 unsigned char ctl1_byte,
+                                 unsigned long divisor_q12)
+{
+  return timeruartConfigure(hal, ctl0_byte, 0, divisor_q12);
+}
+
+hBSP430halSERIAL
+hBSP430timeruartOpenSPI (hBSP430halSERIAL hal,
+                         unsigned char ctl0_byte,
+                         unsigned char ctl1_byte,
+                         unsigned int prescaler)
+{
+  return NULL;
+}
+
+hBSP430halSERIAL
+hBSP430timeruartOpenI2C (hBSP430halSERIAL hal,
+                         unsigned char ctl0_byte,
+                         unsigned char ctl1_byte,
+                         unsigned int prescaler)
+{
+  return NULL;
+}
+
+int
+iBSP430timeruartSetHold_ni (hBSP430halSERIAL hal,
+                            int holdp)
+{
+  sBSP430timeruartState * sp = SERIAL_HAL_STATE(hal);
+  volatile sBSP430hplTIMER * hpl;
+
+  if (! sp->open) {
+    return -1;
+  }
+  hpl = sp->timer->hpl;
+  /* Abandon anything in progress */
+  hpl->cctl[sp->rx_ccidx] = 0;
+  hpl->cctl[sp->tx_ccidx] = TX_CCTL_IDLE;
+  vBSP430timeruartRxReset(&sp->rx, sp->rx.bit_tck);
+  sp->tx_frame = 0;
+  sp->tx_busy = 0;
+  if (! holdp) {
+    hpl->cctl[sp->rx_ccidx] = RX_CCTL_CAPTURE;
+  }
+  return 0;
+}
+
+int
+iBSP430timeruartClose (hBSP430halSERIAL hal)
+{
+  sBSP430timeruartState * sp = SERIAL_HAL_STATE(hal);
+  BSP430_CORE_INTERRUPT_STATE_T istate;
+
+  BSP430_CORE_SAVE_INTERRUPT_STATE(istate);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  if (sp->open) {
+    (void)iBSP430timeruartSetHold_ni(hal, 1);
+    configurePins(sp, 0);
+    BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode,
+                                      sp->timer->cc_cbchain_ni[sp->rx_ccidx],
+                                      sp->rx_cb,
+                                      next_ni);
+    BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode,
+                                      sp->timer->cc_cbchain_ni[sp->tx_ccidx],
+                                      sp->tx_cb,
+                                      next_ni);
+    sp->open = 0;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return 0;
+}
+
+void
+vBSP430timeruartWakeupTransmit_ni (hBSP430halSERIAL hal)
+{
+  sBSP430timeruartState * sp = SERIAL_HAL_STATE(hal);
+  int rv;
+  int c;
+
+  if (sp->tx_busy || (! sp->open)) {
+    return;
+  }
+  c = iBSP430serialTxISRNextOctet_ni(hal, &rv);
+  if (0 <= c) {
+    sp->tx_busy = 1;
+    txStart_ni(sp, sp->timer->hpl, c, CCIE);
+  }
+}
+
+void
+vBSP430timeruartFlush_ni (hBSP430halSERIAL hal)
+{
+  sBSP430timeruartState * sp = SERIAL_HAL_STATE(hal);
+  volatile sBSP430hplTIMER * hpl;
+
+  if (! sp->open) {
+    return;
+  }
+  hpl = sp->timer->hpl;
+  while (sp->tx_busy) {
+    (void)serviceCC_ni(sp, &sp->tx_cb, sp->tx_ccidx);
+  }
+  /* Wait out the final stop bit */
+  while ((unsigned int)(sp->tx_idle_tck - hpl->r) <= sp->rx.bit_tck) {
+    ;
+  }
+}
+
+int
+iBSP430timeruartUARTrxByte_ni (hBSP430halSERIAL hal)
+{
+  sBSP430timeruartState * sp = SERIAL_HAL_STATE(hal);
+
+  if (hal->rx_cbchain_ni) {
+    return -1;
+  }
+  (void)serviceCC_ni(sp, &sp->rx_cb, sp->rx_ccidx);
+  if (sp->rx_ready) {
+    sp->rx_ready = 0;
+    ++hal->num_rx;
+    return sp->rx_held;
+  }
+  return -1;
+}
+
+int
+iBSP430timeruartUARTtxByte_ni (hBSP430halSERIAL hal,
+                               uint8_t c)
+{
+  sBSP430timeruartState * sp = SERIAL_HAL_STATE(hal);
+  volatile sBSP430hplTIMER * hpl;
+
+  if (hal->tx_cbchain_ni) {
+    return -1;
+  }
+  hpl = sp->timer->hpl;
+  txStart_ni(sp, hpl, c, 0);
+  while (1) {
+    while (! (hpl->cctl[sp->tx_ccidx] & CCIFG)) {
+      ;
+    }
+    if (0 == sp->tx_frame) {
+      break;
+    }
+    txScheduleBit_ni(sp, hpl, 0);
+  }
+  /* The stop bit has begun; the next start bit may follow it
+   * directly */
+  sp->tx_idle_tck = hpl->ccr[sp->tx_ccidx] + sp->rx.bit_tck;
+  hpl->cctl[sp->tx_ccidx] = TX_CCTL_IDLE;
+  ++hal->num_tx;
+  return c;
+}
+
+int
+iBSP430timeruartUARTtxData_ni (hBSP430halSERIAL hal,
+                               const uint8_t * data,
+                               size_t len)
+{
+  const uint8_t * p = data;
+  const uint8_t * edata = data + len;
+
+  if (hal->tx_cbchain_ni) {
+    return -1;
+  }
+  while (p < edata) {
+    (void)iBSP430timeruartUARTtxByte_ni(hal, *p++);
+  }
+  return p - data;
+}
+
+int
+iBSP430timeruartUARTtxASCIIZ_ni (hBSP430halSERIAL hal,
+                                 const char * str)
+{
+  const char * in_string = str;
+
+  if (hal->tx_cbchain_ni) {
+    return -1;
+  }
+  while (*str) {
+    (void)iBSP430timeruartUARTtxByte_ni(hal, *str);
+    ++str;
+  }
+  return str - in_string;
+}
+
+const char *
+xBSP430timeruartName (tBSP430periphHandle periph)
+{
+  if (BSP430_PERIPH_TIMERUART0 == periph) {
+    return "TIMERUART0";
+  }
+  if (BSP430_PERIPH_TIMERUART1 == periph) {
+    return "TIMERUART1";
+  }
+  return NULL;
+}
+
+#if BSP430_SERIAL - 0
+static struct sBSP430serialDispatch dispatch_ = {
+#if configBSP430_SERIAL_ENABLE_UART - 0
+  .openUART = hBSP430timeruartOpenUART,
+  .openUARTDivisor = hBSP430timeruartOpenUARTDivisor,
+  .uartRxByte_ni = iBSP430timeruartUARTrxByte_ni,
+  .uartTxByte_ni = iBSP430timeruartUARTtxByte_ni,
+  .uartTxData_ni = iBSP430timeruartUARTtxData_ni,
+  .uartTxASCIIZ_ni = iBSP430timeruartUARTtxASCIIZ_ni,
+#endif /* configBSP430_SERIAL_ENABLE_UART */
+#if configBSP430_SERIAL_ENABLE_SPI - 0
+  .openSPI = hBSP430timeruartOpenSPI,
+#endif /* configBSP430_SERIAL_ENABLE_SPI */
+#if configBSP430_SERIAL_ENABLE_I2C - 0
+  .openI2C = hBSP430timeruartOpenI2C,
+#endif /* configBSP430_SERIAL_ENABLE_I2C */
+  .setHold_ni = iBSP430timeruartSetHold_ni,
+  .close = iBSP430timeruartClose,
+  .wakeupTransmit_ni = vBSP430timeruartWakeupTransmit_ni,
+  .flush_ni = vBSP430timeruartFlush_ni,
+};
+#endif /* BSP430_SERIAL */
+
+#if configBSP430_HAL_TIMERUART0 - 0
+static sBSP430timeruartState timeruart0_ = {
+  .hal = &xBSP430hal_TIMERUART0_,
+  .timer_periph = BSP430_TIMERUART0_TIMER_PERIPH_HANDLE,
+  .rx_ccidx = BSP430_TIMERUART0_RX_CCIDX,
+  .tx_ccidx = BSP430_TIMERUART0_TX_CCIDX,
+  .rx_port = BSP430_TIMERUART0_RX_PORT_PERIPH_HANDLE,
+  .rx_bit = BSP430_TIMERUART0_RX_PORT_BIT,
+  .tx_port = BSP430_TIMERUART0_TX_PORT_PERIPH_HANDLE,
+  .tx_bit = BSP430_TIMERUART0_TX_PORT_BIT,
+};
+
+struct sBSP430halSERIAL xBSP430hal_TIMERUART0_ = {
+  .hal_state = {
+    .cflags = BSP430_SERIAL_HAL_HPL_VARIANT_TIMERUART
+  },
+  .hpl_aux = { .timeruart = &timeruart0_ },
+#if BSP430_SERIAL - 0
+  .dispatch = &dispatch_,
+#endif /* BSP430_SERIAL */
+};
+#endif /* configBSP430_HAL_TIMERUART0 */
+
+#if configBSP430_HAL_TIMERUART1 - 0
+static sBSP430timeruartState timeruart1_ = {
+  .hal = &xBSP430hal_TIMERUART1_,
+  .timer_periph = BSP430_TIMERUART1_TIMER_PERIPH_HANDLE,
+  .rx_ccidx = BSP430_TIMERUART1_RX_CCIDX,
+  .tx_ccidx = BSP430_TIMERUART1_TX_CCIDX,
+  .rx_port = BSP430_TIMERUART1_RX_PORT_PERIPH_HANDLE,
+  .rx_bit = BSP430_TIMERUART1_RX_PORT_BIT,
+  .tx_port = BSP430_TIMERUART1_TX_PORT_PERIPH_HANDLE,
+  .tx_bit = BSP430_TIMERUART1_TX_PORT_BIT,
+};
+
+struct sBSP430halSERIAL xBSP430hal_TIMERUART1_ = {
+  .hal_state = {
+    .cflags = BSP430_SERIAL_HAL_HPL_VARIANT_TIMERUART
+  },
+  .hpl_aux = { .timeruart = &timeruart1_ },
+#if BSP430_SERIAL - 0
+  .dispatch = &dispatch_,
+#endif /* BSP430_SERIAL */
+};
+#endif /* configBSP430_HAL_TIMERUART1 */